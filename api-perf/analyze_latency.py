@@ -49,6 +49,77 @@ def load_benchmark_data(csv_files):
     
     return pd.concat(all_data, ignore_index=True)
 
+def load_benchmark_json(json_files):
+    """Load run_benchmarks.py JSON results (per-call cycles already net of the
+    empty loop, plus latency percentiles and counters when recorded)"""
+    rows = []
+
+    for json_file in json_files:
+        filename = os.path.basename(json_file)
+        condition = filename.replace('api_perf_results_', '').replace('.json', '')
+
+        with open(json_file, 'r') as f:
+            results = json.load(f)
+
+        for entry in results:
+            result = entry['result']
+            metadata = entry.get('metadata', {})
+            rows.append({
+                'function': entry['function'],
+                'prefix': entry['prefix'],
+                'iterations': result['iterations'],
+                # Net of the empty loop, so per-call latencies need no baseline
+                'total_cycles': result['net_cycles'],
+                'metadata': json.dumps(metadata).replace('"', "'"),
+                'metadata_parsed': metadata,
+                'latency': result.get('latency'),
+                'counters': result.get('counters'),
+                'condition': condition,
+                'source_file': filename,
+            })
+
+    return pd.DataFrame(rows)
+
+def load_results(csv_files, json_files):
+    """Load all results, preferring a run's JSON file over its CSV"""
+    json_stems = {os.path.splitext(f)[0] for f in json_files}
+    csv_only = [f for f in csv_files if os.path.splitext(f)[0] not in json_stems]
+
+    frames = []
+    if csv_only:
+        frames.append(load_benchmark_data(csv_only))
+    if json_files:
+        frames.append(load_benchmark_json(json_files))
+    if not frames:
+        raise ValueError("No valid result files found")
+    return pd.concat(frames, ignore_index=True)
+
+def summarize_tails(group):
+    """Median latency percentiles and mean per-call counters across a
+    function's cases, for results that recorded them"""
+    summary = {}
+
+    if 'latency' in group:
+        latencies = [l for l in group['latency'] if isinstance(l, dict)]
+        if latencies:
+            summary['latency_percentiles_cycles'] = {
+                key: round(float(np.median([l[key] for l in latencies])), 2)
+                for key in ('p50', 'p90', 'p99', 'p999', 'max')
+            }
+
+    if 'counters' in group:
+        counters = [c for c in group['counters'] if isinstance(c, dict)]
+        if counters:
+            per_call = {}
+            for name in counters[0]:
+                values = [c[name] for c in counters if c.get(name) is not None]
+                if values:
+                    per_call[name] = round(float(np.mean(values)), 4)
+            if per_call:
+                summary['counters_per_call'] = per_call
+
+    return summary
+
 def filter_invalid_rx_burst(df):
     """Remove rx_burst data where no packets were received (burst size too small)"""
     def is_valid_rx_burst(row):
@@ -229,6 +300,7 @@ def generate_function_latency_map(df, correlations):
                             param_coeffs[param] = round(correlations[function][param]['coefficient'], 4)
                         function_data["parameters"] = param_coeffs
         
+        function_data.update(summarize_tails(group))
         function_map[function] = function_data
     
     return function_map
@@ -327,7 +399,7 @@ def generate_polling_analysis(df):
 def main():
     parser = argparse.ArgumentParser(description='Analyze API performance benchmark results')
     parser.add_argument('--csv-dir', default='.', 
-                       help='Directory containing CSV files (default: current directory)')
+                       help='Directory containing CSV/JSON result files (default: current directory)')
     parser.add_argument('--output', default='function_latency_map.json',
                        help='Output JSON file (default: function_latency_map.json)')
     parser.add_argument('--polling-output', default='polling_analysis.json',
@@ -340,18 +412,19 @@ def main():
     # Find all CSV files
     csv_pattern = os.path.join(args.csv_dir, 'api_perf_results_*.csv')
     csv_files = glob.glob(csv_pattern)
+    json_files = glob.glob(os.path.join(args.csv_dir, 'api_perf_results_*.json'))
     
-    if not csv_files:
-        print(f"No CSV files found matching pattern: {csv_pattern}")
+    if not csv_files and not json_files:
+        print(f"No CSV or JSON files found matching pattern: {csv_pattern}")
         return
     
-    print(f"Found {len(csv_files)} CSV files:")
-    for f in csv_files:
+    print(f"Found {len(csv_files)} CSV files and {len(json_files)} JSON files:")
+    for f in csv_files + json_files:
         print(f"  - {f}")
     
     # Load and process data
     print("\nLoading benchmark data...")
-    df = load_benchmark_data(csv_files)
+    df = load_results(csv_files, json_files)
     print(f"Loaded {len(df)} benchmark results")
     
     # Filter invalid rx_burst data
@@ -1,5 +1,5 @@
 static unsigned int burst_size;
-struct rte_crypto_op *ops[256];
+static struct rte_crypto_op *ops[256];
 
 // Mempool and mbufs used by this benchmark
 static struct rte_mempool *mbuf_pool;
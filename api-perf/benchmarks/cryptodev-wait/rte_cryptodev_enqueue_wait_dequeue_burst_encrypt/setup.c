@@ -16,7 +16,10 @@ if (rte_crypto_op_bulk_alloc(crypto_op_pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC, ops,
     rte_exit(EXIT_FAILURE, "Failed to allocate ops");
 }
 
-// Create mbuf pool on first use
+// Create mbuf pool on first use; in-process runs share it between the crypto benchmarks
+if (mbuf_pool == NULL) {
+    mbuf_pool = rte_mempool_lookup("mbuf_pool");
+}
 if (mbuf_pool == NULL) {
     mbuf_pool = rte_pktmbuf_pool_create("mbuf_pool", MBUF_POOL_SIZE, MBUF_CACHE_SIZE, 0, MBUF_DATA_SIZE, rte_socket_id());
     if (mbuf_pool == NULL) {
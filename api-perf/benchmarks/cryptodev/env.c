@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <rte_eal.h>
+#include <rte_mbuf.h>
+#include <rte_crypto.h>
+#include <rte_cryptodev.h>
+
+#include "driver/benchmark_driver.h"
+#include "benchmarks/cryptodev/env.h"
+
+uint8_t cdev_id = 0;
+uint16_t cdev_nb_qps = 1;
+struct rte_cryptodev_sym_session *enc_session;
+struct rte_cryptodev_sym_session *dec_session;
+struct rte_mempool *crypto_op_pool;
+struct rte_mempool *session_pool;
+
+static void setup_cryptodev(uint64_t ff_disable) {
+    // Check that crypto device is available
+    int num_crypto_devices = rte_cryptodev_count();
+    if (num_crypto_devices < 1) {
+        rte_exit(EXIT_FAILURE, "No crypto devices available\n");
+    }
+
+    // Get crypto device info
+    struct rte_cryptodev_info cdev_info;
+    rte_cryptodev_info_get(cdev_id, &cdev_info);
+
+    // Create crypto operation pool
+    crypto_op_pool = rte_crypto_op_pool_create("crypto_op_pool",
+                                              RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+                                              8192, 128, MAX_AES_GCM_IV_LENGTH, rte_socket_id());
+    if (crypto_op_pool == NULL) {
+        rte_exit(EXIT_FAILURE, "Failed to create crypto operation pool\n");
+    }
+
+    // Create session pool
+    const uint32_t private_session_size = rte_cryptodev_sym_get_private_session_size(cdev_id);
+    session_pool = rte_cryptodev_sym_session_pool_create("session_pool",
+                                                        8192, 128, private_session_size, 0, rte_socket_id());
+    if (session_pool == NULL) {
+        rte_exit(EXIT_FAILURE, "Failed to create session pool\n");
+    }
+
+    // One queue pair per lcore, so that multi-lcore cases do not share one
+    cdev_nb_qps = (uint16_t)RTE_MIN(RTE_MIN(rte_lcore_count(), (unsigned int)BENCH_MAX_LCORES),
+                                    (unsigned int)cdev_info.max_nb_queue_pairs);
+    if (cdev_nb_qps == 0) {
+        cdev_nb_qps = 1;
+    }
+
+    // Configure crypto device
+    struct rte_cryptodev_config config = {
+        .nb_queue_pairs = cdev_nb_qps,
+        .socket_id = rte_socket_id(),
+        .ff_disable = ff_disable,
+    };
+    if (rte_cryptodev_configure(cdev_id, &config) < 0) {
+        rte_exit(EXIT_FAILURE, "Failed to configure cryptodev %u\n", cdev_id);
+    }
+
+    // Setup queue pairs
+    struct rte_cryptodev_qp_conf qp_conf = {
+        .nb_descriptors = 128
+    };
+    for (uint16_t qp = 0; qp < cdev_nb_qps; qp++) {
+        if (rte_cryptodev_queue_pair_setup(cdev_id, qp, &qp_conf, rte_socket_id()) < 0) {
+            rte_exit(EXIT_FAILURE, "Failed to setup queue pair %u\n", qp);
+        }
+    }
+
+    // Start crypto device
+    if (rte_cryptodev_start(cdev_id) < 0) {
+        rte_exit(EXIT_FAILURE, "Failed to start crypto device\n");
+    }
+
+    // Create a sample key for the session
+    uint8_t key[AES128_KEY_LENGTH];
+    for (int i = 0; i < AES128_KEY_LENGTH; i++) {
+        key[i] = i; // Simple key for testing
+    }
+
+    // Setup AEAD transforms (encrypt and decrypt)
+    struct rte_crypto_sym_xform enc_xform = {
+        .type = RTE_CRYPTO_SYM_XFORM_AEAD,
+        .next = NULL,
+        .aead = {
+            .op = RTE_CRYPTO_AEAD_OP_ENCRYPT,
+            .algo = RTE_CRYPTO_AEAD_AES_GCM,
+            .key.data = key,
+            .key.length = AES128_KEY_LENGTH,
+            .iv.offset = sizeof(struct rte_crypto_op) + sizeof(struct rte_crypto_sym_op),
+            .iv.length = MAX_AES_GCM_IV_LENGTH,
+            .aad_length = 0,
+            .digest_length = AES_GCM_TAG_LENGTH,
+        },
+    };
+
+    struct rte_crypto_sym_xform dec_xform = enc_xform;
+    dec_xform.aead.op = RTE_CRYPTO_AEAD_OP_DECRYPT;
+
+    // Create sessions
+    enc_session = rte_cryptodev_sym_session_create(cdev_id, &enc_xform, session_pool);
+    if (enc_session == NULL) {
+        rte_exit(EXIT_FAILURE, "Failed to create encrypt session\n");
+    }
+    dec_session = rte_cryptodev_sym_session_create(cdev_id, &dec_xform, session_pool);
+    if (dec_session == NULL) {
+        rte_exit(EXIT_FAILURE, "Failed to create decrypt session\n");
+    }
+}
+
+static void setup_cryptodev_sym(void) {
+    setup_cryptodev(RTE_CRYPTODEV_FF_ASYMMETRIC_CRYPTO | RTE_CRYPTODEV_FF_SECURITY);
+}
+
+static void setup_cryptodev_wait(void) {
+    setup_cryptodev(RTE_CRYPTODEV_FF_SECURITY);
+}
+
+static void teardown_cryptodev(void) {
+    // Free sessions
+    if (enc_session != NULL) {
+        rte_cryptodev_sym_session_free(cdev_id, enc_session);
+        enc_session = NULL;
+    }
+    if (dec_session != NULL) {
+        rte_cryptodev_sym_session_free(cdev_id, dec_session);
+        dec_session = NULL;
+    }
+
+    // Stop and close crypto device
+    rte_cryptodev_stop(cdev_id);
+    rte_cryptodev_close(cdev_id);
+
+    // Free crypto operation pool
+    if (crypto_op_pool != NULL) {
+        rte_mempool_free(crypto_op_pool);
+        crypto_op_pool = NULL;
+    }
+
+    // Free session pool
+    if (session_pool != NULL) {
+        rte_mempool_free(session_pool);
+        session_pool = NULL;
+    }
+}
+
+const struct bench_env bench_env_cryptodev = {
+    .name = "cryptodev",
+    .setup = setup_cryptodev_sym,
+    .teardown = teardown_cryptodev,
+};
+
+const struct bench_env bench_env_cryptodev_wait = {
+    .name = "cryptodev-wait",
+    .setup = setup_cryptodev_wait,
+    .teardown = teardown_cryptodev,
+};
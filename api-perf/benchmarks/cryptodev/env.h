@@ -0,0 +1,28 @@
+#ifndef BENCHMARKS_CRYPTODEV_ENV_H
+#define BENCHMARKS_CRYPTODEV_ENV_H
+
+#include <rte_crypto.h>
+#include <rte_cryptodev.h>
+
+#include "driver/bench_registry.h"
+
+// Crypto constants
+#define AES128_KEY_LENGTH 16
+#define MAX_AES_GCM_IV_LENGTH 12
+#define AES_GCM_TAG_LENGTH 16
+
+// Crypto device, pools and AES-GCM sessions shared by the cryptodev and
+// cryptodev-wait benchmarks. The device has one queue pair per EAL lcore
+// (up to BENCH_MAX_LCORES); worker w of a multi-lcore case uses queue pair w.
+extern uint8_t cdev_id;
+extern uint16_t cdev_nb_qps;
+extern struct rte_cryptodev_sym_session *enc_session;
+extern struct rte_cryptodev_sym_session *dec_session;
+extern struct rte_mempool *crypto_op_pool;
+extern struct rte_mempool *session_pool;
+
+// Same device, configured with and without asymmetric crypto
+extern const struct bench_env bench_env_cryptodev;
+extern const struct bench_env bench_env_cryptodev_wait;
+
+#endif // BENCHMARKS_CRYPTODEV_ENV_H
@@ -1 +1 @@
-struct rte_crypto_op *ops[32];
\ No newline at end of file
+static struct rte_crypto_op *ops[32];
\ No newline at end of file
@@ -1,2 +1,6 @@
-struct rte_crypto_op *ops[32]; // Max size for the array
-unsigned int bulk_size;
\ No newline at end of file
+// Workers allocate from and free to the shared crypto_op_pool
+#define BENCH_MULTI_LCORE 1
+
+static struct rte_crypto_op *ops[BENCH_MAX_LCORES][32]; // Max size for the array
+static unsigned int bulk_size;
+static unsigned int lcores;
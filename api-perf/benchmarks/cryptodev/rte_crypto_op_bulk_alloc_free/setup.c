@@ -1,4 +1,8 @@
 const char* bulk_size_str = get_benchmark_param("bulk_size");
 bulk_size = bulk_size_str ? (unsigned int)strtoul(bulk_size_str, NULL, 10) : 32;
+if (bulk_size == 0 || bulk_size > 32) {
+    rte_exit(EXIT_FAILURE, "bulk_size must be 1..32");
+}
+lcores = bench_lcores();
 
-// Use the crypto_op_pool created by the template
\ No newline at end of file
+// Use the crypto_op_pool created by the template
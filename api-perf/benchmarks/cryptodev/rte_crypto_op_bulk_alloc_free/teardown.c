@@ -1,7 +1,9 @@
 // Free allocated crypto operations
-for (unsigned int i = 0; i < bulk_size; i++) {
-    if (ops[i] != NULL) {
-        rte_crypto_op_free(ops[i]);
-        ops[i] = NULL;
+for (unsigned int w = 0; w < lcores; w++) {
+    for (unsigned int i = 0; i < bulk_size; i++) {
+        if (ops[w][i] != NULL) {
+            rte_crypto_op_free(ops[w][i]);
+            ops[w][i] = NULL;
+        }
     }
 }
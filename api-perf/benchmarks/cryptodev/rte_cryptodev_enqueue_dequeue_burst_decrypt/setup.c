@@ -11,12 +11,15 @@ if (data_size > MBUF_DATA_SIZE) {
     rte_exit(EXIT_FAILURE, "data_size (%u) exceeds MBUF_DATA_SIZE (%u)", data_size, (unsigned)MBUF_DATA_SIZE);
 }
 
-// Use the crypto_op_pool created by the template
-if (rte_crypto_op_bulk_alloc(crypto_op_pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC, ops, burst_size) < 0) {
-    rte_exit(EXIT_FAILURE, "Failed to allocate ops");
+lcores = bench_lcores();
+if (lcores > cdev_nb_qps) {
+    rte_exit(EXIT_FAILURE, "lcores=%u but cryptodev %u has %u queue pairs", lcores, cdev_id, cdev_nb_qps);
 }
 
-// Create mbuf pool on first use
+// Create mbuf pool on first use; in-process runs share it between the crypto benchmarks
+if (mbuf_pool == NULL) {
+    mbuf_pool = rte_mempool_lookup("mbuf_pool");
+}
 if (mbuf_pool == NULL) {
     mbuf_pool = rte_pktmbuf_pool_create("mbuf_pool", MBUF_POOL_SIZE, MBUF_CACHE_SIZE, 0, MBUF_DATA_SIZE, rte_socket_id());
     if (mbuf_pool == NULL) {
@@ -24,52 +27,63 @@ if (mbuf_pool == NULL) {
     }
 }
 
-// Allocate mbufs for this burst
-if (rte_pktmbuf_alloc_bulk(mbuf_pool, mbufs, burst_size) < 0) {
-    rte_exit(EXIT_FAILURE, "Failed to allocate mbufs");
-}
-if (rte_pktmbuf_alloc_bulk(mbuf_pool, dst_mbufs, burst_size) < 0) {
-    rte_exit(EXIT_FAILURE, "Failed to allocate dst mbufs");
-}
-
-// Initialize per-op buffers (IVs) and set lengths
+// Initialize per-op buffers (IVs)
 for (unsigned int i = 0; i < burst_size; i++) {
     for (unsigned int j = 0; j < MAX_AES_GCM_IV_LENGTH; j++) {
         ivs[i][j] = (uint8_t)(i + j);
     }
-
-    rte_pktmbuf_reset(mbufs[i]);
-    rte_pktmbuf_append(mbufs[i], data_size);
-    rte_pktmbuf_reset(dst_mbufs[i]);
-    rte_pktmbuf_append(dst_mbufs[i], data_size);
 }
 
-// First, encrypt the prepared buffers so we have valid ciphertext+tag for decryption
-for (unsigned int i = 0; i < burst_size; i++) {
-    struct rte_crypto_op *op = ops[i];
-    op->sym->m_src = mbufs[i];
+for (unsigned int w = 0; w < lcores; w++) {
+    in_flight_ops[w].ops = 0;
 
-    op->sym->aead.data.offset = 0;
-    op->sym->aead.data.length = data_size - AES_GCM_TAG_LENGTH; // plaintext length
+    // Use the crypto_op_pool created by the template
+    if (rte_crypto_op_bulk_alloc(crypto_op_pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC, ops[w], burst_size) < 0) {
+        rte_exit(EXIT_FAILURE, "Failed to allocate ops");
+    }
 
-    op->sym->aead.digest.data = rte_pktmbuf_mtod_offset(mbufs[i], uint8_t *, data_size - AES_GCM_TAG_LENGTH);
-    op->sym->aead.aad.data = rte_pktmbuf_mtod_offset(mbufs[i], uint8_t *, 0);
+    // Allocate mbufs for this burst
+    if (rte_pktmbuf_alloc_bulk(mbuf_pool, mbufs[w], burst_size) < 0) {
+        rte_exit(EXIT_FAILURE, "Failed to allocate mbufs");
+    }
+    if (rte_pktmbuf_alloc_bulk(mbuf_pool, dst_mbufs[w], burst_size) < 0) {
+        rte_exit(EXIT_FAILURE, "Failed to allocate dst mbufs");
+    }
 
-    rte_crypto_op_attach_sym_session(op, enc_session);
-}
+    // Set lengths
+    for (unsigned int i = 0; i < burst_size; i++) {
+        rte_pktmbuf_reset(mbufs[w][i]);
+        rte_pktmbuf_append(mbufs[w][i], data_size);
+        rte_pktmbuf_reset(dst_mbufs[w][i]);
+        rte_pktmbuf_append(dst_mbufs[w][i], data_size);
+    }
 
-rte_cryptodev_enqueue_burst(cdev_id, 0, ops, burst_size);
-struct rte_crypto_op *tmp_ops[burst_size];
-unsigned int completed = 0;
-while (completed < burst_size) {
-    unsigned int n = rte_cryptodev_dequeue_burst(cdev_id, 0, &tmp_ops[completed], burst_size - completed);
-    completed += n;
-}
+    // First, encrypt the prepared buffers so we have valid ciphertext+tag for decryption
+    for (unsigned int i = 0; i < burst_size; i++) {
+        struct rte_crypto_op *op = ops[w][i];
+        op->sym->m_src = mbufs[w][i];
 
-// Now attach decrypt session for the benchmark run
-for (unsigned int i = 0; i < burst_size; i++) {
-    struct rte_crypto_op *op = ops[i];
-    op->sym->m_dst = dst_mbufs[i];
-    rte_crypto_op_attach_sym_session(op, dec_session);
-}
+        op->sym->aead.data.offset = 0;
+        op->sym->aead.data.length = data_size - AES_GCM_TAG_LENGTH; // plaintext length
+
+        op->sym->aead.digest.data = rte_pktmbuf_mtod_offset(mbufs[w][i], uint8_t *, data_size - AES_GCM_TAG_LENGTH);
+        op->sym->aead.aad.data = rte_pktmbuf_mtod_offset(mbufs[w][i], uint8_t *, 0);
 
+        rte_crypto_op_attach_sym_session(op, enc_session);
+    }
+
+    rte_cryptodev_enqueue_burst(cdev_id, w, ops[w], burst_size);
+    struct rte_crypto_op *tmp_ops[burst_size];
+    unsigned int completed = 0;
+    while (completed < burst_size) {
+        unsigned int n = rte_cryptodev_dequeue_burst(cdev_id, w, &tmp_ops[completed], burst_size - completed);
+        completed += n;
+    }
+
+    // Now attach decrypt session for the benchmark run
+    for (unsigned int i = 0; i < burst_size; i++) {
+        struct rte_crypto_op *op = ops[w][i];
+        op->sym->m_dst = dst_mbufs[w][i];
+        rte_crypto_op_attach_sym_session(op, dec_session);
+    }
+}
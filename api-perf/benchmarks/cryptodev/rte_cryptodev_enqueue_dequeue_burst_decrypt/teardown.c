@@ -1,20 +1,24 @@
 // Validate that all enqueued operations were dequeued
-if (in_flight_ops != 0) {
-    rte_exit(EXIT_FAILURE, "ERROR: %llu operations still in-flight at teardown. Enqueue/dequeue mismatch detected!", in_flight_ops);
+for (unsigned int w = 0; w < lcores; w++) {
+    if (in_flight_ops[w].ops != 0) {
+        rte_exit(EXIT_FAILURE, "ERROR: %llu operations still in-flight at teardown on queue pair %u. Enqueue/dequeue mismatch detected!", in_flight_ops[w].ops, w);
+    }
 }
 
 // Free allocated crypto operations
-for (unsigned int i = 0; i < burst_size; i++) {
-    if (ops[i] != NULL) {
-        rte_crypto_op_free(ops[i]);
-        ops[i] = NULL;
-    }
-    if (mbufs[i] != NULL) {
-        rte_pktmbuf_free(mbufs[i]);
-        mbufs[i] = NULL;
-    }
-    if (dst_mbufs[i] != NULL) {
-        rte_pktmbuf_free(dst_mbufs[i]);
-        dst_mbufs[i] = NULL;
+for (unsigned int w = 0; w < lcores; w++) {
+    for (unsigned int i = 0; i < burst_size; i++) {
+        if (ops[w][i] != NULL) {
+            rte_crypto_op_free(ops[w][i]);
+            ops[w][i] = NULL;
+        }
+        if (mbufs[w][i] != NULL) {
+            rte_pktmbuf_free(mbufs[w][i]);
+            mbufs[w][i] = NULL;
+        }
+        if (dst_mbufs[w][i] != NULL) {
+            rte_pktmbuf_free(dst_mbufs[w][i]);
+            dst_mbufs[w][i] = NULL;
+        }
     }
 }
@@ -1,11 +1,13 @@
-// Clean up any remaining in-flight packets
+// Clean up any remaining in-flight packets, on every worker's queue pair
 struct rte_crypto_op *cleanup_ops[256];
-while (in_flight_ops > 0) {
-    unsigned int dequeued = rte_cryptodev_dequeue_burst(cdev_id, 0, cleanup_ops, 256);
-    if (dequeued > 0) {
-        in_flight_ops -= dequeued;
-    } else {
-        // No more packets to dequeue
-        break;
+for (unsigned int w = 0; w < lcores; w++) {
+    while (in_flight_ops[w].ops > 0) {
+        unsigned int dequeued = rte_cryptodev_dequeue_burst(cdev_id, w, cleanup_ops, 256);
+        if (dequeued > 0) {
+            in_flight_ops[w].ops -= dequeued;
+        } else {
+            // No more packets to dequeue
+            break;
+        }
     }
 }
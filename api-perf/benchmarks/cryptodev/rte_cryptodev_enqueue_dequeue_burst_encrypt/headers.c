@@ -1,9 +1,14 @@
+// Worker w enqueues its own ops to and dequeues from queue pair w, so with
+// lcores > 1 the workers share the device but no queue pair
+#define BENCH_MULTI_LCORE 1
+
 static unsigned int burst_size;
-struct rte_crypto_op *ops[256];
+static unsigned int lcores;
+static struct rte_crypto_op *ops[BENCH_MAX_LCORES][256];
 
 // Mempool and mbufs used by this benchmark
 static struct rte_mempool *mbuf_pool;
-static struct rte_mbuf *mbufs[256];
+static struct rte_mbuf *mbufs[BENCH_MAX_LCORES][256];
 
 // Tunables for mbuf pool and mbuf payload sizes
 #define MBUF_POOL_SIZE 8192
@@ -13,6 +18,7 @@ static struct rte_mbuf *mbufs[256];
 // Per-op inputs
 static uint8_t ivs[256][MAX_AES_GCM_IV_LENGTH];
 
-// Global counter to track in-flight operations
-static volatile unsigned long long in_flight_ops = 0;
-
+// Per-worker counters to track in-flight operations
+static struct {
+    volatile unsigned long long ops;
+} __rte_cache_aligned in_flight_ops[BENCH_MAX_LCORES];
@@ -4,10 +4,10 @@
 #define AES_GCM_TAG_LENGTH 16
 
 // Create a sample key for the session
-uint8_t key[AES128_KEY_LENGTH] = {0};
+static uint8_t key[AES128_KEY_LENGTH] = {0};
 
 // Setup AEAD transform
-struct rte_crypto_sym_xform aead_xform = {
+static struct rte_crypto_sym_xform aead_xform = {
     .type = RTE_CRYPTO_SYM_XFORM_AEAD,
     .next = NULL,
     .aead = {
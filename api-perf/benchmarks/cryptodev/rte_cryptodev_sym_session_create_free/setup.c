@@ -1 +1 @@
-// No additional setup needed - session pool is created in setup_cryptodev()
\ No newline at end of file
+// No additional setup needed - session pool is created by setup_cryptodev() in env.c
\ No newline at end of file
@@ -1,2 +1,2 @@
 // No cleanup needed - sessions are created and freed in the benchmark loop
-// Session pool is cleaned up by template's teardown_cryptodev()
+// Session pool is cleaned up by teardown_cryptodev() in env.c
@@ -0,0 +1,16 @@
+#ifndef BENCHMARKS_DPDK_ENV_H
+#define BENCHMARKS_DPDK_ENV_H
+
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+
+#include "driver/bench_registry.h"
+
+// Ethernet port and mbufs shared by the dpdk benchmarks
+extern uint16_t port_id;
+extern struct rte_mempool *mbuf_pool;
+extern struct rte_mbuf **bufs;
+
+extern const struct bench_env bench_env_dpdk;
+
+#endif // BENCHMARKS_DPDK_ENV_H
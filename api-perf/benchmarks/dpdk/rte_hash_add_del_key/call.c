@@ -0,0 +1,4 @@
+// Each insert is undone so the occupancy stays at the configured level
+const struct bench_flow_key *key = &new_keys[i & (NEW_KEYS - 1)];
+failures += rte_hash_add_key_data(table, key, (void *)(uintptr_t)i) < 0;
+rte_hash_del_key(table, key);
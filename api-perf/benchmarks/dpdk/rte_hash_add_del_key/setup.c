@@ -0,0 +1,41 @@
+const char* entries_str = get_benchmark_param("entries");
+entries = entries_str ? (unsigned int)strtoul(entries_str, NULL, 10) : 65536;
+// Percentage of the table filled before the benchmark
+const char* occupancy_str = get_benchmark_param("occupancy");
+occupancy = occupancy_str ? (unsigned int)strtoul(occupancy_str, NULL, 10) : 50;
+if (entries == 0 || occupancy > 100) {
+    rte_exit(EXIT_FAILURE, "Invalid hash parameters: entries=%u occupancy=%u\n", entries, occupancy);
+}
+
+// Extendable buckets, as the NFs' rte_table_hash_ext maps, so any occupancy can be reached
+struct rte_hash_parameters hash_params = {
+    .name = "bench_hash",
+    .entries = entries + 1, // room for the key added on top of the occupancy
+    .key_len = sizeof(struct bench_flow_key),
+    .hash_func = rte_jhash,
+    .hash_func_init_val = 0,
+    .socket_id = rte_socket_id(),
+    .extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE,
+};
+table = rte_hash_create(&hash_params);
+if (table == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot create hash table: %s\n", rte_strerror(rte_errno));
+}
+
+stored_keys = (unsigned int)((uint64_t)entries * occupancy / 100);
+for (unsigned int k = 0; k < stored_keys; k++) {
+    struct bench_flow_key key = make_flow_key(k);
+    if (rte_hash_add_key_data(table, &key, (void *)(uintptr_t)k) < 0) {
+        rte_exit(EXIT_FAILURE, "Cannot fill hash table to %u%% (%u of %u keys)\n", occupancy, k, entries);
+    }
+}
+
+// Keys that are not in the table
+new_keys = malloc(NEW_KEYS * sizeof(*new_keys));
+if (new_keys == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate new keys\n");
+}
+for (unsigned int k = 0; k < NEW_KEYS; k++) {
+    new_keys[k] = make_flow_key(entries + k);
+}
+failures = 0;
@@ -0,0 +1,7 @@
+// Print metadata
+printf("metadata: {'entries': %u, 'occupancy': %u, 'stored_keys': %u, 'failures': %lu}\n", entries, occupancy, stored_keys, failures);
+
+rte_hash_free(table);
+table = NULL;
+free(new_keys);
+new_keys = NULL;
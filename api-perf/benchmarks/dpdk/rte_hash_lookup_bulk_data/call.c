@@ -0,0 +1,3 @@
+uint64_t hit_mask;
+rte_hash_lookup_bulk_data(table, &lookup_key_ptrs[(i * burst_size) & (LOOKUP_KEYS - 1)], burst_size, &hit_mask, lookup_data);
+hits += __builtin_popcountll(hit_mask);
@@ -0,0 +1,42 @@
+#include <stdlib.h>
+#include <rte_errno.h>
+#include <rte_hash.h>
+#include <rte_jhash.h>
+
+// Flow key as in the NFs' maps: IPv4 5-tuple padded to 16 bytes
+struct bench_flow_key {
+    uint32_t src_ip;
+    uint32_t dst_ip;
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint8_t proto;
+    uint8_t pad[3];
+};
+
+// Distinct keys for distinct indices (src_ip is a bijection of the index)
+static struct bench_flow_key make_flow_key(uint32_t index) {
+    struct bench_flow_key key = {
+        .src_ip = index * 2654435761u,
+        .dst_ip = ~index,
+        .src_port = (uint16_t)(index ^ (index >> 16)),
+        .dst_port = 80,
+        .proto = 6,
+    };
+    return key;
+}
+
+// Lookups cycle through this many precomputed keys
+#define LOOKUP_KEYS (1 << 16)
+
+static struct rte_hash *table;
+static struct bench_flow_key *lookup_keys;
+static unsigned int entries;
+static unsigned int occupancy;
+static unsigned int hit_pct;
+static unsigned int stored_keys;
+static unsigned int burst_size;
+static unsigned long hits;
+// Bulk lookups take arrays of key pointers; the tail repeats the head so a
+// burst starting near the end stays in bounds
+static const void *lookup_key_ptrs[LOOKUP_KEYS + RTE_HASH_LOOKUP_BULK_MAX];
+static void *lookup_data[RTE_HASH_LOOKUP_BULK_MAX];
@@ -0,0 +1,56 @@
+const char* burst_size_str = get_benchmark_param("burst_size");
+burst_size = burst_size_str ? (unsigned int)strtoul(burst_size_str, NULL, 10) : 32;
+if (burst_size == 0 || burst_size > RTE_HASH_LOOKUP_BULK_MAX) {
+    rte_exit(EXIT_FAILURE, "burst_size must be 1..%d\n", RTE_HASH_LOOKUP_BULK_MAX);
+}
+const char* entries_str = get_benchmark_param("entries");
+entries = entries_str ? (unsigned int)strtoul(entries_str, NULL, 10) : 65536;
+// Percentage of the table filled before the benchmark
+const char* occupancy_str = get_benchmark_param("occupancy");
+occupancy = occupancy_str ? (unsigned int)strtoul(occupancy_str, NULL, 10) : 50;
+// Percentage of lookups for keys that are in the table
+const char* hit_pct_str = get_benchmark_param("hit_pct");
+hit_pct = hit_pct_str ? (unsigned int)strtoul(hit_pct_str, NULL, 10) : 100;
+if (entries == 0 || occupancy > 100 || hit_pct > 100) {
+    rte_exit(EXIT_FAILURE, "Invalid hash parameters: entries=%u occupancy=%u hit_pct=%u\n", entries, occupancy, hit_pct);
+}
+
+// Extendable buckets, as the NFs' rte_table_hash_ext maps, so any occupancy can be reached
+struct rte_hash_parameters hash_params = {
+    .name = "bench_hash",
+    .entries = entries,
+    .key_len = sizeof(struct bench_flow_key),
+    .hash_func = rte_jhash,
+    .hash_func_init_val = 0,
+    .socket_id = rte_socket_id(),
+    .extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE,
+};
+table = rte_hash_create(&hash_params);
+if (table == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot create hash table: %s\n", rte_strerror(rte_errno));
+}
+
+stored_keys = (unsigned int)((uint64_t)entries * occupancy / 100);
+for (unsigned int k = 0; k < stored_keys; k++) {
+    struct bench_flow_key key = make_flow_key(k);
+    if (rte_hash_add_key_data(table, &key, (void *)(uintptr_t)k) < 0) {
+        rte_exit(EXIT_FAILURE, "Cannot fill hash table to %u%% (%u of %u keys)\n", occupancy, k, entries);
+    }
+}
+
+// Random mix of stored keys (hits) and keys past the table's capacity (misses)
+lookup_keys = malloc(LOOKUP_KEYS * sizeof(*lookup_keys));
+if (lookup_keys == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate lookup keys\n");
+}
+uint64_t rng = 88172645463325252ULL;
+for (unsigned int k = 0; k < LOOKUP_KEYS; k++) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    uint32_t r = (uint32_t)(rng >> 32);
+    uint32_t index = (stored_keys && r % 100 < hit_pct) ? r % stored_keys : entries + r % entries;
+    lookup_keys[k] = make_flow_key(index);
+}
+for (unsigned int k = 0; k < LOOKUP_KEYS + RTE_HASH_LOOKUP_BULK_MAX; k++) {
+    lookup_key_ptrs[k] = &lookup_keys[k & (LOOKUP_KEYS - 1)];
+}
+hits = 0;
@@ -0,0 +1,2 @@
+void *data;
+hits += rte_hash_lookup_data(table, &lookup_keys[i & (LOOKUP_KEYS - 1)], &data) >= 0;
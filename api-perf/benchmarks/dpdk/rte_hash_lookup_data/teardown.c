@@ -0,0 +1,7 @@
+// Print metadata
+printf("metadata: {'entries': %u, 'occupancy': %u, 'hit_pct': %u, 'stored_keys': %u, 'hits': %lu}\n", entries, occupancy, hit_pct, stored_keys, hits);
+
+rte_hash_free(table);
+table = NULL;
+free(lookup_keys);
+lookup_keys = NULL;
@@ -2,5 +2,5 @@
 #include <rte_udp.h>
 
 // Global variables for benchmark configuration
-unsigned int pkt_size;
+static unsigned int pkt_size;
 
@@ -0,0 +1,2 @@
+uint32_t next_hop;
+hits += rte_lpm_lookup(lpm, lookup_ips[i & (LOOKUP_IPS - 1)], &next_hop) == 0;
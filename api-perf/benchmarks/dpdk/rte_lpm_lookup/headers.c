@@ -0,0 +1,15 @@
+#include <stdlib.h>
+#include <rte_errno.h>
+#include <rte_lpm.h>
+
+// Lookups cycle through this many precomputed addresses
+#define LOOKUP_IPS (1 << 16)
+
+static struct rte_lpm *lpm;
+static uint32_t *rule_ips;
+static uint8_t *rule_depths;
+static uint32_t *lookup_ips;
+static unsigned int rules;
+static unsigned int long_prefix_pct;
+static unsigned int hit_pct;
+static unsigned long hits;
@@ -0,0 +1,11 @@
+// Print metadata
+printf("metadata: {'rules': %u, 'long_prefix_pct': %u, 'hit_pct': %u, 'hits': %lu}\n", rules, long_prefix_pct, hit_pct, hits);
+
+rte_lpm_free(lpm);
+lpm = NULL;
+free(rule_ips);
+rule_ips = NULL;
+free(rule_depths);
+rule_depths = NULL;
+free(lookup_ips);
+lookup_ips = NULL;
@@ -0,0 +1 @@
+rte_lpm_lookup_bulk(lpm, &lookup_ips[(i * burst_size) & (LOOKUP_IPS - 1)], next_hops, burst_size);
@@ -0,0 +1,18 @@
+#include <stdlib.h>
+#include <rte_errno.h>
+#include <rte_lpm.h>
+
+// Lookups cycle through this many precomputed addresses
+#define LOOKUP_IPS (1 << 16)
+#define LOOKUP_BURST_MAX 256
+
+static struct rte_lpm *lpm;
+static uint32_t *rule_ips;
+static uint8_t *rule_depths;
+// The tail repeats the head so a burst starting near the end stays in bounds
+static uint32_t *lookup_ips;
+static uint32_t next_hops[LOOKUP_BURST_MAX];
+static unsigned int burst_size;
+static unsigned int rules;
+static unsigned int long_prefix_pct;
+static unsigned int hit_pct;
@@ -0,0 +1,59 @@
+const char* burst_size_str = get_benchmark_param("burst_size");
+burst_size = burst_size_str ? (unsigned int)strtoul(burst_size_str, NULL, 10) : 32;
+if (burst_size == 0 || burst_size > LOOKUP_BURST_MAX) {
+    rte_exit(EXIT_FAILURE, "burst_size must be 1..%d\n", LOOKUP_BURST_MAX);
+}
+// Number of routes, as in the NFs' pfx2as tables
+const char* rules_str = get_benchmark_param("rules");
+rules = rules_str ? (unsigned int)strtoul(rules_str, NULL, 10) : 65536;
+// Percentage of /25-/32 routes, each of which needs a tbl8 group; the rest are /16-/24
+const char* long_prefix_pct_str = get_benchmark_param("long_prefix_pct");
+long_prefix_pct = long_prefix_pct_str ? (unsigned int)strtoul(long_prefix_pct_str, NULL, 10) : 0;
+// Percentage of lookups for addresses inside a route
+const char* hit_pct_str = get_benchmark_param("hit_pct");
+hit_pct = hit_pct_str ? (unsigned int)strtoul(hit_pct_str, NULL, 10) : 100;
+if (rules == 0 || long_prefix_pct > 100 || hit_pct > 100) {
+    rte_exit(EXIT_FAILURE, "Invalid LPM parameters: rules=%u long_prefix_pct=%u hit_pct=%u\n", rules, long_prefix_pct, hit_pct);
+}
+
+// Sized as lpm_dpdk.c: one tbl8 group per long prefix, at least 256
+unsigned int long_prefixes = (unsigned int)((uint64_t)rules * long_prefix_pct / 100);
+struct rte_lpm_config lpm_config = {
+    .max_rules = rules,
+    .number_tbl8s = long_prefixes > 256 ? long_prefixes : 256,
+    .flags = 0,
+};
+lpm = rte_lpm_create("bench_lpm", rte_socket_id(), &lpm_config);
+if (lpm == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot create LPM table: %s\n", rte_strerror(rte_errno));
+}
+
+rule_ips = malloc(rules * sizeof(*rule_ips));
+rule_depths = malloc(rules * sizeof(*rule_depths));
+lookup_ips = malloc((LOOKUP_IPS + LOOKUP_BURST_MAX) * sizeof(*lookup_ips));
+if (rule_ips == NULL || rule_depths == NULL || lookup_ips == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate LPM addresses\n");
+}
+
+uint64_t rng = 88172645463325252ULL;
+for (unsigned int k = 0; k < rules; k++) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    uint32_t r = (uint32_t)(rng >> 32);
+    uint8_t depth = (k < long_prefixes) ? 25 + r % 8 : 16 + r % 9;
+    rule_depths[k] = depth;
+    rule_ips[k] = (uint32_t)rng & ~(uint32_t)(0xFFFFFFFFULL >> depth);
+    if (rte_lpm_add(lpm, rule_ips[k], depth, k & 0xFFFFFF) < 0) {
+        rte_exit(EXIT_FAILURE, "Cannot add route %u to the LPM table\n", k);
+    }
+}
+
+// Hits are random hosts under a random route; misses are random addresses
+for (unsigned int k = 0; k < LOOKUP_IPS; k++) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    uint32_t r = (uint32_t)(rng >> 32);
+    unsigned int rule = r % rules;
+    lookup_ips[k] = (r % 100 < hit_pct) ? rule_ips[rule] | ((uint32_t)rng & (uint32_t)(0xFFFFFFFFULL >> rule_depths[rule])) : (uint32_t)rng;
+}
+for (unsigned int k = LOOKUP_IPS; k < LOOKUP_IPS + LOOKUP_BURST_MAX; k++) {
+    lookup_ips[k] = lookup_ips[k - LOOKUP_IPS];
+}
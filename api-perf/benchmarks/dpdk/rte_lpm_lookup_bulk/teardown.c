@@ -0,0 +1,11 @@
+// Print metadata
+printf("metadata: {'burst_size': %u, 'rules': %u, 'long_prefix_pct': %u, 'hit_pct': %u}\n", burst_size, rules, long_prefix_pct, hit_pct);
+
+rte_lpm_free(lpm);
+lpm = NULL;
+free(rule_ips);
+rule_ips = NULL;
+free(rule_depths);
+rule_depths = NULL;
+free(lookup_ips);
+lookup_ips = NULL;
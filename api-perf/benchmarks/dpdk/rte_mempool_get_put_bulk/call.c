@@ -0,0 +1,5 @@
+if (rte_mempool_get_bulk(bench_pool, pool_workers[worker].objs, bulk_size) == 0) {
+    rte_mempool_put_bulk(bench_pool, pool_workers[worker].objs, bulk_size);
+} else {
+    pool_workers[worker].failures++;
+}
@@ -0,0 +1,20 @@
+#include <stdlib.h>
+#include <rte_errno.h>
+#include <rte_mempool.h>
+
+#define MEMPOOL_BULK_MAX 256
+
+// Every worker gets and puts its own objects; with lcores > 1 they contend
+// on the pool's ring, or with a cache only when it runs empty or full
+#define BENCH_MULTI_LCORE 1
+
+static struct rte_mempool *bench_pool;
+static struct mempool_worker {
+    void *objs[MEMPOOL_BULK_MAX];
+    unsigned long failures;
+} __rte_cache_aligned pool_workers[BENCH_MAX_LCORES];
+static unsigned int bulk_size;
+static unsigned int cache_size;
+static unsigned int pool_size;
+static unsigned int elt_size;
+static unsigned int lcores;
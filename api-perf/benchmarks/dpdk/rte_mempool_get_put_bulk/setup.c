@@ -0,0 +1,22 @@
+const char* bulk_size_str = get_benchmark_param("bulk_size");
+bulk_size = bulk_size_str ? (unsigned int)strtoul(bulk_size_str, NULL, 10) : 32;
+// Per-lcore cache size; 0 takes every get/put to the shared ring
+const char* cache_size_str = get_benchmark_param("cache_size");
+cache_size = cache_size_str ? (unsigned int)strtoul(cache_size_str, NULL, 10) : 256;
+const char* pool_size_str = get_benchmark_param("pool_size");
+pool_size = pool_size_str ? (unsigned int)strtoul(pool_size_str, NULL, 10) : 8191;
+const char* elt_size_str = get_benchmark_param("elt_size");
+elt_size = elt_size_str ? (unsigned int)strtoul(elt_size_str, NULL, 10) : 2048;
+lcores = bench_lcores();
+if (bulk_size == 0 || bulk_size > MEMPOOL_BULK_MAX || bulk_size * lcores > pool_size || cache_size > RTE_MEMPOOL_CACHE_MAX_SIZE) {
+    rte_exit(EXIT_FAILURE, "Invalid mempool parameters: bulk_size=%u cache_size=%u pool_size=%u\n", bulk_size, cache_size, pool_size);
+}
+
+bench_pool = rte_mempool_create("bench_pool", pool_size, elt_size, cache_size, 0,
+                                NULL, NULL, NULL, NULL, rte_socket_id(), 0);
+if (bench_pool == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot create mempool: %s\n", rte_strerror(rte_errno));
+}
+for (unsigned int w = 0; w < lcores; w++) {
+    pool_workers[w].failures = 0;
+}
@@ -0,0 +1,10 @@
+unsigned long failures = 0;
+for (unsigned int w = 0; w < lcores; w++) {
+    failures += pool_workers[w].failures;
+}
+
+// Print metadata
+printf("metadata: {'bulk_size': %u, 'cache_size': %u, 'pool_size': %u, 'elt_size': %u, 'lcores': %u, 'failures': %lu}\n", bulk_size, cache_size, pool_size, elt_size, lcores, failures);
+
+rte_mempool_free(bench_pool);
+bench_pool = NULL;
@@ -0,0 +1,6 @@
+// The mbufs freed each iteration are allocated first, so a call is
+// rte_pktmbuf_alloc_bulk + rte_pktmbuf_free_bulk of burst_size mbufs
+if (rte_pktmbuf_alloc_bulk(mbuf_pool, free_bufs[worker], burst_size) != 0) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate mbufs in free_bulk benchmark\n");
+}
+rte_pktmbuf_free_bulk(free_bufs[worker], burst_size);
@@ -0,0 +1,12 @@
+#include <stdlib.h>
+#include <rte_mbuf.h>
+
+#define FREE_BURST_MAX 256
+
+// Workers allocate from and free to the shared mbuf pool through their
+// own lcore caches
+#define BENCH_MULTI_LCORE 1
+
+static struct rte_mbuf *free_bufs[BENCH_MAX_LCORES][FREE_BURST_MAX];
+static unsigned int burst_size;
+static unsigned int lcores;
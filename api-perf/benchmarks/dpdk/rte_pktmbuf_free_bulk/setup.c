@@ -0,0 +1,10 @@
+const char* burst_size_str = get_benchmark_param("burst_size");
+burst_size = burst_size_str ? (unsigned int)strtoul(burst_size_str, NULL, 10) : 32;
+if (burst_size == 0 || burst_size > FREE_BURST_MAX) {
+    rte_exit(EXIT_FAILURE, "burst_size must be 1..%d\n", FREE_BURST_MAX);
+}
+lcores = bench_lcores();
+// Each worker holds a burst and up to a full lcore cache of mbufs
+if (lcores * (burst_size + mbuf_pool->cache_size * 3 / 2) > mbuf_pool->size) {
+    rte_exit(EXIT_FAILURE, "MBUF_POOL is too small for lcores=%u burst_size=%u\n", lcores, burst_size);
+}
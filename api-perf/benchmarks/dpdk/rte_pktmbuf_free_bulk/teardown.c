@@ -0,0 +1,2 @@
+// Print metadata
+printf("metadata: {'burst_size': %u, 'lcores': %u}\n", burst_size, lcores);
@@ -1,5 +1,5 @@
 #include <rte_ip.h>
 
 // Global variables for benchmark configuration
-unsigned int pkt_size;
+static unsigned int pkt_size;
 
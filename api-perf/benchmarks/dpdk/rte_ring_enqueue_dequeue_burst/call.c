@@ -0,0 +1,3 @@
+// One producer and one consumer step per iteration, on the same lcore
+unsigned int n = rte_ring_enqueue_burst(ring, ring_workers[worker].objs, burst_size, NULL);
+ring_workers[worker].transferred += rte_ring_dequeue_burst(ring, ring_workers[worker].objs, n, NULL);
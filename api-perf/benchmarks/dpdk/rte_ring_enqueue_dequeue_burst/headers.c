@@ -0,0 +1,21 @@
+#include <stdlib.h>
+#include <string.h>
+#include <rte_errno.h>
+#include <rte_ring.h>
+
+#define RING_BURST_MAX 256
+
+// With lcores > 1 every worker is both a producer and a consumer of the
+// one ring, so only the multi-producer/consumer sync modes apply
+#define BENCH_MULTI_LCORE 1
+
+static struct rte_ring *ring;
+static struct ring_worker {
+    void *objs[RING_BURST_MAX];
+    unsigned long transferred;
+} __rte_cache_aligned ring_workers[BENCH_MAX_LCORES];
+static unsigned int burst_size;
+static unsigned int ring_size;
+static unsigned int occupancy;
+static unsigned int lcores;
+static const char *sync_mode;
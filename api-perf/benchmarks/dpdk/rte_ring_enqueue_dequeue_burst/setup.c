@@ -0,0 +1,56 @@
+const char* burst_size_str = get_benchmark_param("burst_size");
+burst_size = burst_size_str ? (unsigned int)strtoul(burst_size_str, NULL, 10) : 32;
+const char* ring_size_str = get_benchmark_param("ring_size");
+ring_size = ring_size_str ? (unsigned int)strtoul(ring_size_str, NULL, 10) : 1024;
+// Percentage of the ring filled before the benchmark
+const char* occupancy_str = get_benchmark_param("occupancy");
+occupancy = occupancy_str ? (unsigned int)strtoul(occupancy_str, NULL, 10) : 0;
+// Producer/consumer synchronization: sp_sc, mp_mc, mp_rts or mp_hts
+sync_mode = get_benchmark_param("sync");
+if (sync_mode == NULL) {
+    sync_mode = "sp_sc";
+}
+lcores = bench_lcores();
+if (burst_size == 0 || burst_size > RING_BURST_MAX || ring_size == 0 || occupancy > 100) {
+    rte_exit(EXIT_FAILURE, "Invalid ring parameters: burst_size=%u ring_size=%u occupancy=%u\n", burst_size, ring_size, occupancy);
+}
+if (lcores > 1 && strcmp(sync_mode, "sp_sc") == 0) {
+    rte_exit(EXIT_FAILURE, "sync=sp_sc needs lcores=1\n");
+}
+
+unsigned int ring_flags;
+if (strcmp(sync_mode, "sp_sc") == 0) {
+    ring_flags = RING_F_SP_ENQ | RING_F_SC_DEQ;
+} else if (strcmp(sync_mode, "mp_mc") == 0) {
+    ring_flags = 0;
+} else if (strcmp(sync_mode, "mp_rts") == 0) {
+    ring_flags = RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ;
+} else if (strcmp(sync_mode, "mp_hts") == 0) {
+    ring_flags = RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ;
+} else {
+    rte_exit(EXIT_FAILURE, "Unknown sync mode %s\n", sync_mode);
+}
+
+// RING_F_EXACT_SZ: ring_size usable slots, so occupancy is a fraction of the real capacity
+ring = rte_ring_create("bench_ring", ring_size, rte_socket_id(), ring_flags | RING_F_EXACT_SZ);
+if (ring == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot create ring: %s\n", rte_strerror(rte_errno));
+}
+
+// Dummy objects: the ring only moves pointers
+for (unsigned int w = 0; w < lcores; w++) {
+    for (unsigned int k = 0; k < RING_BURST_MAX; k++) {
+        ring_workers[w].objs[k] = (void *)(uintptr_t)(k + 1);
+    }
+    ring_workers[w].transferred = 0;
+}
+// Room is left for every worker's burst
+unsigned int prefill = (unsigned int)((uint64_t)ring_size * occupancy / 100);
+if (prefill + burst_size * lcores > ring_size) {
+    prefill = ring_size > burst_size * lcores ? ring_size - burst_size * lcores : 0;
+}
+for (unsigned int k = 0; k < prefill; k++) {
+    if (rte_ring_enqueue(ring, (void *)(uintptr_t)(k % RING_BURST_MAX + 1)) != 0) {
+        rte_exit(EXIT_FAILURE, "Cannot prefill ring\n");
+    }
+}
@@ -0,0 +1,10 @@
+unsigned long transferred = 0;
+for (unsigned int w = 0; w < lcores; w++) {
+    transferred += ring_workers[w].transferred;
+}
+
+// Print metadata
+printf("metadata: {'burst_size': %u, 'ring_size': %u, 'occupancy': %u, 'sync': '%s', 'lcores': %u, 'total_objects_transferred': %lu}\n", burst_size, ring_size, occupancy, sync_mode, lcores, transferred);
+
+rte_ring_free(ring);
+ring = NULL;
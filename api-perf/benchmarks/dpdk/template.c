@@ -5,100 +5,69 @@
 #include <rte_mbuf.h>
 
 #include "driver/benchmark_driver.h"
+#include "benchmarks/dpdk/env.h"
 
 // {{DPDK_HEADERS}}
 
-static uint16_t port_id = 0;
+// Snippets whose state is per worker define BENCH_MULTI_LCORE and may run
+// with lcores > 1
+#ifndef BENCH_MULTI_LCORE
+#define BENCH_MULTI_LCORE 0
+#endif
 
-struct rte_mempool *mbuf_pool;
-struct rte_mbuf **bufs;
-
-void setup_ethernet_device() {
-    if (rte_eth_dev_count_avail() == 0)
-        rte_exit(EXIT_FAILURE, "No available Ethernet devices\n");
-
-    // Create mbuf pool for Ethernet RX/TX
-    if (mbuf_pool == NULL) {
-        mbuf_pool = rte_pktmbuf_pool_create("MBUF_POOL", 8192, 256, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
-        if (mbuf_pool == NULL)
-            rte_exit(EXIT_FAILURE, "Cannot create mbuf pool\n");
-    }
-
-    // Allocate bufs with a default size. Benchmarks that need a different size can re-allocate it.
-    bufs = calloc(32, sizeof(struct rte_mbuf *));
-    if (bufs == NULL) {
-        rte_exit(EXIT_FAILURE, "Cannot allocate bufs array for default burst size 32\n");
-    }
-
-    struct rte_eth_conf port_conf = {
-        .rxmode = {
-            .mq_mode = RTE_ETH_MQ_RX_NONE,
-            .mtu = 1518,
-        },
-        .txmode = {
-            .mq_mode = RTE_ETH_MQ_TX_NONE,
-        },
-    };
-
-    int ret = rte_eth_dev_configure(port_id, 1, 1, &port_conf);
-    if (ret < 0) {
-        rte_exit(EXIT_FAILURE, "Cannot configure device: err=%d, port=%u\n", ret, port_id);
-    }
-
-    ret = rte_eth_rx_queue_setup(port_id, 0, 1024, rte_eth_dev_socket_id(port_id), NULL, mbuf_pool);
-    if (ret < 0) {
-        rte_exit(EXIT_FAILURE, "rte_eth_rx_queue_setup: err=%d, port=%u\n", ret, port_id);
-    }
-
-    ret = rte_eth_tx_queue_setup(port_id, 0, 1024, rte_eth_dev_socket_id(port_id), NULL);
-    if (ret < 0) {
-        rte_exit(EXIT_FAILURE, "rte_eth_tx_queue_setup: err=%d, port=%u\n", ret, port_id);
-    }
-
-    ret = rte_eth_dev_start(port_id);
-    if (ret < 0) {
-        rte_exit(EXIT_FAILURE, "rte_eth_dev_start: err=%d, port=%u\n", ret, port_id);
-    }
-}
-
-void setup_benchmark() {
+static void setup_benchmark(void) {
     // {{BENCHMARK_SETUP}}
 }
 
-void run_benchmark() {
+static int benchmark_loop(void *arg __rte_unused) {
     uint64_t start, end;
 
+    const unsigned int worker __rte_unused = bench_worker_start();
     start = rte_rdtsc();
-    for (unsigned long long i = 0; i < g_iterations; ++i) {
-        // {{BENCHMARK_LOOP}}
+    if (g_latency_batch) {
+        // Same loop, timed every g_latency_batch iterations
+        for (unsigned long long i = 0; i < g_iterations;) {
+            unsigned long long batch_end = RTE_MIN(i + g_latency_batch, g_iterations);
+            unsigned long long batch_calls = batch_end - i;
+            uint64_t batch_start = bench_batch_tsc();
+            for (; i < batch_end; ++i) {
+                // {{BENCHMARK_LOOP}}
+            }
+            bench_record_batch(bench_batch_tsc() - batch_start, batch_calls);
+        }
+    } else {
+        for (unsigned long long i = 0; i < g_iterations; ++i) {
+            // {{BENCHMARK_LOOP}}
+        }
     }
     end = rte_rdtsc();
 
     uint64_t total_cycles = end - start;
-    printf("Total cycles: %lu\n", (unsigned long)total_cycles);
+    bench_worker_stop(total_cycles);
+    return 0;
 }
 
-void teardown_benchmark() {
-    // {{BENCHMARK_TEARDOWN}}
+static void run_benchmark(void) {
+    bench_begin();
+    bench_launch(benchmark_loop, BENCH_MULTI_LCORE);
+    bench_end();
 }
 
-void teardown_ethernet_device() {
-    if (bufs) {
-        free(bufs);
-        bufs = NULL;
-    }
-
-    rte_eth_dev_stop(port_id);
-    rte_eth_dev_close(port_id);
+static void teardown_benchmark(void) {
+    // {{BENCHMARK_TEARDOWN}}
 }
 
+// {{BENCHMARK_ENTRY}}
+
+#ifndef BENCH_IN_PROCESS
 int main(int argc, char **argv) {
     init_dpdk(argc, argv);
-    setup_ethernet_device();
+    bench_env_dpdk.setup();
     setup_benchmark();
     run_benchmark();
     teardown_benchmark();
-    teardown_ethernet_device();
+    bench_env_dpdk.teardown();
     cleanup_dpdk();
     return 0;
 }
+#endif
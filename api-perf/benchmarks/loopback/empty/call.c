@@ -0,0 +1 @@
+// No-op
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rte_eal.h>
+#include <rte_ethdev.h>
+#include <rte_eth_ring.h>
+#include <rte_bus_vdev.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+
+#include "benchmarks/loopback/env.h"
+
+#define LOOPBACK_RING_SIZE 1024
+#define LOOPBACK_POOL_SIZE 8191
+#define LOOPBACK_GEN_BURST 32
+
+uint16_t loopback_tx_port;
+uint16_t loopback_rx_port;
+struct rte_mempool *loopback_pool;
+unsigned long loopback_peer_packets;
+
+// ring_ab carries a -> b (the benchmarked direction), ring_ba b -> a
+static struct rte_ring *ring_ab;
+static struct rte_ring *ring_ba;
+static const char *const port_names[2] = { "net_loopback_a", "net_loopback_b" };
+
+static unsigned int peer_lcore = RTE_MAX_LCORE;
+static volatile int peer_stop;
+static unsigned int peer_pkt_size;
+
+static void write_packet(char *data, unsigned int pkt_size) {
+    // Ethernet header (14 bytes)
+    static const uint8_t eth[14] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, // dst MAC
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x56, // src MAC
+        0x08, 0x00,                         // EtherType (IPv4)
+    };
+    memcpy(data, eth, sizeof(eth));
+
+    // IP header (20 bytes)
+    unsigned int ip_len = pkt_size - 14;
+    data[14] = 0x45; // Version 4, header length 5
+    data[15] = 0x00; // Type of Service
+    data[16] = (ip_len >> 8) & 0xFF; data[17] = ip_len & 0xFF; // Total length
+    data[18] = 0x00; data[19] = 0x00; // Identification
+    data[20] = 0x40; data[21] = 0x00; // Flags, Fragment offset
+    data[22] = 0x40; // Time to live
+    data[23] = 0x11; // Protocol (UDP)
+    data[24] = 0x00; data[25] = 0x00; // Checksum
+    data[26] = 0x0a; data[27] = 0x00; data[28] = 0x00; data[29] = 0x01; // Source IP
+    data[30] = 0x0a; data[31] = 0x00; data[32] = 0x00; data[33] = 0x02; // Destination IP
+
+    // UDP header (8 bytes)
+    unsigned int udp_len = pkt_size - 34;
+    data[34] = 0x00; data[35] = 0x35; // Source port (53)
+    data[36] = 0x00; data[37] = 0x35; // Destination port (53)
+    data[38] = (udp_len >> 8) & 0xFF; data[39] = udp_len & 0xFF; // Length
+    data[40] = 0x00; data[41] = 0x00; // Checksum
+
+    // Payload
+    for (unsigned int i = 42; i < pkt_size; i++) {
+        data[i] = (char)(i % 256);
+    }
+}
+
+void loopback_fill_pool(unsigned int pkt_size) {
+    if (pkt_size < 64 || pkt_size > RTE_MBUF_DEFAULT_DATAROOM) {
+        rte_exit(EXIT_FAILURE, "pkt_size must be 64..%u\n", RTE_MBUF_DEFAULT_DATAROOM);
+    }
+
+    // Every mbuf once, so that whichever one the benchmark gets holds the packet
+    struct rte_mbuf **all = calloc(LOOPBACK_POOL_SIZE, sizeof(*all));
+    if (all == NULL) {
+        rte_exit(EXIT_FAILURE, "Cannot allocate mbuf array\n");
+    }
+    unsigned int n = 0;
+    while (n < LOOPBACK_POOL_SIZE && (all[n] = rte_pktmbuf_alloc(loopback_pool)) != NULL) {
+        write_packet(rte_pktmbuf_mtod(all[n], char *), pkt_size);
+        n++;
+    }
+    for (unsigned int i = 0; i < n; i++) {
+        rte_pktmbuf_free(all[i]);
+    }
+    free(all);
+}
+
+static void drain_port(uint16_t port) {
+    struct rte_mbuf *pkts[LOOPBACK_GEN_BURST];
+    uint16_t n;
+    while ((n = rte_eth_rx_burst(port, 0, pkts, LOOPBACK_GEN_BURST)) > 0) {
+        rte_pktmbuf_free_bulk(pkts, n);
+    }
+}
+
+static int generator_main(void *arg) {
+    struct rte_mbuf *pkts[LOOPBACK_GEN_BURST];
+    unsigned long generated = 0;
+    (void)arg;
+
+    while (!peer_stop) {
+        if (rte_pktmbuf_alloc_bulk(loopback_pool, pkts, LOOPBACK_GEN_BURST) != 0) {
+            // Everything is in flight; wait for the benchmark to free some
+            rte_pause();
+            continue;
+        }
+        for (unsigned int i = 0; i < LOOPBACK_GEN_BURST; i++) {
+            loopback_set_len(pkts[i], peer_pkt_size);
+        }
+        uint16_t sent = rte_eth_tx_burst(loopback_tx_port, 0, pkts, LOOPBACK_GEN_BURST);
+        if (sent < LOOPBACK_GEN_BURST) {
+            rte_pktmbuf_free_bulk(&pkts[sent], LOOPBACK_GEN_BURST - sent);
+        }
+        generated += sent;
+    }
+    loopback_peer_packets = generated;
+    return 0;
+}
+
+static int drain_main(void *arg) {
+    struct rte_mbuf *pkts[LOOPBACK_BURST_MAX];
+    unsigned long drained = 0;
+    (void)arg;
+
+    while (!peer_stop) {
+        uint16_t n = rte_eth_rx_burst(loopback_rx_port, 0, pkts, LOOPBACK_BURST_MAX);
+        if (n > 0) {
+            rte_pktmbuf_free_bulk(pkts, n);
+            drained += n;
+        }
+    }
+    loopback_peer_packets = drained;
+    return 0;
+}
+
+static void start_peer(lcore_function_t *fn) {
+    if (peer_lcore == RTE_MAX_LCORE) {
+        rte_exit(EXIT_FAILURE, "loopback benchmarks need a second lcore for the traffic peer "
+                 "(EAL -l <main>,<peer> or run_benchmarks.py --worker-cores)\n");
+    }
+    peer_stop = 0;
+    loopback_peer_packets = 0;
+    if (rte_eal_remote_launch(fn, NULL, peer_lcore) != 0) {
+        rte_exit(EXIT_FAILURE, "Cannot launch traffic peer on lcore %u\n", peer_lcore);
+    }
+}
+
+void loopback_start_generator(unsigned int pkt_size) {
+    peer_pkt_size = pkt_size;
+    start_peer(generator_main);
+}
+
+void loopback_start_drain(void) {
+    start_peer(drain_main);
+}
+
+void loopback_stop_peer(void) {
+    peer_stop = 1;
+    rte_eal_wait_lcore(peer_lcore);
+    // Whatever is still queued goes back to the pool
+    drain_port(loopback_rx_port);
+    drain_port(loopback_tx_port);
+}
+
+static void setup_port(uint16_t port) {
+    struct rte_eth_conf port_conf = {
+        .rxmode = {
+            .mq_mode = RTE_ETH_MQ_RX_NONE,
+        },
+        .txmode = {
+            .mq_mode = RTE_ETH_MQ_TX_NONE,
+        },
+    };
+
+    int ret = rte_eth_dev_configure(port, 1, 1, &port_conf);
+    if (ret < 0) {
+        rte_exit(EXIT_FAILURE, "Cannot configure device: err=%d, port=%u\n", ret, port);
+    }
+    ret = rte_eth_rx_queue_setup(port, 0, LOOPBACK_RING_SIZE, rte_socket_id(), NULL, loopback_pool);
+    if (ret < 0) {
+        rte_exit(EXIT_FAILURE, "rte_eth_rx_queue_setup: err=%d, port=%u\n", ret, port);
+    }
+    ret = rte_eth_tx_queue_setup(port, 0, LOOPBACK_RING_SIZE, rte_socket_id(), NULL);
+    if (ret < 0) {
+        rte_exit(EXIT_FAILURE, "rte_eth_tx_queue_setup: err=%d, port=%u\n", ret, port);
+    }
+    ret = rte_eth_dev_start(port);
+    if (ret < 0) {
+        rte_exit(EXIT_FAILURE, "rte_eth_dev_start: err=%d, port=%u\n", ret, port);
+    }
+}
+
+static void setup_loopback(void) {
+    // The last worker lcore runs the traffic peer, away from the benchmark's
+    unsigned int lcore_id;
+    peer_lcore = RTE_MAX_LCORE;
+    RTE_LCORE_FOREACH_WORKER(lcore_id) {
+        peer_lcore = lcore_id;
+    }
+
+    loopback_pool = rte_pktmbuf_pool_create("LOOPBACK_POOL", LOOPBACK_POOL_SIZE, 256, 0,
+                                            RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+    if (loopback_pool == NULL) {
+        rte_exit(EXIT_FAILURE, "Cannot create loopback mbuf pool\n");
+    }
+
+    // Single producer and consumer per ring: one lcore transmits, one receives
+    ring_ab = rte_ring_create("loopback_ab", LOOPBACK_RING_SIZE, rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+    ring_ba = rte_ring_create("loopback_ba", LOOPBACK_RING_SIZE, rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+    if (ring_ab == NULL || ring_ba == NULL) {
+        rte_exit(EXIT_FAILURE, "Cannot create loopback rings\n");
+    }
+
+    int port_a = rte_eth_from_rings(port_names[0], &ring_ba, 1, &ring_ab, 1, rte_socket_id());
+    int port_b = rte_eth_from_rings(port_names[1], &ring_ab, 1, &ring_ba, 1, rte_socket_id());
+    if (port_a < 0 || port_b < 0) {
+        rte_exit(EXIT_FAILURE, "Cannot create net_ring loopback ports\n");
+    }
+    loopback_tx_port = (uint16_t)port_a;
+    loopback_rx_port = (uint16_t)port_b;
+
+    setup_port(loopback_tx_port);
+    setup_port(loopback_rx_port);
+}
+
+static void teardown_loopback(void) {
+    uint16_t ports[2] = { loopback_tx_port, loopback_rx_port };
+    for (int i = 0; i < 2; i++) {
+        rte_eth_dev_stop(ports[i]);
+        rte_eth_dev_close(ports[i]);
+        rte_vdev_uninit(port_names[i]);
+    }
+
+    rte_ring_free(ring_ab);
+    rte_ring_free(ring_ba);
+    ring_ab = NULL;
+    ring_ba = NULL;
+
+    rte_mempool_free(loopback_pool);
+    loopback_pool = NULL;
+}
+
+const struct bench_env bench_env_loopback = {
+    .name = "loopback",
+    .setup = setup_loopback,
+    .teardown = teardown_loopback,
+};
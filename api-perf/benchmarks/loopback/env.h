@@ -0,0 +1,39 @@
+#ifndef BENCHMARKS_LOOPBACK_ENV_H
+#define BENCHMARKS_LOOPBACK_ENV_H
+
+#include <rte_ethdev.h>
+#include <rte_launch.h>
+#include <rte_mbuf.h>
+
+#include "driver/bench_registry.h"
+
+// Two net_ring ports wired back to back: what loopback_tx_port transmits,
+// loopback_rx_port receives (and the other way round). No NIC or hugepages
+// needed, so the rx/tx benchmarks run anywhere EAL does.
+extern uint16_t loopback_tx_port;
+extern uint16_t loopback_rx_port;
+extern struct rte_mempool *loopback_pool;
+
+#define LOOPBACK_BURST_MAX 256
+
+// Writes an Ethernet/IPv4/UDP packet of pkt_size bytes into every mbuf of
+// loopback_pool; mbufs allocated afterwards only need their lengths set
+void loopback_fill_pool(unsigned int pkt_size);
+static inline void loopback_set_len(struct rte_mbuf *m, unsigned int pkt_size) {
+    m->data_len = (uint16_t)pkt_size;
+    m->pkt_len = pkt_size;
+}
+
+// The other side of a benchmark, on a worker lcore of its own until
+// loopback_stop_peer(): the generator keeps loopback_rx_port's queue full,
+// the drain empties it as fast as the benchmark transmits
+void loopback_start_generator(unsigned int pkt_size);
+void loopback_start_drain(void);
+void loopback_stop_peer(void);
+
+// Packets the peer generated or drained since it was started
+extern unsigned long loopback_peer_packets;
+
+extern const struct bench_env bench_env_loopback;
+
+#endif // BENCHMARKS_LOOPBACK_ENV_H
@@ -0,0 +1,5 @@
+uint16_t rx_count = rte_eth_rx_burst(loopback_rx_port, 0, rx_bufs, burst_size);
+result += rx_count;
+empty_polls += (rx_count == 0);
+// Free received packets back to the pool for the generator
+rte_pktmbuf_free_bulk(rx_bufs, rx_count);
\ No newline at end of file
@@ -0,0 +1,6 @@
+#include <stdlib.h>
+static unsigned int burst_size;
+static unsigned int pkt_size;
+static struct rte_mbuf *rx_bufs[LOOPBACK_BURST_MAX];
+static unsigned long result = 0;
+static unsigned long empty_polls = 0;
@@ -0,0 +1,5 @@
+loopback_stop_peer();
+
+// Print metadata
+printf("metadata: {'burst_size': %u, 'pkt_size': %u, 'total_packets_received': %lu, 'empty_polls': %lu, 'generated': %lu}\n",
+       burst_size, pkt_size, result, empty_polls, loopback_peer_packets);
\ No newline at end of file
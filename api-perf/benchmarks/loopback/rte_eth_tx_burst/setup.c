@@ -0,0 +1,14 @@
+const char* burst_size_str = get_benchmark_param("burst_size");
+burst_size = burst_size_str ? (unsigned int)strtoul(burst_size_str, NULL, 10) : 32;
+if (burst_size == 0 || burst_size > LOOPBACK_BURST_MAX) {
+    rte_exit(EXIT_FAILURE, "burst_size must be 1..%u\n", LOOPBACK_BURST_MAX);
+}
+const char* pkt_size_str = get_benchmark_param("pkt_size");
+pkt_size = pkt_size_str ? (unsigned int)strtoul(pkt_size_str, NULL, 10) : 64;
+
+// The peer lcore receives and frees whatever the loop transmits
+loopback_fill_pool(pkt_size);
+loopback_start_drain();
+
+result = 0;
+tx_full = 0;
\ No newline at end of file
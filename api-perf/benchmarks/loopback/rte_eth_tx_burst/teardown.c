@@ -0,0 +1,5 @@
+loopback_stop_peer();
+
+// Print metadata
+printf("metadata: {'burst_size': %u, 'pkt_size': %u, 'total_packets_sent': %lu, 'tx_full': %lu, 'drained': %lu}\n",
+       burst_size, pkt_size, result, tx_full, loopback_peer_packets);
\ No newline at end of file
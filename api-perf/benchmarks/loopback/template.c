@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <rte_eal.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+
+#include "driver/benchmark_driver.h"
+#include "benchmarks/loopback/env.h"
+
+// {{DPDK_HEADERS}}
+
+// Snippets whose state is per worker define BENCH_MULTI_LCORE and may run
+// with lcores > 1
+#ifndef BENCH_MULTI_LCORE
+#define BENCH_MULTI_LCORE 0
+#endif
+
+static void setup_benchmark(void) {
+    // {{BENCHMARK_SETUP}}
+}
+
+static int benchmark_loop(void *arg __rte_unused) {
+    uint64_t start, end;
+
+    const unsigned int worker __rte_unused = bench_worker_start();
+    start = rte_rdtsc();
+    if (g_latency_batch) {
+        // Same loop, timed every g_latency_batch iterations
+        for (unsigned long long i = 0; i < g_iterations;) {
+            unsigned long long batch_end = RTE_MIN(i + g_latency_batch, g_iterations);
+            unsigned long long batch_calls = batch_end - i;
+            uint64_t batch_start = bench_batch_tsc();
+            for (; i < batch_end; ++i) {
+                // {{BENCHMARK_LOOP}}
+            }
+            bench_record_batch(bench_batch_tsc() - batch_start, batch_calls);
+        }
+    } else {
+        for (unsigned long long i = 0; i < g_iterations; ++i) {
+            // {{BENCHMARK_LOOP}}
+        }
+    }
+    end = rte_rdtsc();
+
+    uint64_t total_cycles = end - start;
+    bench_worker_stop(total_cycles);
+    return 0;
+}
+
+static void run_benchmark(void) {
+    bench_begin();
+    bench_launch(benchmark_loop, BENCH_MULTI_LCORE);
+    bench_end();
+}
+
+static void teardown_benchmark(void) {
+    // {{BENCHMARK_TEARDOWN}}
+}
+
+// {{BENCHMARK_ENTRY}}
+
+#ifndef BENCH_IN_PROCESS
+int main(int argc, char **argv) {
+    init_dpdk(argc, argv);
+    bench_env_loopback.setup();
+    setup_benchmark();
+    run_benchmark();
+    teardown_benchmark();
+    bench_env_loopback.teardown();
+    cleanup_dpdk();
+    return 0;
+}
+#endif
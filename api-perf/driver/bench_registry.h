@@ -0,0 +1,33 @@
+#ifndef BENCH_REGISTRY_H
+#define BENCH_REGISTRY_H
+
+// Benchmarks as seen by the in-process runner (driver/bench_runner.c). Every
+// generated benchmark defines one bench_entry with BENCH_ENTRY; the entries
+// of a build are listed in the generated bench_registry.c.
+
+// Devices and pools shared by all benchmarks of a type, set up once per run
+struct bench_env {
+    const char *name;
+    void (*setup)(void);
+    // Called before every benchmark's setup to undo changes a previous
+    // benchmark made to the shared state; may be NULL
+    void (*prepare)(void);
+    void (*teardown)(void);
+};
+
+struct bench_entry {
+    const char *type;
+    const char *function;
+    const struct bench_env *env;
+    void (*setup)(void);
+    void (*run)(void);
+    void (*teardown)(void);
+};
+
+#define BENCH_ENTRY(sym, type, function, env) \
+    const struct bench_entry sym = { type, function, &env, setup_benchmark, run_benchmark, teardown_benchmark }
+
+// NULL-terminated
+extern const struct bench_entry *const bench_registry[];
+
+#endif // BENCH_REGISTRY_H
@@ -0,0 +1,158 @@
+// In-process runner: every generated benchmark is linked into this binary
+// (see bench_registry.h), EAL and the devices are initialized once, and a
+// plan of cases runs back to back with warmup and repetitions.
+//
+// Usage: api_perf <EAL args> -- [-i N] [-l N] [-p] [-w N] [-r N] [-f plan] [-L]
+//   -w N     warmup run of N iterations before each case (default 10000, 0 = off)
+//   -r N     measured runs per case (default 1)
+//   -f plan  read cases from this file instead of stdin
+//   -L       list the linked benchmarks and exit
+//
+// Each plan line is "<type> <function> [key=value ...]"; blank lines and
+// lines starting with '#' are skipped. Every measured run prints
+// "case: <type> <function> rep=<n> [key=value ...]" followed by the output
+// of the standalone executable (Total cycles, json, metadata); warmup runs
+// print under a "warmup:" line instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark_driver.h"
+#include "bench_registry.h"
+
+#define MAX_LINE 1024
+
+static unsigned long long g_warmup_iterations = 10000ULL;
+static unsigned int g_repetitions = 1;
+static const char *g_plan_path;
+static int g_list;
+
+static void parse_runner_args(int argc, char **argv) {
+    int i = 1;
+    while (i < argc && strcmp(argv[i], "--") != 0) {
+        i++;
+    }
+    for (i++; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            g_warmup_iterations = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            g_repetitions = (unsigned int)strtoul(argv[++i], NULL, 10);
+            if (g_repetitions == 0) {
+                g_repetitions = 1;
+            }
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            g_plan_path = argv[++i];
+        } else if (strcmp(argv[i], "-L") == 0) {
+            g_list = 1;
+        }
+    }
+}
+
+static const struct bench_entry *find_entry(const char *type, const char *function) {
+    for (const struct bench_entry *const *entry = bench_registry; *entry; entry++) {
+        if (strcmp((*entry)->type, type) == 0 && strcmp((*entry)->function, function) == 0) {
+            return *entry;
+        }
+    }
+    return NULL;
+}
+
+static void run_once(const struct bench_entry *entry) {
+    if (entry->env->prepare) {
+        entry->env->prepare();
+    }
+    entry->setup();
+    entry->run();
+    entry->teardown();
+}
+
+static void run_case(const struct bench_entry *entry, const char *params) {
+    unsigned long long iterations = g_iterations;
+
+    if (g_warmup_iterations) {
+        printf("warmup: %s %s%s\n", entry->type, entry->function, params);
+        g_iterations = g_warmup_iterations;
+        run_once(entry);
+        g_iterations = iterations;
+    }
+    for (unsigned int rep = 0; rep < g_repetitions; rep++) {
+        printf("case: %s %s rep=%u%s\n", entry->type, entry->function, rep, params);
+        run_once(entry);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    parse_runner_args(argc, argv);
+
+    if (g_list) {
+        for (const struct bench_entry *const *entry = bench_registry; *entry; entry++) {
+            printf("%s %s\n", (*entry)->type, (*entry)->function);
+        }
+        return 0;
+    }
+
+    init_dpdk(argc, argv);
+
+    FILE *plan = stdin;
+    if (g_plan_path) {
+        plan = fopen(g_plan_path, "r");
+        if (plan == NULL) {
+            rte_exit(EXIT_FAILURE, "Cannot open plan %s\n", g_plan_path);
+        }
+    }
+
+    const struct bench_env *env = NULL;
+    char line[MAX_LINE];
+    unsigned int lineno = 0;
+    while (fgets(line, sizeof(line), plan)) {
+        lineno++;
+        char *save = NULL;
+        char *type = strtok_r(line, " \t\r\n", &save);
+        if (type == NULL || type[0] == '#') {
+            continue;
+        }
+        char *function = strtok_r(NULL, " \t\r\n", &save);
+        if (function == NULL) {
+            rte_exit(EXIT_FAILURE, "Plan line %u: missing function\n", lineno);
+        }
+        const struct bench_entry *entry = find_entry(type, function);
+        if (entry == NULL) {
+            rte_exit(EXIT_FAILURE, "Plan line %u: no benchmark %s/%s in this build\n", lineno, type, function);
+        }
+
+        // key=value pairs become the case's benchmark parameters
+        char params[MAX_LINE] = "";
+        size_t params_len = 0;
+        reset_benchmark_params();
+        for (char *param = strtok_r(NULL, " \t\r\n", &save); param; param = strtok_r(NULL, " \t\r\n", &save)) {
+            char *eq = strchr(param, '=');
+            if (eq == NULL || eq == param) {
+                rte_exit(EXIT_FAILURE, "Plan line %u: expected key=value, got %s\n", lineno, param);
+            }
+            params_len += snprintf(params + params_len, sizeof(params) - params_len, " %s", param);
+            *eq = '\0';
+            set_benchmark_param(param, eq + 1);
+        }
+
+        // Devices stay up while consecutive cases share them
+        if (entry->env != env) {
+            if (env) {
+                env->teardown();
+            }
+            env = entry->env;
+            env->setup();
+        }
+        run_case(entry, params);
+    }
+
+    if (env) {
+        env->teardown();
+    }
+    if (plan != stdin) {
+        fclose(plan);
+    }
+    cleanup_dpdk();
+    return 0;
+}
@@ -3,6 +3,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <rte_pause.h>
 
 #define MAX_PARAMS 16
 
@@ -11,9 +16,11 @@ static struct benchmark_param {
     char value[128];
 } g_params[MAX_PARAMS];
 static int g_param_count = 0;
+static int g_cli_param_count = 0; // parameters given on the command line
 
 const char *get_benchmark_param(const char *key) {
-    for (int i = 0; i < g_param_count; i++) {
+    // Latest first, so that a case's parameters override the command line
+    for (int i = g_param_count - 1; i >= 0; i--) {
         if (strcmp(g_params[i].key, key) == 0) {
             return g_params[i].value;
         }
@@ -21,8 +28,29 @@ const char *get_benchmark_param(const char *key) {
     return NULL;
 }
 
+static void add_param(const char *key, const char *value) {
+    if (g_param_count < MAX_PARAMS) {
+        strncpy(g_params[g_param_count].key, key, sizeof(g_params[g_param_count].key) - 1);
+        strncpy(g_params[g_param_count].value, value, sizeof(g_params[g_param_count].value) - 1);
+        g_param_count++;
+    } else {
+        rte_exit(EXIT_FAILURE, "Too many benchmark parameters (max %d)\n", MAX_PARAMS);
+    }
+}
+
+void set_benchmark_param(const char *key, const char *value) {
+    add_param(key, value);
+}
+
+void reset_benchmark_params(void) {
+    memset(&g_params[g_cli_param_count], 0, (g_param_count - g_cli_param_count) * sizeof(g_params[0]));
+    g_param_count = g_cli_param_count;
+}
+
 // Defaults, override via command line args
 unsigned long long g_iterations = 1000000ULL;
+unsigned long long g_latency_batch = 0;
+int g_perf_counters = 0;
 
 static void parse_command_line_args(int argc, char **argv) {
     int separator_index = -1;
@@ -39,11 +67,7 @@ static void parse_command_line_args(int argc, char **argv) {
         if (strncmp(argv[i], "--", 2) == 0 && i + 1 < argc) {
             const char *key = argv[i] + 2;
             const char *value = argv[i + 1];
-            if (g_param_count < MAX_PARAMS) {
-                strncpy(g_params[g_param_count].key, key, sizeof(g_params[g_param_count].key) - 1);
-                strncpy(g_params[g_param_count].value, value, sizeof(g_params[g_param_count].value) - 1);
-                g_param_count++;
-            }
+            add_param(key, value);
             i++; // Skip value
         } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
             g_iterations = strtoull(argv[i + 1], NULL, 10);
@@ -51,8 +75,14 @@ static void parse_command_line_args(int argc, char **argv) {
                 g_iterations = 1000000ULL; // fallback to default
             }
             i++; // skip the value
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            g_latency_batch = strtoull(argv[i + 1], NULL, 10);
+            i++; // skip the value
+        } else if (strcmp(argv[i], "-p") == 0) {
+            g_perf_counters = 1;
         }
     }
+    g_cli_param_count = g_param_count;
     
     // EAL args: everything before '--' (or all args if no '--')
     int dpdk_argc = (separator_index >= 0) ? separator_index : argc;
@@ -67,7 +97,427 @@ void init_dpdk(int argc, char **argv) {
     parse_command_line_args(argc, argv);
 }
 
+
+
+
+// Per-call latency histogram, in cycles. One bucket per cycle; slower calls
+// only count towards the overflow bucket and the maximum.
+#define LATENCY_BUCKETS 65536
+
+struct latency_hist {
+    uint64_t *buckets;
+    uint64_t samples;
+    uint64_t overflow;
+    uint64_t max;
+    double sum;
+};
+
+// Hardware counters, each opened on its own so that one the CPU (or VM)
+// lacks does not disable the others
+enum {
+    COUNTER_INSTRUCTIONS,
+    COUNTER_L1D_MISSES,
+    COUNTER_LLC_MISSES,
+    COUNTER_BRANCH_MISSES,
+    NUM_COUNTERS
+};
+
+static const char *counter_names[NUM_COUNTERS] = {
+    "instructions", "l1d_misses", "llc_misses", "branch_misses"
+};
+
+// Measurement state of one lcore running the loop; worker 0 is the main
+// lcore. Counters count the calling thread, so every worker opens its own.
+struct bench_worker {
+    unsigned int index;
+    unsigned int lcore_id;
+    struct latency_hist hist;
+    int counters_opened;
+    int counter_fds[NUM_COUNTERS];
+    uint64_t counters[NUM_COUNTERS];
+    uint64_t start_tsc;
+    uint64_t end_tsc;
+    uint64_t cycles;
+} __rte_cache_aligned;
+
+static struct bench_worker g_workers[BENCH_MAX_LCORES];
+static RTE_DEFINE_PER_LCORE(struct bench_worker *, bench_self);
+
+// The launch in progress
+static int (*g_loop)(void *);
+static unsigned int g_running_lcores = 1;
+static unsigned int g_barrier;
+
+// Cost of the empty loop, measured by calibrate_empty() on the main lcore
+static unsigned long long g_calibrated_iterations;
+static unsigned long long g_calibrated_batch;
+static int g_calibrating = 0;
+static uint64_t g_empty_cycles;
+static uint64_t g_empty_call_cycles; // median per-call cycles of an empty batch
+static uint64_t g_empty_counters[NUM_COUNTERS];
+
+// Histogram of all workers, for the aggregate percentiles
+static struct latency_hist g_merged_hist;
+
+static void hist_reset(struct latency_hist *hist) {
+    if (hist->buckets == NULL) {
+        hist->buckets = calloc(LATENCY_BUCKETS, sizeof(uint64_t));
+        if (hist->buckets == NULL) {
+            rte_exit(EXIT_FAILURE, "Cannot allocate latency histogram\n");
+        }
+    } else {
+        memset(hist->buckets, 0, LATENCY_BUCKETS * sizeof(uint64_t));
+    }
+    hist->samples = 0;
+    hist->overflow = 0;
+    hist->max = 0;
+    hist->sum = 0;
+}
+
+static void hist_merge(struct latency_hist *into, const struct latency_hist *from) {
+    for (uint64_t cycles = 0; cycles < LATENCY_BUCKETS; cycles++) {
+        into->buckets[cycles] += from->buckets[cycles];
+    }
+    into->samples += from->samples;
+    into->overflow += from->overflow;
+    into->sum += from->sum;
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+}
+
+static uint64_t hist_percentile(const struct latency_hist *hist, double pct) {
+    uint64_t rank = (uint64_t)(pct * (double)hist->samples);
+    uint64_t seen = 0;
+    for (uint64_t cycles = 0; cycles < LATENCY_BUCKETS; cycles++) {
+        seen += hist->buckets[cycles];
+        if (seen > rank) {
+            return cycles;
+        }
+    }
+    return hist->max;
+}
+
+void bench_record_batch(uint64_t cycles, unsigned long long calls) {
+    struct latency_hist *hist = &RTE_PER_LCORE(bench_self)->hist;
+    uint64_t per_call = cycles / calls;
+    if (!g_calibrating) {
+        per_call = per_call > g_empty_call_cycles ? per_call - g_empty_call_cycles : 0;
+    }
+    if (per_call < LATENCY_BUCKETS) {
+        hist->buckets[per_call]++;
+    } else {
+        hist->overflow++;
+    }
+    hist->samples++;
+    hist->sum += (double)cycles / calls - (g_calibrating ? 0 : g_empty_call_cycles);
+    if (per_call > hist->max) {
+        hist->max = per_call;
+    }
+}
+
+static void open_counters(struct bench_worker *w) {
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[NUM_COUNTERS] = {
+        [COUNTER_INSTRUCTIONS] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        [COUNTER_L1D_MISSES] = { PERF_TYPE_HW_CACHE,
+                                 PERF_COUNT_HW_CACHE_L1D |
+                                 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        [COUNTER_LLC_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        [COUNTER_BRANCH_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    w->counters_opened = 1;
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[c].type;
+        attr.config = events[c].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        w->counter_fds[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (w->counter_fds[c] < 0 && w->index == 0) {
+            fprintf(stderr, "Warning: cannot open perf counter %s, not reporting it\n",
+                    counter_names[c]);
+        }
+    }
+}
+
+static void start_counters(struct bench_worker *w) {
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        if (w->counter_fds[c] >= 0) {
+            ioctl(w->counter_fds[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(w->counter_fds[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+static void stop_counters(struct bench_worker *w, uint64_t values[NUM_COUNTERS]) {
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        values[c] = 0;
+        if (w->counter_fds[c] >= 0) {
+            ioctl(w->counter_fds[c], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(w->counter_fds[c], &values[c], sizeof(values[c])) != sizeof(values[c])) {
+                values[c] = 0;
+            }
+        }
+    }
+}
+
+// The "empty" benchmark, in the shape the template loop has with the
+// current options
+static void __attribute__((noinline)) calibrate_empty(void) {
+    struct bench_worker *w = &g_workers[0];
+
+    g_calibrating = 1;
+    if (g_latency_batch) {
+        hist_reset(&w->hist);
+    }
+    if (g_perf_counters) {
+        start_counters(w);
+    }
+
+    uint64_t start = rte_rdtsc();
+    if (g_latency_batch) {
+        for (unsigned long long i = 0; i < g_iterations;) {
+            unsigned long long batch_end = RTE_MIN(i + g_latency_batch, g_iterations);
+            unsigned long long calls = batch_end - i;
+            uint64_t batch_start = bench_batch_tsc();
+            for (; i < batch_end; ++i) {
+                __asm__ volatile("" ::: "memory");
+            }
+            bench_record_batch(bench_batch_tsc() - batch_start, calls);
+        }
+    } else {
+        for (unsigned long long i = 0; i < g_iterations; ++i) {
+            __asm__ volatile("" ::: "memory");
+        }
+    }
+    g_empty_cycles = rte_rdtsc() - start;
+
+    if (g_perf_counters) {
+        stop_counters(w, g_empty_counters);
+    }
+    g_empty_call_cycles = g_latency_batch ? hist_percentile(&w->hist, 0.5) : 0;
+    g_calibrating = 0;
+    g_calibrated_iterations = g_iterations;
+    g_calibrated_batch = g_latency_batch;
+}
+
+unsigned int bench_lcores(void) {
+    const char *lcores_str = get_benchmark_param("lcores");
+    unsigned long lcores = lcores_str ? strtoul(lcores_str, NULL, 10) : 1;
+    if (lcores == 0 || lcores > BENCH_MAX_LCORES) {
+        rte_exit(EXIT_FAILURE, "lcores must be 1..%d\n", BENCH_MAX_LCORES);
+    }
+    if (lcores > rte_lcore_count()) {
+        rte_exit(EXIT_FAILURE, "lcores=%lu but EAL has %u lcores (pass -l)\n", lcores, rte_lcore_count());
+    }
+    return (unsigned int)lcores;
+}
+
+void bench_begin(void) {
+    g_workers[0].lcore_id = rte_lcore_id();
+    RTE_PER_LCORE(bench_self) = &g_workers[0];
+    if (g_perf_counters && !g_workers[0].counters_opened) {
+        open_counters(&g_workers[0]);
+    }
+    if (g_calibrated_iterations != g_iterations || g_calibrated_batch != g_latency_batch) {
+        calibrate_empty();
+    }
+}
+
+static int worker_main(void *arg) {
+    RTE_PER_LCORE(bench_self) = arg;
+    return g_loop(NULL);
+}
+
+void bench_launch(int (*loop)(void *), int multi_lcore) {
+    unsigned int lcores = bench_lcores();
+    if (lcores > 1 && !multi_lcore) {
+        rte_exit(EXIT_FAILURE, "This benchmark keeps state for one lcore only (lcores=%u)\n", lcores);
+    }
+
+    g_loop = loop;
+    g_running_lcores = lcores;
+    __atomic_store_n(&g_barrier, 0, __ATOMIC_RELAXED);
+
+    // Lcores a benchmark keeps busy itself (e.g. a traffic generator) are skipped
+    unsigned int index = 1;
+    unsigned int lcore_id;
+    RTE_LCORE_FOREACH_WORKER(lcore_id) {
+        if (index < lcores && rte_eal_get_lcore_state(lcore_id) == WAIT) {
+            g_workers[index].index = index;
+            g_workers[index].lcore_id = lcore_id;
+            index++;
+        }
+    }
+    if (index < lcores) {
+        rte_exit(EXIT_FAILURE, "lcores=%u but only %u lcores are idle\n", lcores, index);
+    }
+    for (unsigned int w = 1; w < lcores; w++) {
+        if (rte_eal_remote_launch(worker_main, &g_workers[w], g_workers[w].lcore_id) != 0) {
+            rte_exit(EXIT_FAILURE, "Cannot launch benchmark on lcore %u\n", g_workers[w].lcore_id);
+        }
+    }
+    worker_main(&g_workers[0]);
+    for (unsigned int w = 1; w < lcores; w++) {
+        rte_eal_wait_lcore(g_workers[w].lcore_id);
+    }
+}
+
+unsigned int bench_worker_start(void) {
+    struct bench_worker *w = RTE_PER_LCORE(bench_self);
+
+    if (g_latency_batch) {
+        hist_reset(&w->hist);
+    }
+    if (g_perf_counters && !w->counters_opened) {
+        open_counters(w);
+    }
+
+    // Every lcore of the case enters the loop at the same time
+    if (g_running_lcores > 1) {
+        __atomic_add_fetch(&g_barrier, 1, __ATOMIC_ACQ_REL);
+        while (__atomic_load_n(&g_barrier, __ATOMIC_ACQUIRE) < g_running_lcores) {
+            rte_pause();
+        }
+    }
+
+    if (g_perf_counters) {
+        start_counters(w);
+    }
+    w->start_tsc = rte_rdtsc();
+    return w->index;
+}
+
+void bench_worker_stop(uint64_t cycles) {
+    struct bench_worker *w = RTE_PER_LCORE(bench_self);
+
+    w->end_tsc = rte_rdtsc();
+    if (g_perf_counters) {
+        stop_counters(w, w->counters);
+    }
+    w->cycles = cycles;
+}
+
+static void print_latency(const struct latency_hist *hist) {
+    printf("{\"batch\": %llu, \"samples\": %lu, \"overflow\": %lu, "
+           "\"mean\": %.3f, \"p50\": %lu, \"p90\": %lu, \"p99\": %lu, \"p999\": %lu, "
+           "\"max\": %lu}",
+           g_latency_batch, (unsigned long)hist->samples, (unsigned long)hist->overflow,
+           hist->sum / hist->samples,
+           (unsigned long)hist_percentile(hist, 0.5),
+           (unsigned long)hist_percentile(hist, 0.9),
+           (unsigned long)hist_percentile(hist, 0.99),
+           (unsigned long)hist_percentile(hist, 0.999),
+           (unsigned long)hist->max);
+}
+
+void bench_end(void) {
+    unsigned int lcores = g_running_lcores;
+
+    // With several lcores, totals are per lcore on average and the
+    // latency distribution is that of all calls on all lcores
+    uint64_t total_cycles = 0;
+    uint64_t first_start = UINT64_MAX;
+    uint64_t last_end = 0;
+    for (unsigned int w = 0; w < lcores; w++) {
+        total_cycles += g_workers[w].cycles;
+        first_start = RTE_MIN(first_start, g_workers[w].start_tsc);
+        last_end = RTE_MAX(last_end, g_workers[w].end_tsc);
+    }
+    total_cycles /= lcores;
+
+    const struct latency_hist *hist = &g_workers[0].hist;
+    if (g_latency_batch && lcores > 1) {
+        hist_reset(&g_merged_hist);
+        for (unsigned int w = 0; w < lcores; w++) {
+            hist_merge(&g_merged_hist, &g_workers[w].hist);
+        }
+        hist = &g_merged_hist;
+    }
+
+    uint64_t net_cycles = total_cycles > g_empty_cycles ? total_cycles - g_empty_cycles : 0;
+    printf("Total cycles: %lu\n", (unsigned long)total_cycles);
+
+    printf("json: {\"iterations\": %llu, \"total_cycles\": %lu, \"empty_cycles\": %lu, "
+           "\"net_cycles\": %lu, \"cycles_per_call\": %.3f",
+           g_iterations, (unsigned long)total_cycles, (unsigned long)g_empty_cycles,
+           (unsigned long)net_cycles, (double)net_cycles / g_iterations);
+
+    if (g_latency_batch && hist->samples) {
+        printf(", \"latency\": ");
+        print_latency(hist);
+    }
+
+    if (g_perf_counters) {
+        // Per call, net of the empty loop
+        printf(", \"counters\": {");
+        for (int c = 0; c < NUM_COUNTERS; c++) {
+            printf("%s\"%s\": ", c ? ", " : "", counter_names[c]);
+            if (g_workers[0].counter_fds[c] < 0) {
+                printf("null");
+            } else {
+                double net = 0;
+                for (unsigned int w = 0; w < lcores; w++) {
+                    net += (double)g_workers[w].counters[c] - (double)g_empty_counters[c];
+                }
+                printf("%.4f", (net > 0 ? net : 0) / ((double)g_iterations * lcores));
+            }
+        }
+        printf("}");
+    }
+
+    if (lcores > 1) {
+        // Throughput of every lcore over its own loop, and of all of them
+        // between the first start and the last end
+        double tsc_mhz = (double)rte_get_tsc_hz() / 1e6;
+        uint64_t wall_cycles = last_end - first_start;
+        printf(", \"lcores\": %u, \"aggregate\": {\"calls\": %llu, \"wall_cycles\": %lu, "
+               "\"mcalls_per_sec\": %.3f}, \"per_lcore\": [",
+               lcores, g_iterations * lcores, (unsigned long)wall_cycles,
+               wall_cycles ? (double)g_iterations * lcores * tsc_mhz / wall_cycles : 0.0);
+        for (unsigned int w = 0; w < lcores; w++) {
+            const struct bench_worker *worker = &g_workers[w];
+            uint64_t net = worker->cycles > g_empty_cycles ? worker->cycles - g_empty_cycles : 0;
+            printf("%s{\"lcore\": %u, \"total_cycles\": %lu, \"cycles_per_call\": %.3f, "
+                   "\"mcalls_per_sec\": %.3f",
+                   w ? ", " : "", worker->lcore_id, (unsigned long)worker->cycles,
+                   (double)net / g_iterations,
+                   worker->cycles ? (double)g_iterations * tsc_mhz / worker->cycles : 0.0);
+            if (g_latency_batch && worker->hist.samples) {
+                printf(", \"latency\": ");
+                print_latency(&worker->hist);
+            }
+            printf("}");
+        }
+        printf("]");
+    }
+    printf("}\n");
+}
+
 void cleanup_dpdk(void) {
+    for (unsigned int w = 0; w < BENCH_MAX_LCORES; w++) {
+        free(g_workers[w].hist.buckets);
+        g_workers[w].hist.buckets = NULL;
+        if (!g_workers[w].counters_opened) {
+            continue;
+        }
+        for (int c = 0; c < NUM_COUNTERS; c++) {
+            if (g_workers[w].counter_fds[c] >= 0) {
+                close(g_workers[w].counter_fds[c]);
+                g_workers[w].counter_fds[c] = -1;
+            }
+        }
+        g_workers[w].counters_opened = 0;
+    }
+    free(g_merged_hist.buckets);
+    g_merged_hist.buckets = NULL;
     rte_eal_cleanup();
 }
-
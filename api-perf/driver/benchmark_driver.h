@@ -1,17 +1,60 @@
 #ifndef BENCHMARK_DRIVER_H
 #define BENCHMARK_DRIVER_H
 
+#include <rte_cycles.h>
 #include <rte_eal.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_ethdev.h>
 #include <rte_mempool.h>
 
 // Runtime-configurable parameters with sensible defaults
 extern unsigned long long g_iterations; // iterations for the benchmark loop
+extern unsigned long long g_latency_batch; // -l: iterations per latency sample, 0 = off
+extern int g_perf_counters; // -p: read hardware counters around the loop
 
 // Generic parameter retrieval
 const char *get_benchmark_param(const char *key);
 
+// Per-case parameters of the in-process runner, on top of the command line's
+void set_benchmark_param(const char *key, const char *value);
+void reset_benchmark_params(void);
+
 void init_dpdk(int argc, char **argv);
 void cleanup_dpdk(void);
 
+// Most lcores a case can run on (the "lcores" parameter, default 1)
+#define BENCH_MAX_LCORES 32
+
+// Number of lcores the current case runs on; snippets that keep state per
+// worker size it with this in their setup
+unsigned int bench_lcores(void);
+
+// Measurement around the benchmark loop. bench_begin() calibrates an empty
+// loop of the same shape once (its cost is subtracted from everything
+// reported); bench_end() prints "Total cycles" and a "json: {...}" line with
+// per-call cycles, latency percentiles and counters, plus per-lcore and
+// aggregate throughput when the case ran on several lcores.
+void bench_begin(void);
+void bench_end(void);
+
+// Runs loop on the main lcore, and with lcores=N on N-1 worker lcores as
+// well. multi_lcore says whether the benchmark's state is per worker
+// (BENCH_MULTI_LCORE in its headers.c); without it lcores must be 1.
+void bench_launch(int (*loop)(void *), int multi_lcore);
+
+// Called by the loop on every lcore: bench_worker_start() waits until all
+// lcores of the case are ready, starts the counters and returns the
+// worker's index (0 on the main lcore); bench_worker_stop() records the
+// cycles the loop measured.
+unsigned int bench_worker_start(void);
+void bench_worker_stop(uint64_t cycles);
+
+// Records one latency sample: cycles spent on calls iterations
+void bench_record_batch(uint64_t cycles, unsigned long long calls);
+
+static inline uint64_t bench_batch_tsc(void) {
+    return rte_rdtsc_precise();
+}
+
 #endif // BENCHMARK_DRIVER_H
@@ -7,6 +7,10 @@ def get_snippet_content(snippet_path):
             return f.read().strip()
     return ''
 
+def entry_symbol(benchmark_type, function_name):
+    # C identifier of a benchmark's bench_entry, e.g. bench_cryptodev_wait_empty
+    return 'bench_' + f'{benchmark_type}_{function_name}'.replace('-', '_')
+
 def generate_benchmark(function_name, output_file, template_base_dir, benchmark_type):
     benchmark_dir = os.path.join(template_base_dir, benchmark_type)
     template_file = os.path.join(benchmark_dir, 'template.c')
@@ -45,19 +49,44 @@ def generate_benchmark(function_name, output_file, template_base_dir, benchmark_
     code = code.replace('// {{BENCHMARK_TEARDOWN}}', benchmark_teardown)
     code = code.replace('// {{CLEANUP_INFLIGHT}}', cleanup_inflight)
     code = code.replace('// {{WAIT_TIME_ACCUMULATE}}', '')
-    code = code.replace('void run_benchmark()', 'void run_benchmark(void)')
+    env_symbol = 'bench_env_' + benchmark_type.replace('-', '_')
+    code = code.replace('// {{BENCHMARK_ENTRY}}',
+                        f'BENCH_ENTRY({entry_symbol(benchmark_type, function_name)}, '
+                        f'"{benchmark_type}", "{function_name}", {env_symbol});')
 
 
     with open(output_file, 'w') as f:
         f.write(code)
 
+def generate_registry(entries, output_file):
+    # entries: (benchmark_type, function_name) pairs, in run order
+    symbols = [entry_symbol(t, f) for t, f in entries]
+    lines = ['#include <stddef.h>', '', '#include "driver/bench_registry.h"', '']
+    lines += [f'extern const struct bench_entry {sym};' for sym in symbols]
+    lines += ['', 'const struct bench_entry *const bench_registry[] = {']
+    lines += [f'    &{sym},' for sym in symbols]
+    lines += ['    NULL,', '};', '']
+
+    with open(output_file, 'w') as f:
+        f.write('\n'.join(lines))
+
 if __name__ == '__main__':
     parser = argparse.ArgumentParser(description='Generate API benchmark source code.')
-    parser.add_argument('function', help='The function to benchmark.')
+    parser.add_argument('function', nargs='+', help='The function to benchmark (with --registry: <type>/<function> entries).')
     parser.add_argument('-o', '--output', required=True, help='Output C file.')
-    parser.add_argument('-b', '--template_base_dir', required=True, help='Path to the base directory containing benchmark templates (e.g., benchmarks/).')
-    parser.add_argument('-t', '--benchmark_type', required=True, help='Type of benchmark (e.g., dpdk, doca).')
+    parser.add_argument('-b', '--template_base_dir', help='Path to the base directory containing benchmark templates (e.g., benchmarks/).')
+    parser.add_argument('-t', '--benchmark_type', help='Type of benchmark (e.g., dpdk, doca).')
+    parser.add_argument('--registry', action='store_true', help='Write the in-process runner\'s table of benchmarks instead.')
     args = parser.parse_args()
 
-    generate_benchmark(args.function, args.output, args.template_base_dir, args.benchmark_type)
-    print(f"Successfully generated {args.output} for function {args.function} of type {args.benchmark_type}.")
+    if args.registry:
+        entries = [tuple(entry.split('/', 1)) for entry in args.function]
+        if any(len(entry) != 2 for entry in entries):
+            parser.error('registry entries are <type>/<function>')
+        generate_registry(entries, args.output)
+        print(f"Successfully generated {args.output} with {len(entries)} benchmarks.")
+    else:
+        if not args.template_base_dir or not args.benchmark_type or len(args.function) != 1:
+            parser.error('one function, -b and -t are required')
+        generate_benchmark(args.function[0], args.output, args.template_base_dir, args.benchmark_type)
+        print(f"Successfully generated {args.output} for function {args.function[0]} of type {args.benchmark_type}.")
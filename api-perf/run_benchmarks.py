@@ -9,12 +9,30 @@ import json
 import itertools
 import signal
 import atexit
+import tempfile
 from datetime import datetime
 
 
+def parse_cpu_list(cpu_list: str) -> list[int]:
+    # "4-7,9" -> [4, 5, 6, 7, 9], as taskset and EAL -l take it
+    cpus = []
+    for part in cpu_list.split(','):
+        if '-' in part:
+            first, last = part.split('-', 1)
+            cpus.extend(range(int(first), int(last) + 1))
+        elif part:
+            cpus.append(int(part))
+    return cpus
+
+
 class BenchmarkRunner:
-    def __init__(self, cpu_core=3, verbose=False):
+    def __init__(self, cpu_core=3, verbose=False, worker_cores=None):
         self.cpu_core = cpu_core
+        # Extra cores for multi-lcore cases (the "lcores" parameter); the
+        # main lcore stays on cpu_core and every core gets the same tuning
+        self.worker_cores = worker_cores
+        self.cpu_list = f"{cpu_core},{worker_cores}" if worker_cores else str(cpu_core)
+        self.max_lcores = 1 + (len(parse_cpu_list(worker_cores)) if worker_cores else 0)
         self.verbose = verbose
         self.original_settings = {}
         self.setup_completed = False
@@ -36,7 +54,7 @@ class BenchmarkRunner:
         try:
             # Get current governor and frequency info
             result = subprocess.run([
-                "cpupower", "-c", str(self.cpu_core), "frequency-info"
+                "cpupower", "-c", self.cpu_list, "frequency-info"
             ], capture_output=True, text=True, check=True)
             
             # Parse governor from output
@@ -93,7 +111,7 @@ class BenchmarkRunner:
         self.get_current_settings()
         
         # Print current settings before changing
-        print(f"Current CPU {self.cpu_core} settings:")
+        print(f"Current CPU {self.cpu_list} settings:")
         if 'governor' in self.original_settings:
             print(f"  Governor: {self.original_settings['governor']}")
         print()
@@ -102,10 +120,10 @@ class BenchmarkRunner:
         if supported_commands.get('frequency-set', False):
             try:
                 subprocess.run([
-                    "sudo", "cpupower", "-c", str(self.cpu_core), "frequency-set", 
+                    "sudo", "cpupower", "-c", self.cpu_list, "frequency-set", 
                     "-g", "performance"
                 ], check=True, capture_output=True)
-                print(f"✓ Set CPU {self.cpu_core} to performance mode")
+                print(f"✓ Set CPU {self.cpu_list} to performance mode")
             except subprocess.CalledProcessError as e:
                 print(f"⚠ Warning: Could not set CPU governor: {e}")
         else:
@@ -115,7 +133,7 @@ class BenchmarkRunner:
         if supported_commands.get('idle-set', False):
             try:
                 subprocess.run([
-                    "sudo", "cpupower", "-c", str(self.cpu_core), "idle-set", "-d", "0"
+                    "sudo", "cpupower", "-c", self.cpu_list, "idle-set", "-d", "0"
                 ], check=True, capture_output=True)
                 print("✓ Disabled CPU idle states")
             except subprocess.CalledProcessError as e:
@@ -137,7 +155,7 @@ class BenchmarkRunner:
         if 'governor' in self.original_settings:
             try:
                 subprocess.run([
-                    "sudo", "cpupower", "-c", str(self.cpu_core), "frequency-set",
+                    "sudo", "cpupower", "-c", self.cpu_list, "frequency-set",
                     "-g", self.original_settings['governor']
                 ], check=True, capture_output=True)
                 print(f"✓ Restored governor to {self.original_settings['governor']}")
@@ -147,7 +165,7 @@ class BenchmarkRunner:
         # Re-enable CPU idle states
         try:
             subprocess.run([
-                "sudo", "cpupower", "-c", str(self.cpu_core), "idle-set", "-e", "0"
+                "sudo", "cpupower", "-c", self.cpu_list, "idle-set", "-e", "0"
             ], check=True, capture_output=True)
             print("✓ Re-enabled CPU idle states")
         except subprocess.CalledProcessError:
@@ -155,6 +173,12 @@ class BenchmarkRunner:
         
         print("✓ CPU settings restored")
     
+    def eal_lcore_args(self) -> list[str]:
+        # EAL lcores for multi-lcore cases; none keeps EAL's defaults
+        if not self.worker_cores:
+            return []
+        return ['-l', self.cpu_list, '--main-lcore', str(self.cpu_core)]
+
     def warm_up(self, exe_path, cmd_args):
         """Run executable once to warm up caches."""
         if self.verbose:
@@ -173,7 +197,7 @@ class BenchmarkRunner:
                     i += 1
             
             subprocess.run([
-                "taskset", "-c", str(self.cpu_core),
+                "taskset", "-c", self.cpu_list,
                 exe_path
             ] + warm_up_args, check=True, capture_output=True)
             if self.verbose:
@@ -250,7 +274,7 @@ def discover_prefixes(build_dir: str) -> list[str]:
         for entry in os.listdir(build_dir):
             if entry.startswith('.'):
                 continue
-            if '_' not in entry:
+            if '_' not in entry or entry == RUNNER_NAME:
                 continue
             full = os.path.join(build_dir, entry)
             if not os.path.isfile(full):
@@ -290,6 +314,29 @@ def get_benchmark_config(full_config, prefix, func):
     return final_config
 
 
+def _excluded(combo: dict, exclude: list[dict]) -> bool:
+    # An "exclude" entry matches a combination when every key it names does
+    # (a list value matches any of its elements)
+    for entry in exclude:
+        if all(combo.get(k) in (v if isinstance(v, list) else [v]) for k, v in entry.items()):
+            return True
+    return False
+
+
+def param_combinations(func: str, config: dict, max_lcores: int) -> list[dict]:
+    # Every combination of the sweep, without the excluded ones and the
+    # lcores values there are no cores for
+    params_dict = config.get("params", {})
+    keys = list(params_dict.keys())
+    combos = [dict(zip(keys, combo)) for combo in itertools.product(*[params_dict[k] for k in keys])]
+    combos = [combo for combo in combos if not _excluded(combo, config.get("exclude", []))]
+    runnable = [combo for combo in combos if int(combo.get('lcores', 1)) <= max_lcores]
+    if len(runnable) < len(combos):
+        print(f"Skipping {len(combos) - len(runnable)} {func} cases with lcores > {max_lcores} "
+              f"(give more --worker-cores)", file=sys.stderr)
+    return runnable
+
+
 def _parse_cycles(stdout_text: str) -> float | None:
     # Expect lines like: "Total cycles: <integer>" or "Cycles for <type> empty: <float>"
     match = re.search(r"(?:Total cycles|Cycles for \w+ empty):\s*([0-9]+(?:\.[0-9]+)?)", stdout_text)
@@ -300,6 +347,17 @@ def _parse_cycles(stdout_text: str) -> float | None:
             return None
     return None
 
+def _parse_result_json(stdout_text: str) -> dict:
+    # Look for the driver's "json: {...}" line (per-call cycles net of the
+    # empty loop, latency percentiles, hardware counters)
+    match = re.search(r"^json:\s*(\{.*\})\s*$", stdout_text, re.MULTILINE)
+    if match:
+        try:
+            return json.loads(match.group(1))
+        except (ValueError, json.JSONDecodeError):
+            return {}
+    return {}
+
 def _parse_metadata(stdout_text: str) -> dict:
     # Look for lines like: "metadata: {'key': value, ...}"
     match = re.search(r"metadata:\s*(\{.*\})", stdout_text)
@@ -326,7 +384,7 @@ def run_benchmark(function_name: str, build_dir: str, prefix: str, runner: Bench
         print(f"Warning: Warm-up failed for {function_name}", file=sys.stderr)
 
     # Use taskset to pin to specific CPU core for consistent measurements
-    cmd = ["taskset", "-c", str(runner.cpu_core), exe_path] + cmd_args
+    cmd = ["taskset", "-c", runner.cpu_list, exe_path] + cmd_args
 
     case_suffix = f" ({case_info})" if case_info else ""
     print(f"\n--- Running benchmark for {function_name}{case_suffix} ---")
@@ -353,6 +411,124 @@ def run_benchmark(function_name: str, build_dir: str, prefix: str, runner: Bench
         return 0, cycles, metadata, result.stdout, result.stderr
 
 
+def report_result(func: str, prefix: str, iterations: int, cycles: float, metadata: dict, params: dict, result_json: dict,
+                  csv_writer, json_results: list, empty_cycles: dict) -> None:
+    # Calculate and display cycles per call, net of the empty loop
+    if 'cycles_per_call' in result_json:
+        print(f"  → Cycles per call (net): {result_json['cycles_per_call']:.2f}")
+        latency = result_json.get('latency')
+        if latency:
+            print(f"  → Latency (cycles): p50 {latency['p50']} p90 {latency['p90']} "
+                  f"p99 {latency['p99']} p99.9 {latency['p999']} max {latency['max']}")
+        aggregate = result_json.get('aggregate')
+        if aggregate:
+            print(f"  → {result_json['lcores']} lcores: {aggregate['mcalls_per_sec']:.2f} Mcalls/s aggregate, "
+                  + ", ".join(f"{w['mcalls_per_sec']:.2f}" for w in result_json['per_lcore']) + " per lcore")
+    elif prefix in empty_cycles and func != 'empty':
+        empty_cycles_for_prefix = empty_cycles[prefix]
+        if cycles > empty_cycles_for_prefix:
+            net_cycles = cycles - empty_cycles_for_prefix
+            cycles_per_call = net_cycles / iterations
+            print(f"  → Cycles per call (net): {cycles_per_call:.2f}")
+
+    # Merge metadata from benchmark with parameters
+    metadata.update(params)
+    metadata_json = json.dumps(metadata).replace('"', "'")
+    csv_writer.writerow([func, prefix, iterations, cycles, metadata_json])
+    if result_json:
+        json_results.append({
+            'function': func,
+            'prefix': prefix,
+            'metadata': metadata,
+            'result': result_json,
+        })
+
+
+# In-process runner (driver/bench_runner.c): every benchmark in one binary
+RUNNER_NAME = 'api_perf'
+
+
+def list_runner_benchmarks(runner_path: str) -> list[tuple[str, str]]:
+    # (type, function) pairs linked into the runner, in registry order
+    result = subprocess.run([runner_path, '--', '-L'], capture_output=True, text=True, check=True)
+    return [tuple(line.split()) for line in result.stdout.splitlines() if len(line.split()) == 2]
+
+
+def _parse_param_value(value: str):
+    # Plan values come back as text; keep numbers numeric as in benchmark_cases.json
+    try:
+        return json.loads(value)
+    except ValueError:
+        return value
+
+
+def split_runner_output(stdout_text: str) -> list[tuple[str, str, dict, str]]:
+    # (type, function, params, output) for every measured run; warmup runs are dropped
+    runs = []
+    current = None
+    for line in stdout_text.splitlines():
+        match = re.match(r"^(case|warmup): (\S+) (\S+)(.*)$", line)
+        if match:
+            current = None
+            if match.group(1) == 'case':
+                params = dict(kv.split('=', 1) for kv in match.group(4).split() if '=' in kv)
+                params.pop('rep', None)
+                current = (match.group(2), match.group(3), {k: _parse_param_value(v) for k, v in params.items()}, [])
+                runs.append(current)
+        elif current is not None:
+            current[3].append(line)
+    return [(t, f, params, "\n".join(lines)) for t, f, params, lines in runs]
+
+
+def run_in_process(runner_path: str, benchmarks: list[tuple[str, str]], full_config: dict, runner: BenchmarkRunner,
+                   iterations: int, warmup_iterations: int, repetitions: int, measure_args: list[str],
+                   csv_writer, json_results: list) -> int:
+    # One process per distinct set of EAL args; within it the runner keeps a
+    # type's devices up across consecutive cases, so cases are kept grouped by type
+    groups: dict[tuple, list[str]] = {}
+    for prefix, func in sorted(benchmarks, key=lambda b: b[0]):
+        config = get_benchmark_config(full_config, prefix, func)
+        lines = groups.setdefault(tuple(config.get("eal_args", [])), [])
+        for combo in param_combinations(func, config, runner.max_lcores):
+            lines.append(" ".join([prefix, func] + [f"{k}={v}" for k, v in combo.items()]))
+
+    exit_code = 0
+    for eal_args, plan_lines in groups.items():
+        with tempfile.NamedTemporaryFile('w', prefix='api_perf_', suffix='.plan', delete=False) as plan:
+            plan.write("\n".join(plan_lines) + "\n")
+        cmd = (["taskset", "-c", runner.cpu_list, runner_path] + runner.eal_lcore_args() + list(eal_args) +
+               ['--', '-i', str(iterations), '-w', str(warmup_iterations), '-r', str(repetitions)] +
+               measure_args + ['-f', plan.name])
+        print(f"\n--- Running {len(plan_lines)} cases in-process ---")
+        print("Command:", " ".join(shlex.quote(part) for part in cmd))
+        if runner.verbose:
+            print("\n".join(plan_lines))
+
+        try:
+            result = subprocess.run(cmd, capture_output=True, text=True, env=os.environ.copy())
+        finally:
+            os.unlink(plan.name)
+
+        # Runs that completed before a failure are still recorded
+        for prefix, func, params, output in split_runner_output(result.stdout or ""):
+            case_info = ", ".join(f"{k}={v}" for k, v in params.items()) or "Default"
+            print(f"\n--- {prefix} {func} ({case_info}) ---")
+            print(output.strip())
+            cycles = _parse_cycles(output)
+            if cycles is None:
+                continue
+            report_result(func, prefix, iterations, cycles, _parse_metadata(output), params,
+                          _parse_result_json(output), csv_writer, json_results, {})
+
+        if result.returncode != 0:
+            print("Error running benchmarks:", file=sys.stderr)
+            if result.stderr:
+                print(result.stderr, file=sys.stderr)
+            detect_and_explain_common_errors(result.stdout or "", result.stderr or "")
+            exit_code = result.returncode
+    return exit_code
+
+
 def check_permissions():
     """Check if script has proper permissions for accurate measurements."""
     if hasattr(os, 'geteuid') and os.geteuid() == 0:  # Running as root
@@ -387,6 +563,12 @@ Examples:
   %(prog)s --verbose                          # Run with detailed output
   %(prog)s --cpu-core 2 --iterations 5000000 # Use specific CPU core and iterations
   %(prog)s rte_eth_rx_burst                   # Run specific function
+  %(prog)s -r 5                               # Five measured runs per case
+  %(prog)s --worker-cores 4-18 rte_ring_enqueue_dequeue_burst  # Up to 16 lcores
+
+If the build contains the in-process runner (api_perf), each set of EAL args
+is initialized once and the whole sweep runs in that process; --standalone
+runs the per-benchmark executables (meson -Dstandalone=true) instead.
 
 Optimizations applied:
   - CPU governor set to performance mode
@@ -402,7 +584,14 @@ Optimizations applied:
     parser.add_argument('--prefix', default=None, help='Force a specific executable prefix (e.g., dpdk). If omitted, prefix is auto-detected.')
     parser.add_argument('-i', '--iterations', type=int, default=1000000, help='Number of iterations for benchmarks (default: 1000000)')
     parser.add_argument('--csv', default=None, help='Path to CSV file for results. If omitted, a timestamped file is created in the current directory.')
+    parser.add_argument('--json', default=None, help='Path to JSON results file (consumed by analyze_latency.py). If omitted, it is named after the CSV file.')
+    parser.add_argument('--latency-batch', type=int, default=0, help='Record a latency sample every N iterations (1 = per call) for percentiles (default: off)')
+    parser.add_argument('--perf-counters', action='store_true', help='Read instructions, L1D/LLC misses and branch misses around the loop (needs perf_event access)')
+    parser.add_argument('-r', '--repetitions', type=int, default=1, help='Measured runs per case with the in-process runner (default: 1)')
+    parser.add_argument('--warmup-iterations', type=int, default=10000, help='Iterations of the warm-up run before each case (default: 10000)')
+    parser.add_argument('--standalone', action='store_true', help='Run one executable per benchmark instead of the in-process runner')
     parser.add_argument('--cpu-core', type=int, default=3, help='CPU core to pin benchmarks to (default: 3)')
+    parser.add_argument('--worker-cores', default=None, help='Cores for the worker lcores of multi-lcore cases, e.g. 4-18 (default: none, so lcores=1 only)')
     parser.add_argument('--verbose', action='store_true', help='Enable verbose output showing detailed setup and warm-up information')
 
     args = parser.parse_args()
@@ -411,14 +600,23 @@ Optimizations applied:
     check_permissions()
 
     # Create benchmark runner
-    runner = BenchmarkRunner(cpu_core=args.cpu_core, verbose=args.verbose)
+    runner = BenchmarkRunner(cpu_core=args.cpu_core, verbose=args.verbose, worker_cores=args.worker_cores)
     
     # Set up CPU for optimal benchmarking
     runner.setup_cpu()
 
+    # Prefer the in-process runner when it was built
+    runner_path = os.path.join(args.build_dir, RUNNER_NAME)
+    in_process = not args.standalone and os.access(runner_path, os.X_OK)
+    available: list[tuple[str, str]] = []
+    if in_process:
+        available = list_runner_benchmarks(runner_path)
+
     # Determine prefixes
     if args.prefix:
         prefixes = [args.prefix]
+    elif in_process:
+        prefixes = sorted({prefix for prefix, _ in available}, key=lambda p: (p != 'dpdk', p))
     else:
         prefixes = discover_prefixes(args.build_dir)
 
@@ -440,6 +638,15 @@ Optimizations applied:
     csv_file = open(csv_path, mode='w', newline='')
     csv_writer = csv.writer(csv_file)
     csv_writer.writerow(['function', 'prefix', 'iterations', 'total_cycles', 'metadata'])
+    json_path = args.json or os.path.splitext(csv_path)[0] + '.json'
+    json_results = []
+
+    # Measurement options understood by the driver, after '--'
+    measure_args: list[str] = []
+    if args.latency_batch > 0:
+        measure_args.extend(['-l', str(args.latency_batch)])
+    if args.perf_counters:
+        measure_args.append('-p')
 
     # Load benchmark cases from JSON
     with open('benchmark_cases.json', 'r') as f:
@@ -447,91 +654,96 @@ Optimizations applied:
     
     benchmark_cases = full_config["benchmarks"]
 
-    benchmarks_to_run = []
-    if len(args.functions) == 0:
-        # Run all discovered, across all prefixes
-        for prefix in prefixes:
-            functions = discover_functions(args.build_dir, prefix)
-            for func in functions:
-                benchmarks_to_run.append((prefix, func))
-    else:
-        # Run specified functions, choosing best available prefix per function
+    if in_process:
+        benchmarks_to_run = [(prefix, func) for prefix, func in available
+                             if prefix in prefixes and func != 'empty'
+                             and (not args.functions or func in args.functions)]
         for func in args.functions:
-            prefix = args.prefix or choose_prefix_for_function(args.build_dir, func, prefixes)
-            if prefix is None:
-                print(f"Executable not found for function '{func}' with any known prefix in {args.build_dir}.", file=sys.stderr)
+            if not any(f == func for _, f in benchmarks_to_run):
+                print(f"Benchmark '{func}' is not in {runner_path}.", file=sys.stderr)
                 exit_code = 1
-                continue
-            benchmarks_to_run.append((prefix, func))
+        # The driver subtracts a calibrated empty loop itself, so no 'empty' baseline runs
+        rc = run_in_process(runner_path, benchmarks_to_run, full_config, runner, args.iterations,
+                            args.warmup_iterations, args.repetitions, measure_args, csv_writer, json_results)
+        if rc != 0:
+            exit_code = rc
+    else:
+        benchmarks_to_run = []
+        if len(args.functions) == 0:
+            # Run all discovered, across all prefixes
+            for prefix in prefixes:
+                functions = discover_functions(args.build_dir, prefix)
+                for func in functions:
+                    benchmarks_to_run.append((prefix, func))
+        else:
+            # Run specified functions, choosing best available prefix per function
+            for func in args.functions:
+                prefix = args.prefix or choose_prefix_for_function(args.build_dir, func, prefixes)
+                if prefix is None:
+                    print(f"Executable not found for function '{func}' with any known prefix in {args.build_dir}.", file=sys.stderr)
+                    exit_code = 1
+                    continue
+                benchmarks_to_run.append((prefix, func))
 
-    # First, run empty benchmarks to get baseline cycles
-    empty_cycles = {}
-    for prefix in prefixes:
-        if 'empty' in discover_functions(args.build_dir, prefix):
-            benchmark_full_config = get_benchmark_config(full_config, prefix, 'empty')
-            eal_args = benchmark_full_config.get("eal_args", [])
-            benchmark_args = ['-i', str(args.iterations)]
-            cmd_args = eal_args + ['--'] + benchmark_args
+        # First, run empty benchmarks to get baseline cycles
+        empty_cycles = {}
+        for prefix in prefixes:
+            if 'empty' in discover_functions(args.build_dir, prefix):
+                benchmark_full_config = get_benchmark_config(full_config, prefix, 'empty')
+                eal_args = benchmark_full_config.get("eal_args", [])
+                benchmark_args = ['-i', str(args.iterations)] + measure_args
+                cmd_args = runner.eal_lcore_args() + eal_args + ['--'] + benchmark_args
             
-            rc, cycles, metadata, _out, _err = run_benchmark('empty', build_dir=args.build_dir, prefix=prefix, runner=runner, cmd_args=cmd_args, env=os.environ.copy(), case_info="Empty baseline")
-            if cycles is not None:
-                empty_cycles[prefix] = cycles
-                print(f"Empty benchmark for {prefix}: {cycles} cycles")
-            if rc != 0:
-                exit_code = rc
-
-    # Now run all other benchmarks
-    for prefix, func in benchmarks_to_run:
-        if func == 'empty':  # Skip empty benchmarks as they were already run
-            continue
+                rc, cycles, metadata, _out, _err = run_benchmark('empty', build_dir=args.build_dir, prefix=prefix, runner=runner, cmd_args=cmd_args, env=os.environ.copy(), case_info="Empty baseline")
+                if cycles is not None:
+                    empty_cycles[prefix] = cycles
+                    print(f"Empty benchmark for {prefix}: {cycles} cycles")
+                if rc != 0:
+                    exit_code = rc
+
+        # Now run all other benchmarks
+        for prefix, func in benchmarks_to_run:
+            if func == 'empty':  # Skip empty benchmarks as they were already run
+                continue
             
-        benchmark_full_config = get_benchmark_config(full_config, prefix, func)
-        params_dict = benchmark_full_config.get("params", {})
-        eal_args = benchmark_full_config.get("eal_args", [])
-        
-        # Generate all combinations of parameters
-        param_keys = list(params_dict.keys())
-        param_values = [params_dict[k] for k in param_keys]
+            benchmark_full_config = get_benchmark_config(full_config, prefix, func)
+            eal_args = benchmark_full_config.get("eal_args", [])
         
-        for combo in itertools.product(*param_values):
-            # Build benchmark (post --) args: params then iterations
-            benchmark_args: list[str] = []
-            case_info_parts = []
-            metadata_params = {}
-            for i, key in enumerate(param_keys):
-                benchmark_args.extend([f"--{key}", str(combo[i])])
-                case_info_parts.append(f"{key}={combo[i]}")
-                metadata_params[key] = combo[i]
-            benchmark_args.extend(['-i', str(args.iterations)])
-
-            # Full command: EAL args first, then '--', then benchmark args
-            cmd_args = eal_args + ['--'] + benchmark_args
-            case_info = ", ".join(case_info_parts) if case_info_parts else "Default"
+            # Generate all combinations of parameters
+            for combo in param_combinations(func, benchmark_full_config, runner.max_lcores):
+                # Build benchmark (post --) args: params then iterations
+                benchmark_args: list[str] = []
+                case_info_parts = []
+                metadata_params = {}
+                for key, value in combo.items():
+                    benchmark_args.extend([f"--{key}", str(value)])
+                    case_info_parts.append(f"{key}={value}")
+                    metadata_params[key] = value
+                benchmark_args.extend(['-i', str(args.iterations)])
+                benchmark_args.extend(measure_args)
+
+                # Full command: EAL args first, then '--', then benchmark args
+                cmd_args = runner.eal_lcore_args() + eal_args + ['--'] + benchmark_args
+                case_info = ", ".join(case_info_parts) if case_info_parts else "Default"
             
-            # Set up environment
-            env = os.environ.copy()
+                # Set up environment
+                env = os.environ.copy()
             
-            rc, cycles, metadata, stdout, stderr = run_benchmark(func, build_dir=args.build_dir, prefix=prefix, runner=runner, cmd_args=cmd_args, env=env, case_info=case_info)
+                rc, cycles, metadata, stdout, stderr = run_benchmark(func, build_dir=args.build_dir, prefix=prefix, runner=runner, cmd_args=cmd_args, env=env, case_info=case_info)
             
-            if cycles is not None:
-                total_cycles = cycles  # cycles is already total cycles now
-                
-                # Calculate and display cycles per call if empty benchmark data is available
-                if prefix in empty_cycles and func != 'empty':
-                    empty_cycles_for_prefix = empty_cycles[prefix]
-                    if total_cycles > empty_cycles_for_prefix:
-                        net_cycles = total_cycles - empty_cycles_for_prefix
-                        cycles_per_call = net_cycles / args.iterations
-                        print(f"  → Cycles per call (net): {cycles_per_call:.2f}")
-                
-                # Merge metadata from benchmark with parameters
-                metadata.update(metadata_params)
-                metadata_json = json.dumps(metadata).replace('"', "'")
-                csv_writer.writerow([func, prefix, args.iterations, total_cycles, metadata_json])
-            if rc != 0:
-                exit_code = rc
+                result_json = _parse_result_json(stdout or "")
+                if cycles is not None:
+                    report_result(func, prefix, args.iterations, cycles, metadata, metadata_params, result_json,
+                                  csv_writer, json_results, empty_cycles)
+                if rc != 0:
+                    exit_code = rc
 
     csv_file.flush()
     csv_file.close()
+    if json_results:
+        with open(json_path, 'w') as f:
+            json.dump(json_results, f, indent=2)
     print(f"\n--- All benchmarks complete ---\nResults written to {csv_path}")
+    if json_results:
+        print(f"Detailed results written to {json_path}")
     sys.exit(exit_code)
@@ -9,11 +9,7 @@ bool ether_addr_eq(void* k1, void* k2)
             [fr2]ether_addrp(k2, ea2) &*&
             (result ? (ea1 != ea2) : ea1 == ea2); @*/
 {
-  struct rte_ether_addr* a = (struct rte_ether_addr*)k1;
-  struct rte_ether_addr* b = (struct rte_ether_addr*)k2;
-  return 0 == memcmp(a,
-                     b,
-                     sizeof(struct rte_ether_addr));
+  return ether_addr_eq_inline(k1, k2);
 }
 
 bool static_key_eq(void* k1, void* k2)
@@ -34,21 +30,7 @@ int ether_addr_hash(void* k)
 /*@ ensures [fr]ether_addrp(k, ea) &*&
             result == eth_addr_hash(ea); @*/
 {
-  struct rte_ether_addr* addr = (struct rte_ether_addr*)k;
-  /* Good hash function */
-    return (int)((*(uint32_t*)addr) ^
-               (*(uint32_t*)((char*)addr + 2)));
-
-  /* Poor hash function */
-  // long long hash = 0;
-  // for(int i = 0; i <ETHER_ADDR_LEN; i++){
-  //   hash*=31;
-  //   hash += addr->addr_bytes[i];
-  // }
-
-  // hash = hash % INT_MAX;
-
-  // return (int)hash;
+  return ether_addr_hash_inline(k);
 }
 
 int static_key_hash(void* key)
@@ -7,6 +7,8 @@
 
 #include "lib/stubs/core_stub.h"
 
+#include "include_ignored_by_verifast.h"
+
 // Use only a single map when replaying for performance analysis
 // as the tool does not support multiple data structure instances
 // yet.
@@ -85,6 +87,36 @@ int static_key_hash(void* key);
 /*@ ensures [fr]static_keyp(key, sk) &*&
             result == st_key_hash(sk); @*/
 
+#ifdef _NO_VERIFAST_
+#include <string.h>
+
+// ether_addr_eq and ether_addr_hash, inlinable into the specialized
+// containers (lib/containers/specialize.h)
+static inline bool ether_addr_eq_inline(struct rte_ether_addr* a,
+                                        struct rte_ether_addr* b)
+{
+  return 0 == memcmp(a, b, sizeof(struct rte_ether_addr));
+}
+
+static inline int ether_addr_hash_inline(struct rte_ether_addr* addr)
+{
+  /* Good hash function */
+  return (int)((*(uint32_t*)addr) ^
+               (*(uint32_t*)((char*)addr + 2)));
+
+  /* Poor hash function */
+  // long long hash = 0;
+  // for(int i = 0; i <ETHER_ADDR_LEN; i++){
+  //   hash*=31;
+  //   hash += addr->addr_bytes[i];
+  // }
+
+  // hash = hash % INT_MAX;
+
+  // return (int)hash;
+}
+#endif//_NO_VERIFAST_
+
 void init_nothing_ea(void* entry);
 /*@ requires chars(entry, sizeof(struct rte_ether_addr), _); @*/
 /*@ ensures ether_addrp(entry, _); @*/
@@ -29,8 +29,27 @@
 #include "lib/containers/double-chain.h"
 #include "lib/containers/map.h"
 #include "lib/containers/vector.h"
+#include "lib/containers/vector-group.h"
 #include "lib/expirator.h"
 
+#define MAP_SPEC_NAME ether_addr
+#define MAP_SPEC_KEY_T struct rte_ether_addr
+#define MAP_SPEC_KEY_EQ ether_addr_eq_inline
+#define MAP_SPEC_KEY_HASH ether_addr_hash_inline
+#include "lib/containers/map-specialized.h"
+
+#define VECTOR_SPEC_NAME ether_addr
+#define VECTOR_SPEC_ELEM_T struct rte_ether_addr
+#include "lib/containers/vector-specialized.h"
+
+#define VECTOR_SPEC_NAME dyn_value
+#define VECTOR_SPEC_ELEM_T struct DynamicValue
+#include "lib/containers/vector-specialized.h"
+
+#define EXPIRATOR_SPEC_NAME ether_addr
+#define EXPIRATOR_SPEC_KEY_T struct rte_ether_addr
+#include "lib/expirator-specialized.h"
+
 #define NO_STATIC_MAPPING
 
 struct bridge_config config;
@@ -54,23 +73,23 @@ int bridge_expire_entries(time_t time) {
   assert(sizeof(uint64_t) <= sizeof(time_t));
   time_t min_time = (time_t)min_time_u; // OK since the assert above passed
 
-  return expire_items_single_map(dynamic_ft.heap, dynamic_ft.keys,
-                                 dynamic_ft.map, min_time);
+  return ether_addr_expire_items_single_map(dynamic_ft.heap, dynamic_ft.keys,
+                                            dynamic_ft.map, min_time);
 }
 
 int bridge_get_device(struct rte_ether_addr *dst, uint16_t src_device) {
   int device = -1;
   int index = -1;
-  int present = map_get(dynamic_ft.map, dst, &index);
+  int present = ether_addr_map_get(dynamic_ft.map, dst, &index);
   if (present) {
 #ifdef DUMP_PERF_VARS
     printf("Unicast\n");
 #endif
     // VIGOR_TAG(TRAFFIC_CLASS, KNOWN_DEST);
     struct DynamicValue *value = 0;
-    vector_borrow(dynamic_ft.values, index, (void **)&value);
+    dyn_value_vector_borrow(dynamic_ft.values, index, &value);
     device = value->device;
-    vector_return(dynamic_ft.values, index, value);
+    dyn_value_vector_return(dynamic_ft.values, index, value);
     return device;
   }
   // VIGOR_TAG(TRAFFIC_CLASS, UNKNOWN_DEST);
@@ -81,7 +100,7 @@ int bridge_get_device(struct rte_ether_addr *dst, uint16_t src_device) {
 void bridge_put_update_entry(struct rte_ether_addr *src, uint16_t src_device,
                              time_t time) {
   int index = -1;
-  int present = map_get(dynamic_ft.map, src, &index);
+  int present = ether_addr_map_get(dynamic_ft.map, src, &index);
   if (present) {
     dchain_rejuvenate_index(dynamic_ft.heap, index, time);
     // VIGOR_TAG(TRAFFIC_CLASS, KNOWN_SRC);
@@ -95,15 +114,15 @@ void bridge_put_update_entry(struct rte_ether_addr *src, uint16_t src_device,
     }
     struct rte_ether_addr *key = 0;
     struct DynamicValue *value = 0;
-    vector_borrow(dynamic_ft.keys, index, (void **)&key);
-    vector_borrow(dynamic_ft.values, index, (void **)&value);
+    ether_addr_vector_borrow(dynamic_ft.keys, index, &key);
+    dyn_value_vector_borrow(dynamic_ft.values, index, &value);
     memcpy(key, src, sizeof(struct rte_ether_addr));
     value->device = src_device;
-    map_put(dynamic_ft.map, key, index);
+    ether_addr_map_put(dynamic_ft.map, key, index);
     // VIGOR_TAG(TRAFFIC_CLASS, UNKNOWN_SRC);
     // the other half of the key is in the map
-    vector_return(dynamic_ft.keys, index, key);
-    vector_return(dynamic_ft.values, index, value);
+    ether_addr_vector_return(dynamic_ft.keys, index, key);
+    dyn_value_vector_return(dynamic_ft.values, index, value);
   }
 }
 
@@ -280,14 +299,14 @@ void nf_core_init(void) {
       map_allocate(ether_addr_eq, ether_addr_hash, capacity, &dynamic_ft.map);
   if (!happy)
     rte_exit(EXIT_FAILURE, "error allocating dynamic map");
-  happy = vector_allocate(sizeof(struct rte_ether_addr), capacity, init_nothing_ea,
-                          &dynamic_ft.keys);
-  if (!happy)
-    rte_exit(EXIT_FAILURE, "error allocating dynamic key array");
-  happy = vector_allocate(sizeof(struct DynamicValue), capacity,
-                          init_nothing_dv, &dynamic_ft.values);
+  // The map reads an entry's key and bridge_get_device its value: one record
+  struct VectorGroupMember dynamic_vectors[] = {
+      {sizeof(struct rte_ether_addr), init_nothing_ea, &dynamic_ft.keys},
+      {sizeof(struct DynamicValue), init_nothing_dv, &dynamic_ft.values},
+  };
+  happy = vector_allocate_group(capacity, 2, dynamic_vectors);
   if (!happy)
-    rte_exit(EXIT_FAILURE, "error allocating dynamic value array");
+    rte_exit(EXIT_FAILURE, "error allocating dynamic key and value arrays");
   happy = dchain_allocate(capacity, &dynamic_ft.heap);
   if (!happy)
     rte_exit(EXIT_FAILURE, "error allocating heap");
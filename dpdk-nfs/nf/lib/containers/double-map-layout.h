@@ -0,0 +1,41 @@
+#ifndef _DOUBLE_MAP_LAYOUT_H_INCLUDED_
+#define _DOUBLE_MAP_LAYOUT_H_INCLUDED_
+
+#include "double-map.h"
+#include <stdint.h>
+
+// Shared by double-map.c and the specialized double maps
+// (double-map-specialized.h)
+struct DoubleMap
+{
+  int value_size;
+
+  uq_value_copy *cpy;
+  uq_value_destr *dstr;
+
+  uint8_t *values;
+
+  int *bbs_a;
+  void **kps_a;
+  int *khs_a;
+  int *chns_a;
+  int *inds_a;
+  map_keys_equality *eq_a;
+  map_key_hash *hsh_a;
+
+  int *bbs_b;
+  void **kps_b;
+  int *khs_b;
+  int *chns_b;
+  int *inds_b;
+  map_keys_equality *eq_b;
+  map_key_hash *hsh_b;
+
+  dmap_extract_keys *exk;
+  dmap_pack_keys *pk;
+
+  int n_vals;
+  int capacity;
+};
+
+#endif //_DOUBLE_MAP_LAYOUT_H_INCLUDED_
@@ -0,0 +1,213 @@
+// Template (see specialize.h): the DoubleMap functions for one value type
+// and its two key types, as <DMAP_SPEC_NAME>_dmap_get_a etc.
+//
+// DMAP_SPEC_NAME          prefix of the functions
+// DMAP_SPEC_KEY_A_T       type of key A
+// DMAP_SPEC_KEY_A_EQ      bool (DMAP_SPEC_KEY_A_T *, DMAP_SPEC_KEY_A_T *)
+// DMAP_SPEC_KEY_A_HASH    int (DMAP_SPEC_KEY_A_T *)
+// DMAP_SPEC_KEY_B_T, DMAP_SPEC_KEY_B_EQ, DMAP_SPEC_KEY_B_HASH  the same for B
+// DMAP_SPEC_VALUE_T       value type; its size must be the value_size given
+//                         to dmap_allocate
+// DMAP_SPEC_VALUE_COPY    void (DMAP_SPEC_VALUE_T *dst, DMAP_SPEC_VALUE_T *src)
+// DMAP_SPEC_VALUE_DESTR   void (DMAP_SPEC_VALUE_T *)
+// DMAP_SPEC_EXTRACT_KEYS  void (DMAP_SPEC_VALUE_T *, DMAP_SPEC_KEY_A_T **,
+//                               DMAP_SPEC_KEY_B_T **)
+// DMAP_SPEC_PACK_KEYS     void (DMAP_SPEC_VALUE_T *, DMAP_SPEC_KEY_A_T *,
+//                               DMAP_SPEC_KEY_B_T *)
+// Each is the inlinable version of the function given to dmap_allocate.
+//
+// <DMAP_SPEC_NAME>_dmap_hash_a and _b hash a key once for a packet, for
+// <DMAP_SPEC_NAME>_dmap_get_a_with_hash and _b_with_hash, as the map
+// template does (map-specialized.h).
+
+#include "double-map.h"
+#include "specialize.h"
+
+#define DMAP_SPEC_FN(fn) SPEC_CONCAT(DMAP_SPEC_NAME, fn)
+
+#ifdef CONTAINERS_SPECIALIZED
+
+#include "double-map-layout.h"
+
+#define MAP_IMPL_SPEC_NAME SPEC_CONCAT(DMAP_SPEC_NAME, a)
+#define MAP_IMPL_SPEC_KEY_T DMAP_SPEC_KEY_A_T
+#define MAP_IMPL_SPEC_KEY_EQ DMAP_SPEC_KEY_A_EQ
+#include "map-impl-specialized.h"
+
+#define MAP_IMPL_SPEC_NAME SPEC_CONCAT(DMAP_SPEC_NAME, b)
+#define MAP_IMPL_SPEC_KEY_T DMAP_SPEC_KEY_B_T
+#define MAP_IMPL_SPEC_KEY_EQ DMAP_SPEC_KEY_B_EQ
+#include "map-impl-specialized.h"
+
+#define DMAP_SPEC_FN_A(fn) DMAP_SPEC_FN(SPEC_CONCAT(a, fn))
+#define DMAP_SPEC_FN_B(fn) DMAP_SPEC_FN(SPEC_CONCAT(b, fn))
+
+static inline int DMAP_SPEC_FN(dmap_hash_a)(DMAP_SPEC_KEY_A_T *key) {
+  return DMAP_SPEC_KEY_A_HASH(key);
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_a_with_hash)(struct DoubleMap *map,
+                                                     DMAP_SPEC_KEY_A_T *key,
+                                                     int hash, int *index) {
+  return DMAP_SPEC_FN_A(map_impl_get)(map->bbs_a, map->kps_a, map->khs_a,
+                                      map->chns_a, map->inds_a, key, hash,
+                                      index, map->capacity);
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_a)(struct DoubleMap *map,
+                                           DMAP_SPEC_KEY_A_T *key,
+                                           int *index) {
+  return DMAP_SPEC_FN(dmap_get_a_with_hash)(map, key,
+                                            DMAP_SPEC_KEY_A_HASH(key), index);
+}
+
+static inline int DMAP_SPEC_FN(dmap_hash_b)(DMAP_SPEC_KEY_B_T *key) {
+  return DMAP_SPEC_KEY_B_HASH(key);
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_b_with_hash)(struct DoubleMap *map,
+                                                     DMAP_SPEC_KEY_B_T *key,
+                                                     int hash, int *index) {
+  return DMAP_SPEC_FN_B(map_impl_get)(map->bbs_b, map->kps_b, map->khs_b,
+                                      map->chns_b, map->inds_b, key, hash,
+                                      index, map->capacity);
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_b)(struct DoubleMap *map,
+                                           DMAP_SPEC_KEY_B_T *key,
+                                           int *index) {
+  return DMAP_SPEC_FN(dmap_get_b_with_hash)(map, key,
+                                            DMAP_SPEC_KEY_B_HASH(key), index);
+}
+
+static inline int DMAP_SPEC_FN(dmap_put)(struct DoubleMap *map,
+                                         DMAP_SPEC_VALUE_T *value, int index) {
+  DMAP_SPEC_KEY_A_T *key_a = 0;
+  DMAP_SPEC_KEY_B_T *key_b = 0;
+  DMAP_SPEC_VALUE_T *my_value = (DMAP_SPEC_VALUE_T *)map->values + index;
+  DMAP_SPEC_VALUE_COPY(my_value, value);
+  DMAP_SPEC_EXTRACT_KEYS(my_value, &key_a, &key_b);
+  DMAP_SPEC_FN_A(map_impl_put)(map->bbs_a, map->kps_a, map->khs_a,
+                               map->chns_a, map->inds_a, key_a,
+                               DMAP_SPEC_KEY_A_HASH(key_a), index,
+                               map->capacity);
+  DMAP_SPEC_FN_B(map_impl_put)(map->bbs_b, map->kps_b, map->khs_b,
+                               map->chns_b, map->inds_b, key_b,
+                               DMAP_SPEC_KEY_B_HASH(key_b), index,
+                               map->capacity);
+  ++map->n_vals;
+  DMAP_SPEC_PACK_KEYS(my_value, key_a, key_b);
+  return 1;
+}
+
+static inline void DMAP_SPEC_FN(dmap_get_value)(struct DoubleMap *map,
+                                                int index,
+                                                DMAP_SPEC_VALUE_T *value_out) {
+  DMAP_SPEC_VALUE_COPY(value_out, (DMAP_SPEC_VALUE_T *)map->values + index);
+}
+
+static inline int DMAP_SPEC_FN(dmap_erase)(struct DoubleMap *map, int index) {
+  DMAP_SPEC_KEY_A_T *key_a = 0;
+  DMAP_SPEC_KEY_B_T *key_b = 0;
+  void *out_key_a = 0;
+  void *out_key_b = 0;
+  DMAP_SPEC_VALUE_T *my_value = (DMAP_SPEC_VALUE_T *)map->values + index;
+  DMAP_SPEC_EXTRACT_KEYS(my_value, &key_a, &key_b);
+  DMAP_SPEC_FN_A(map_impl_erase)(map->bbs_a, map->kps_a, map->khs_a,
+                                 map->chns_a, key_a,
+                                 DMAP_SPEC_KEY_A_HASH(key_a), map->capacity,
+                                 &out_key_a);
+  DMAP_SPEC_FN_B(map_impl_erase)(map->bbs_b, map->kps_b, map->khs_b,
+                                 map->chns_b, key_b,
+                                 DMAP_SPEC_KEY_B_HASH(key_b), map->capacity,
+                                 &out_key_b);
+  DMAP_SPEC_PACK_KEYS(my_value, key_a, key_b);
+  DMAP_SPEC_PACK_KEYS(my_value, out_key_a, out_key_b);
+  DMAP_SPEC_VALUE_DESTR(my_value);
+  --map->n_vals;
+  return 1;
+}
+
+#undef DMAP_SPEC_FN_A
+#undef DMAP_SPEC_FN_B
+
+#else // CONTAINERS_SPECIALIZED
+
+static inline int DMAP_SPEC_FN(dmap_hash_a)(DMAP_SPEC_KEY_A_T *key) {
+#ifdef KLEE_VERIFICATION
+  return 0;
+#else  // KLEE_VERIFICATION
+  return DMAP_SPEC_KEY_A_HASH(key);
+#endif // KLEE_VERIFICATION
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_a_with_hash)(struct DoubleMap *map,
+                                                     DMAP_SPEC_KEY_A_T *key,
+                                                     int hash, int *index) {
+#ifdef KLEE_VERIFICATION
+  return dmap_get_a(map, key, index);
+#else  // KLEE_VERIFICATION
+  return dmap_get_a_with_hash(map, key, hash, index);
+#endif // KLEE_VERIFICATION
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_a)(struct DoubleMap *map,
+                                           DMAP_SPEC_KEY_A_T *key,
+                                           int *index) {
+  return dmap_get_a(map, key, index);
+}
+
+static inline int DMAP_SPEC_FN(dmap_hash_b)(DMAP_SPEC_KEY_B_T *key) {
+#ifdef KLEE_VERIFICATION
+  return 0;
+#else  // KLEE_VERIFICATION
+  return DMAP_SPEC_KEY_B_HASH(key);
+#endif // KLEE_VERIFICATION
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_b_with_hash)(struct DoubleMap *map,
+                                                     DMAP_SPEC_KEY_B_T *key,
+                                                     int hash, int *index) {
+#ifdef KLEE_VERIFICATION
+  return dmap_get_b(map, key, index);
+#else  // KLEE_VERIFICATION
+  return dmap_get_b_with_hash(map, key, hash, index);
+#endif // KLEE_VERIFICATION
+}
+
+static inline int DMAP_SPEC_FN(dmap_get_b)(struct DoubleMap *map,
+                                           DMAP_SPEC_KEY_B_T *key,
+                                           int *index) {
+  return dmap_get_b(map, key, index);
+}
+
+static inline int DMAP_SPEC_FN(dmap_put)(struct DoubleMap *map,
+                                         DMAP_SPEC_VALUE_T *value, int index) {
+  return dmap_put(map, value, index);
+}
+
+static inline void DMAP_SPEC_FN(dmap_get_value)(struct DoubleMap *map,
+                                                int index,
+                                                DMAP_SPEC_VALUE_T *value_out) {
+  dmap_get_value(map, index, value_out);
+}
+
+static inline int DMAP_SPEC_FN(dmap_erase)(struct DoubleMap *map, int index) {
+  return dmap_erase(map, index);
+}
+
+#endif // CONTAINERS_SPECIALIZED
+
+#undef DMAP_SPEC_FN
+#undef DMAP_SPEC_NAME
+#undef DMAP_SPEC_KEY_A_T
+#undef DMAP_SPEC_KEY_A_EQ
+#undef DMAP_SPEC_KEY_A_HASH
+#undef DMAP_SPEC_KEY_B_T
+#undef DMAP_SPEC_KEY_B_EQ
+#undef DMAP_SPEC_KEY_B_HASH
+#undef DMAP_SPEC_VALUE_T
+#undef DMAP_SPEC_VALUE_COPY
+#undef DMAP_SPEC_VALUE_DESTR
+#undef DMAP_SPEC_EXTRACT_KEYS
+#undef DMAP_SPEC_PACK_KEYS
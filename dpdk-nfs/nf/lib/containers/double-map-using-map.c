@@ -94,6 +94,18 @@ dmap_get_b(struct DoubleMap* dmap, void* key, int* index)
 	return map_get(dmap->second, key, index);
 }
 
+int
+dmap_get_a_with_hash(struct DoubleMap* dmap, void* key, int hash, int* index)
+{
+	return map_get_with_hash(dmap->first, key, hash, index);
+}
+
+int
+dmap_get_b_with_hash(struct DoubleMap* dmap, void* key, int hash, int* index)
+{
+	return map_get_with_hash(dmap->second, key, hash, index);
+}
+
 void
 dmap_get_value(struct DoubleMap* dmap, int index, void* value_out)
 {
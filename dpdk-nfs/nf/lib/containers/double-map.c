@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "double-map.h"
+#include "double-map-layout.h"
 
 #ifdef DUMP_PERF_VARS
 #include "lib/nf_log.h"
@@ -9,38 +10,6 @@
 
 //@ #include "arith.gh"
 
-struct DoubleMap
-{
-  int value_size;
-
-  uq_value_copy *cpy;
-  uq_value_destr *dstr;
-
-  uint8_t *values;
-
-  int *bbs_a;
-  void **kps_a;
-  int *khs_a;
-  int *chns_a;
-  int *inds_a;
-  map_keys_equality *eq_a;
-  map_key_hash *hsh_a;
-
-  int *bbs_b;
-  void **kps_b;
-  int *khs_b;
-  int *chns_b;
-  int *inds_b;
-  map_keys_equality *eq_b;
-  map_key_hash *hsh_b;
-
-  dmap_extract_keys *exk;
-  dmap_pack_keys *pk;
-
-  int n_vals;
-  int capacity;
-};
-
 /*@
   predicate valsp<t1,t2,vt>(void* values, int val_size,
                             predicate (void*,vt) fvp,
@@ -608,6 +577,87 @@ int dmap_get_b /*@ <K1,K2,V> @*/ (struct DoubleMap *map, void *key, int *index)
                       fvp, bvp, rof, vsz, vk1, vk2, rp1, rp2, map); @*/
 }
 
+int dmap_get_a_with_hash /*@ <K1,K2,V> @*/ (struct DoubleMap *map, void *key,
+                                            int hash, int *index)
+/*@ requires dmappingp<K1,K2,V>(?m, ?kp1, ?kp2, ?hsh1, ?hsh2,
+                                ?fvp, ?bvp, ?rof, ?vsz,
+                                ?vk1, ?vk2, ?rp1, ?rp2, map) &*&
+             kp1(key, ?k1) &*&
+             hash == hsh1(k1) &*&
+             *index |-> ?i; @*/
+/*@ ensures dmappingp<K1,K2,V>(m, kp1, kp2, hsh1, hsh2,
+                               fvp, bvp, rof, vsz,
+                               vk1, vk2, rp1, rp2, map) &*&
+            kp1(key, k1) &*&
+            (dmap_has_k1_fp(m, k1) ?
+             (result == 1 &*&
+              *index |-> ?ind &*&
+              ind == dmap_get_k1_fp(m, k1) &*&
+              true == rp1(k1, ind)) :
+             (result == 0 &*& *index |-> i)); @*/
+{
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_a";
+#endif
+
+  /*@ open dmappingp(m, kp1, kp2, hsh1, hsh2,
+                     fvp, bvp, rof, vsz, vk1, vk2, rp1, rp2, map); @*/
+  int rez = map_impl_get(map->bbs_a, map->kps_a, map->khs_a, map->chns_a,
+                         map->inds_a, key,
+                         map->eq_a, hash, index,
+                         map->capacity);
+  /*@ close dmappingp(m, kp1, kp2, hsh1, hsh2,
+                      fvp, bvp, rof, vsz, vk1, vk2, rp1, rp2, map); @*/
+  return rez;
+}
+
+int dmap_get_b_with_hash /*@ <K1,K2,V> @*/ (struct DoubleMap *map, void *key,
+                                            int hash, int *index)
+/*@ requires dmappingp<K1,K2,V>(?m, ?kp1, ?kp2, ?hsh1, ?hsh2,
+                                ?fvp, ?bvp, ?rof, ?vsz,
+                                ?vk1, ?vk2, ?rp1, ?rp2, map) &*&
+             kp2(key, ?k2) &*&
+             hash == hsh2(k2) &*&
+             *index |-> ?i; @*/
+/*@ ensures dmappingp<K1,K2,V>(m, kp1, kp2, hsh1, hsh2,
+                               fvp, bvp, rof, vsz,
+                               vk1, vk2, rp1, rp2, map) &*&
+            kp2(key, k2) &*&
+            (dmap_has_k2_fp(m, k2) ?
+             (result == 1 &*&
+              *index |-> ?ind &*&
+              ind == dmap_get_k2_fp(m, k2) &*&
+              true == rp2(k2, ind)) :
+             (result == 0 &*& *index |-> i)); @*/
+{
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_b";
+#endif
+
+  /*@ open dmappingp(m, kp1, kp2, hsh1, hsh2,
+                     fvp, bvp, rof, vsz, vk1, vk2, rp1, rp2, map); @*/
+  //@ int* bbs1 = map->bbs_a;
+  //@ void** kps1 = map->kps_a;
+  //@ int* khs1 = map->khs_a;
+  //@ int* chns1 = map->chns_a;
+  //@ int* vals1 = map->inds_a;
+  /*@ assert mapping(?m1, ?addrs1, kp1, rp1, hsh1, ?cap,
+                     bbs1, kps1, khs1, chns1, vals1);
+    @*/
+  /*@ close hide_mapping(m1, addrs1, kp1, rp1, hsh1, cap,
+                         bbs1, kps1, khs1, chns1, vals1);
+    @*/
+  return map_impl_get(map->bbs_b, map->kps_b, map->khs_b, map->chns_b,
+                      map->inds_b, key,
+                      map->eq_b, hash, index,
+                      map->capacity);
+  //@ open hide_mapping(_, _, _, _, _, _, _, _, _, _, _);
+  /*@ close dmappingp(m, kp1, kp2, hsh1, hsh2,
+                      fvp, bvp, rof, vsz, vk1, vk2, rp1, rp2, map); @*/
+}
+
 /*@
   lemma void extract_value<t1,t2,vt>(void* values, list<option<vt> > vals, int i)
   requires valsp<t1,t2,vt>(values, ?vsz, ?fvp, ?bvp, ?addrs1, ?addrs2,
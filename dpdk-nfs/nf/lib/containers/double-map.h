@@ -637,6 +637,51 @@ int dmap_get_b /*@ <K1,K2,V> @*/ (struct DoubleMap *map, void *key, int *index);
               true == rp2(k2, ind)) :
              (result == 0 &*& *index |-> i)); @*/
 
+/**
+   dmap_get_a and dmap_get_b for a caller that already has the hash of the
+   key, e.g. because it needs it for something else too.
+
+   @param hash - the hash of the key, by the hash function of that key given
+                 to dmap_allocate.
+*/
+int dmap_get_a_with_hash /*@ <K1,K2,V> @*/ (struct DoubleMap *map, void *key,
+                                            int hash, int *index);
+/*@ requires dmappingp<K1,K2,V>(?m, ?kp1, ?kp2, ?hsh1, ?hsh2,
+                                ?fvp, ?bvp, ?rof, ?vsz,
+                                ?vk1, ?vk2, ?rp1, ?rp2, map) &*&
+             kp1(key, ?k1) &*&
+             hash == hsh1(k1) &*&
+             *index |-> ?i; @*/
+/*@ ensures dmappingp<K1,K2,V>(m, kp1, kp2, hsh1, hsh2,
+                               fvp, bvp, rof, vsz,
+                               vk1, vk2, rp1, rp2, map) &*&
+            kp1(key, k1) &*&
+            (dmap_has_k1_fp(m, k1) ?
+             (result == 1 &*&
+              *index |-> ?ind &*&
+              ind == dmap_get_k1_fp(m, k1) &*&
+              true == rp1(k1, ind)) :
+             (result == 0 &*& *index |-> i)); @*/
+
+int dmap_get_b_with_hash /*@ <K1,K2,V> @*/ (struct DoubleMap *map, void *key,
+                                            int hash, int *index);
+/*@ requires dmappingp<K1,K2,V>(?m, ?kp1, ?kp2, ?hsh1, ?hsh2,
+                                ?fvp, ?bvp, ?rof, ?vsz,
+                                ?vk1, ?vk2, ?rp1, ?rp2, map) &*&
+             kp2(key, ?k2) &*&
+             hash == hsh2(k2) &*&
+             *index |-> ?i; @*/
+/*@ ensures dmappingp<K1,K2,V>(m, kp1, kp2, hsh1, hsh2,
+                               fvp, bvp, rof, vsz,
+                               vk1, vk2, rp1, rp2, map) &*&
+            kp2(key, k2) &*&
+            (dmap_has_k2_fp(m, k2) ?
+             (result == 1 &*&
+              *index |-> ?ind &*&
+              ind == dmap_get_k2_fp(m, k2) &*&
+              true == rp2(k2, ind)) :
+             (result == 0 &*& *index |-> i)); @*/
+
 /**
    Add entry to the map. Use the internal index 'index'. The index must be
    uinque for this map for this moment, use an allocator to ensure that (See
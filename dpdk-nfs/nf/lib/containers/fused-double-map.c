@@ -0,0 +1,309 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "double-map.h"
+#include "specialize.h"
+
+// The specialized double maps (double-map-specialized.h) read the struct
+// DoubleMap of double-map-layout.h, not this one
+#ifdef CONTAINERS_SPECIALIZED
+#error "fused-double-map.c cannot be built with SPECIALIZE_CONTAINERS"
+#endif
+
+#ifdef DUMP_PERF_VARS
+#include "lib/nf_log.h"
+#endif
+
+// DoubleMap with one record per bucket instead of the five parallel arrays
+// (busybits, key pointers, key hashes, chains, indexes) of each map-impl
+// table in double-map.c. A bucket is its key hash, its chain counter and the
+// value index; the key itself is read from the value, at the offset
+// dmap_extract_keys gives at allocation. Every value is stored together with
+// its two hashes and the buckets its keys went to, so dmap_erase goes
+// straight to both buckets, without hashing or comparing keys.
+//
+// dmap_put touches the value and one bucket per key (plus the buckets probed
+// before), where double-map.c touches the value and five arrays per key.
+//
+// The keys must be fields of the value, at the same offsets in every value
+// (dmap_extract_keys only computes their addresses), and dmap_pack_keys must
+// have nothing to undo; both hold for all the NFs here, and are not called
+// after allocation. The capacity is a power of 2, as for double-map.c.
+
+struct dmap_bucket {
+  int hash;  // of the key here, when index != -1
+  int chain; // keys that probed past this bucket
+  int index; // of the value, -1 if the bucket is free
+};
+
+// In front of every value
+struct dmap_entry {
+  int hash_a;
+  int hash_b;
+  int bucket_a;
+  int bucket_b;
+};
+
+struct DoubleMap {
+  int value_size;
+  // dmap_entry + value, rounded up to keep the entries aligned
+  int stride;
+  int capacity;
+  int n_vals;
+
+  uint8_t *entries;
+  struct dmap_bucket *buckets_a;
+  struct dmap_bucket *buckets_b;
+
+  int key_a_offset;
+  int key_b_offset;
+
+  map_keys_equality *eq_a;
+  map_key_hash *hsh_a;
+  map_keys_equality *eq_b;
+  map_key_hash *hsh_b;
+
+  uq_value_copy *cpy;
+  uq_value_destr *dstr;
+};
+
+static int loop(int k, int capacity) { return k & (capacity - 1); }
+
+static struct dmap_entry *dmap_entry(struct DoubleMap *map, int index) {
+  return (struct dmap_entry *)(map->entries + (size_t)index * map->stride);
+}
+
+static uint8_t *dmap_value(struct DoubleMap *map, int index) {
+  return (uint8_t *)(dmap_entry(map, index) + 1);
+}
+
+static int find_key(struct DoubleMap *map, struct dmap_bucket *buckets,
+                    int key_offset, map_keys_equality *eq, void *key,
+                    int hash) {
+#ifdef DUMP_PERF_VARS
+  int buckets_traversed = 0;
+  int hash_collisions = 0;
+#endif
+  int start = loop(hash, map->capacity);
+  int result = -1;
+  for (int i = 0; i < map->capacity; ++i) {
+#ifdef DUMP_PERF_VARS
+    buckets_traversed++;
+#endif
+    struct dmap_bucket *b = &buckets[loop(start + i, map->capacity)];
+    if (b->index != -1 && b->hash == hash) {
+      if (eq(dmap_value(map, b->index) + key_offset, key)) {
+        result = b->index;
+        break;
+      }
+#ifdef DUMP_PERF_VARS
+      hash_collisions++;
+#endif
+    } else if (b->chain == 0) {
+      break;
+    }
+  }
+#ifdef DUMP_PERF_VARS
+  NF_PERF_DEBUG("t:%d", buckets_traversed);
+  NF_PERF_DEBUG("c:%d", hash_collisions);
+#endif
+  return result;
+}
+
+// Returns the bucket the index went to
+static int insert(struct dmap_bucket *buckets, int hash, int index,
+                  int capacity) {
+#ifdef DUMP_PERF_VARS
+  int buckets_traversed = 0;
+#endif
+  int start = loop(hash, capacity);
+  for (int i = 0; i < capacity; ++i) {
+#ifdef DUMP_PERF_VARS
+    buckets_traversed++;
+#endif
+    int bucket = loop(start + i, capacity);
+    struct dmap_bucket *b = &buckets[bucket];
+    if (b->index == -1) {
+      b->hash = hash;
+      b->index = index;
+#ifdef DUMP_PERF_VARS
+      NF_PERF_DEBUG("t:%d", buckets_traversed);
+#endif
+      return bucket;
+    }
+    b->chain++;
+  }
+  // The tables have a bucket per value index
+  abort();
+}
+
+static void remove_bucket(struct dmap_bucket *buckets, int hash, int bucket,
+                          int capacity) {
+#ifdef DUMP_PERF_VARS
+  int buckets_traversed = 1;
+#endif
+  for (int i = loop(hash, capacity); i != bucket; i = loop(i + 1, capacity)) {
+#ifdef DUMP_PERF_VARS
+    buckets_traversed++;
+#endif
+    buckets[i].chain--;
+  }
+  buckets[bucket].index = -1;
+#ifdef DUMP_PERF_VARS
+  NF_PERF_DEBUG("t:%d", buckets_traversed);
+  NF_PERF_DEBUG("c:%d", 0);
+#endif
+}
+
+static void init_buckets(struct dmap_bucket *buckets, int capacity) {
+  for (int i = 0; i < capacity; ++i) {
+    buckets[i].chain = 0;
+    buckets[i].index = -1;
+  }
+}
+
+int dmap_allocate(map_keys_equality *eq_a, map_key_hash *hsh_a,
+                  map_keys_equality *eq_b, map_key_hash *hsh_b,
+                  int value_size, uq_value_copy *v_cpy,
+                  uq_value_destr *v_destr, dmap_extract_keys *dexk,
+                  dmap_pack_keys *dpk, int capacity,
+                  struct DoubleMap **map_out) {
+  struct DoubleMap *map = malloc(sizeof(struct DoubleMap));
+  if (map == NULL) {
+    return 0;
+  }
+  int align = sizeof(struct dmap_entry);
+  map->stride = (sizeof(struct dmap_entry) + value_size + align - 1) /
+                align * align;
+  map->entries = malloc((size_t)map->stride * capacity);
+  map->buckets_a = malloc(sizeof(struct dmap_bucket) * capacity);
+  map->buckets_b = malloc(sizeof(struct dmap_bucket) * capacity);
+  if (map->entries == NULL || map->buckets_a == NULL ||
+      map->buckets_b == NULL) {
+    goto fail;
+  }
+
+  // The key offsets, from the first value
+  void *key_a = NULL;
+  void *key_b = NULL;
+  uint8_t *value = dmap_value(map, 0);
+  dexk(value, &key_a, &key_b);
+  dpk(value, key_a, key_b);
+  map->key_a_offset = (uint8_t *)key_a - value;
+  map->key_b_offset = (uint8_t *)key_b - value;
+  if (map->key_a_offset < 0 || map->key_a_offset >= value_size ||
+      map->key_b_offset < 0 || map->key_b_offset >= value_size) {
+    // The keys are not part of the value
+    goto fail;
+  }
+
+  map->value_size = value_size;
+  map->capacity = capacity;
+  map->n_vals = 0;
+  map->eq_a = eq_a;
+  map->hsh_a = hsh_a;
+  map->eq_b = eq_b;
+  map->hsh_b = hsh_b;
+  map->cpy = v_cpy;
+  map->dstr = v_destr;
+  init_buckets(map->buckets_a, capacity);
+  init_buckets(map->buckets_b, capacity);
+
+  *map_out = map;
+  return 1;
+
+fail:
+  free(map->buckets_b);
+  free(map->buckets_a);
+  free(map->entries);
+  free(map);
+  return 0;
+}
+
+int dmap_get_a(struct DoubleMap *map, void *key, int *index) {
+  return dmap_get_a_with_hash(map, key, map->hsh_a(key), index);
+}
+
+int dmap_get_a_with_hash(struct DoubleMap *map, void *key, int hash,
+                          int *index) {
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_a";
+#endif
+  int found = find_key(map, map->buckets_a, map->key_a_offset, map->eq_a,
+                       key, hash);
+  if (found == -1) {
+    return 0;
+  }
+  *index = found;
+  return 1;
+}
+
+int dmap_get_b(struct DoubleMap *map, void *key, int *index) {
+  return dmap_get_b_with_hash(map, key, map->hsh_b(key), index);
+}
+
+int dmap_get_b_with_hash(struct DoubleMap *map, void *key, int hash,
+                          int *index) {
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_b";
+#endif
+  int found = find_key(map, map->buckets_b, map->key_b_offset, map->eq_b,
+                       key, hash);
+  if (found == -1) {
+    return 0;
+  }
+  *index = found;
+  return 1;
+}
+
+int dmap_put(struct DoubleMap *map, void *value, int index) {
+  struct dmap_entry *entry = dmap_entry(map, index);
+  uint8_t *my_value = dmap_value(map, index);
+  map->cpy((char *)my_value, value);
+
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_a";
+#endif
+  entry->hash_a = map->hsh_a(my_value + map->key_a_offset);
+  entry->bucket_a = insert(map->buckets_a, entry->hash_a, index,
+                           map->capacity);
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_b";
+#endif
+  entry->hash_b = map->hsh_b(my_value + map->key_b_offset);
+  entry->bucket_b = insert(map->buckets_b, entry->hash_b, index,
+                           map->capacity);
+
+  ++map->n_vals;
+  return 1;
+}
+
+void dmap_get_value(struct DoubleMap *map, int index, void *value_out) {
+  map->cpy(value_out, dmap_value(map, index));
+}
+
+int dmap_erase(struct DoubleMap *map, int index) {
+  struct dmap_entry *entry = dmap_entry(map, index);
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_a";
+#endif
+  remove_bucket(map->buckets_a, entry->hash_a, entry->bucket_a,
+                map->capacity);
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "dmap_";
+  perf_dump_suffix = "_b";
+#endif
+  remove_bucket(map->buckets_b, entry->hash_b, entry->bucket_b,
+                map->capacity);
+
+  map->dstr(dmap_value(map, index));
+  --map->n_vals;
+  return 1;
+}
+
+int dmap_size(struct DoubleMap *map) { return map->n_vals; }
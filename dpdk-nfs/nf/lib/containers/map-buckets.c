@@ -204,3 +204,16 @@ map_size(struct Map* map)
 {
 	return map->size;
 }
+
+// Recomputes the hash, the buckets are found through map_get_node
+int
+map_get_with_hash(struct Map* map, void* key, int hash, int* value_out)
+{
+	return map_get(map, key, value_out);
+}
+
+void
+map_put_with_hash(struct Map* map, void* key, int hash, int value)
+{
+	map_put(map, key, value);
+}
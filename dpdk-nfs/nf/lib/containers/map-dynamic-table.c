@@ -98,6 +98,11 @@ void map_put(struct Map *map, void *key, int value) {
   }
 }
 
+// Resizing rehashes every key anyway
+void map_put_with_hash(struct Map *map, void *key, int hash, int value) {
+  map_put(map, key, value);
+}
+
 void map_erase(struct Map *map, void *key, void **trash) {
   assert(map && map->table && key);
 
@@ -118,9 +123,13 @@ void map_erase(struct Map *map, void *key, void **trash) {
 }
 
 int map_get(struct Map *map, void *key, int *value_out) {
+  return map_get_with_hash(map, key, map->khash(key), value_out);
+}
+
+int map_get_with_hash(struct Map *map, void *key, int hash, int *value_out) {
   assert(map && map->table && key && value_out);
 
-  int bucket = map->khash(key) &( map->size-1);
+  int bucket = hash &( map->size-1);
 
   for (struct Mapping *mapping = map->table[bucket]; mapping;
        mapping = mapping->next) {
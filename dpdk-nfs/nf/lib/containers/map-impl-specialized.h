@@ -0,0 +1,106 @@
+// Template (see specialize.h): the map-impl.c functions for one key type,
+// with the key equality inlined. Used by map-specialized.h and
+// double-map-specialized.h.
+//
+// MAP_IMPL_SPEC_NAME    prefix of the functions
+// MAP_IMPL_SPEC_KEY_T   key type
+// MAP_IMPL_SPEC_KEY_EQ  bool (MAP_IMPL_SPEC_KEY_T *, MAP_IMPL_SPEC_KEY_T *)
+
+#include "specialize.h"
+
+#ifdef CONTAINERS_SPECIALIZED
+
+#define MAP_IMPL_SPEC_FN(fn) SPEC_CONCAT(MAP_IMPL_SPEC_NAME, fn)
+
+#ifndef _MAP_IMPL_SPEC_LOOP_DEFINED_
+#define _MAP_IMPL_SPEC_LOOP_DEFINED_
+static inline int map_impl_spec_loop(int k, int capacity) {
+  int g = k & (capacity - 1);
+  return (g + capacity) & (capacity - 1);
+}
+#endif //_MAP_IMPL_SPEC_LOOP_DEFINED_
+
+static inline int MAP_IMPL_SPEC_FN(find_key)(int *busybits, void **keyps,
+                                             int *k_hashes, int *chns,
+                                             MAP_IMPL_SPEC_KEY_T *keyp,
+                                             int key_hash, int capacity) {
+  int start = map_impl_spec_loop(key_hash, capacity);
+  for (int i = 0; i < capacity; ++i) {
+    int index = map_impl_spec_loop(start + i, capacity);
+    if (busybits[index] != 0 && k_hashes[index] == key_hash) {
+      if (MAP_IMPL_SPEC_KEY_EQ(keyps[index], keyp)) {
+        return index;
+      }
+    } else if (chns[index] == 0) {
+      return -1;
+    }
+  }
+  return -1;
+}
+
+static inline int MAP_IMPL_SPEC_FN(find_key_remove_chain)(
+    int *busybits, void **keyps, int *k_hashes, int *chns,
+    MAP_IMPL_SPEC_KEY_T *keyp, int key_hash, int capacity, void **keyp_out) {
+  int start = map_impl_spec_loop(key_hash, capacity);
+  for (int i = 0; i < capacity; ++i) {
+    int index = map_impl_spec_loop(start + i, capacity);
+    if (busybits[index] != 0 && k_hashes[index] == key_hash &&
+        MAP_IMPL_SPEC_KEY_EQ(keyps[index], keyp)) {
+      busybits[index] = 0;
+      *keyp_out = keyps[index];
+      return index;
+    }
+    chns[index]--;
+  }
+  return -1;
+}
+
+static inline int MAP_IMPL_SPEC_FN(find_empty)(int *busybits, int *chns,
+                                               int start, int capacity) {
+  for (int i = 0; i < capacity; ++i) {
+    int index = map_impl_spec_loop(start + i, capacity);
+    if (busybits[index] == 0) {
+      return index;
+    }
+    chns[index]++;
+  }
+  return -1;
+}
+
+static inline int MAP_IMPL_SPEC_FN(map_impl_get)(
+    int *busybits, void **keyps, int *k_hashes, int *chns, int *values,
+    MAP_IMPL_SPEC_KEY_T *keyp, int hash, int *value, int capacity) {
+  int index = MAP_IMPL_SPEC_FN(find_key)(busybits, keyps, k_hashes, chns,
+                                         keyp, hash, capacity);
+  if (index == -1) {
+    return 0;
+  }
+  *value = values[index];
+  return 1;
+}
+
+static inline void MAP_IMPL_SPEC_FN(map_impl_put)(
+    int *busybits, void **keyps, int *k_hashes, int *chns, int *values,
+    MAP_IMPL_SPEC_KEY_T *keyp, int hash, int value, int capacity) {
+  int start = map_impl_spec_loop(hash, capacity);
+  int index = MAP_IMPL_SPEC_FN(find_empty)(busybits, chns, start, capacity);
+  busybits[index] = 1;
+  keyps[index] = keyp;
+  k_hashes[index] = hash;
+  values[index] = value;
+}
+
+static inline void MAP_IMPL_SPEC_FN(map_impl_erase)(
+    int *busybits, void **keyps, int *k_hashes, int *chns,
+    MAP_IMPL_SPEC_KEY_T *keyp, int hash, int capacity, void **keyp_out) {
+  MAP_IMPL_SPEC_FN(find_key_remove_chain)(busybits, keyps, k_hashes, chns,
+                                          keyp, hash, capacity, keyp_out);
+}
+
+#undef MAP_IMPL_SPEC_FN
+
+#endif // CONTAINERS_SPECIALIZED
+
+#undef MAP_IMPL_SPEC_NAME
+#undef MAP_IMPL_SPEC_KEY_T
+#undef MAP_IMPL_SPEC_KEY_EQ
@@ -0,0 +1,20 @@
+#ifndef _MAP_LAYOUT_H_INCLUDED_
+#define _MAP_LAYOUT_H_INCLUDED_
+
+#include "map-impl.h"
+#include "map-util.h"
+
+// Shared by map.c and the specialized maps (map-specialized.h)
+struct Map {
+  int *busybits;
+  void **keyps;
+  int *khs;
+  int *chns;
+  int *vals;
+  int capacity; // Must be a power of 2
+  int size;
+  map_keys_equality *keys_eq;
+  map_key_hash *khash;
+};
+
+#endif //_MAP_LAYOUT_H_INCLUDED_
@@ -72,3 +72,16 @@ map_get(struct Map* map, void* key, int* value_out)
 	}
 	return 0;
 }
+
+// The Ruby table hashes the key itself
+int
+map_get_with_hash(struct Map* map, void* key, int hash, int* value_out)
+{
+	return map_get(map, key, value_out);
+}
+
+void
+map_put_with_hash(struct Map* map, void* key, int hash, int value)
+{
+	map_put(map, key, value);
+}
@@ -0,0 +1,121 @@
+// Template (see specialize.h): map_get, map_put and map_erase for one key
+// type, as <MAP_SPEC_NAME>_map_get etc.
+//
+// <MAP_SPEC_NAME>_map_hash hashes a key once for a packet, for
+// <MAP_SPEC_NAME>_map_get_with_hash and _map_put_with_hash and for any other
+// use the NF has for it. Under KLEE it is not computed (the map stubs do
+// not use it) and these call map_get and map_put, like the traces the
+// contracts describe.
+//
+// MAP_SPEC_NAME      prefix of the functions
+// MAP_SPEC_KEY_T     key type
+// MAP_SPEC_KEY_EQ    bool (MAP_SPEC_KEY_T *, MAP_SPEC_KEY_T *), the inlinable
+//                    version of the keq given to map_allocate
+// MAP_SPEC_KEY_HASH  int (MAP_SPEC_KEY_T *), the inlinable version of the
+//                    khash given to map_allocate
+
+#include "map.h"
+#include "specialize.h"
+
+#define MAP_SPEC_FN(fn) SPEC_CONCAT(MAP_SPEC_NAME, fn)
+
+#ifdef CONTAINERS_SPECIALIZED
+
+#include "map-layout.h"
+
+#define MAP_IMPL_SPEC_NAME MAP_SPEC_NAME
+#define MAP_IMPL_SPEC_KEY_T MAP_SPEC_KEY_T
+#define MAP_IMPL_SPEC_KEY_EQ MAP_SPEC_KEY_EQ
+#include "map-impl-specialized.h"
+
+static inline int MAP_SPEC_FN(map_hash)(MAP_SPEC_KEY_T *key) {
+  return MAP_SPEC_KEY_HASH(key);
+}
+
+static inline int MAP_SPEC_FN(map_get_with_hash)(struct Map *map,
+                                                 MAP_SPEC_KEY_T *key, int hash,
+                                                 int *value_out) {
+  return MAP_SPEC_FN(map_impl_get)(map->busybits, map->keyps, map->khs,
+                                   map->chns, map->vals, key, hash, value_out,
+                                   map->capacity);
+}
+
+static inline int MAP_SPEC_FN(map_get)(struct Map *map, MAP_SPEC_KEY_T *key,
+                                       int *value_out) {
+  return MAP_SPEC_FN(map_get_with_hash)(map, key, MAP_SPEC_KEY_HASH(key),
+                                        value_out);
+}
+
+static inline void MAP_SPEC_FN(map_put_with_hash)(struct Map *map,
+                                                  MAP_SPEC_KEY_T *key,
+                                                  int hash, int value) {
+  MAP_SPEC_FN(map_impl_put)(map->busybits, map->keyps, map->khs, map->chns,
+                            map->vals, key, hash, value, map->capacity);
+  ++map->size;
+}
+
+static inline void MAP_SPEC_FN(map_put)(struct Map *map, MAP_SPEC_KEY_T *key,
+                                        int value) {
+  MAP_SPEC_FN(map_put_with_hash)(map, key, MAP_SPEC_KEY_HASH(key), value);
+}
+
+static inline void MAP_SPEC_FN(map_erase)(struct Map *map, MAP_SPEC_KEY_T *key,
+                                          void **trash) {
+  int hash = MAP_SPEC_KEY_HASH(key);
+  MAP_SPEC_FN(map_impl_erase)(map->busybits, map->keyps, map->khs, map->chns,
+                              key, hash, map->capacity, trash);
+  --map->size;
+}
+
+#else // CONTAINERS_SPECIALIZED
+
+static inline int MAP_SPEC_FN(map_hash)(MAP_SPEC_KEY_T *key) {
+#ifdef KLEE_VERIFICATION
+  return 0;
+#else  // KLEE_VERIFICATION
+  return MAP_SPEC_KEY_HASH(key);
+#endif // KLEE_VERIFICATION
+}
+
+static inline int MAP_SPEC_FN(map_get_with_hash)(struct Map *map,
+                                                 MAP_SPEC_KEY_T *key, int hash,
+                                                 int *value_out) {
+#ifdef KLEE_VERIFICATION
+  return map_get(map, key, value_out);
+#else  // KLEE_VERIFICATION
+  return map_get_with_hash(map, key, hash, value_out);
+#endif // KLEE_VERIFICATION
+}
+
+static inline int MAP_SPEC_FN(map_get)(struct Map *map, MAP_SPEC_KEY_T *key,
+                                       int *value_out) {
+  return map_get(map, key, value_out);
+}
+
+static inline void MAP_SPEC_FN(map_put_with_hash)(struct Map *map,
+                                                  MAP_SPEC_KEY_T *key,
+                                                  int hash, int value) {
+#ifdef KLEE_VERIFICATION
+  map_put(map, key, value);
+#else  // KLEE_VERIFICATION
+  map_put_with_hash(map, key, hash, value);
+#endif // KLEE_VERIFICATION
+}
+
+static inline void MAP_SPEC_FN(map_put)(struct Map *map, MAP_SPEC_KEY_T *key,
+                                        int value) {
+  map_put(map, key, value);
+}
+
+static inline void MAP_SPEC_FN(map_erase)(struct Map *map, MAP_SPEC_KEY_T *key,
+                                          void **trash) {
+  map_erase(map, key, trash);
+}
+
+#endif // CONTAINERS_SPECIALIZED
+
+#undef MAP_SPEC_FN
+#undef MAP_SPEC_NAME
+#undef MAP_SPEC_KEY_T
+#undef MAP_SPEC_KEY_EQ
+#undef MAP_SPEC_KEY_HASH
@@ -1,4 +1,5 @@
 #include "map.h"
+#include "map-layout.h"
 #include "lib/containers/map-impl.h"
 #include <stdlib.h>
 
@@ -6,18 +7,6 @@
 #include "lib/nf_log.h"
 #endif
 
-struct Map {
-  int *busybits;
-  void **keyps;
-  int *khs;
-  int *chns;
-  int *vals;
-  int capacity; // Must be a power of 2
-  int size;
-  map_keys_equality *keys_eq;
-  map_key_hash *khash;
-};
-
 #ifndef NULL
 #define NULL 0
 #endif // NULL
@@ -157,6 +146,34 @@ int map_get /*@ <t> @*/ (struct Map *map, void *key, int *value_out)
   //@ close mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
 }
 
+int map_get_with_hash /*@ <t> @*/ (struct Map *map, void *key, int hash,
+                                   int *value_out)
+/*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
+                     mapc(?capacity, ?contents, ?addrs)) &*&
+             kp(key, ?k) &*&
+             hash == hsh(k) &*&
+             *value_out |-> ?old_v; @*/
+/*@ ensures mapp<t>(map, kp, hsh, recp,
+                    mapc(capacity, contents, addrs)) &*&
+            kp(key, k) &*&
+            map_has_fp(contents, k) ?
+              (result == 1 &*&
+               *value_out |-> ?new_v &*&
+               new_v == map_get_fp(contents, k)) :
+              (result == 0 &*&
+               *value_out |-> old_v); @*/
+{
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "map_";
+  perf_dump_suffix = "";
+#endif
+
+  //@ open mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
+  return map_impl_get(map->busybits, map->keyps, map->khs, map->chns, map->vals,
+                      key, map->keys_eq, hash, value_out, map->capacity);
+  //@ close mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
+}
+
 void map_put /*@ <t> @*/ (struct Map *map, void *key, int value)
 /*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
                      mapc(?capacity, ?contents, ?addrs)) &*&
@@ -185,6 +202,34 @@ void map_put /*@ <t> @*/ (struct Map *map, void *key, int value)
   @*/
 }
 
+void map_put_with_hash /*@ <t> @*/ (struct Map *map, void *key, int hash,
+                                    int value)
+/*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
+                     mapc(?capacity, ?contents, ?addrs)) &*&
+             [0.5]kp(key, ?k) &*&
+             hash == hsh(k) &*&
+             true == recp(k, value) &*&
+             length(contents) < capacity &*&
+             false == map_has_fp(contents, k); @*/
+/*@ ensures mapp<t>(map, kp, hsh, recp,
+                    mapc(capacity, map_put_fp(contents, k, value),
+                         map_put_fp(addrs, k, key))); @*/
+{
+#ifdef DUMP_PERF_VARS
+  perf_dump_prefix = "map_";
+  perf_dump_suffix = "";
+#endif
+
+  //@ open mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
+  map_impl_put(map->busybits, map->keyps, map->khs, map->chns, map->vals, key,
+               hash, value, map->capacity);
+  ++map->size;
+  /*@ close mapp<t>(map, kp, hsh, recp, mapc(capacity,
+                                             map_put_fp(contents, k, value),
+                                             map_put_fp(addrs, k, key)));
+  @*/
+}
+
 /*@
   lemma void map_erase_decrement_len<kt, vt>(list<pair<kt, vt> > m, kt k)
   requires true == map_has_fp(m, k);
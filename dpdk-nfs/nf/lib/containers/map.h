@@ -54,6 +54,26 @@ int map_get /*@ <t> @*/ (struct Map *map, void *key, int *value_out);
               (result == 0 &*&
                *value_out |-> old_v); @*/
 
+// map_get and map_put for a caller that already has the hash of the key,
+// e.g. because it needs it for something else too. The hash must be the
+// one of the hash function given to map_allocate.
+int map_get_with_hash /*@ <t> @*/ (struct Map *map, void *key, int hash,
+                                   int *value_out);
+/*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
+                     mapc(?capacity, ?contents, ?addrs)) &*&
+             kp(key, ?k) &*&
+             hash == hsh(k) &*&
+             *value_out |-> ?old_v; @*/
+/*@ ensures mapp<t>(map, kp, hsh, recp,
+                    mapc(capacity, contents, addrs)) &*&
+            kp(key, k) &*&
+            map_has_fp(contents, k) ?
+              (result == 1 &*&
+               *value_out |-> ?new_v &*&
+               new_v == map_get_fp(contents, k)) :
+              (result == 0 &*&
+               *value_out |-> old_v); @*/
+
 void map_put /*@ <t> @*/ (struct Map *map, void *key, int value);
 /*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
                      mapc(?capacity, ?contents, ?addrs)) &*&
@@ -65,6 +85,19 @@ void map_put /*@ <t> @*/ (struct Map *map, void *key, int value);
                     mapc(capacity, map_put_fp(contents, k, value),
                          map_put_fp(addrs, k, key))); @*/
 
+void map_put_with_hash /*@ <t> @*/ (struct Map *map, void *key, int hash,
+                                    int value);
+/*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
+                     mapc(?capacity, ?contents, ?addrs)) &*&
+             [0.5]kp(key, ?k) &*&
+             hash == hsh(k) &*&
+             true == recp(k, value) &*&
+             length(contents) < capacity &*&
+             false == map_has_fp(contents, k); @*/
+/*@ ensures mapp<t>(map, kp, hsh, recp,
+                    mapc(capacity, map_put_fp(contents, k, value),
+                         map_put_fp(addrs, k, key))); @*/
+
 void map_erase /*@ <t> @*/ (struct Map *map, void *key, void **trash);
 /*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
                      mapc(?capacity, ?contents, ?addrs)) &*&
@@ -246,6 +246,42 @@ int map_get/*@ <t> @*/(struct Map* map, void* key, int* value_out)
   //@ close mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
 }
 
+int map_get_with_hash/*@ <t> @*/(struct Map* map, void* key, int hash,
+                                 int* value_out)
+/*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
+                     mapc(?capacity, ?contents, ?addrs)) &*&
+             kp(key, ?k) &*&
+             hash == hsh(k) &*&
+             *value_out |-> ?old_v; @*/
+/*@ ensures mapp<t>(map, kp, hsh, recp,
+                    mapc(capacity, contents, addrs)) &*&
+            kp(key, k) &*&
+            map_has_fp(contents, k) ?
+              (result == 1 &*&
+               *value_out |-> ?new_v &*&
+               new_v == map_get_fp(contents, k)) :
+              (result == 0 &*&
+               *value_out |-> old_v); @*/
+{
+#ifdef DUMP_PERF_VARS
+ perf_dump_prefix="map_";
+ perf_dump_suffix="";
+#endif
+
+  //@ open mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
+  return map_impl_get(CURRENT_MAP(map)->busybits,
+                      CURRENT_MAP(map)->keyps,
+                      CURRENT_MAP(map)->khs,
+                      CURRENT_MAP(map)->chns,
+                      CURRENT_MAP(map)->vals,
+                      key,
+                      CURRENT_MAP(map)->keys_eq,
+                      hash ^ CURRENT_MAP(map)->hash_seed,
+                      value_out,
+                      CURRENT_MAP(map)->capacity);
+  //@ close mapp<t>(map, kp, hsh, recp, mapc(capacity, contents, addrs));
+}
+
 void map_put/*@ <t> @*/(struct Map* map, void* key, int value)
 /*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
                      mapc(?capacity, ?contents, ?addrs)) &*&
@@ -341,6 +377,23 @@ void map_put/*@ <t> @*/(struct Map* map, void* key, int value)
   }
   @*/
 
+// A rehash recomputes every hash anyway
+void map_put_with_hash/*@ <t> @*/(struct Map* map, void* key, int hash,
+                                  int value)
+/*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
+                     mapc(?capacity, ?contents, ?addrs)) &*&
+             [0.5]kp(key, ?k) &*&
+             hash == hsh(k) &*&
+             true == recp(k, value) &*&
+             length(contents) < capacity &*&
+             false == map_has_fp(contents, k); @*/
+/*@ ensures mapp<t>(map, kp, hsh, recp,
+                    mapc(capacity, map_put_fp(contents, k, value),
+                         map_put_fp(addrs, k, key))); @*/
+{
+  map_put(map, key, value);
+}
+
 void map_erase/*@ <t> @*/(struct Map* map, void* key, void** trash)
 /*@ requires mapp<t>(map, ?kp, ?hsh, ?recp,
                      mapc(?capacity, ?contents, ?addrs)) &*&
@@ -0,0 +1,225 @@
+// Cycles per map operation on the flow table of VigNAT (FlowId keys) and
+// the MAC table of the bridge (rte_ether_addr keys), through the generic map,
+// which calls the hash and equality through function pointers, and through
+// its specialization (specialize.h), on the same map and keys. Each
+// operation is timed ROUNDS times per version, alternating which version
+// goes first; the medians are reported, and the saving is the median of the
+// per-round differences, with their range.
+// Built with SPECIALIZE_CONTAINERS by "make container-bench".
+// Usage: ./container-bench [capacity [occupancy%]]
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rte_cycles.h>
+
+#include "bridge/bridge_data.h"
+#include "vignat/nat-flow.h"
+
+#define MAP_SPEC_NAME flow_id
+#define MAP_SPEC_KEY_T struct FlowId
+#define MAP_SPEC_KEY_EQ FlowId_eq_inline
+#define MAP_SPEC_KEY_HASH FlowId_hash_inline
+#include "lib/containers/map-specialized.h"
+
+#define MAP_SPEC_NAME ether_addr
+#define MAP_SPEC_KEY_T struct rte_ether_addr
+#define MAP_SPEC_KEY_EQ ether_addr_eq_inline
+#define MAP_SPEC_KEY_HASH ether_addr_hash_inline
+#include "lib/containers/map-specialized.h"
+
+#ifndef CONTAINERS_SPECIALIZED
+#error "Build with -DSPECIALIZE_CONTAINERS"
+#endif
+
+#define OPS (1 << 20)
+#define ROUNDS 7
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return rng_state;
+}
+
+// Keys [0, present) are in the map, [present, 2 * present) are not
+struct workload {
+  int present;
+  int *hits;
+  int *misses;
+};
+
+static struct workload make_workload(int present) {
+  struct workload w = {present, malloc(OPS * sizeof(int)),
+                       malloc(OPS * sizeof(int))};
+  if (w.hits == NULL || w.misses == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+  for (int i = 0; i < OPS; i++) {
+    w.hits[i] = rng() % present;
+    w.misses[i] = present + rng() % present;
+  }
+  return w;
+}
+
+static volatile int sink;
+
+#define CYCLES_PER_OP(cycles, op)                                              \
+  do {                                                                         \
+    int sum_ = 0;                                                              \
+    uint64_t start_ = rte_rdtsc();                                             \
+    for (int i = 0; i < OPS; i++) {                                            \
+      op;                                                                      \
+    }                                                                          \
+    cycles = (double)(rte_rdtsc() - start_) / OPS;                             \
+    sink = sum_;                                                               \
+  } while (0)
+
+// Times both versions of an operation ROUNDS times, the generic one first
+// in even rounds and second in odd ones, so that neither always runs on the
+// caches the other left
+#define COMPARE(table, name, generic_op, specialized_op)                       \
+  do {                                                                         \
+    double generic_[ROUNDS], specialized_[ROUNDS];                             \
+    for (int round_ = 0; round_ < ROUNDS; round_++) {                          \
+      if (round_ % 2 == 0) {                                                   \
+        CYCLES_PER_OP(generic_[round_], generic_op);                           \
+        CYCLES_PER_OP(specialized_[round_], specialized_op);                   \
+      } else {                                                                 \
+        CYCLES_PER_OP(specialized_[round_], specialized_op);                   \
+        CYCLES_PER_OP(generic_[round_], generic_op);                           \
+      }                                                                        \
+    }                                                                          \
+    report(table, name, generic_, specialized_);                               \
+  } while (0)
+
+static int compare_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// Sorts values in place
+static double median(double *values) {
+  qsort(values, ROUNDS, sizeof(double), compare_double);
+  return values[ROUNDS / 2];
+}
+
+static void report(const char *table, const char *op, double *generic,
+                   double *specialized) {
+  double saved[ROUNDS];
+  for (int r = 0; r < ROUNDS; r++) {
+    saved[r] = generic[r] - specialized[r];
+  }
+  // median() leaves saved sorted, so its ends are the range
+  double saved_median = median(saved);
+  printf("%-10s %-12s %8.1f %12.1f %8.1f %7.1f..%.1f\n", table, op,
+         median(generic), median(specialized), saved_median, saved[0],
+         saved[ROUNDS - 1]);
+}
+
+static void bench_flow_id(int capacity, struct workload *w) {
+  struct FlowId *keys = malloc(2 * w->present * sizeof(struct FlowId));
+  struct Map *map = NULL;
+  if (keys == NULL || !map_allocate(FlowId_eq, FlowId_hash, capacity, &map)) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+  for (int k = 0; k < 2 * w->present; k++) {
+    keys[k] = (struct FlowId){.src_port = rng(),
+                              .dst_port = rng(),
+                              .src_ip = rng(),
+                              .dst_ip = rng(),
+                              .internal_device = 0,
+                              .protocol = 6};
+  }
+  for (int k = 0; k < w->present; k++) {
+    map_put(map, &keys[k], k);
+  }
+
+  int v;
+  void *trash;
+  COMPARE("vignat", "get (hit)",
+          sum_ += map_get(map, &keys[w->hits[i]], &v),
+          sum_ += flow_id_map_get(map, &keys[w->hits[i]], &v));
+  COMPARE("vignat", "get (miss)",
+          sum_ += map_get(map, &keys[w->misses[i]], &v),
+          sum_ += flow_id_map_get(map, &keys[w->misses[i]], &v));
+  COMPARE("vignat", "erase+put",
+          {
+            map_erase(map, &keys[w->hits[i]], &trash);
+            map_put(map, &keys[w->hits[i]], w->hits[i]);
+          },
+          {
+            flow_id_map_erase(map, &keys[w->hits[i]], &trash);
+            flow_id_map_put(map, &keys[w->hits[i]], w->hits[i]);
+          });
+  free(keys);
+}
+
+static void bench_ether_addr(int capacity, struct workload *w) {
+  struct rte_ether_addr *keys =
+      malloc(2 * w->present * sizeof(struct rte_ether_addr));
+  struct Map *map = NULL;
+  if (keys == NULL ||
+      !map_allocate(ether_addr_eq, ether_addr_hash, capacity, &map)) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+  for (int k = 0; k < 2 * w->present; k++) {
+    uint64_t r = rng();
+    for (int b = 0; b < RTE_ETHER_ADDR_LEN; b++) {
+      keys[k].addr_bytes[b] = r >> (8 * b);
+    }
+  }
+  for (int k = 0; k < w->present; k++) {
+    map_put(map, &keys[k], k);
+  }
+
+  int v;
+  void *trash;
+  COMPARE("bridge", "get (hit)",
+          sum_ += map_get(map, &keys[w->hits[i]], &v),
+          sum_ += ether_addr_map_get(map, &keys[w->hits[i]], &v));
+  COMPARE("bridge", "get (miss)",
+          sum_ += map_get(map, &keys[w->misses[i]], &v),
+          sum_ += ether_addr_map_get(map, &keys[w->misses[i]], &v));
+  COMPARE("bridge", "erase+put",
+          {
+            map_erase(map, &keys[w->hits[i]], &trash);
+            map_put(map, &keys[w->hits[i]], w->hits[i]);
+          },
+          {
+            ether_addr_map_erase(map, &keys[w->hits[i]], &trash);
+            ether_addr_map_put(map, &keys[w->hits[i]], w->hits[i]);
+          });
+  free(keys);
+}
+
+int main(int argc, char *argv[]) {
+  int capacity = argc > 1 ? atoi(argv[1]) : 65536;
+  int occupancy = argc > 2 ? atoi(argv[2]) : 75;
+  if (capacity <= 0 || (capacity & (capacity - 1)) != 0 || occupancy <= 0 ||
+      occupancy > 100) {
+    fprintf(stderr,
+            "Usage: %s [capacity (a power of 2) [occupancy%% (1-100)]]\n",
+            argv[0]);
+    return 1;
+  }
+  int present = (int)((int64_t)capacity * occupancy / 100);
+  if (present == 0) {
+    present = 1;
+  }
+  struct workload w = make_workload(present);
+
+  printf("%d of %d entries, median cycles per operation over %d rounds\n",
+         present, capacity, ROUNDS);
+  printf("%-10s %-12s %8s %12s %8s %s\n", "table", "operation", "generic",
+         "specialized", "saved", "  range");
+  bench_flow_id(capacity, &w);
+  bench_ether_addr(capacity, &w);
+  return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef _SPECIALIZE_H_INCLUDED_
+#define _SPECIALIZE_H_INCLUDED_
+
+// Type-specialized containers. Each *-specialized.h header is a template:
+// define its parameters, include it, and it defines static inline
+// <name>_<function> variants of the container functions for one key or
+// value type (e.g. flow_id_map_get). The parameters are undefined at the
+// end of the template, so it can be included again for another type.
+//
+// With SPECIALIZE_CONTAINERS (make SPECIALIZE_CONTAINERS=YES), the variants
+// run the algorithm of the generic containers on the same structs, with the
+// hash, equality and copy functions inlined instead of called through
+// function pointers. Otherwise, and always under KLEE and in the replay
+// executables whose traces the contracts describe, they call the generic
+// functions.
+//
+// The specialized variants read the structs of map.c, vector.c and
+// double-map.c (*-layout.h): only specialize with these implementations
+// selected in the Makefile (fused-double-map.c refuses to build otherwise).
+
+#if defined(SPECIALIZE_CONTAINERS) && !defined(KLEE_VERIFICATION) && \
+    !defined(REPLAY)
+#define CONTAINERS_SPECIALIZED
+#endif
+
+#define SPEC_CONCAT_(a, b) a##_##b
+#define SPEC_CONCAT(a, b) SPEC_CONCAT_(a, b)
+
+#endif //_SPECIALIZE_H_INCLUDED_
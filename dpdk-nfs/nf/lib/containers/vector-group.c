@@ -0,0 +1,92 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "vector-group.h"
+#include "vector-layout.h"
+
+// Not verified. A member's data points to its field in the first record and
+// its elem_size is the record size, which is all vector_borrow (vector.c)
+// needs to reach the field in any record. Unlike vector_allocate, the
+// capacity is not bounded by VECTOR_CAPACITY_UPPER_LIMIT (a bound of the
+// proofs): the only bound vector_borrow needs at runtime is that the offset
+// of the last record, an int, does not overflow.
+
+#define VECTOR_GROUP_LINE_SIZE 64
+#define VECTOR_GROUP_MAX_RECORD 4096
+
+// Natural alignment of an element of this size, up to 8 bytes
+static int vector_group_align(int size) {
+  int align = 1;
+  while (align < 8 && align < size) {
+    align *= 2;
+  }
+  return align;
+}
+
+static int vector_group_round_up(int n, int align) {
+  return (n + align - 1) / align * align;
+}
+
+int vector_allocate_group(unsigned capacity, int count,
+                          struct VectorGroupMember *members) {
+  if (count <= 0 || capacity == 0 || capacity > INT_MAX) {
+    return 0;
+  }
+
+  int offsets[count];
+  int record_size = 0;
+  int record_align = 1;
+  for (int i = 0; i < count; ++i) {
+    if (members[i].elem_size <= 0 ||
+        members[i].elem_size >= VECTOR_GROUP_MAX_RECORD) {
+      return 0;
+    }
+    int align = vector_group_align(members[i].elem_size);
+    if (record_align < align) {
+      record_align = align;
+    }
+    offsets[i] = vector_group_round_up(record_size, align);
+    record_size = offsets[i] + members[i].elem_size;
+  }
+  record_size = vector_group_round_up(record_size, record_align);
+  if (record_size <= VECTOR_GROUP_LINE_SIZE) {
+    while ((record_size & (record_size - 1)) != 0) {
+      record_size += record_align;
+    }
+  }
+  if (record_size >= VECTOR_GROUP_MAX_RECORD ||
+      (uint64_t)record_size * capacity > INT_MAX) {
+    return 0;
+  }
+
+  char *data = NULL;
+  if (posix_memalign((void **)&data, VECTOR_GROUP_LINE_SIZE,
+                     (size_t)record_size * capacity) != 0) {
+    return 0;
+  }
+  struct Vector *vectors[count];
+  for (int i = 0; i < count; ++i) {
+    vectors[i] = malloc(sizeof(struct Vector));
+    if (vectors[i] == NULL) {
+      for (int j = 0; j < i; ++j) {
+        free(vectors[j]);
+      }
+      free(data);
+      return 0;
+    }
+    vectors[i]->data = data + offsets[i];
+    vectors[i]->elem_size = record_size;
+    vectors[i]->capacity = capacity;
+  }
+
+  for (unsigned index = 0; index < capacity; ++index) {
+    for (int i = 0; i < count; ++i) {
+      members[i].init_elem(data + (size_t)record_size * index + offsets[i]);
+    }
+  }
+  for (int i = 0; i < count; ++i) {
+    *members[i].vector_out = vectors[i];
+  }
+  return 1;
+}
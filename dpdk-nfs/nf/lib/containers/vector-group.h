@@ -0,0 +1,29 @@
+#ifndef _VECTOR_GROUP_H_INCLUDED_
+#define _VECTOR_GROUP_H_INCLUDED_
+
+#include "vector.h"
+
+// Vectors always indexed together (e.g. the keys and the values of a flow
+// table), stored as one array of records: the elements of all the vectors at
+// one index are next to each other, so the accesses for one index touch one
+// cache line instead of one per vector.
+//
+// Each member is an ordinary struct Vector: vector_borrow and vector_return
+// (and the typed ones of vector-specialized.h) work on it unchanged.
+
+struct VectorGroupMember {
+  int elem_size;
+  vector_init_elem *init_elem;
+  struct Vector **vector_out;
+};
+
+// Allocates the count vectors of members with the given capacity and
+// initializes their elements, as vector_allocate does for each. Records of
+// at most 64 bytes are padded to a power of 2 and the array is 64-byte
+// aligned, so that no record straddles two cache lines. The capacity may
+// exceed VECTOR_CAPACITY_UPPER_LIMIT, as long as the array is under 2 GiB.
+// Returns 1 on success, 0 otherwise (then the vector_outs are unchanged).
+int vector_allocate_group(unsigned capacity, int count,
+                          struct VectorGroupMember *members);
+
+#endif //_VECTOR_GROUP_H_INCLUDED_
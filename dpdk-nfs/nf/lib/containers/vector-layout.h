@@ -0,0 +1,11 @@
+#ifndef _VECTOR_LAYOUT_H_INCLUDED_
+#define _VECTOR_LAYOUT_H_INCLUDED_
+
+// Shared by vector.c and the specialized vectors (vector-specialized.h)
+struct Vector {
+  char *data;
+  int elem_size;
+  int capacity;
+};
+
+#endif //_VECTOR_LAYOUT_H_INCLUDED_
@@ -0,0 +1,50 @@
+// Template (see specialize.h): vector_borrow and vector_return for one
+// element type, as <VECTOR_SPEC_NAME>_vector_borrow etc.
+//
+// VECTOR_SPEC_NAME    prefix of the functions
+// VECTOR_SPEC_ELEM_T  element type; its size must be the elem_size given to
+//                     vector_allocate or vector_allocate_group
+//
+// The specialized vector_borrow is the pointer arithmetic of vector.c,
+// inlined: it steps by the vector's elem_size, which for a member of a
+// group (vector-group.h) is the size of the whole record.
+
+#include "vector.h"
+#include "specialize.h"
+
+#define VECTOR_SPEC_FN(fn) SPEC_CONCAT(VECTOR_SPEC_NAME, fn)
+
+#ifdef CONTAINERS_SPECIALIZED
+
+#include "vector-layout.h"
+
+static inline void VECTOR_SPEC_FN(vector_borrow)(struct Vector *vector,
+                                                 int index,
+                                                 VECTOR_SPEC_ELEM_T **val_out) {
+  *val_out =
+      (VECTOR_SPEC_ELEM_T *)(vector->data + index * vector->elem_size);
+}
+
+static inline void VECTOR_SPEC_FN(vector_return)(struct Vector *vector,
+                                                 int index,
+                                                 VECTOR_SPEC_ELEM_T *value) {}
+
+#else // CONTAINERS_SPECIALIZED
+
+static inline void VECTOR_SPEC_FN(vector_borrow)(struct Vector *vector,
+                                                 int index,
+                                                 VECTOR_SPEC_ELEM_T **val_out) {
+  vector_borrow(vector, index, (void **)val_out);
+}
+
+static inline void VECTOR_SPEC_FN(vector_return)(struct Vector *vector,
+                                                 int index,
+                                                 VECTOR_SPEC_ELEM_T *value) {
+  vector_return(vector, index, value);
+}
+
+#endif // CONTAINERS_SPECIALIZED
+
+#undef VECTOR_SPEC_FN
+#undef VECTOR_SPEC_NAME
+#undef VECTOR_SPEC_ELEM_T
@@ -1,16 +1,11 @@
 #include "vector.h"
+#include "vector-layout.h"
 #include <stdint.h>
 #include <stdlib.h>
 
 //@ #include "arith.gh"
 //@ #include "stdex.gh"
 
-struct Vector {
-  char *data;
-  int elem_size;
-  int capacity;
-};
-
 /*@
   predicate entsp<t>(void* data, int el_size,
                      predicate (void*;t) entp,
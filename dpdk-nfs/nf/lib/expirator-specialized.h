@@ -0,0 +1,36 @@
+// Template (see containers/specialize.h): expire_items_single_map for one
+// key type, as <EXPIRATOR_SPEC_NAME>_expire_items_single_map. It erases
+// through the map and vector specializations of the same name, which must
+// be included first.
+//
+// EXPIRATOR_SPEC_NAME   prefix of the function and of the map and vector
+//                       specializations
+// EXPIRATOR_SPEC_KEY_T  key type
+
+#include "expirator.h"
+#include "containers/specialize.h"
+
+#define EXPIRATOR_SPEC_FN(fn) SPEC_CONCAT(EXPIRATOR_SPEC_NAME, fn)
+
+static inline int EXPIRATOR_SPEC_FN(expire_items_single_map)(
+    struct DoubleChain *chain, struct Vector *vector, struct Map *map,
+    time_t time) {
+#ifdef CONTAINERS_SPECIALIZED
+  int count = 0;
+  int index = -1;
+  while (dchain_expire_one_index(chain, &index, time)) {
+    EXPIRATOR_SPEC_KEY_T *key;
+    EXPIRATOR_SPEC_FN(vector_borrow)(vector, index, &key);
+    EXPIRATOR_SPEC_FN(map_erase)(map, key, (void **)&key);
+    EXPIRATOR_SPEC_FN(vector_return)(vector, index, key);
+    ++count;
+  }
+  return count;
+#else  // CONTAINERS_SPECIALIZED
+  return expire_items_single_map(chain, vector, map, time);
+#endif // CONTAINERS_SPECIALIZED
+}
+
+#undef EXPIRATOR_SPEC_FN
+#undef EXPIRATOR_SPEC_NAME
+#undef EXPIRATOR_SPEC_KEY_T
@@ -0,0 +1,430 @@
+// Compares the flow hashes of lib/flow-hash.h on a set of flows: the chains
+// they produce in a map of the given capacity, probed the way map-impl.c
+// does (the "t" buckets traversed and "c" hash collisions of the contracts),
+// and their speed, one key at a time and in bursts.
+// The flows are the distinct IPv4 TCP/UDP 5-tuples of a pcap (the classic
+// format, not pcapng), or sequential addresses and ports with --synthetic.
+// Built by "make flow-hash-bench".
+// Usage: ./flow-hash-bench [--capacity N] (--synthetic FLOWS | trace.pcap)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lib/flow-hash.h"
+
+#define SPEED_ROUNDS 64
+#define BURST 32
+
+typedef int (*flow_hash_fn)(struct flow_hash_key k);
+
+struct variant {
+  const char *name;
+  flow_hash_fn hash;
+};
+
+static const struct variant variants[] = {
+    {"mul31", flow_hash_mul31},
+    {"mix", flow_hash_mix},
+#ifdef FLOW_HASH_HAS_CRC32C
+    {"crc32c", flow_hash_crc32c},
+#endif
+};
+
+#define N_VARIANTS ((int)(sizeof(variants) / sizeof(variants[0])))
+
+struct flows {
+  struct flow_hash_key *keys;
+  int n;
+  int cap;
+};
+
+static void die(const char *msg) {
+  fprintf(stderr, "%s\n", msg);
+  exit(1);
+}
+
+static void *alloc(size_t n, size_t size) {
+  void *p = calloc(n, size);
+  if (p == NULL) {
+    die("Out of memory");
+  }
+  return p;
+}
+
+static void flows_add(struct flows *f, struct flow_hash_key k) {
+  if (f->n == f->cap) {
+    f->cap = f->cap ? 2 * f->cap : 1024;
+    f->keys = realloc(f->keys, f->cap * sizeof(*f->keys));
+    if (f->keys == NULL) {
+      die("Out of memory");
+    }
+  }
+  f->keys[f->n++] = k;
+}
+
+static int key_cmp(const void *a, const void *b) {
+  const struct flow_hash_key *x = a, *y = b;
+  if (x->addrs != y->addrs) {
+    return x->addrs < y->addrs ? -1 : 1;
+  }
+  if (x->rest != y->rest) {
+    return x->rest < y->rest ? -1 : 1;
+  }
+  return 0;
+}
+
+// Sorts, which loses the order of arrival; the map does not care
+static void flows_dedup(struct flows *f) {
+  qsort(f->keys, f->n, sizeof(*f->keys), key_cmp);
+  int n = 0;
+  for (int i = 0; i < f->n; i++) {
+    if (n == 0 || key_cmp(&f->keys[n - 1], &f->keys[i]) != 0) {
+      f->keys[n++] = f->keys[i];
+    }
+  }
+  f->n = n;
+}
+
+static uint32_t rd32(const uint8_t *p, int swap) {
+  return swap ? (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+                    (uint32_t)p[2] << 8 | p[3]
+              : (uint32_t)p[3] << 24 | (uint32_t)p[2] << 16 |
+                    (uint32_t)p[1] << 8 | p[0];
+}
+
+// The packet fields are network order, hashed as the NFs read them from
+// the mbuf, i.e. not swapped on little-endian machines
+static uint32_t ne32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint16_t ne16(const uint8_t *p) {
+  uint16_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static void parse_frame(struct flows *f, const uint8_t *p, uint32_t len) {
+  uint32_t off = 12;
+  if (len < off + 2) {
+    return;
+  }
+  uint32_t type = (uint32_t)p[off] << 8 | p[off + 1];
+  while ((type == 0x8100 || type == 0x88a8) && len >= off + 6) {
+    off += 4;
+    type = (uint32_t)p[off] << 8 | p[off + 1];
+  }
+  off += 2;
+  if (type != 0x0800 || len < off + 20) {
+    return;
+  }
+  const uint8_t *ip = p + off;
+  uint32_t ihl = (ip[0] & 0xf) * 4;
+  uint8_t proto = ip[9];
+  if ((proto != 6 && proto != 17) || ihl < 20 || len < off + ihl + 4) {
+    return;
+  }
+  const uint8_t *l4 = ip + ihl;
+  flows_add(f, flow_hash_pack(ne32(ip + 12), ne32(ip + 16), ne16(l4),
+                              ne16(l4 + 2), 0, proto));
+}
+
+static void read_pcap(struct flows *f, const char *path) {
+  FILE *in = fopen(path, "rb");
+  if (in == NULL) {
+    perror(path);
+    exit(1);
+  }
+  uint8_t hdr[24];
+  if (fread(hdr, 1, sizeof(hdr), in) != sizeof(hdr)) {
+    die("Truncated pcap header");
+  }
+  uint32_t magic = rd32(hdr, 0);
+  int swap;
+  if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+    swap = 0;
+  } else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+    swap = 1;
+  } else {
+    die("Not a pcap file (pcapng is not supported)");
+  }
+  if (rd32(hdr + 20, swap) != 1) {
+    die("Only Ethernet captures are supported");
+  }
+  uint8_t rec[16];
+  uint8_t *frame = NULL;
+  uint32_t frame_cap = 0;
+  while (fread(rec, 1, sizeof(rec), in) == sizeof(rec)) {
+    uint32_t caplen = rd32(rec + 8, swap);
+    if (caplen > frame_cap) {
+      frame_cap = caplen;
+      frame = realloc(frame, frame_cap);
+      if (frame == NULL) {
+        die("Out of memory");
+      }
+    }
+    if (fread(frame, 1, caplen, in) != caplen) {
+      break;
+    }
+    parse_frame(f, frame, caplen);
+  }
+  free(frame);
+  fclose(in);
+}
+
+// Sequential clients in 10.0.0.0/16, then sequential source ports, towards
+// one server, like the flows of a traffic generator. The fields are network
+// order, as the NFs read them, so the address bits that change are the high
+// ones, which MUL31 hardly mixes into the low bits the map uses.
+static void synthetic(struct flows *f, int n) {
+  for (int i = 0; i < n; i++) {
+    uint32_t src_ip = __builtin_bswap32(0x0a000000 | (uint32_t)(i & 0xffff));
+    uint16_t src_port = __builtin_bswap16(1024 + (i >> 16));
+    flows_add(f, flow_hash_pack(src_ip, __builtin_bswap32(0xc0a80001),
+                                src_port, __builtin_bswap16(80), 0, 6));
+  }
+}
+
+struct stats {
+  int max;
+  int p50;
+  int p99;
+  double mean;
+};
+
+static struct stats stats_of(int *v, int n) {
+  struct stats s;
+  int max = 0;
+  long long sum = 0;
+  for (int i = 0; i < n; i++) {
+    sum += v[i];
+    max = v[i] > max ? v[i] : max;
+  }
+  long long *hist = alloc(max + 1, sizeof(long long));
+  for (int i = 0; i < n; i++) {
+    hist[v[i]]++;
+  }
+  long long seen = 0;
+  int p50 = -1, p99 = -1;
+  for (int x = 0; x <= max; x++) {
+    seen += hist[x];
+    if (p50 < 0 && seen * 100 >= (long long)n * 50) {
+      p50 = x;
+    }
+    if (p99 < 0 && seen * 100 >= (long long)n * 99) {
+      p99 = x;
+    }
+  }
+  free(hist);
+  s.max = max;
+  s.p50 = p50;
+  s.p99 = p99;
+  s.mean = n ? (double)sum / n : 0;
+  return s;
+}
+
+// The buckets of map-impl.c: busybits, k_hashes, chns and the key index
+struct table {
+  int capacity;
+  int *busy;
+  int *khs;
+  int *chns;
+  int *keys;
+};
+
+static void table_put(struct table *t, int key, int hash) {
+  int start = hash & (t->capacity - 1);
+  for (int i = 0; i < t->capacity; i++) {
+    int index = (start + i) & (t->capacity - 1);
+    if (!t->busy[index]) {
+      t->busy[index] = 1;
+      t->khs[index] = hash;
+      t->keys[index] = key;
+      return;
+    }
+    t->chns[index]++;
+  }
+  die("Map full");
+}
+
+// Buckets traversed and hash collisions of find_key in map-impl.c
+static void table_find(struct table *t, const struct flow_hash_key *keys,
+                       struct flow_hash_key k, int hash, int *traversed,
+                       int *collisions) {
+  int start = hash & (t->capacity - 1);
+  *traversed = 0;
+  *collisions = 0;
+  for (int i = 0; i < t->capacity; i++) {
+    int index = (start + i) & (t->capacity - 1);
+    ++*traversed;
+    if (t->busy[index] && t->khs[index] == hash) {
+      if (key_cmp(&keys[t->keys[index]], &k) == 0) {
+        return;
+      }
+      ++*collisions;
+    }
+    if (t->chns[index] == 0) {
+      return;
+    }
+  }
+}
+
+static void print_stats(const char *hash, const char *find, int *traversed,
+                        int *collisions, int n) {
+  struct stats t = stats_of(traversed, n);
+  struct stats c = stats_of(collisions, n);
+  printf("%-7s %-5s %6.2f %4d %4d %5d   %6.3f %4d %4d\n", hash, find, t.mean,
+         t.p50, t.p99, t.max, c.mean, c.p99, c.max);
+}
+
+// Even flows go in the map and hit, odd ones miss: sorted flows alternate,
+// so both halves have the same shape
+static void chains(const struct variant *v, const struct flows *f,
+                   int capacity) {
+  int present = (f->n + 1) / 2;
+  int missing = f->n / 2;
+  struct table t = {capacity, alloc(capacity, sizeof(int)),
+                    alloc(capacity, sizeof(int)), alloc(capacity, sizeof(int)),
+                    alloc(capacity, sizeof(int))};
+  int *hashes = alloc(f->n, sizeof(int));
+  int *hit_t = alloc(present, sizeof(int));
+  int *hit_c = alloc(present, sizeof(int));
+  int *miss_t = alloc(missing, sizeof(int));
+  int *miss_c = alloc(missing, sizeof(int));
+  for (int i = 0; i < f->n; i++) {
+    hashes[i] = v->hash(f->keys[i]);
+  }
+  for (int i = 0; i < f->n; i += 2) {
+    table_put(&t, i, hashes[i]);
+  }
+  for (int i = 0; i < f->n; i++) {
+    if (i % 2 == 0) {
+      table_find(&t, f->keys, f->keys[i], hashes[i], &hit_t[i / 2],
+                 &hit_c[i / 2]);
+    } else {
+      table_find(&t, f->keys, f->keys[i], hashes[i], &miss_t[i / 2],
+                 &miss_c[i / 2]);
+    }
+  }
+  print_stats(v->name, "hit", hit_t, hit_c, present);
+  print_stats(v->name, "miss", miss_t, miss_c, missing);
+  free(t.busy);
+  free(t.khs);
+  free(t.chns);
+  free(t.keys);
+  free(hashes);
+  free(hit_t);
+  free(hit_c);
+  free(miss_t);
+  free(miss_c);
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int sink;
+
+// The variant is called directly, not through the table, so that it inlines
+// as it does in the NFs
+#define SPEED(fn, f)                                                           \
+  do {                                                                         \
+    int sum_ = 0;                                                              \
+    double start_ = now_ns();                                                  \
+    for (int r = 0; r < SPEED_ROUNDS; r++) {                                   \
+      for (int i = 0; i < (f)->n; i++) {                                       \
+        /* Chained through sum_, as a lookup waits for its hash */             \
+        struct flow_hash_key k_ = (f)->keys[i];                                \
+        k_.addrs ^= (uint64_t)(sum_ & 1);                                      \
+        sum_ += fn(k_);                                                        \
+      }                                                                        \
+    }                                                                          \
+    single = (now_ns() - start_) / ((double)SPEED_ROUNDS * (f)->n);            \
+    int out_[BURST];                                                           \
+    start_ = now_ns();                                                         \
+    for (int r = 0; r < SPEED_ROUNDS; r++) {                                   \
+      for (int i = 0; i + BURST <= (f)->n; i += BURST) {                       \
+        for (int j = 0; j < BURST; j++) {                                      \
+          out_[j] = fn((f)->keys[i + j]);                                      \
+        }                                                                      \
+        sum_ += out_[i / BURST % BURST];                                       \
+      }                                                                        \
+    }                                                                          \
+    burst = (now_ns() - start_) /                                              \
+            ((double)SPEED_ROUNDS * ((f)->n / BURST * BURST));                 \
+    sink = sum_;                                                               \
+  } while (0)
+
+static void speed(const struct flows *f) {
+  double single, burst;
+  printf("\n%-7s %12s %12s\n", "hash", "ns (single)", "ns (burst)");
+  SPEED(flow_hash_mul31, f);
+  printf("%-7s %12.2f %12.2f\n", "mul31", single, burst);
+  SPEED(flow_hash_mix, f);
+  printf("%-7s %12.2f %12.2f\n", "mix", single, burst);
+#ifdef FLOW_HASH_HAS_CRC32C
+  SPEED(flow_hash_crc32c, f);
+  printf("%-7s %12.2f %12.2f\n", "crc32c", single, burst);
+#endif
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [--capacity N (a power of 2)] "
+          "(--synthetic FLOWS | trace.pcap)\n",
+          argv0);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+  int capacity = 65536;
+  int n_synthetic = 0;
+  const char *pcap = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+      capacity = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+      n_synthetic = atoi(argv[++i]);
+    } else if (argv[i][0] != '-' && pcap == NULL) {
+      pcap = argv[i];
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (capacity <= 0 || (capacity & (capacity - 1)) != 0 ||
+      (pcap == NULL) == (n_synthetic <= 0)) {
+    usage(argv[0]);
+  }
+
+  struct flows f = {NULL, 0, 0};
+  if (pcap != NULL) {
+    read_pcap(&f, pcap);
+  } else {
+    synthetic(&f, n_synthetic);
+  }
+  flows_dedup(&f);
+  // Half the flows go in the map, at most 75% of it
+  if (f.n / 2 > capacity / 4 * 3) {
+    f.n = capacity / 4 * 3 * 2;
+  }
+  if (f.n < 2) {
+    die("Not enough IPv4 TCP/UDP flows");
+  }
+
+  printf("%d flows in the map of %d, %d looked up and missing\n", f.n / 2,
+         capacity, f.n - f.n / 2);
+  printf("%-7s %-5s %6s %4s %4s %5s   %6s %4s %4s\n", "hash", "find",
+         "t mean", "p50", "p99", "max", "c mean", "p99", "max");
+  for (int v = 0; v < N_VARIANTS; v++) {
+    chains(&variants[v], &f, capacity);
+  }
+  speed(&f);
+  return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef _FLOW_HASH_H_INCLUDED_
+#define _FLOW_HASH_H_INCLUDED_
+
+#include <stdint.h>
+
+// Hashes of flow keys (addresses, ports, device, protocol), packed into two
+// 64-bit words. flow_hash(k) is the variant selected at build time
+// (make FLOW_HASH=...), flow_hash_no_device(k) the same for keys without a
+// device (packed with device 0):
+//   MIX     a folded 128-bit multiply of the two words, the default
+//   CRC32C  the CRC32C instruction; needs SSE4.2 or the ARMv8 CRC extension
+//           (DPDK's -march=native has them)
+//   MUL31   hash * 31 + field over the fields, modulo INT_MAX; the hash
+//           the NFs used before
+// The maps take the hash modulo their power-of-2 capacity, so the low bits
+// must depend on every field, which MUL31 does poorly for sequential
+// addresses and ports. All variants are non-negative.
+
+struct flow_hash_key {
+  uint64_t addrs; // src_ip << 32 | dst_ip
+  uint64_t rest;  // src_port << 48 | dst_port << 32 | device << 16 | protocol
+};
+
+static inline struct flow_hash_key
+flow_hash_pack(uint32_t src_ip, uint32_t dst_ip, uint16_t src_port,
+               uint16_t dst_port, uint16_t device, uint8_t protocol) {
+  struct flow_hash_key k;
+  k.addrs = (uint64_t)src_ip << 32 | dst_ip;
+  k.rest = (uint64_t)src_port << 48 | (uint64_t)dst_port << 32 |
+           (uint64_t)device << 16 | protocol;
+  return k;
+}
+
+static inline long long flow_hash_mul31_ports_addrs(struct flow_hash_key k) {
+  long long hash = (uint16_t)(k.rest >> 48);
+  hash *= 31;
+  hash += (uint16_t)(k.rest >> 32);
+  hash *= 31;
+  hash += (uint32_t)(k.addrs >> 32);
+  hash *= 31;
+  hash += (uint32_t)k.addrs;
+  return hash;
+}
+
+static inline int flow_hash_mul31(struct flow_hash_key k) {
+  long long hash = flow_hash_mul31_ports_addrs(k);
+  hash *= 31;
+  hash += (uint16_t)(k.rest >> 16);
+  hash *= 31;
+  hash += (uint8_t)k.rest;
+  return (int)(hash % 2147483647);
+}
+
+// Without the device step, as the firewall hashed its flows
+static inline int flow_hash_mul31_no_device(struct flow_hash_key k) {
+  long long hash = flow_hash_mul31_ports_addrs(k);
+  hash *= 31;
+  hash += (uint8_t)k.rest;
+  return (int)(hash % 2147483647);
+}
+
+// One 64x64->128 bit multiply, folded: every input bit reaches the low
+// bits, unlike a 64-bit multiply, which only carries upwards (so that
+// fields in the high bits, like the ports, end up colliding).
+static inline int flow_hash_mix(struct flow_hash_key k) {
+  __uint128_t p = (__uint128_t)(k.addrs ^ 0xa0761d6478bd642full) *
+                  (k.rest ^ 0xe7037ed1a0b428dbull);
+  uint64_t h = (uint64_t)p ^ (uint64_t)(p >> 64);
+  return (int)(h & 0x7fffffff);
+}
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define FLOW_HASH_HAS_CRC32C
+static inline int flow_hash_crc32c(struct flow_hash_key k) {
+  uint64_t h = _mm_crc32_u64(0xffffffff, k.addrs);
+  h = _mm_crc32_u64(h, k.rest);
+  return (int)(h & 0x7fffffff);
+}
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define FLOW_HASH_HAS_CRC32C
+static inline int flow_hash_crc32c(struct flow_hash_key k) {
+  uint32_t h = __crc32cd(0xffffffff, k.addrs);
+  h = __crc32cd(h, k.rest);
+  return (int)(h & 0x7fffffff);
+}
+#endif
+
+#if defined(FLOW_HASH_CRC32C)
+#ifndef FLOW_HASH_HAS_CRC32C
+#error "FLOW_HASH=CRC32C needs SSE4.2 or the ARMv8 CRC extension"
+#endif
+#define flow_hash(k) flow_hash_crc32c(k)
+#define flow_hash_no_device(k) flow_hash_crc32c(k)
+#elif defined(FLOW_HASH_MUL31)
+#define flow_hash(k) flow_hash_mul31(k)
+#define flow_hash_no_device(k) flow_hash_mul31_no_device(k)
+#else
+#define flow_hash(k) flow_hash_mix(k)
+#define flow_hash_no_device(k) flow_hash_mix(k)
+#endif
+
+// flow_hash of n keys. The keys are independent, so the loop keeps several
+// hashes in flight instead of waiting for each one's multiply or CRC chain.
+static inline void flow_hash_burst(const struct flow_hash_key *keys, int n,
+                                   int *hashes) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int h0 = flow_hash(keys[i]);
+    int h1 = flow_hash(keys[i + 1]);
+    int h2 = flow_hash(keys[i + 2]);
+    int h3 = flow_hash(keys[i + 3]);
+    hashes[i] = h0;
+    hashes[i + 1] = h1;
+    hashes[i + 2] = h2;
+    hashes[i + 3] = h3;
+  }
+  for (; i < n; i++) {
+    hashes[i] = flow_hash(keys[i]);
+  }
+}
+
+#endif //_FLOW_HASH_H_INCLUDED_
@@ -66,7 +66,8 @@ enum TrafficClass {
   EXTERNAL_NEW,
   EXTERNAL_KNOWN,
   INTERNAL_KNOWN,
-  IP_OPT
+  IP_OPT,
+  IPV6
 };
 
 extern enum TrafficClass NF_TRAFFIC_CLASS;
@@ -34,6 +34,16 @@ struct rte_ipv4_hdr *nf_get_mbuf_ipv4_header(struct rte_mbuf *mbuf) {
                                  sizeof(struct rte_ether_hdr));
 }
 
+struct rte_ipv6_hdr *nf_get_mbuf_ipv6_header(struct rte_mbuf *mbuf) {
+  struct rte_ether_hdr *ether_header = nf_get_mbuf_ether_header(mbuf);
+  if (ether_header->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)) {
+    return NULL;
+  }
+
+  return rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv6_hdr *,
+                                 sizeof(struct rte_ether_hdr));
+}
+
 struct arp_hdr *nf_get_mbuf_arp_header(struct rte_mbuf *mbuf){
   struct rte_ether_hdr *ether_header = nf_get_mbuf_ether_header(mbuf);
   if (ether_header->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_ARP)) {
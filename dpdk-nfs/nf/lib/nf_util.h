@@ -14,6 +14,7 @@ struct rte_icmp_hdr;
 
 // rte_ip
 struct rte_ipv4_hdr;
+struct rte_ipv6_hdr;
 
 // A header for TCP or UDP packets, containing common data.
 // (This is used to point into DPDK data structures!)
@@ -30,6 +31,8 @@ struct arp_hdr *nf_get_mbuf_arp_header(struct rte_mbuf *mbuf);
 // if they all took rte_mbuf
 struct rte_ipv4_hdr *nf_get_mbuf_ipv4_header(struct rte_mbuf *mbuf);
 
+struct rte_ipv6_hdr *nf_get_mbuf_ipv6_header(struct rte_mbuf *mbuf);
+
 struct tcpudp_hdr *nf_get_ipv4_tcpudp_header(struct rte_ipv4_hdr *header);
 
 struct rte_icmp_hdr *nf_get_ipv4_icmp_header(struct rte_ipv4_hdr *header);
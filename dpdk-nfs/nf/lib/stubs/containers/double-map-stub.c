@@ -203,6 +203,17 @@ int dmap_get_b(struct DoubleMap *map, void *key, int *index) {
   return 0;
 }
 
+// The hash is not modelled, as for map_get_with_hash (map-stub.c)
+int dmap_get_a_with_hash(struct DoubleMap *map, void *key, int hash,
+                         int *index) {
+  return dmap_get_a(map, key, index);
+}
+
+int dmap_get_b_with_hash(struct DoubleMap *map, void *key, int hash,
+                         int *index) {
+  return dmap_get_b(map, key, index);
+}
+
 int dmap_put(struct DoubleMap *map, void *value_, int index) {
   ALLOW(map);
 
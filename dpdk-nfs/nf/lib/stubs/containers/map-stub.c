@@ -254,6 +254,16 @@ __attribute__((noinline)) void map_put(struct Map *map, void *key, int value) {
   map->keys_seen++;
 }
 
+// The hash is not modelled: these are map_get and map_put, and are traced
+// as such (the specialization templates call those directly under KLEE)
+int map_get_with_hash(struct Map *map, void *key, int hash, int *value_out) {
+  return map_get(map, key, value_out);
+}
+
+void map_put_with_hash(struct Map *map, void *key, int hash, int value) {
+  map_put(map, key, value);
+}
+
 __attribute__((noinline)) void map_erase(struct Map *map, void *key,
                                          void **trash) {
   /* Tracing function and necessary variable(s) */
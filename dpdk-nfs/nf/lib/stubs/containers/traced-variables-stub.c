@@ -15,6 +15,8 @@ int traced_variable_type(char *variable, char **type) {
       !strcmp(variable, "expired_flows") ||
       !strcmp(variable, "backend_capacity") ||
       !strcmp(variable, "lpm_stages") || !strcmp(variable, "max_lpm_depth") ||
+      !strcmp(variable, "lpm6_levels") ||
+      !strcmp(variable, "lpm6_max_levels") ||
       !strcmp(variable, "available_backends")) {
     strcpy(*type, "PCV");
     return 1;
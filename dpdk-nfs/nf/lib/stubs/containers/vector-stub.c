@@ -1,5 +1,6 @@
 #include "klee/klee.h"
 #include "lib/containers/vector.h"
+#include "lib/containers/vector-group.h"
 #include "vector-stub-control.h"
 #include <stdint.h>
 #include <stdlib.h>
@@ -65,6 +66,19 @@ int vector_allocate(int elem_size, unsigned capacity,
   return 1;
 }
 
+int vector_allocate_group(unsigned capacity, int count,
+                          struct VectorGroupMember *members) {
+  // Not traced: the layout of the records is invisible to the NF, so the
+  // group is modelled as its vectors, each allocated (and traced) on its own.
+  for (int i = 0; i < count; ++i) {
+    if (!vector_allocate(members[i].elem_size, capacity, members[i].init_elem,
+                         members[i].vector_out)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
 void vector_reset(struct Vector *vector) {
   // Do not trace. This function is an internal knob of the model.
   // TODO: reallocate vector->data to avoid having the same pointer?
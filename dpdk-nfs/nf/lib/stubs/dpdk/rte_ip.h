@@ -39,6 +39,18 @@
   rte_be32_t dst_addr;            /**< destination address */
 } __attribute__((packed));
 
+/**
+ * IPv6 Header
+ */
+struct rte_ipv6_hdr {
+  rte_be32_t vtc_flow;   /**< IP version, traffic class & flow label. */
+  rte_be16_t payload_len; /**< IP payload size, including ext. headers */
+  uint8_t  proto;        /**< Protocol, next header. */
+  uint8_t  hop_limits;   /**< Hop limits. */
+  uint8_t  src_addr[16]; /**< IP address of source host. */
+  uint8_t  dst_addr[16]; /**< IP address of destination host(s). */
+} __attribute__((packed));
+
 __attribute__((noinline)) static uint16_t
 rte_ipv4_icmp_cksum(const struct rte_ipv4_hdr *ipv4_hdr, const void *l4_hdr) {
   return klee_int("ICMP_cksum");
@@ -0,0 +1,261 @@
+// Batch replay of KLEE test cases in one process.
+//
+// Tracing a test case used to take a fresh `executable` (or
+// `replayable-tracing`) per .ktest, redoing the EAL, mempool and device
+// initialization every time. None of that reads the test case: the first
+// symbolic value is taken when lcore_main allocates the NF state. So main()
+// runs the initialization once and calls replay_server_run() right before
+// lcore_main, which forks a child per test case. The child points
+// KTEST_FILE at its .ktest (the KLEE runtime opens it at the first symbolic
+// value) and goes on replaying as usual. The child starts in a directory of
+// its own, where the tracer writes trace.out: the parent forks from there,
+// so that a pintool can reopen its trace right after the fork (see
+// FPOINT_AFTER_IN_CHILD in pin/counts.cpp). The parent keeps REPLAY_JOBS
+// children running and appends every trace.out to a single output file,
+// with an index.
+//
+//   REPLAY_KTESTS        file listing the .ktest paths, one per line
+//   REPLAY_OUT           all traces, concatenated (default: traces.out); the
+//                        index is <REPLAY_OUT>.idx, one line
+//                        "<ktest> <offset> <length> <exit status>" per test
+//   REPLAY_JOBS          children at a time (default: online CPUs)
+//   REPLAY_TRACE_SUFFIX  also write each trace next to its .ktest, with this
+//                        suffix in place of .ktest (e.g. .tracelog)
+//
+// The child's copy-on-write memory is the reset: the containers, stubs and
+// tracer state of one test case never reach the next one.
+
+#ifdef VIGOR_EXECUTABLE
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "lib/stubs/replay_server.h"
+
+#define TRACE_FILE "trace.out"
+
+struct replay_job {
+  pid_t pid;
+  size_t test;
+  char dir[PATH_MAX];
+};
+
+static void replay_fail(const char *what, const char *arg) {
+  fprintf(stderr, "replay_server: %s %s: %s\n", what, arg, strerror(errno));
+  exit(1);
+}
+
+static char **read_ktests(const char *list, size_t *count) {
+  FILE *f = fopen(list, "r");
+  if (f == NULL) {
+    replay_fail("cannot open", list);
+  }
+
+  size_t capacity = 1024;
+  char **ktests = malloc(capacity * sizeof(char *));
+  char *line = NULL;
+  size_t line_capacity = 0;
+  ssize_t len;
+  *count = 0;
+  while ((len = getline(&line, &line_capacity, f)) != -1) {
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+      line[--len] = '\0';
+    }
+    if (len == 0) {
+      continue;
+    }
+    // The children change directory, so relative paths would break
+    char *path = realpath(line, NULL);
+    if (path == NULL) {
+      replay_fail("cannot find", line);
+    }
+    if (*count == capacity) {
+      capacity *= 2;
+      ktests = realloc(ktests, capacity * sizeof(char *));
+    }
+    ktests[(*count)++] = path;
+  }
+  free(line);
+  fclose(f);
+  return ktests;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag,
+                        struct FTW *ftwbuf) {
+  (void)sb;
+  (void)flag;
+  (void)ftwbuf;
+  return remove(path);
+}
+
+// Appends the child's trace to `out` (and its own file, with a suffix);
+// returns the trace length, or -1 if the child did not write one
+static long collect_trace(struct replay_job *job, const char *ktest,
+                          FILE *out, const char *suffix) {
+  char trace[PATH_MAX + sizeof(TRACE_FILE) + 1];
+  snprintf(trace, sizeof(trace), "%s/%s", job->dir, TRACE_FILE);
+  FILE *in = fopen(trace, "r");
+  if (in == NULL) {
+    return -1;
+  }
+
+  FILE *copy = NULL;
+  if (suffix != NULL) {
+    char path[PATH_MAX];
+    size_t base = strlen(ktest);
+    if (base > 6 && strcmp(ktest + base - 6, ".ktest") == 0) {
+      base -= 6;
+    }
+    snprintf(path, sizeof(path), "%.*s%s", (int)base, ktest, suffix);
+    copy = fopen(path, "w");
+    if (copy == NULL) {
+      replay_fail("cannot write", path);
+    }
+  }
+
+  char buf[1 << 16];
+  size_t n;
+  long length = 0;
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    if (fwrite(buf, 1, n, out) != n ||
+        (copy != NULL && fwrite(buf, 1, n, copy) != n)) {
+      replay_fail("cannot write trace of", ktest);
+    }
+    length += (long)n;
+  }
+  fclose(in);
+  if (copy != NULL) {
+    fclose(copy);
+  }
+  return length;
+}
+
+void replay_server_run(void) {
+  const char *list = getenv("REPLAY_KTESTS");
+  if (list == NULL) {
+    return;
+  }
+  const char *out_path = getenv("REPLAY_OUT");
+  if (out_path == NULL) {
+    out_path = "traces.out";
+  }
+  const char *suffix = getenv("REPLAY_TRACE_SUFFIX");
+  long jobs = getenv("REPLAY_JOBS") ? atol(getenv("REPLAY_JOBS"))
+                                    : sysconf(_SC_NPROCESSORS_ONLN);
+  if (jobs < 1) {
+    jobs = 1;
+  }
+
+  size_t count;
+  char **ktests = read_ktests(list, &count);
+
+  char index_path[PATH_MAX];
+  snprintf(index_path, sizeof(index_path), "%s.idx", out_path);
+  FILE *out = fopen(out_path, "w");
+  if (out == NULL) {
+    replay_fail("cannot write", out_path);
+  }
+  FILE *index = fopen(index_path, "w");
+  if (index == NULL) {
+    replay_fail("cannot write", index_path);
+  }
+
+  int cwd = open(".", O_RDONLY | O_DIRECTORY);
+  if (cwd < 0) {
+    replay_fail("cannot open", ".");
+  }
+
+  struct replay_job *running = calloc((size_t)jobs, sizeof(struct replay_job));
+  size_t next = 0;
+  long active = 0;
+  size_t failed = 0;
+  while (next < count || active > 0) {
+    for (long j = 0; j < jobs && next < count; j++) {
+      struct replay_job *job = &running[j];
+      if (job->pid != 0) {
+        continue;
+      }
+      job->test = next++;
+      snprintf(job->dir, sizeof(job->dir), "replay.XXXXXX");
+      if (mkdtemp(job->dir) == NULL) {
+        replay_fail("cannot create", job->dir);
+      }
+
+      // Buffered output would be written again by the child
+      fflush(NULL);
+      if (chdir(job->dir) != 0) {
+        replay_fail("cannot enter", job->dir);
+      }
+      pid_t pid = fork();
+      if (pid < 0) {
+        replay_fail("cannot fork for", ktests[job->test]);
+      }
+      if (pid == 0) {
+        if (setenv("KTEST_FILE", ktests[job->test], 1) != 0) {
+          replay_fail("cannot set up", ktests[job->test]);
+        }
+        close(cwd);
+        fclose(out);
+        fclose(index);
+        return;
+      }
+      if (fchdir(cwd) != 0) {
+        replay_fail("cannot return from", job->dir);
+      }
+      job->pid = pid;
+      active++;
+    }
+
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      replay_fail("waitpid", "");
+    }
+    struct replay_job *job = NULL;
+    for (long j = 0; j < jobs; j++) {
+      if (running[j].pid == pid) {
+        job = &running[j];
+      }
+    }
+    if (job == NULL) {
+      continue;
+    }
+
+    const char *ktest = ktests[job->test];
+    int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    long offset = ftell(out);
+    long length = collect_trace(job, ktest, out, suffix);
+    if (length < 0) {
+      fprintf(stderr, "replay_server: no %s for %s (exit status %d)\n",
+              TRACE_FILE, ktest, code);
+      length = 0;
+      failed++;
+    } else if (code != 0) {
+      fprintf(stderr, "replay_server: %s exited with status %d\n", ktest, code);
+      failed++;
+    }
+    fprintf(index, "%s %ld %ld %d\n", ktest, offset, length, code);
+    nftw(job->dir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    job->pid = 0;
+    active--;
+  }
+
+  close(cwd);
+  fclose(out);
+  fclose(index);
+  fprintf(stderr, "replay_server: replayed %zu test cases into %s, %zu failed\n",
+          count, out_path, failed);
+  exit(failed == 0 ? 0 : 1);
+}
+
+#endif // VIGOR_EXECUTABLE
@@ -0,0 +1,7 @@
+#pragma once
+
+// Batch replay of KLEE test cases (see replay_server.c).
+// Without REPLAY_KTESTS in the environment this returns right away. With it,
+// it returns once in each of the forked children, one per test case, and
+// exits in the parent when all of them are done.
+void replay_server_run(void);
@@ -0,0 +1,42 @@
+#!/usr/bin/python3
+
+import argparse
+import random
+
+# Rough prefix-length distribution of a full IPv4 BGP table.
+DEPTH_WEIGHTS = {
+    8: 0.0002, 12: 0.002, 13: 0.004, 14: 0.008, 15: 0.01, 16: 0.02,
+    17: 0.015, 18: 0.025, 19: 0.04, 20: 0.06, 21: 0.07, 22: 0.12,
+    23: 0.09, 24: 0.5, 25: 0.01, 26: 0.01, 27: 0.008, 28: 0.005,
+    29: 0.002, 30: 0.0008,
+}
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="create a synthetic pfx2as routing table")
+    parser.add_argument('--output', help='name of output pfx2as file',
+                        required=True)
+    parser.add_argument('--prefixes', type=int, default=1000000,
+                        help='number of prefixes to generate')
+    parser.add_argument('--ports', type=int, default=2,
+                        help='number of output ports (next hops)')
+    parser.add_argument('--seed', type=int, default=0)
+
+    args = parser.parse_args()
+    random.seed(args.seed)
+
+    depths = list(DEPTH_WEIGHTS.keys())
+    weights = list(DEPTH_WEIGHTS.values())
+
+    seen = set()
+    with open(args.output, 'w') as out:
+        while len(seen) < args.prefixes:
+            depth = random.choices(depths, weights)[0]
+            ip = random.getrandbits(32) & ((0xFFFFFFFF << (32 - depth)) & 0xFFFFFFFF)
+            if (ip, depth) in seen:
+                continue
+            seen.add((ip, depth))
+            port = random.randrange(args.ports)
+            out.write("%d.%d.%d.%d\t%d\t%d\n" % (ip >> 24, (ip >> 16) & 0xFF,
+                                                 (ip >> 8) & 0xFF, ip & 0xFF,
+                                                 depth, port))
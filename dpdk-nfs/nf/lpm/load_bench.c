@@ -0,0 +1,74 @@
+// Measures NF startup cost of lpm_init() on a given pfx2as file, then the
+// per-address cost of lpm_lookup() and lpm_lookup_bulk() on random addresses.
+// Usage: ./load-bench <EAL args> -- <pfx2as file>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rte_cycles.h>
+#include <rte_eal.h>
+
+#include "lpm/lpm.h"
+
+#define LOOKUP_ADDRS (1 << 20)
+#define LOOKUP_BURST 32
+
+int main(int argc, char *argv[]) {
+  int ret = rte_eal_init(argc, argv);
+  if (ret < 0) {
+    rte_exit(EXIT_FAILURE, "Error with EAL initialization, ret=%d\n", ret);
+  }
+  argc -= ret;
+  argv += ret;
+  if (argc < 2) {
+    rte_exit(EXIT_FAILURE, "Usage: %s <EAL args> -- <pfx2as file>\n",
+             argv[0]);
+  }
+
+  void *lpm;
+  uint64_t start = rte_get_tsc_cycles();
+  lpm_init(argv[1], &lpm);
+  uint64_t end = rte_get_tsc_cycles();
+
+  double ms = (double)(end - start) * 1000.0 / (double)rte_get_tsc_hz();
+  printf("lpm_init: %" PRIu64 " cycles, %.1f ms\n", end - start, ms);
+
+  uint32_t *addrs = malloc(LOOKUP_ADDRS * sizeof(uint32_t));
+  uint32_t *hops = malloc(LOOKUP_ADDRS * sizeof(uint32_t));
+  if (addrs == NULL || hops == NULL) {
+    rte_exit(EXIT_FAILURE, "Out of memory\n");
+  }
+  srand(0);
+  for (unsigned i = 0; i < LOOKUP_ADDRS; ++i) {
+    addrs[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+  }
+
+  uint32_t checksum = 0;
+  start = rte_get_tsc_cycles();
+  for (unsigned i = 0; i < LOOKUP_ADDRS; ++i) {
+    checksum += lpm_lookup(lpm, addrs[i]);
+  }
+  end = rte_get_tsc_cycles();
+  printf("lpm_lookup: %.1f cycles/address\n",
+         (double)(end - start) / LOOKUP_ADDRS);
+
+  start = rte_get_tsc_cycles();
+  for (unsigned i = 0; i < LOOKUP_ADDRS; i += LOOKUP_BURST) {
+    lpm_lookup_bulk(lpm, &addrs[i], LOOKUP_BURST, &hops[i]);
+  }
+  end = rte_get_tsc_cycles();
+  printf("lpm_lookup_bulk (%d): %.1f cycles/address\n", LOOKUP_BURST,
+         (double)(end - start) / LOOKUP_ADDRS);
+
+  for (unsigned i = 0; i < LOOKUP_ADDRS; ++i) {
+    checksum -= hops[i];
+  }
+  if (checksum != 0) {
+    rte_exit(EXIT_FAILURE, "lpm_lookup and lpm_lookup_bulk disagree\n");
+  }
+
+  free(addrs);
+  free(hops);
+  return 0;
+}
@@ -15,27 +15,53 @@
 #include "lib/nf_forward.h"
 #include "lib/nf_util.h"
 #include "lpm/lpm.h"
+#include "lpm/lpm6.h"
 
 struct nat_config config;
 void *lpm;
+void *lpm6;
 
 enum TrafficClass NF_TRAFFIC_CLASS = UNDEFINED;
 
 void nf_core_init(void) {
   lpm_init("routing-table.pfx2as", &lpm);
   assert(lpm);
+  lpm6_init("routing-table-v6.pfx2as", &lpm6);
+  assert(lpm6);
+}
+
+static int lookup_ipv6(struct rte_mbuf *mbuf) {
+  struct rte_ipv6_hdr *ip6_header = nf_get_mbuf_ipv6_header(mbuf);
+  if (ip6_header == NULL) {
+    return -1;
+  }
+  // Hop limit exceeded; we do not generate ICMPv6 errors, just drop.
+  if (ip6_header->hop_limits <= 1) {
+    return -1;
+  }
+  ip6_header->hop_limits--;
+  uint32_t hop = lpm6_lookup(lpm6, ip6_header->dst_addr);
+  if (hop >= rte_eth_dev_count_avail()) {
+    return -1;
+  }
+  return hop;
 }
 
 __attribute__((noinline))
 int nf_core_process(struct rte_mbuf *mbuf, time_t now) {
   // VIGOR_TAG(TRAFFIC_CLASS, PACKET_RECEIVED);
+  uint8_t dst_device;
   struct rte_ipv4_hdr *ip_header = nf_get_mbuf_ipv4_header(mbuf);
-  if (ip_header == NULL) {
-    return mbuf->port;
+  if (ip_header != NULL) {
+    dst_device = lpm_lookup(lpm, rte_be_to_cpu_32(ip_header->dst_addr));
+  } else {
+    int hop = lookup_ipv6(mbuf);
+    if (hop < 0) {
+      return mbuf->port;
+    }
+    dst_device = hop;
   }
 
-  uint8_t dst_device = lpm_lookup(lpm, rte_be_to_cpu_32(ip_header->dst_addr));
-
 #ifdef KLEE_VERIFICATION
   // Concretize the device, to avoid symbolic indexing.
   for (uint8_t d = 0; d < rte_eth_dev_count_avail(); ++d) {
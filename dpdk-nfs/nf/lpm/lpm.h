@@ -7,3 +7,7 @@
 
 void lpm_init(const char fname[], void **lpm_out);
 uint32_t lpm_lookup(void *lpm, uint32_t addr);
+// Looks up n addresses (host byte order) at once; hops[i] is the next hop of
+// addrs[i], or -1 if no prefix matches.
+void lpm_lookup_bulk(void *lpm, const uint32_t *addrs, unsigned n,
+                     uint32_t *hops);
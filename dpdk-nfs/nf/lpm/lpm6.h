@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+// IPv6 longest prefix match. Addresses are 16 bytes in network byte order,
+// as they appear in rte_ipv6_hdr. Next hops are 31-bit; -1 means no route.
+void lpm6_init(const char fname[], void **lpm_out);
+uint32_t lpm6_lookup(void *lpm, const uint8_t addr[16]);
+// Looks up n addresses at once; hops[i] is the next hop of addrs[i].
+void lpm6_lookup_bulk(void *lpm, const uint8_t (*addrs)[16], unsigned n,
+                      uint32_t *hops);
@@ -0,0 +1,333 @@
+// IPv6 longest prefix match on a Poptrie (Asai, Ohara, SIGCOMM '15).
+// The first 16 bits index a direct-pointing table; the remaining 112 bits are
+// consumed 6 at a time by compressed 64-ary nodes, for at most 19 node visits.
+// Each node stores two bitmaps and two base indices instead of 64 pointers:
+// children are contiguous, and runs of identical leaves are stored once, so
+// a node visit is one 24-byte read plus a popcount. The number of node visits
+// is the "lpm6_levels" PCV of the LPM6 contracts.
+
+#include "lpm6.h"
+#include "pfx2as.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_byteorder.h>
+#include <rte_debug.h>
+#include <rte_prefetch.h>
+
+#ifdef DUMP_PERF_VARS
+#include "lib/nf_log.h"
+#endif
+
+static const unsigned LPM6_MAX_RULES = 1e6;
+
+#define LPM6_TOP_BITS 16
+#define LPM6_TOP_ENTRIES (1 << LPM6_TOP_BITS)
+#define LPM6_STRIDE 6
+#define LPM6_NODE_FANOUT (1 << LPM6_STRIDE)
+#define LPM6_ADDR_BITS 128
+
+// Top-level entries either point to a node or hold a leaf.
+#define LPM6_TOP_NODE (1u << 31)
+
+// Leaves store next_hop + 1 so that 0 means "no route" and (leaf - 1) is the
+// lookup result either way.
+#define LPM6_NO_ROUTE 0
+
+// Number of lookups lpm6_lookup_bulk keeps in flight.
+#define LPM6_BATCH 8
+
+struct lpm6_node {
+  // Bit v set: slot v has a child node, at base1 + rank of v in vector.
+  uint64_t vector;
+  // Bit v set: slot v starts a new run of leaves, at base0 + rank of v.
+  uint64_t leafvec;
+  uint32_t base0;
+  uint32_t base1;
+};
+
+struct lpm6_poptrie {
+  uint32_t *top;
+  struct lpm6_node *nodes;
+  uint32_t *leaves;
+  uint32_t nodes_used, nodes_capacity;
+  uint32_t leaves_used, leaves_capacity;
+};
+
+typedef unsigned __int128 lpm6_addr_t;
+
+static inline lpm6_addr_t lpm6_addr(const uint8_t addr[16]) {
+  uint64_t hi, lo;
+  memcpy(&hi, addr, sizeof(hi));
+  memcpy(&lo, addr + 8, sizeof(lo));
+  return ((lpm6_addr_t)rte_be_to_cpu_64(hi) << 64) | rte_be_to_cpu_64(lo);
+}
+
+// The `stride` address bits starting at bit `offset` (from the MSB).
+static inline unsigned lpm6_bits(lpm6_addr_t addr, unsigned offset,
+                                 unsigned stride) {
+  return (unsigned)((addr << offset) >> (LPM6_ADDR_BITS - stride));
+}
+
+// Mask of the bits up to and including v.
+static inline uint64_t lpm6_rank_mask(unsigned v) {
+  return (2ull << v) - 1;
+}
+
+/* Construction */
+
+static uint32_t lpm6_reserve_nodes(struct lpm6_poptrie *lpm, uint32_t n) {
+  while (lpm->nodes_used + n > lpm->nodes_capacity) {
+    lpm->nodes_capacity = lpm->nodes_capacity ? 2 * lpm->nodes_capacity : 1024;
+    lpm->nodes =
+        realloc(lpm->nodes, lpm->nodes_capacity * sizeof(struct lpm6_node));
+    if (lpm->nodes == NULL) {
+      rte_exit(EXIT_FAILURE, "Cannot allocate the LPM6 table");
+    }
+  }
+  uint32_t first = lpm->nodes_used;
+  lpm->nodes_used += n;
+  return first;
+}
+
+static uint32_t lpm6_push_leaf(struct lpm6_poptrie *lpm, uint32_t leaf) {
+  if (lpm->leaves_used == lpm->leaves_capacity) {
+    lpm->leaves_capacity =
+        lpm->leaves_capacity ? 2 * lpm->leaves_capacity : 1024;
+    lpm->leaves =
+        realloc(lpm->leaves, lpm->leaves_capacity * sizeof(uint32_t));
+    if (lpm->leaves == NULL) {
+      rte_exit(EXIT_FAILURE, "Cannot allocate the LPM6 table");
+    }
+  }
+  lpm->leaves[lpm->leaves_used] = leaf;
+  return lpm->leaves_used++;
+}
+
+// Computes the leaf of each of the 2^stride slots under a node at `offset`,
+// from the prefixes in [lo, hi) that end within the node, and sets need_child
+// for the slots that some longer prefix goes through.
+static void lpm6_paint(const struct pfx2as6_entry *entries, size_t lo,
+                       size_t hi, unsigned offset, unsigned stride,
+                       uint32_t inherited, uint32_t *leaf, uint8_t *leaf_depth,
+                       uint8_t *need_child) {
+  unsigned slots = 1u << stride;
+  for (unsigned v = 0; v < slots; ++v) {
+    leaf[v] = inherited;
+    leaf_depth[v] = 0;
+    need_child[v] = 0;
+  }
+  for (size_t i = lo; i < hi; ++i) {
+    const struct pfx2as6_entry *entry = &entries[i];
+    unsigned first = lpm6_bits(lpm6_addr(entry->ip), offset, stride);
+    if (entry->depth > offset + stride) {
+      need_child[first] = 1;
+      continue;
+    }
+    unsigned count = 1u << (offset + stride - entry->depth);
+    for (unsigned v = first; v < first + count; ++v) {
+      // Entries at the same address come by increasing depth, but a shorter
+      // prefix at a lower address may come after a longer one.
+      if (leaf_depth[v] <= entry->depth) {
+        leaf[v] = entry->next_hop + 1;
+        leaf_depth[v] = entry->depth;
+      }
+    }
+  }
+}
+
+// The prefixes in [*lo, hi) that go through slot v of the node at `offset`
+// are contiguous: they share the slot bits and sort after any shorter prefix
+// starting at the same address. Narrows [*lo, *end) down to them.
+static void lpm6_slot_range(const struct pfx2as6_entry *entries, size_t *lo,
+                            size_t hi, unsigned offset, unsigned stride,
+                            unsigned v, size_t *end) {
+  size_t i = *lo;
+  while (lpm6_bits(lpm6_addr(entries[i].ip), offset, stride) != v ||
+         entries[i].depth <= offset + stride) {
+    ++i;
+  }
+  *lo = i;
+  while (i < hi && lpm6_bits(lpm6_addr(entries[i].ip), offset, stride) == v) {
+    ++i;
+  }
+  *end = i;
+}
+
+static void lpm6_build_node(struct lpm6_poptrie *lpm, uint32_t node_idx,
+                            const struct pfx2as6_entry *entries, size_t lo,
+                            size_t hi, unsigned offset, uint32_t inherited) {
+  uint32_t leaf[LPM6_NODE_FANOUT];
+  uint8_t leaf_depth[LPM6_NODE_FANOUT];
+  uint8_t need_child[LPM6_NODE_FANOUT];
+  lpm6_paint(entries, lo, hi, offset, LPM6_STRIDE, inherited, leaf, leaf_depth,
+             need_child);
+
+  uint64_t vector = 0;
+  uint64_t leafvec = 0;
+  uint32_t base0 = lpm->leaves_used;
+  int have_leaf = 0;
+  uint32_t last_leaf = 0;
+  for (unsigned v = 0; v < LPM6_NODE_FANOUT; ++v) {
+    if (need_child[v]) {
+      vector |= 1ull << v;
+    } else if (!have_leaf || leaf[v] != last_leaf) {
+      leafvec |= 1ull << v;
+      lpm6_push_leaf(lpm, leaf[v]);
+      have_leaf = 1;
+      last_leaf = leaf[v];
+    }
+  }
+
+  uint32_t base1 = lpm6_reserve_nodes(lpm, __builtin_popcountll(vector));
+  // lpm->nodes may move while building the children.
+  lpm->nodes[node_idx] = (struct lpm6_node){
+    .vector = vector, .leafvec = leafvec, .base0 = base0, .base1 = base1
+  };
+
+  uint32_t child = base1;
+  size_t i = lo;
+  for (unsigned v = 0; v < LPM6_NODE_FANOUT; ++v) {
+    if (!need_child[v]) {
+      continue;
+    }
+    size_t end;
+    lpm6_slot_range(entries, &i, hi, offset, LPM6_STRIDE, v, &end);
+    lpm6_build_node(lpm, child++, entries, i, end, offset + LPM6_STRIDE,
+                    leaf[v]);
+    i = end;
+  }
+}
+
+void lpm6_init(const char fname[], void **lpm_out) {
+  struct pfx2as6_table table;
+  pfx2as6_load(fname, LPM6_MAX_RULES, &table);
+
+  struct lpm6_poptrie *lpm = calloc(1, sizeof(struct lpm6_poptrie));
+  uint32_t *leaf = malloc(LPM6_TOP_ENTRIES * sizeof(uint32_t));
+  uint8_t *leaf_depth = malloc(LPM6_TOP_ENTRIES);
+  uint8_t *need_child = malloc(LPM6_TOP_ENTRIES);
+  if (lpm == NULL || leaf == NULL || leaf_depth == NULL || need_child == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate the LPM6 table");
+  }
+  lpm->top = leaf;
+
+  lpm6_paint(table.entries, 0, table.count, 0, LPM6_TOP_BITS, LPM6_NO_ROUTE,
+             leaf, leaf_depth, need_child);
+
+  size_t i = 0;
+  for (unsigned v = 0; v < LPM6_TOP_ENTRIES; ++v) {
+    if (!need_child[v]) {
+      continue;
+    }
+    size_t end;
+    lpm6_slot_range(table.entries, &i, table.count, 0, LPM6_TOP_BITS, v, &end);
+    uint32_t node = lpm6_reserve_nodes(lpm, 1);
+    lpm6_build_node(lpm, node, table.entries, i, end, LPM6_TOP_BITS, leaf[v]);
+    // Overwriting leaf[v] is fine: the child took its own copy as inherited.
+    lpm->top[v] = LPM6_TOP_NODE | node;
+    i = end;
+  }
+
+  free(leaf_depth);
+  free(need_child);
+  pfx2as6_free(&table);
+
+  *lpm_out = lpm;
+}
+
+/* Lookup */
+
+// One node visit. Returns 1 and updates *node_idx if the lookup continues in
+// a child, 0 and sets *hop otherwise.
+static inline int lpm6_step(const struct lpm6_poptrie *lpm, uint32_t *node_idx,
+                            lpm6_addr_t addr, unsigned offset, uint32_t *hop) {
+  const struct lpm6_node *node = &lpm->nodes[*node_idx];
+  unsigned v = lpm6_bits(addr, offset, LPM6_STRIDE);
+  uint64_t mask = lpm6_rank_mask(v);
+  if (node->vector & (1ull << v)) {
+    *node_idx = node->base1 + __builtin_popcountll(node->vector & mask) - 1;
+    return 1;
+  }
+  *hop = lpm->leaves[node->base0 + __builtin_popcountll(node->leafvec & mask) -
+                     1] -
+         1;
+  return 0;
+}
+
+static inline uint32_t lpm6_top_index(const uint8_t addr[16]) {
+  return (uint32_t)addr[0] << 8 | addr[1];
+}
+
+uint32_t lpm6_lookup(void *lpm_ptr, const uint8_t addr[16]) {
+  const struct lpm6_poptrie *lpm = lpm_ptr;
+  uint32_t entry = lpm->top[lpm6_top_index(addr)];
+  uint32_t hop = entry - 1;
+  int levels = 0;
+  if (entry & LPM6_TOP_NODE) {
+    lpm6_addr_t a = lpm6_addr(addr);
+    uint32_t node_idx = entry & ~LPM6_TOP_NODE;
+    unsigned offset = LPM6_TOP_BITS;
+    for (;;) {
+      ++levels;
+      if (!lpm6_step(lpm, &node_idx, a, offset, &hop)) {
+        break;
+      }
+      offset += LPM6_STRIDE;
+    }
+  }
+#ifdef DUMP_PERF_VARS
+  NF_PERF_DEBUG("Lpm6_lookup:lpm6_levels:%d", levels);
+#else
+  (void)levels;
+#endif
+  return hop;
+}
+
+// Walks up to LPM6_BATCH tries in lockstep, so that the node reads of the
+// different lookups overlap instead of each one stalling on its own chain.
+static void lpm6_lookup_batch(const struct lpm6_poptrie *lpm,
+                              const uint8_t (*addrs)[16], unsigned n,
+                              uint32_t *hops) {
+  lpm6_addr_t a[LPM6_BATCH];
+  uint32_t node_idx[LPM6_BATCH];
+  unsigned active = 0;
+
+  for (unsigned k = 0; k < n; ++k) {
+    uint32_t entry = lpm->top[lpm6_top_index(addrs[k])];
+    hops[k] = entry - 1;
+    if (entry & LPM6_TOP_NODE) {
+      a[k] = lpm6_addr(addrs[k]);
+      node_idx[k] = entry & ~LPM6_TOP_NODE;
+      rte_prefetch0(&lpm->nodes[node_idx[k]]);
+      active |= 1u << k;
+    }
+  }
+
+  for (unsigned offset = LPM6_TOP_BITS; active != 0; offset += LPM6_STRIDE) {
+    for (unsigned k = 0; k < n; ++k) {
+      if (!(active & (1u << k))) {
+        continue;
+      }
+      if (lpm6_step(lpm, &node_idx[k], a[k], offset, &hops[k])) {
+        rte_prefetch0(&lpm->nodes[node_idx[k]]);
+      } else {
+        active &= ~(1u << k);
+      }
+    }
+  }
+}
+
+void lpm6_lookup_bulk(void *lpm_ptr, const uint8_t (*addrs)[16], unsigned n,
+                      uint32_t *hops) {
+  const struct lpm6_poptrie *lpm = lpm_ptr;
+  for (unsigned i = 0; i < n; i += LPM6_BATCH) {
+    unsigned batch = n - i < LPM6_BATCH ? n - i : LPM6_BATCH;
+    for (unsigned k = i + LPM6_BATCH; k < i + 2 * LPM6_BATCH && k < n; ++k) {
+      rte_prefetch0(&lpm->top[lpm6_top_index(addrs[k])]);
+    }
+    lpm6_lookup_batch(lpm, addrs + i, batch, hops + i);
+  }
+}
@@ -0,0 +1,26 @@
+#include "lpm6.h"
+
+#include <rte_ethdev.h>
+#include <stdlib.h>
+
+#include <klee/klee.h>
+
+// 16-bit top level, then 6-bit strides: at most 19 node visits.
+#define LPM6_MAX_LEVELS 19
+
+void __attribute__((noinline)) lpm6_init(const char fname[], void **lpm_out) {
+  *lpm_out = malloc(1);
+  klee_trace_ret();
+}
+
+uint32_t __attribute__((noinline))
+lpm6_lookup(void *lpm, const uint8_t addr[16]) {
+  klee_trace_ret();
+  int lpm6_levels = klee_range(0, LPM6_MAX_LEVELS + 1, "lpm6_levels");
+  if (lpm6_levels > 0) {
+    ds_path_2();
+  } else
+    ds_path_1();
+  TRACE_VAR(lpm6_levels, "lpm6_levels")
+  return klee_range(0, rte_eth_dev_count_avail(), "lpm6_next_hop");
+}
@@ -0,0 +1,238 @@
+// Self-contained DIR-24-8 longest prefix match (Gupta, Lin, McKeown '98).
+// A lookup reads exactly one tbl24 entry and, for addresses covered by a
+// prefix longer than 24 bits, one tbl8 entry; that second access is the
+// "multi_stage_lookup" PCV of the LPM contracts.
+
+#include "lpm.h"
+#include "pfx2as.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_debug.h>
+#include <rte_prefetch.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#ifdef DUMP_PERF_VARS
+#include "lib/nf_log.h"
+#endif
+
+static const unsigned LPM_MAX_RULES = 1e6;
+
+#define LPM_TBL24_ENTRIES (1 << 24)
+#define LPM_TBL8_GROUP_ENTRIES (1 << 8)
+
+// Entry layout, identical for tbl24 and tbl8:
+//  [31]    valid
+//  [30]    extended: tbl24 only, bits [23:0] hold a tbl8 group index
+//  [29:24] depth of the prefix that wrote the entry
+//  [23:0]  next hop
+#define LPM_ENTRY_VALID (1u << 31)
+#define LPM_ENTRY_EXT (1u << 30)
+#define LPM_ENTRY_DEPTH_SHIFT 24
+#define LPM_ENTRY_DEPTH_MASK (0x3Fu << LPM_ENTRY_DEPTH_SHIFT)
+#define LPM_ENTRY_DATA_MASK 0x00FFFFFFu
+
+// How many addresses ahead lpm_lookup_bulk prefetches tbl24 entries.
+#define LPM_PREFETCH_DISTANCE 8
+
+struct lpm_dir24_8 {
+  uint32_t *tbl24;
+  uint32_t *tbl8;
+  uint32_t tbl8_groups;
+  uint32_t tbl8_used;
+  int use_avx2;
+};
+
+static inline uint32_t lpm_entry(uint8_t depth, uint32_t next_hop) {
+  return LPM_ENTRY_VALID | ((uint32_t)depth << LPM_ENTRY_DEPTH_SHIFT) |
+         (next_hop & LPM_ENTRY_DATA_MASK);
+}
+
+static inline uint8_t lpm_entry_depth(uint32_t entry) {
+  return (entry & LPM_ENTRY_DEPTH_MASK) >> LPM_ENTRY_DEPTH_SHIFT;
+}
+
+// Overwrites entry unless it already holds a longer prefix.
+static inline void lpm_entry_set(uint32_t *entry, uint32_t new_entry,
+                                 uint8_t depth) {
+  if (!(*entry & LPM_ENTRY_VALID) || lpm_entry_depth(*entry) <= depth) {
+    *entry = new_entry;
+  }
+}
+
+static void lpm_add(struct lpm_dir24_8 *lpm, uint32_t ip, uint8_t depth,
+                    uint32_t next_hop) {
+  uint32_t new_entry = lpm_entry(depth, next_hop);
+
+  if (depth <= 24) {
+    uint32_t first = depth == 0 ? 0 : (ip >> 8) & (~0u << (24 - depth));
+    uint32_t count = 1u << (24 - depth);
+    for (uint32_t i = first; i < first + count; ++i) {
+      uint32_t *entry = &lpm->tbl24[i];
+      if (*entry & LPM_ENTRY_EXT) {
+        uint32_t *group =
+            &lpm->tbl8[(*entry & LPM_ENTRY_DATA_MASK) * LPM_TBL8_GROUP_ENTRIES];
+        for (int j = 0; j < LPM_TBL8_GROUP_ENTRIES; ++j) {
+          lpm_entry_set(&group[j], new_entry, depth);
+        }
+      } else {
+        lpm_entry_set(entry, new_entry, depth);
+      }
+    }
+    return;
+  }
+
+  uint32_t *entry = &lpm->tbl24[ip >> 8];
+  if (!(*entry & LPM_ENTRY_EXT)) {
+    if (lpm->tbl8_used == lpm->tbl8_groups) {
+      rte_exit(EXIT_FAILURE, "LPM table out of tbl8 groups (%u)\n",
+               lpm->tbl8_groups);
+    }
+    uint32_t group_idx = lpm->tbl8_used++;
+    uint32_t *group = &lpm->tbl8[group_idx * LPM_TBL8_GROUP_ENTRIES];
+    // The group inherits whatever shorter prefix covered the /24.
+    for (int j = 0; j < LPM_TBL8_GROUP_ENTRIES; ++j) {
+      group[j] = *entry;
+    }
+    *entry = LPM_ENTRY_VALID | LPM_ENTRY_EXT | group_idx;
+  }
+
+  uint32_t *group =
+      &lpm->tbl8[(*entry & LPM_ENTRY_DATA_MASK) * LPM_TBL8_GROUP_ENTRIES];
+  uint32_t first = ip & 0xFF & (0xFFu << (32 - depth));
+  uint32_t count = 1u << (32 - depth);
+  for (uint32_t j = first; j < first + count; ++j) {
+    lpm_entry_set(&group[j], new_entry, depth);
+  }
+}
+
+void lpm_init(const char fname[], void **lpm_out) {
+  struct pfx2as_table table;
+  pfx2as_load(fname, LPM_MAX_RULES, &table);
+
+  struct lpm_dir24_8 *lpm = malloc(sizeof(struct lpm_dir24_8));
+  if (lpm == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate the LPM table");
+  }
+  lpm->tbl8_groups = table.tbl8_groups > 0 ? table.tbl8_groups : 1;
+  lpm->tbl8_used = 0;
+  lpm->tbl24 = calloc(LPM_TBL24_ENTRIES, sizeof(uint32_t));
+  lpm->tbl8 = calloc((size_t)lpm->tbl8_groups * LPM_TBL8_GROUP_ENTRIES,
+                     sizeof(uint32_t));
+  if (lpm->tbl24 == NULL || lpm->tbl8 == NULL) {
+    rte_exit(EXIT_FAILURE, "Cannot allocate the LPM table");
+  }
+#if defined(__x86_64__)
+  lpm->use_avx2 = __builtin_cpu_supports("avx2");
+#else
+  lpm->use_avx2 = 0;
+#endif
+
+  for (size_t i = 0; i < table.count; ++i) {
+    struct pfx2as_entry *entry = &table.entries[i];
+    lpm_add(lpm, entry->ip, entry->depth, entry->next_hop);
+  }
+  pfx2as_free(&table);
+
+  *lpm_out = lpm;
+}
+
+static inline uint32_t lpm_resolve(const struct lpm_dir24_8 *lpm,
+                                   uint32_t entry, uint32_t addr) {
+  if (unlikely(entry & LPM_ENTRY_EXT)) {
+    entry = lpm->tbl8[(entry & LPM_ENTRY_DATA_MASK) * LPM_TBL8_GROUP_ENTRIES +
+                      (addr & 0xFF)];
+  }
+  return (entry & LPM_ENTRY_VALID) ? (entry & LPM_ENTRY_DATA_MASK) : -1;
+}
+
+uint32_t lpm_lookup(void *lpm_ptr, uint32_t addr) {
+  const struct lpm_dir24_8 *lpm = lpm_ptr;
+  uint32_t entry = lpm->tbl24[addr >> 8];
+#ifdef DUMP_PERF_VARS
+  NF_PERF_DEBUG("Lpm_lookup:multi_stage_lookup:%d",
+                (entry & LPM_ENTRY_EXT) != 0);
+#endif
+  return lpm_resolve(lpm, entry, addr);
+}
+
+#if defined(__x86_64__)
+// 8 lookups per iteration: one gather for the tbl24 entries and, only if some
+// lane is extended, a second masked gather for the tbl8 entries.
+__attribute__((target("avx2"))) static void
+lpm_lookup_bulk_avx2(const struct lpm_dir24_8 *lpm, const uint32_t *addrs,
+                     unsigned n, uint32_t *hops) {
+  const __m256i ext_bit = _mm256_set1_epi32(LPM_ENTRY_EXT);
+  const __m256i valid_bit = _mm256_set1_epi32(LPM_ENTRY_VALID);
+  const __m256i data_mask = _mm256_set1_epi32(LPM_ENTRY_DATA_MASK);
+  const __m256i low_byte = _mm256_set1_epi32(0xFF);
+  const __m256i miss = _mm256_set1_epi32(-1);
+
+  unsigned i = 0;
+  for (; i + 8 <= n; i += 8) {
+    if (i + 8 + LPM_PREFETCH_DISTANCE <= n) {
+      for (int k = 0; k < 8; ++k) {
+        rte_prefetch0(&lpm->tbl24[addrs[i + LPM_PREFETCH_DISTANCE + k] >> 8]);
+      }
+    }
+    __m256i addr = _mm256_loadu_si256((const __m256i *)&addrs[i]);
+    __m256i entry = _mm256_i32gather_epi32(
+        (const int *)lpm->tbl24, _mm256_srli_epi32(addr, 8), 4);
+
+    __m256i ext = _mm256_cmpeq_epi32(_mm256_and_si256(entry, ext_bit),
+                                     ext_bit);
+    int ext_lanes = _mm256_movemask_ps(_mm256_castsi256_ps(ext));
+    if (unlikely(ext_lanes != 0)) {
+      __m256i tbl8_idx = _mm256_or_si256(
+          _mm256_slli_epi32(_mm256_and_si256(entry, data_mask), 8),
+          _mm256_and_si256(addr, low_byte));
+      entry = _mm256_mask_i32gather_epi32(entry, (const int *)lpm->tbl8,
+                                          tbl8_idx, ext, 4);
+    }
+
+    __m256i valid = _mm256_cmpeq_epi32(_mm256_and_si256(entry, valid_bit),
+                                       valid_bit);
+    __m256i hop = _mm256_blendv_epi8(miss, _mm256_and_si256(entry, data_mask),
+                                     valid);
+    _mm256_storeu_si256((__m256i *)&hops[i], hop);
+  }
+
+  for (; i < n; ++i) {
+    hops[i] = lpm_resolve(lpm, lpm->tbl24[addrs[i] >> 8], addrs[i]);
+  }
+}
+#endif
+
+// Two passes so that the tbl24 loads of a burst overlap: first fetch all
+// tbl24 entries (prefetching ahead), then resolve the extended ones.
+static void lpm_lookup_bulk_scalar(const struct lpm_dir24_8 *lpm,
+                                   const uint32_t *addrs, unsigned n,
+                                   uint32_t *hops) {
+  for (unsigned i = 0; i < n; ++i) {
+    if (i + LPM_PREFETCH_DISTANCE < n) {
+      rte_prefetch0(&lpm->tbl24[addrs[i + LPM_PREFETCH_DISTANCE] >> 8]);
+    }
+    hops[i] = lpm->tbl24[addrs[i] >> 8];
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    hops[i] = lpm_resolve(lpm, hops[i], addrs[i]);
+  }
+}
+
+void lpm_lookup_bulk(void *lpm_ptr, const uint32_t *addrs, unsigned n,
+                     uint32_t *hops) {
+  const struct lpm_dir24_8 *lpm = lpm_ptr;
+#if defined(__x86_64__)
+  if (lpm->use_avx2) {
+    lpm_lookup_bulk_avx2(lpm, addrs, n, hops);
+  } else
+#endif
+  {
+    lpm_lookup_bulk_scalar(lpm, addrs, n, hops);
+  }
+}
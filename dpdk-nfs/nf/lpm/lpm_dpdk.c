@@ -1,18 +1,24 @@
 #include "lpm.h"
+#include "pfx2as.h"
 
 #include <stdio.h>
-#include <arpa/inet.h>
 #include <rte_lpm.h>
 #include <rte_lcore.h>
 
 static const unsigned LPM_MAX_RULES = 1e6;
+// Lower bound on tbl8 groups; the actual number is sized from the table.
 static const unsigned LPM_NUMBER_TBL8S = 1 << 8;
 
 
 void lpm_init(const char fname[], void **lpm_out) {
+  struct pfx2as_table table;
+  pfx2as_load(fname, LPM_MAX_RULES, &table);
+
   struct rte_lpm_config config_lpm;
-  config_lpm.max_rules = LPM_MAX_RULES;
-  config_lpm.number_tbl8s = LPM_NUMBER_TBL8S;
+  config_lpm.max_rules = table.count > 0 ? table.count : 1;
+  config_lpm.number_tbl8s = table.tbl8_groups > LPM_NUMBER_TBL8S
+                                ? table.tbl8_groups
+                                : LPM_NUMBER_TBL8S;
   config_lpm.flags = 0;
   *lpm_out = rte_lpm_create("route_table", rte_socket_id(), &config_lpm);
   if (*lpm_out == NULL) {
@@ -20,45 +26,19 @@ void lpm_init(const char fname[], void **lpm_out) {
              rte_socket_id());
   }
 
-  FILE *pfx2as_file = fopen(fname, "r");
-  if (pfx2as_file == NULL) {
-    rte_exit(EXIT_FAILURE, "Error opening pfx2as file: %s.\n", fname);
-  }
-
-  for (unsigned long count = 0; count < LPM_MAX_RULES; ++count) {
-    char ip_str[INET_ADDRSTRLEN];
-    uint32_t ip;
-    uint8_t depth;
-    int port;
-
-    int result = fscanf(pfx2as_file, "%s", ip_str);
-    if (result == EOF) {
-      break;
-    }
-
-    if (result != 1) {
-      rte_exit(EXIT_FAILURE, "Error in ipaddr in pfx2as file %s:%lu\n", fname,
-               count);
-    }
-
-    result = fscanf(pfx2as_file, "%hh" PRIu8, &depth);
-    if (result != 1) {
-      rte_exit(EXIT_FAILURE, "Error in prefix detpth in pfx2as file %s:%lu\n",
-               fname, count);
-    }
-
-    result = fscanf(pfx2as_file, "%d_", &port);
-    if (result == 1) {
-      while (getc(pfx2as_file) != '\n')
-        continue;
-    }
-    inet_pton(AF_INET, ip_str, &ip);
-    result = rte_lpm_add(*lpm_out, rte_be_to_cpu_32(ip), depth, port);
+  // Entries are sorted by increasing depth, so every tbl24/tbl8 entry is
+  // written once per covering prefix and no tbl8 group is expanded twice.
+  // rte_lpm_add still checks each rule against the others of its depth; for
+  // full BGP tables, lpm_dir24_8.c (the default) builds its tables directly.
+  for (size_t i = 0; i < table.count; ++i) {
+    struct pfx2as_entry *entry = &table.entries[i];
+    int result =
+        rte_lpm_add(*lpm_out, entry->ip, entry->depth, entry->next_hop);
     if (result < 0) {
-      rte_exit(EXIT_FAILURE, "Cannot add entry %lu to the LPM table.", count);
+      rte_exit(EXIT_FAILURE, "Cannot add entry %zu to the LPM table.", i);
     }
   }
-  fclose(pfx2as_file);
+  pfx2as_free(&table);
 }
 
 uint32_t lpm_lookup(void *lpm, uint32_t addr) {
@@ -66,3 +46,13 @@ uint32_t lpm_lookup(void *lpm, uint32_t addr) {
   int result = rte_lpm_lookup(lpm, addr, &next_hop);
   return result == 0 ? next_hop : -1;
 }
+
+void lpm_lookup_bulk(void *lpm, const uint32_t *addrs, unsigned n,
+                     uint32_t *hops) {
+  rte_lpm_lookup_bulk(lpm, addrs, hops, n);
+  for (unsigned i = 0; i < n; ++i) {
+    hops[i] = (hops[i] & RTE_LPM_LOOKUP_SUCCESS)
+                  ? hops[i] & 0x00FFFFFF
+                  : (uint32_t)-1;
+  }
+}
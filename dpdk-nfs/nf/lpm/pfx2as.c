@@ -0,0 +1,317 @@
+#include "pfx2as.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <rte_debug.h>
+
+#define PFX2AS_MAX_DEPTH 32
+#define PFX2AS6_MAX_DEPTH 128
+
+static inline int is_blank(char c) { return c == ' ' || c == '\t'; }
+
+static inline int is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static inline const char *skip_blanks(const char *p, const char *end) {
+  while (p < end && is_blank(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+// Parses an unsigned decimal number, returns NULL if there is no digit at p.
+static inline const char *parse_uint(const char *p, const char *end,
+                                     uint32_t *out) {
+  if (p == end || !is_digit(*p)) {
+    return NULL;
+  }
+  uint64_t value = 0;
+  while (p < end && is_digit(*p)) {
+    value = value * 10 + (uint64_t)(*p - '0');
+    if (value > UINT32_MAX) {
+      return NULL;
+    }
+    ++p;
+  }
+  *out = (uint32_t)value;
+  return p;
+}
+
+static inline const char *parse_ipv4(const char *p, const char *end,
+                                     uint32_t *out) {
+  uint32_t ip = 0;
+  for (int i = 0; i < 4; ++i) {
+    uint32_t octet;
+    if (i != 0) {
+      if (p == end || *p != '.') {
+        return NULL;
+      }
+      ++p;
+    }
+    p = parse_uint(p, end, &octet);
+    if (p == NULL || octet > 255) {
+      return NULL;
+    }
+    ip = (ip << 8) | octet;
+  }
+  *out = ip;
+  return p;
+}
+
+static size_t count_lines(const char *data, size_t size) {
+  size_t lines = 0;
+  const char *p = data;
+  const char *end = data + size;
+  while (p < end) {
+    const char *nl = memchr(p, '\n', end - p);
+    ++lines;
+    if (nl == NULL) {
+      break;
+    }
+    p = nl + 1;
+  }
+  return lines;
+}
+
+static const char *map_file(const char fname[], size_t *size_out) {
+  int fd = open(fname, O_RDONLY);
+  if (fd < 0) {
+    rte_exit(EXIT_FAILURE, "Error opening pfx2as file: %s.\n", fname);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    rte_exit(EXIT_FAILURE, "Cannot stat pfx2as file: %s.\n", fname);
+  }
+
+  size_t size = (size_t)st.st_size;
+  const char *data = NULL;
+  if (size != 0) {
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    if (data == MAP_FAILED) {
+      rte_exit(EXIT_FAILURE, "Cannot mmap pfx2as file: %s.\n", fname);
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  *size_out = size;
+  return data;
+}
+
+static void unmap_file(const char *data, size_t size) {
+  if (data != NULL) {
+    munmap((void *)data, size);
+  }
+}
+
+void pfx2as_load(const char fname[], size_t max_entries,
+                 struct pfx2as_table *table_out) {
+  size_t size;
+  const char *data = map_file(fname, &size);
+
+  size_t capacity = count_lines(data, size);
+  if (capacity > max_entries) {
+    capacity = max_entries;
+  }
+  struct pfx2as_entry *parsed = malloc((capacity + 1) * sizeof(*parsed));
+  struct pfx2as_entry *sorted = malloc((capacity + 1) * sizeof(*sorted));
+  // One bit per /24 block, to count the tbl8 groups the table will need.
+  uint8_t *long_blocks = calloc((1 << 24) / 8, 1);
+  if (parsed == NULL || sorted == NULL || long_blocks == NULL) {
+    rte_exit(EXIT_FAILURE, "Out of memory loading pfx2as file: %s.\n", fname);
+  }
+
+  size_t depth_count[PFX2AS_MAX_DEPTH + 1] = { 0 };
+  uint32_t tbl8_groups = 0;
+  size_t count = 0;
+  unsigned long line = 0;
+  const char *p = data;
+  const char *end = data + size;
+  while (p < end && count < capacity) {
+    ++line;
+    const char *eol = memchr(p, '\n', end - p);
+    if (eol == NULL) {
+      eol = end;
+    }
+
+    p = skip_blanks(p, eol);
+    if (p == eol || *p == '\r') {
+      // Empty line
+      p = eol + 1;
+      continue;
+    }
+
+    uint32_t ip;
+    uint32_t depth;
+    uint32_t next_hop;
+    p = parse_ipv4(p, eol, &ip);
+    if (p == NULL || p == eol || !is_blank(*p)) {
+      rte_exit(EXIT_FAILURE, "Error in ipaddr in pfx2as file %s:%lu\n", fname,
+               line);
+    }
+    p = parse_uint(skip_blanks(p, eol), eol, &depth);
+    if (p == NULL || depth > PFX2AS_MAX_DEPTH) {
+      rte_exit(EXIT_FAILURE, "Error in prefix depth in pfx2as file %s:%lu\n",
+               fname, line);
+    }
+    // Multi-origin ASes look like "123_456" or "123,456"; keep the first one.
+    p = parse_uint(skip_blanks(p, eol), eol, &next_hop);
+    if (p == NULL) {
+      rte_exit(EXIT_FAILURE, "Error in next hop in pfx2as file %s:%lu\n",
+               fname, line);
+    }
+
+    // Normalize host bits away, as rte_lpm_add does.
+    ip = depth == 0 ? 0 : ip & (UINT32_MAX << (PFX2AS_MAX_DEPTH - depth));
+    parsed[count] = (struct pfx2as_entry){
+      .ip = ip, .next_hop = next_hop, .depth = (uint8_t)depth
+    };
+    ++depth_count[depth];
+    ++count;
+
+    if (depth > 24) {
+      uint32_t block = ip >> 8;
+      uint8_t mask = (uint8_t)(1 << (block & 7));
+      if (!(long_blocks[block >> 3] & mask)) {
+        long_blocks[block >> 3] |= mask;
+        ++tbl8_groups;
+      }
+    }
+
+    p = eol + 1;
+  }
+
+  // Counting sort by depth: O(n), stable.
+  size_t offsets[PFX2AS_MAX_DEPTH + 1];
+  size_t offset = 0;
+  for (int d = 0; d <= PFX2AS_MAX_DEPTH; ++d) {
+    offsets[d] = offset;
+    offset += depth_count[d];
+  }
+  for (size_t i = 0; i < count; ++i) {
+    sorted[offsets[parsed[i].depth]++] = parsed[i];
+  }
+
+  free(parsed);
+  free(long_blocks);
+  unmap_file(data, size);
+
+  table_out->entries = sorted;
+  table_out->count = count;
+  table_out->tbl8_groups = tbl8_groups;
+}
+
+void pfx2as_free(struct pfx2as_table *table) {
+  free(table->entries);
+  table->entries = NULL;
+  table->count = 0;
+  table->tbl8_groups = 0;
+}
+
+static int pfx2as6_compare(const void *a, const void *b) {
+  const struct pfx2as6_entry *ea = a;
+  const struct pfx2as6_entry *eb = b;
+  int result = memcmp(ea->ip, eb->ip, sizeof(ea->ip));
+  if (result != 0) {
+    return result;
+  }
+  return (int)ea->depth - (int)eb->depth;
+}
+
+void pfx2as6_load(const char fname[], size_t max_entries,
+                  struct pfx2as6_table *table_out) {
+  size_t size;
+  const char *data = map_file(fname, &size);
+
+  size_t capacity = count_lines(data, size);
+  if (capacity > max_entries) {
+    capacity = max_entries;
+  }
+  struct pfx2as6_entry *entries = malloc((capacity + 1) * sizeof(*entries));
+  if (entries == NULL) {
+    rte_exit(EXIT_FAILURE, "Out of memory loading pfx2as file: %s.\n", fname);
+  }
+
+  size_t count = 0;
+  unsigned long line = 0;
+  const char *p = data;
+  const char *end = data + size;
+  while (p < end && count < capacity) {
+    ++line;
+    const char *eol = memchr(p, '\n', end - p);
+    if (eol == NULL) {
+      eol = end;
+    }
+
+    p = skip_blanks(p, eol);
+    if (p == eol || *p == '\r') {
+      // Empty line
+      p = eol + 1;
+      continue;
+    }
+
+    // IPv6 text addresses are irregular enough that inet_pton is worth it;
+    // v6 tables are also an order of magnitude smaller than v4 ones.
+    char ip_str[INET6_ADDRSTRLEN];
+    const char *ip_end = p;
+    while (ip_end < eol && !is_blank(*ip_end)) {
+      ++ip_end;
+    }
+    struct pfx2as6_entry *entry = &entries[count];
+    if (ip_end - p >= INET6_ADDRSTRLEN) {
+      rte_exit(EXIT_FAILURE, "Error in ipaddr in pfx2as file %s:%lu\n", fname,
+               line);
+    }
+    memcpy(ip_str, p, ip_end - p);
+    ip_str[ip_end - p] = '\0';
+    if (inet_pton(AF_INET6, ip_str, entry->ip) != 1) {
+      rte_exit(EXIT_FAILURE, "Error in ipaddr in pfx2as file %s:%lu\n", fname,
+               line);
+    }
+
+    uint32_t depth;
+    uint32_t next_hop;
+    p = parse_uint(skip_blanks(ip_end, eol), eol, &depth);
+    if (p == NULL || depth > PFX2AS6_MAX_DEPTH) {
+      rte_exit(EXIT_FAILURE, "Error in prefix depth in pfx2as file %s:%lu\n",
+               fname, line);
+    }
+    p = parse_uint(skip_blanks(p, eol), eol, &next_hop);
+    if (p == NULL) {
+      rte_exit(EXIT_FAILURE, "Error in next hop in pfx2as file %s:%lu\n",
+               fname, line);
+    }
+
+    // Normalize host bits away.
+    for (unsigned byte = 0; byte < 16; ++byte) {
+      unsigned bit = byte * 8;
+      if (bit >= depth) {
+        entry->ip[byte] = 0;
+      } else if (depth - bit < 8) {
+        entry->ip[byte] &= (uint8_t)(0xFF << (8 - (depth - bit)));
+      }
+    }
+    entry->depth = (uint8_t)depth;
+    entry->next_hop = next_hop;
+    ++count;
+
+    p = eol + 1;
+  }
+  unmap_file(data, size);
+
+  qsort(entries, count, sizeof(*entries), pfx2as6_compare);
+
+  table_out->entries = entries;
+  table_out->count = count;
+}
+
+void pfx2as6_free(struct pfx2as6_table *table) {
+  free(table->entries);
+  table->entries = NULL;
+  table->count = 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One line of a CAIDA pfx2as routing table: "<ip> <depth> <next hop>[_...]".
+// The address is kept in host byte order.
+struct pfx2as_entry {
+  uint32_t ip;
+  uint32_t next_hop;
+  uint8_t depth;
+};
+
+struct pfx2as_table {
+  struct pfx2as_entry *entries;
+  size_t count;
+  // Number of distinct /24 blocks that contain a prefix longer than 24 bits,
+  // i.e. the number of tbl8 groups a DIR-24-8 table needs to hold the routes.
+  uint32_t tbl8_groups;
+};
+
+// Memory-maps and parses fname, at most max_entries routes.
+// Entries come out sorted by increasing depth (stable w.r.t. file order),
+// so inserting them in order never rewrites a longer prefix with a shorter one.
+// Exits via rte_exit on malformed input.
+void pfx2as_load(const char fname[], size_t max_entries,
+                 struct pfx2as_table *table_out);
+
+void pfx2as_free(struct pfx2as_table *table);
+
+// IPv6 variant; the address is kept in network byte order.
+struct pfx2as6_entry {
+  uint8_t ip[16];
+  uint32_t next_hop;
+  uint8_t depth;
+};
+
+struct pfx2as6_table {
+  struct pfx2as6_entry *entries;
+  size_t count;
+};
+
+// Entries come out sorted by address, then by increasing depth, so that all
+// prefixes under a given trie node are contiguous.
+void pfx2as6_load(const char fname[], size_t max_entries,
+                  struct pfx2as6_table *table_out);
+
+void pfx2as6_free(struct pfx2as6_table *table);
@@ -5,6 +5,10 @@
 #include <klee/klee.h>
 #endif
 
+#ifdef VIGOR_EXECUTABLE
+#include "lib/stubs/replay_server.h"
+#endif
+
 #include <inttypes.h>
 #include <stdio.h>
 #include <assert.h>
@@ -436,6 +440,12 @@ int main(int argc, char *argv[]) {
     mmap_file[i] = 0;
 #endif //DUMP_LATENCY 
 
+#ifdef VIGOR_EXECUTABLE
+  // Nothing above reads the test case; with REPLAY_KTESTS set, fork from
+  // here once per test case instead of starting over for each of them.
+  replay_server_run();
+#endif // VIGOR_EXECUTABLE
+
   lcore_main();
 
   return 0;
@@ -3,9 +3,13 @@
 #include <fstream>
 #include <string>
 
+#include "trace-format.h"
+
 // This is more or less copied from the pintool examples
 
 ofstream trace;
+trace_format::TraceWriter binary_trace;
+static bool binary = false;
 static bool is_counting = false;
 static UINT64 instr_count = 0;
 static UINT64 mem_count = 0;
@@ -16,20 +20,37 @@ typedef struct {
   std::string function;
   std::string assembly;
   std::string category;
+  uint32_t binary_id;
 } instruction_data_t;
 
 std::vector<std::pair<bool, unsigned long>> addresses;
 
+KNOB<BOOL> KnobBinary(KNOB_MODE_WRITEONCE, "pintool", "binary", "0",
+                      "write a binary trace (trace-format.h, trace-dump prints it as text)");
+
 VOID log_read_op(VOID *ip, VOID *addr) {
- if(is_counting)  addresses.push_back(std::make_pair(0, (unsigned long)addr));
+ if(is_counting && binary) binary_trace.mem_op((unsigned long)addr, false);
+ else if(is_counting)  addresses.push_back(std::make_pair(0, (unsigned long)addr));
 }
 
 VOID log_write_op(VOID *ip, VOID *addr) {
-  if(is_counting) addresses.push_back(std::make_pair(1, (unsigned long)addr));
+  if(is_counting && binary) binary_trace.mem_op((unsigned long)addr, true);
+  else if(is_counting) addresses.push_back(std::make_pair(1, (unsigned long)addr));
 }
 
+static const LEVEL_BASE::REG binary_registers[trace_format::NUM_REGISTERS] = {
+  LEVEL_BASE::REG_RAX, LEVEL_BASE::REG_RBX, LEVEL_BASE::REG_RDI, LEVEL_BASE::REG_RSI,
+  LEVEL_BASE::REG_RDX, LEVEL_BASE::REG_RCX, LEVEL_BASE::REG_RBP, LEVEL_BASE::REG_RSP,
+  LEVEL_BASE::REG_R8, LEVEL_BASE::REG_R9, LEVEL_BASE::REG_R10, LEVEL_BASE::REG_R11,
+  LEVEL_BASE::REG_R12, LEVEL_BASE::REG_R13, LEVEL_BASE::REG_R14, LEVEL_BASE::REG_R15};
+
 VOID log_instruction(CONTEXT* ctx, instruction_data_t *id) {
-  if (is_counting) { 
+  if (is_counting && binary) {
+    uint64_t registers[trace_format::NUM_REGISTERS];
+    for (unsigned r = 0; r < trace_format::NUM_REGISTERS; r++)
+      registers[r] = PIN_GetContextReg(ctx, binary_registers[r]);
+    binary_trace.record(id->binary_id, registers);
+  } else if (is_counting) { 
 
   /* Printing instruction category */
   trace << id->category << std::endl;
@@ -118,6 +139,8 @@ VOID trace_instr(INS ins, VOID* v)
     id->function = RTN_FindNameByAddress(id->ip);
     id->assembly = INS_Disassemble(ins);
     id->category = CATEGORY_StringShort(INS_Category(ins));
+    if (binary)
+      id->binary_id = binary_trace.add_instruction(id->ip, id->function, id->assembly, id->category);
 
     for (UINT32 memOp = 0; memOp < memOperands; memOp++) {
     if (INS_MemoryOperandIsRead(ins, memOp)) {
@@ -166,7 +189,10 @@ VOID Image(IMG img, VOID* v)
 
 VOID Fini(INT32 code, VOID* v)
 {
-	trace.close();
+	if (binary)
+		binary_trace.close();
+	else
+		trace.close();
 }
 
 
@@ -178,7 +204,15 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
-	trace.open("pincounts.log", ios::trunc);
+	binary = KnobBinary.Value();
+	if (binary) {
+		if (!binary_trace.open("pincounts.log", trace_format::FLAG_REGISTERS)) {
+			std::cout << "ERROR: could not open pincounts.log..." << std::endl;
+			return 1;
+		}
+	} else {
+		trace.open("pincounts.log", ios::trunc);
+	}
 
 	IMG_AddInstrumentFunction(Image, 0);
 	INS_AddInstrumentFunction(trace_instr, 0);
@@ -0,0 +1,375 @@
+// Replays the memory accesses of instruction traces through a simulated
+// L1/L2/LLC hierarchy and prints, per trace (one KLEE path), the hits and
+// misses of every level as CSV.
+//
+// Traces are the text traces of pin/counts.cpp ("<ip> |<fn> | <asm> | r<addr>
+// w<addr>", addresses in hex), as the .tracelog rules of the NF Makefile
+// write them, or their binary form (-binary 1, see
+// trace-format.h). Each trace starts from the same warm state: that of
+// replaying --warm <trace>, and of the first --warm-packets packets of the
+// trace itself, which are not counted. Traces are simulated in parallel.
+//
+// The caches are set associative with LRU replacement, write-allocate, and
+// filled on the way back from a miss. The optional prefetcher tracks the
+// stride of every memory operand of every instruction (a copy's load and
+// store stride apart) and, once a stride repeats, fetches the next
+// --prefetch lines of it into L2.
+//
+// Usage: cache-sim [options] <trace>...
+//   --l1 SIZE,WAYS  --l2 SIZE,WAYS  --llc SIZE,WAYS   (e.g. 32K,8)
+//   --line BYTES  --prefetch DEGREE  --warm TRACE  --warm-packets N  -j N
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "trace-reader.h"
+
+struct CacheConfig {
+  uint64_t size;
+  unsigned ways;
+};
+
+struct Config {
+  CacheConfig levels[3] = {{32 << 10, 8}, {1 << 20, 16}, {32 << 20, 16}};
+  unsigned line = 64;
+  unsigned prefetch = 0;
+  unsigned warm_packets = 0;
+  std::string warm;
+  unsigned jobs = std::thread::hardware_concurrency();
+};
+
+static const char *const LEVEL_NAMES[3] = {"l1", "l2", "llc"};
+
+class Cache {
+public:
+  Cache(const CacheConfig &config, unsigned line)
+      : ways(config.ways), sets(config.size / line / config.ways),
+        tags(sets * ways, EMPTY), stamps(sets * ways, 0), clock(0) {}
+
+  // Looks the line up, and fills it on a miss
+  bool access(uint64_t line_addr) {
+    uint64_t set = line_addr % sets;
+    uint64_t *tag = &tags[set * ways];
+    uint64_t *stamp = &stamps[set * ways];
+    unsigned victim = 0;
+    for (unsigned w = 0; w < ways; w++) {
+      if (tag[w] == line_addr) {
+        stamp[w] = ++clock;
+        return true;
+      }
+      if (stamp[w] < stamp[victim]) {
+        victim = w;
+      }
+    }
+    tag[victim] = line_addr;
+    stamp[victim] = ++clock;
+    return false;
+  }
+
+private:
+  static const uint64_t EMPTY = ~0ull;
+
+  unsigned ways;
+  uint64_t sets;
+  std::vector<uint64_t> tags;
+  std::vector<uint64_t> stamps;
+  uint64_t clock;
+};
+
+struct Counts {
+  uint64_t accesses = 0;
+  uint64_t hits[3] = {0, 0, 0};
+  uint64_t misses[3] = {0, 0, 0};
+  uint64_t prefetches = 0;
+};
+
+struct Stride {
+  uint64_t last;
+  int64_t stride;
+  bool confirmed;
+};
+
+class Hierarchy {
+public:
+  explicit Hierarchy(const Config &config)
+      : line_bits(__builtin_ctz(config.line)), prefetch(config.prefetch) {
+    for (unsigned l = 0; l < 3; l++) {
+      caches.push_back(Cache(config.levels[l], config.line));
+    }
+  }
+
+  // slot: the index of the access among those of its instruction
+  void access(uint64_t ip, unsigned slot, uint64_t addr, bool counted) {
+    uint64_t line_addr = addr >> line_bits;
+    if (counted) {
+      counts.accesses++;
+    }
+    for (unsigned l = 0; l < 3; l++) {
+      bool hit = caches[l].access(line_addr);
+      if (counted) {
+        (hit ? counts.hits : counts.misses)[l]++;
+      }
+      if (hit) {
+        break;
+      }
+    }
+    if (prefetch != 0) {
+      train(ip, slot, addr, counted);
+    }
+  }
+
+  Counts counts;
+
+private:
+  void train(uint64_t ip, unsigned slot, uint64_t addr, bool counted) {
+    // User-space ips fit in 48 bits, an instruction has few memory operands
+    uint64_t key = ip << 8 | (slot & 0xff);
+    auto it = strides.find(key);
+    if (it == strides.end()) {
+      strides[key] = Stride{addr, 0, false};
+      return;
+    }
+    Stride &s = it->second;
+    int64_t stride = (int64_t)(addr - s.last);
+    s.confirmed = stride != 0 && stride == s.stride;
+    s.stride = stride;
+    s.last = addr;
+    if (!s.confirmed) {
+      return;
+    }
+    for (unsigned d = 1; d <= prefetch; d++) {
+      uint64_t line_addr = (addr + s.stride * (int64_t)d) >> line_bits;
+      if (!caches[1].access(line_addr)) {
+        caches[2].access(line_addr);
+      }
+      if (counted) {
+        counts.prefetches++;
+      }
+    }
+  }
+
+  unsigned line_bits;
+  unsigned prefetch;
+  std::vector<Cache> caches;
+  std::unordered_map<uint64_t, Stride> strides; // by (ip, slot)
+};
+
+static bool is_binary(const char *path) {
+  char magic[sizeof(trace_format::MAGIC)];
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    return false;
+  }
+  bool binary = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+                memcmp(magic, trace_format::MAGIC, sizeof(magic)) == 0;
+  fclose(f);
+  return binary;
+}
+
+// Counts the packets of a trace; boundaries before the first instruction,
+// or repeated, do not start a new one
+struct PacketCounter {
+  unsigned packets = 0;
+  bool in_packet = false;
+
+  void boundary() {
+    packets += in_packet;
+    in_packet = false;
+  }
+  bool counted(unsigned warm_packets) {
+    in_packet = true;
+    return packets >= warm_packets;
+  }
+};
+
+// Replays the trace into the hierarchy; false if it cannot be read
+static bool replay(const char *path, Hierarchy &h, unsigned warm_packets,
+                   std::string &error) {
+  PacketCounter packets;
+  if (is_binary(path)) {
+    trace_format::TraceReader reader;
+    if (!reader.open(path)) {
+      error = reader.error();
+      return false;
+    }
+    trace_format::Record r;
+    while (reader.next(r)) {
+      if (r.packet) {
+        packets.boundary();
+        continue;
+      }
+      bool counted = packets.counted(warm_packets);
+      for (unsigned i = 0; i < r.num_mem; i++) {
+        h.access(r.instruction->ip, i, r.mem[i].addr, counted);
+      }
+    }
+    if (reader.error() != NULL) {
+      error = reader.error();
+      return false;
+    }
+    return true;
+  }
+
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    error = strerror(errno);
+    return false;
+  }
+  char *line = NULL;
+  size_t capacity = 0;
+  ssize_t len;
+  while ((len = getline(&line, &capacity, f)) != -1) {
+    if (strncmp(line, "New Packet", 10) == 0) {
+      packets.boundary();
+      continue;
+    }
+    // Register and category lines (abstract-interpretation) have no '|'
+    char *ops = strrchr(line, '|');
+    if (ops == NULL) {
+      continue;
+    }
+    uint64_t ip = strtoull(line, NULL, 16);
+    bool counted = packets.counted(warm_packets);
+    unsigned slot = 0;
+    for (char *p = ops + 1; *p != '\0';) {
+      if ((*p == 'r' || *p == 'w') && (p == ops + 1 || p[-1] == ' ')) {
+        char *end;
+        uint64_t addr = strtoull(p + 1, &end, 16);
+        if (end != p + 1) {
+          h.access(ip, slot++, addr, counted);
+        }
+        p = end;
+      } else {
+        p++;
+      }
+    }
+  }
+  free(line);
+  fclose(f);
+  return true;
+}
+
+static bool parse_cache(const char *arg, CacheConfig &c) {
+  char *end;
+  c.size = strtoull(arg, &end, 10);
+  if (*end == 'K' || *end == 'k') {
+    c.size <<= 10;
+    end++;
+  } else if (*end == 'M' || *end == 'm') {
+    c.size <<= 20;
+    end++;
+  }
+  if (*end != ',') {
+    return false;
+  }
+  c.ways = strtoul(end + 1, &end, 10);
+  return *end == '\0' && c.ways > 0 && c.size > 0;
+}
+
+static int usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [--l1|--l2|--llc SIZE,WAYS] [--line BYTES] "
+          "[--prefetch DEGREE] [--warm TRACE] [--warm-packets N] [-j N] "
+          "<trace>...\n",
+          prog);
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  Config config;
+  std::vector<const char *> traces;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if ((arg == "--l1" || arg == "--l2" || arg == "--llc") && has_value) {
+      unsigned l = arg == "--l1" ? 0 : arg == "--l2" ? 1 : 2;
+      if (!parse_cache(argv[++i], config.levels[l])) {
+        return usage(argv[0]);
+      }
+    } else if (arg == "--line" && has_value) {
+      config.line = atoi(argv[++i]);
+    } else if (arg == "--prefetch" && has_value) {
+      config.prefetch = atoi(argv[++i]);
+    } else if (arg == "--warm" && has_value) {
+      config.warm = argv[++i];
+    } else if (arg == "--warm-packets" && has_value) {
+      config.warm_packets = atoi(argv[++i]);
+    } else if (arg == "-j" && has_value) {
+      config.jobs = atoi(argv[++i]);
+    } else if (arg[0] == '-') {
+      return usage(argv[0]);
+    } else {
+      traces.push_back(argv[i]);
+    }
+  }
+  if (traces.empty() || config.line == 0 ||
+      (config.line & (config.line - 1)) != 0) {
+    return usage(argv[0]);
+  }
+  for (unsigned l = 0; l < 3; l++) {
+    if (config.levels[l].size % ((uint64_t)config.line * config.levels[l].ways)) {
+      fprintf(stderr, "%s: %s is not a whole number of sets\n", argv[0],
+              LEVEL_NAMES[l]);
+      return 1;
+    }
+  }
+
+  Hierarchy warm(config);
+  std::string error;
+  if (!config.warm.empty() && !replay(config.warm.c_str(), warm, 0, error)) {
+    fprintf(stderr, "%s: %s\n", config.warm.c_str(), error.c_str());
+    return 1;
+  }
+  warm.counts = Counts();
+
+  std::vector<Counts> results(traces.size());
+  std::vector<std::string> errors(traces.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t t; (t = next++) < traces.size();) {
+      Hierarchy h = warm;
+      if (replay(traces[t], h, config.warm_packets, errors[t])) {
+        results[t] = h.counts;
+      } else if (errors[t].empty()) {
+        errors[t] = "cannot read the trace";
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned j = 0; j < std::max(config.jobs, 1u); j++) {
+    threads.push_back(std::thread(worker));
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  int status = 0;
+  printf("trace,accesses");
+  for (unsigned l = 0; l < 3; l++) {
+    printf(",%s_hits,%s_misses", LEVEL_NAMES[l], LEVEL_NAMES[l]);
+  }
+  printf(",prefetches\n");
+  for (size_t t = 0; t < traces.size(); t++) {
+    if (!errors[t].empty()) {
+      fprintf(stderr, "%s: %s\n", traces[t], errors[t].c_str());
+      status = 1;
+      continue;
+    }
+    const Counts &c = results[t];
+    printf("%s,%" PRIu64, traces[t], c.accesses);
+    for (unsigned l = 0; l < 3; l++) {
+      printf(",%" PRIu64 ",%" PRIu64, c.hits[l], c.misses[l]);
+    }
+    printf(",%" PRIu64 "\n", c.prefetches);
+  }
+  return status;
+}
@@ -3,7 +3,11 @@
 #include <iostream>
 #include <string>
 
+#include "trace-format.h"
+
 std::ofstream trace;
+trace_format::TraceWriter binary_trace;
+static bool binary = false;
 static bool is_counting = false;
 static UINT64 instr_count = 0;
 static UINT64 mem_count = 0;
@@ -12,6 +16,7 @@ typedef struct {
   unsigned long ip;
   std::string function;
   std::string assembly;
+  uint32_t binary_id;
 } instruction_data_t;
 
 std::string start_fn = "";
@@ -27,19 +32,28 @@ KNOB<std::string> KnobStartFn(KNOB_MODE_WRITEONCE, "pintool", "start-fn",
                          "specify function at which to start tracing");
 KNOB<std::string> KnobEndFn(KNOB_MODE_WRITEONCE, "pintool", "end-fn", "exit@plt",
                        "specify function at which to end tracing");
+KNOB<BOOL> KnobBinary(KNOB_MODE_WRITEONCE, "pintool", "binary", "0",
+                      "write a binary trace (trace-format.h, trace-dump "
+                      "prints it as text)");
 
 VOID log_read_op(VOID *ip, VOID *addr) {
-  if (is_counting)
+  if (is_counting && binary)
+    binary_trace.mem_op((unsigned long)addr, false);
+  else if (is_counting)
     addresses.push_back(std::make_pair(0, (unsigned long)addr));
 }
 
 VOID log_write_op(VOID *ip, VOID *addr) {
-  if (is_counting)
+  if (is_counting && binary)
+    binary_trace.mem_op((unsigned long)addr, true);
+  else if (is_counting)
     addresses.push_back(std::make_pair(1, (unsigned long)addr));
 }
 
 VOID log_instruction(instruction_data_t *id) {
-  if (is_counting) {
+  if (is_counting && binary) {
+    binary_trace.record(id->binary_id, NULL);
+  } else if (is_counting) {
 
     trace << std::hex << std::uppercase << id->ip << " |";
 
@@ -94,6 +108,11 @@ VOID trace_instr(INS ins, VOID *v) {
   id->ip = INS_Address(ins);
   id->function = RTN_FindNameByAddress(id->ip);
   id->assembly = INS_Disassemble(ins);
+  if (binary) {
+    id->binary_id = binary_trace.add_instruction(
+        id->ip, id->function, id->assembly,
+        CATEGORY_StringShort(INS_Category(ins)));
+  }
 
   for (UINT32 memOp = 0; memOp < memOperands; memOp++) {
     if (INS_MemoryOperandIsRead(ins, memOp)) {
@@ -118,7 +137,10 @@ VOID trace_instr(INS ins, VOID *v) {
 VOID trace_after(ADDRINT ret) {
   is_counting = false;
   //	trace << instr_count << " " << mem_count << " " << std::endl;
-  trace << "New Packet" << std::endl;
+  if (binary)
+    binary_trace.packet();
+  else
+    trace << "New Packet" << std::endl;
   instr_count = 0;
   mem_count = 0;
 }
@@ -161,23 +183,73 @@ VOID Image(IMG img, VOID *v) {
   }
 }
 
-VOID Fini(INT32 code, VOID *v) { trace.close(); }
+// Opens trace.out in the current directory and starts the first packet
+static bool open_trace() {
+  if (binary) {
+    if (!binary_trace.reopen("trace.out")) {
+      return false;
+    }
+    binary_trace.packet();
+  } else {
+    if (trace.is_open()) {
+      trace.close();
+    }
+    trace.open("trace.out", std::ofstream::out);
+    if (!trace) {
+      return false;
+    }
+    trace << "New Packet" << std::endl;
+  }
+  return true;
+}
+
+// The replay server (lib/stubs/replay_server.c) forks a child per test case
+// in that test case's directory: flush first, so that the child does not
+// write the parent's buffered output again, then give the child a trace of
+// its own there.
+VOID BeforeFork(THREADID tid, const CONTEXT *ctxt, VOID *v) {
+  if (binary)
+    binary_trace.sync();
+  else
+    trace.flush();
+}
+
+VOID AfterForkInChild(THREADID tid, const CONTEXT *ctxt, VOID *v) {
+  if (!open_trace()) {
+    std::cout << "ERROR: could not reopen trace.out in the child..."
+              << std::endl;
+    PIN_ExitProcess(1);
+  }
+}
+
+VOID Fini(INT32 code, VOID *v) {
+  if (binary)
+    binary_trace.close();
+  else
+    trace.close();
+}
 
 int main(int argc, char *argv[]) {
-  trace.open("trace.out", std::ofstream::out);
-  trace << "New Packet" << std::endl;
   PIN_InitSymbols();
   if (PIN_Init(argc, argv)) {
     std::cout << "ERROR: could not init pin..." << std::endl;
     return 1;
   }
 
+  binary = KnobBinary.Value();
+  if (!open_trace()) {
+    std::cout << "ERROR: could not open trace.out..." << std::endl;
+    return 1;
+  }
+
   start_fn = KnobStartFn.Value();
   end_fn = KnobEndFn.Value();
 
   IMG_AddInstrumentFunction(Image, 0);
   INS_AddInstrumentFunction(trace_instr, 0);
 
+  PIN_AddForkFunction(FPOINT_BEFORE, BeforeFork, 0);
+  PIN_AddForkFunction(FPOINT_AFTER_IN_CHILD, AfterForkInChild, 0);
   PIN_AddFiniFunction(Fini, 0);
 
   PIN_StartProgram();
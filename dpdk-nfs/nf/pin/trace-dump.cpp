@@ -0,0 +1,76 @@
+// Prints a binary instruction trace (trace-format.h) in the text format of
+// the pintools, or with --stats, one "instructions reads writes" line per
+// packet.
+//
+// Usage: trace-dump [--stats] <trace>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "trace-reader.h"
+
+using trace_format::Record;
+using trace_format::TraceReader;
+
+static void print_record(const TraceReader &reader, const Record &r) {
+  if (r.packet) {
+    fputs("New Packet\n", stdout);
+    return;
+  }
+  if (reader.has_registers()) {
+    printf("%s\n", r.instruction->category.c_str());
+    for (unsigned i = 0; i < trace_format::NUM_REGISTERS; i++) {
+      printf("%s = %" PRIX64 "\n", trace_format::REGISTER_NAMES[i],
+             r.registers[i]);
+    }
+  }
+  printf("%" PRIX64 " |%s | %s |", r.instruction->ip,
+         r.instruction->function.c_str(), r.instruction->assembly.c_str());
+  for (unsigned i = 0; i < r.num_mem; i++) {
+    printf(" %c%" PRIX64, r.mem[i].write ? 'w' : 'r', r.mem[i].addr);
+  }
+  putchar('\n');
+}
+
+int main(int argc, char *argv[]) {
+  bool stats = argc == 3 && strcmp(argv[1], "--stats") == 0;
+  if (argc != 2 && !stats) {
+    fprintf(stderr, "Usage: %s [--stats] <trace>\n", argv[0]);
+    return 1;
+  }
+
+  TraceReader reader;
+  if (!reader.open(argv[argc - 1])) {
+    fprintf(stderr, "%s: %s\n", argv[argc - 1], reader.error());
+    return 1;
+  }
+
+  Record r;
+  uint64_t instructions = 0, reads = 0, writes = 0;
+  while (reader.next(r)) {
+    if (!stats) {
+      print_record(reader, r);
+    } else if (r.packet) {
+      if (instructions != 0) {
+        printf("%" PRIu64 " %" PRIu64 " %" PRIu64 "\n", instructions, reads,
+               writes);
+      }
+      instructions = reads = writes = 0;
+    } else {
+      instructions++;
+      for (unsigned i = 0; i < r.num_mem; i++) {
+        r.mem[i].write ? writes++ : reads++;
+      }
+    }
+  }
+  if (stats && instructions != 0) {
+    printf("%" PRIu64 " %" PRIu64 " %" PRIu64 "\n", instructions, reads,
+           writes);
+  }
+  if (reader.error() != NULL) {
+    fprintf(stderr, "%s: %s\n", argv[argc - 1], reader.error());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+// Binary instruction traces, written by the pintools with -binary 1 and read
+// back with trace-reader.h (trace-dump turns them into the text format).
+//
+// A trace is an 8-byte magic, a varint version and a varint of flags,
+// followed by chunks, each starting with a tag byte:
+//
+//   'I' instruction: varint id, varint ip, then function, assembly and
+//       category as varint length + bytes. Written once per instruction,
+//       before the first block that executes it.
+//   'B' block: varint record count, varint byte length, then the records.
+//   'P' packet boundary (the "New Packet" line of the text traces).
+//
+// A record is one executed instruction:
+//
+//   varint  zigzag(id - previous id) << 4 | memory operands (15: more follow
+//           in an extra varint, as count - 15)
+//   varint  zigzag(address - previous address) << 1 | is_write, per operand
+//   varint  zigzag(value - previous value), per register (FLAG_REGISTERS)
+//
+// The previous values start at 0 in every block, so blocks decode on their
+// own. Consecutive instructions are mostly a few ids apart and touch nearby
+// addresses, which takes most records down to 2-4 bytes.
+//
+// Only stdio here: the pintools link against the Pin CRT.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+namespace trace_format {
+
+static const char MAGIC[8] = {'P', 'I', 'X', 'T', 'R', 'A', 'C', 'E'};
+static const uint64_t VERSION = 1;
+
+// The 16 general purpose registers, before the instruction, in this order
+static const uint64_t FLAG_REGISTERS = 1;
+static const unsigned NUM_REGISTERS = 16;
+static const char *const REGISTER_NAMES[NUM_REGISTERS] = {
+    "rax", "rbx", "rdi", "rsi", "rdx", "rcx", "rbp", "rsp",
+    "r8",  "r9",  "r10", "r11", "r12", "r13", "r14", "r15"};
+
+static const char CHUNK_INSTRUCTION = 'I';
+static const char CHUNK_BLOCK = 'B';
+static const char CHUNK_PACKET = 'P';
+
+static const unsigned INLINE_MEM_OPS = 15;
+// Memory operands kept per executed instruction; x86 has at most a few
+static const unsigned MAX_MEM_OPS = 32;
+static const size_t BLOCK_SIZE = 1 << 16;
+
+static inline uint64_t zigzag(int64_t v) {
+  return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline void put_varint(std::string &out, uint64_t v) {
+  while (v >= 0x80) {
+    out += (char)(v | 0x80);
+    v >>= 7;
+  }
+  out += (char)v;
+}
+
+static inline void put_string(std::string &out, const std::string &s) {
+  put_varint(out, s.size());
+  out += s;
+}
+
+class TraceWriter {
+public:
+  TraceWriter() : out(NULL), flags(0), next_id(0), num_mem(0) { reset(); }
+
+  bool open(const char *path, uint64_t trace_flags) {
+    out = fopen(path, "wb");
+    if (out == NULL) {
+      return false;
+    }
+    flags = trace_flags;
+    std::string header(MAGIC, sizeof(MAGIC));
+    put_varint(header, VERSION);
+    put_varint(header, flags);
+    fwrite(header.data(), 1, header.size(), out);
+    return true;
+  }
+
+  // At instrumentation time; the id goes to record()
+  uint32_t add_instruction(uint64_t ip, const std::string &function,
+                           const std::string &assembly,
+                           const std::string &category) {
+    uint32_t id = next_id++;
+    std::string chunk(1, CHUNK_INSTRUCTION);
+    put_varint(chunk, id);
+    put_varint(chunk, ip);
+    put_string(chunk, function);
+    put_string(chunk, assembly);
+    put_string(chunk, category);
+    table += chunk;
+    instructions += chunk;
+    return id;
+  }
+
+  // Memory operands of the next record
+  void mem_op(uint64_t addr, bool write) {
+    if (num_mem < MAX_MEM_OPS) {
+      mem_addrs[num_mem] = addr;
+      mem_writes[num_mem] = write;
+      num_mem++;
+    }
+  }
+
+  // registers: NUM_REGISTERS values with FLAG_REGISTERS, NULL otherwise
+  void record(uint32_t id, const uint64_t *registers) {
+    put_varint(block, zigzag((int64_t)id - (int64_t)prev_id) << 4 |
+                          (num_mem < INLINE_MEM_OPS ? num_mem : INLINE_MEM_OPS));
+    if (num_mem >= INLINE_MEM_OPS) {
+      put_varint(block, num_mem - INLINE_MEM_OPS);
+    }
+    prev_id = id;
+    for (unsigned i = 0; i < num_mem; i++) {
+      put_varint(block, zigzag((int64_t)(mem_addrs[i] - prev_addr)) << 1 |
+                            mem_writes[i]);
+      prev_addr = mem_addrs[i];
+    }
+    num_mem = 0;
+    if (flags & FLAG_REGISTERS) {
+      for (unsigned r = 0; r < NUM_REGISTERS; r++) {
+        put_varint(block, zigzag((int64_t)(registers[r] - prev_regs[r])));
+        prev_regs[r] = registers[r];
+      }
+    }
+    records++;
+    if (block.size() >= BLOCK_SIZE) {
+      flush();
+    }
+  }
+
+  void packet() {
+    flush();
+    fputc(CHUNK_PACKET, out);
+  }
+
+  void close() {
+    if (out != NULL) {
+      flush();
+      fclose(out);
+      out = NULL;
+    }
+  }
+
+  // Starts a new trace at path, e.g. in a forked child. The instructions
+  // instrumented so far are written again, the records not yet flushed are
+  // dropped; the old file is left as it is.
+  bool reopen(const char *path) {
+    if (out != NULL) {
+      fclose(out);
+      out = NULL;
+    }
+    reset();
+    num_mem = 0;
+    if (!open(path, flags)) {
+      return false;
+    }
+    table = instructions;
+    return true;
+  }
+
+  // Writes everything recorded so far to the file
+  void sync() {
+    flush();
+    fflush(out);
+  }
+
+private:
+  void reset() {
+    block.clear();
+    records = 0;
+    prev_id = 0;
+    prev_addr = 0;
+    memset(prev_regs, 0, sizeof(prev_regs));
+  }
+
+  void flush() {
+    // Instructions first: the block may refer to any of them
+    fwrite(table.data(), 1, table.size(), out);
+    table.clear();
+    if (records == 0) {
+      return;
+    }
+    std::string header(1, CHUNK_BLOCK);
+    put_varint(header, records);
+    put_varint(header, block.size());
+    fwrite(header.data(), 1, header.size(), out);
+    fwrite(block.data(), 1, block.size(), out);
+    reset();
+  }
+
+  FILE *out;
+  uint64_t flags;
+  uint32_t next_id;
+  std::string table;        // instructions not written yet
+  std::string instructions; // all of them, for reopen()
+  std::string block;
+  uint64_t records;
+  uint32_t prev_id;
+  uint64_t prev_addr;
+  uint64_t prev_regs[NUM_REGISTERS];
+  unsigned num_mem;
+  uint64_t mem_addrs[MAX_MEM_OPS];
+  bool mem_writes[MAX_MEM_OPS];
+};
+
+} // namespace trace_format
@@ -0,0 +1,231 @@
+#pragma once
+
+// Reader of the binary instruction traces (trace-format.h). The trace is
+// mapped in memory and decoded a record at a time:
+//
+//   trace_format::TraceReader reader;
+//   if (!reader.open("trace.out")) { ... reader.error() ... }
+//   trace_format::Record r;
+//   while (reader.next(r)) {
+//     if (r.packet) { ... } else { ... r.instruction->ip, r.mem[i] ... }
+//   }
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "trace-format.h"
+
+namespace trace_format {
+
+struct Instruction {
+  uint64_t ip;
+  std::string function;
+  std::string assembly;
+  std::string category;
+};
+
+struct MemOp {
+  uint64_t addr;
+  bool write;
+};
+
+struct Record {
+  // A packet boundary, with nothing else set
+  bool packet;
+  const Instruction *instruction;
+  unsigned num_mem;
+  MemOp mem[MAX_MEM_OPS];
+  // With FLAG_REGISTERS
+  uint64_t registers[NUM_REGISTERS];
+};
+
+class TraceReader {
+public:
+  TraceReader()
+      : data(NULL), size(0), pos(NULL), end(NULL), flags(0),
+        block_records(0), failure(NULL) {}
+
+  ~TraceReader() {
+    if (data != NULL) {
+      munmap(data, size);
+    }
+  }
+
+  bool open(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      return fail("cannot open the trace");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(MAGIC)) {
+      ::close(fd);
+      return fail("not a binary trace");
+    }
+    size = st.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      data = NULL;
+      return fail("cannot map the trace");
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    pos = (const uint8_t *)data;
+    end = pos + size;
+
+    if (memcmp(pos, MAGIC, sizeof(MAGIC)) != 0) {
+      return fail("not a binary trace");
+    }
+    pos += sizeof(MAGIC);
+    uint64_t version;
+    if (!get_varint(version) || version != VERSION) {
+      return fail("unsupported trace version");
+    }
+    return get_varint(flags);
+  }
+
+  // The next record, false at the end of the trace or on an error
+  bool next(Record &r) {
+    while (block_records == 0) {
+      if (pos == end) {
+        return false;
+      }
+      char tag = *pos++;
+      if (tag == CHUNK_PACKET) {
+        r.packet = true;
+        return true;
+      } else if (tag == CHUNK_INSTRUCTION) {
+        if (!read_instruction()) {
+          return false;
+        }
+      } else if (tag == CHUNK_BLOCK) {
+        uint64_t length;
+        if (!get_varint(block_records) || !get_varint(length) ||
+            length > (uint64_t)(end - pos)) {
+          return fail("truncated block");
+        }
+        prev_id = 0;
+        prev_addr = 0;
+        memset(prev_regs, 0, sizeof(prev_regs));
+      } else {
+        return fail("unknown chunk");
+      }
+    }
+
+    uint64_t header;
+    if (!get_varint(header)) {
+      return false;
+    }
+    prev_id += unzigzag(header >> 4);
+    if (prev_id < 0 || (uint64_t)prev_id >= table.size()) {
+      return fail("record of an unknown instruction");
+    }
+    r.packet = false;
+    r.instruction = &table[prev_id];
+    uint64_t num_mem = header & 0xf;
+    if (num_mem == INLINE_MEM_OPS) {
+      uint64_t more;
+      if (!get_varint(more)) {
+        return false;
+      }
+      num_mem += more;
+    }
+    if (num_mem > MAX_MEM_OPS) {
+      return fail("too many memory operands");
+    }
+    r.num_mem = num_mem;
+    for (unsigned i = 0; i < r.num_mem; i++) {
+      uint64_t v;
+      if (!get_varint(v)) {
+        return false;
+      }
+      prev_addr += unzigzag(v >> 1);
+      r.mem[i].addr = prev_addr;
+      r.mem[i].write = v & 1;
+    }
+    if (flags & FLAG_REGISTERS) {
+      for (unsigned i = 0; i < NUM_REGISTERS; i++) {
+        uint64_t v;
+        if (!get_varint(v)) {
+          return false;
+        }
+        prev_regs[i] += unzigzag(v);
+        r.registers[i] = prev_regs[i];
+      }
+    }
+    block_records--;
+    return true;
+  }
+
+  bool has_registers() const { return flags & FLAG_REGISTERS; }
+  const std::vector<Instruction> &instructions() const { return table; }
+  // Why open() or next() returned false, NULL at the end of a good trace
+  const char *error() const { return failure; }
+
+private:
+  bool fail(const char *why) {
+    failure = why;
+    pos = end;
+    block_records = 0;
+    return false;
+  }
+
+  bool get_varint(uint64_t &v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (pos == end) {
+        return fail("truncated trace");
+      }
+      uint8_t b = *pos++;
+      v |= (uint64_t)(b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+        return true;
+      }
+    }
+    return fail("bad varint");
+  }
+
+  bool get_string(std::string &s) {
+    uint64_t length;
+    if (!get_varint(length)) {
+      return false;
+    }
+    if (length > (uint64_t)(end - pos)) {
+      return fail("truncated trace");
+    }
+    s.assign((const char *)pos, length);
+    pos += length;
+    return true;
+  }
+
+  bool read_instruction() {
+    uint64_t id;
+    Instruction ins;
+    if (!get_varint(id) || !get_varint(ins.ip) || !get_string(ins.function) ||
+        !get_string(ins.assembly) || !get_string(ins.category)) {
+      return false;
+    }
+    if (id != table.size()) {
+      return fail("instructions out of order");
+    }
+    table.push_back(ins);
+    return true;
+  }
+
+  void *data;
+  size_t size;
+  const uint8_t *pos;
+  const uint8_t *end;
+  uint64_t flags;
+  uint64_t block_records;
+  const char *failure;
+  std::vector<Instruction> table;
+  int64_t prev_id;
+  uint64_t prev_addr;
+  uint64_t prev_regs[NUM_REGISTERS];
+};
+
+} // namespace trace_format
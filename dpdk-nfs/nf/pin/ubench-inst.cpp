@@ -3,9 +3,13 @@
 #include <fstream>
 #include <string>
 
+#include "trace-format.h"
+
 // This is more or less copied from the pintool examples
 
 ofstream trace;
+trace_format::TraceWriter binary_trace;
+static bool binary = false;
 static bool is_counting = false;
 static UINT64 instr_count = 0;
 static UINT64 mem_count = 0;
@@ -14,20 +18,28 @@ typedef struct {
   unsigned long ip;
   std::string function;
   std::string assembly;
+  uint32_t binary_id;
 } instruction_data_t;
 
 std::vector<std::pair<bool, unsigned long>> addresses;
 
+KNOB<BOOL> KnobBinary(KNOB_MODE_WRITEONCE, "pintool", "binary", "0",
+                      "write a binary trace (trace-format.h, trace-dump prints it as text)");
+
 VOID log_read_op(VOID *ip, VOID *addr) {
- if(is_counting)  addresses.push_back(std::make_pair(0, (unsigned long)addr));
+ if(is_counting && binary) binary_trace.mem_op((unsigned long)addr, false);
+ else if(is_counting)  addresses.push_back(std::make_pair(0, (unsigned long)addr));
 }
 
 VOID log_write_op(VOID *ip, VOID *addr) {
-  if(is_counting) addresses.push_back(std::make_pair(1, (unsigned long)addr));
+  if(is_counting && binary) binary_trace.mem_op((unsigned long)addr, true);
+  else if(is_counting) addresses.push_back(std::make_pair(1, (unsigned long)addr));
 }
 
 VOID log_instruction(instruction_data_t *id) {
-  if (is_counting) {
+  if (is_counting && binary) {
+    binary_trace.record(id->binary_id, NULL);
+  } else if (is_counting) {
 
   trace << std::hex << std::uppercase << id->ip << " |";
 
@@ -92,6 +104,9 @@ VOID trace_instr(INS ins, VOID* v)
     id->ip = INS_Address(ins);
     id->function = RTN_FindNameByAddress(id->ip);
     id->assembly = INS_Disassemble(ins);
+    if (binary)
+      id->binary_id = binary_trace.add_instruction(id->ip, id->function, id->assembly,
+                                                   CATEGORY_StringShort(INS_Category(ins)));
 
     for (UINT32 memOp = 0; memOp < memOperands; memOp++) {
     if (INS_MemoryOperandIsRead(ins, memOp)) {
@@ -140,7 +155,10 @@ VOID Image(IMG img, VOID* v)
 
 VOID Fini(INT32 code, VOID* v)
 {
-	trace.close();
+	if (binary)
+		binary_trace.close();
+	else
+		trace.close();
 }
 
 
@@ -152,7 +170,15 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
-	trace.open("pincounts.log", ios::trunc);
+	binary = KnobBinary.Value();
+	if (binary) {
+		if (!binary_trace.open("pincounts.log", 0)) {
+			std::cout << "ERROR: could not open pincounts.log..." << std::endl;
+			return 1;
+		}
+	} else {
+		trace.open("pincounts.log", ios::trunc);
+	}
 
 	IMG_AddInstrumentFunction(Image, 0);
 	INS_AddInstrumentFunction(trace_instr, 0);
@@ -41,8 +41,17 @@ int nf_core_process(struct rte_mbuf *mbuf, time_t now) {
   struct rte_ipv4_hdr *ip_header = nf_get_mbuf_ipv4_header(mbuf);
   // Are there timestamp options we must respect?
   if (ip_header == NULL) {
-    VIGOR_TAG(TRAFFIC_CLASS, INVALID);
-    return mbuf->port;
+    struct rte_ipv6_hdr *ip6_header = nf_get_mbuf_ipv6_header(mbuf);
+    if (ip6_header == NULL) {
+      VIGOR_TAG(TRAFFIC_CLASS, INVALID);
+      return mbuf->port;
+    }
+    VIGOR_TAG(TRAFFIC_CLASS, IPV6);
+    // IPv6 has no options in the base header, only the hop limit to honor.
+    if (ip6_header->hop_limits <= 1) {
+      return mbuf->port;
+    }
+    ip6_header->hop_limits--;
   } else {
     VIGOR_TAG(TRAFFIC_CLASS, VALID);
     if ((ip_header->version_ihl & 0xF) > 5) {
@@ -5,6 +5,12 @@ NF="${PWD##*/}"
 METRICS=${1-llvm}
 TEST=${2:-all}
 LATENCY_DIR=${3:-$(dirname "$0")/../../../}
+# BATCH_REPLAY=1 traces all test cases from one forking run
+if [ -n "$BATCH_REPLAY" ]; then
+  MAKE_TRACES="make batch-"
+else
+  MAKE_TRACES="make -j $(nproc) "
+fi
 
 if ! [[ "$NF" =~ ^(vignat|bridge|vigbalancer|lpm|vigpol|vigfw)$ ]]; then
   echo "Unsupported NF: $NF"
@@ -26,10 +32,10 @@ if [ "$TEST" == "all" ]; then
 	make verify-dpdk
   if [ "$METRICS" != "llvm" ]; then
 	  make executable-$NF
-    make -j $(nproc) instr-traces
+    ${MAKE_TRACES}instr-traces
   else
     make executable-$NF LLVM=TRUE
-    make -j $(nproc) llvm-instr-traces
+    ${MAKE_TRACES}llvm-instr-traces
   fi
 fi
 
@@ -2,6 +2,7 @@
 #include "lib/containers/double-chain.h"
 #include "lib/containers/map.h"
 #include "lib/containers/vector.h"
+#include "lib/containers/vector-group.h"
 #include "lib/expirator.h"
 #include "lib/nf_util.h"
 
@@ -11,6 +12,24 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define MAP_SPEC_NAME lb_flow
+#define MAP_SPEC_KEY_T struct LoadBalancedFlow
+#define MAP_SPEC_KEY_EQ lb_flow_equality
+#define MAP_SPEC_KEY_HASH lb_flow_hash
+#include "lib/containers/map-specialized.h"
+
+#define VECTOR_SPEC_NAME lb_flow
+#define VECTOR_SPEC_ELEM_T struct LoadBalancedFlow
+#include "lib/containers/vector-specialized.h"
+
+#define VECTOR_SPEC_NAME lb_backend
+#define VECTOR_SPEC_ELEM_T struct LoadBalancedBackend
+#include "lib/containers/vector-specialized.h"
+
+#define VECTOR_SPEC_NAME u32
+#define VECTOR_SPEC_ELEM_T uint32_t
+#include "lib/containers/vector-specialized.h"
+
 // KLEE doesn't tolerate && in a klee_assume (see klee/klee#809),
 // so we replace them with & during symbex but interpret them as && in the
 // validator
@@ -160,13 +179,13 @@ struct LoadBalancer *lb_allocate_balancer(uint32_t flow_capacity,
     goto err;
   }
 
-  if (vector_allocate(sizeof(struct LoadBalancedFlow), flow_capacity,
-                      lb_flow_init, &(balancer->flow_heap)) == 0) {
-    goto err;
-  }
-
-  if (vector_allocate(sizeof(uint32_t), flow_capacity, null_init,
-                      &(balancer->flow_id_to_backend_id)) == 0) {
+  // A flow and its backend are stored and looked up together, and so are a
+  // backend and its IP.
+  struct VectorGroupMember flow_vectors[] = {
+      {sizeof(struct LoadBalancedFlow), lb_flow_init, &(balancer->flow_heap)},
+      {sizeof(uint32_t), null_init, &(balancer->flow_id_to_backend_id)},
+  };
+  if (vector_allocate_group(flow_capacity, 2, flow_vectors) == 0) {
     goto err;
   }
 
@@ -174,13 +193,12 @@ struct LoadBalancer *lb_allocate_balancer(uint32_t flow_capacity,
     goto err;
   }
 
-  if (vector_allocate(sizeof(uint32_t), backend_capacity, null_init,
-                      &(balancer->backend_ips)) == 0) {
-    goto err;
-  }
-
-  if (vector_allocate(sizeof(struct LoadBalancedBackend), backend_capacity,
-                      lb_backend_init, &(balancer->backends)) == 0) {
+  struct VectorGroupMember backend_vectors[] = {
+      {sizeof(uint32_t), null_init, &(balancer->backend_ips)},
+      {sizeof(struct LoadBalancedBackend), lb_backend_init,
+       &(balancer->backends)},
+  };
+  if (vector_allocate_group(backend_capacity, 2, backend_vectors) == 0) {
     goto err;
   }
 
@@ -254,7 +272,7 @@ err:
 }
 
 #ifdef KLEE_VERIFICATION
-int lb_find_preferred_available_backend(struct LoadBalancedFlow *flow,
+int lb_find_preferred_available_backend(int flow_hash,
                                         struct Vector *cht,
                                         struct DoubleChain *active_backends,
                                         uint32_t cht_height,
@@ -279,28 +297,28 @@ int lb_find_preferred_available_backend(struct LoadBalancedFlow *flow,
   }
 }
 #else // KLEE_VERIFICATION
-int lb_find_preferred_available_backend(struct LoadBalancedFlow *flow,
+int lb_find_preferred_available_backend(int flow_hash,
                                         struct Vector *cht,
                                         struct DoubleChain *active_backends,
                                         uint32_t cht_height,
                                         uint32_t backend_capacity,
                                         int *chosen_backend) {
 
-  uint64_t hash = (uint64_t)lb_flow_hash(flow);
+  uint64_t hash = (uint64_t)flow_hash;
   for (int i = 0; i < backend_capacity; ++i) {
 
     int candidate_idx = (hash + i) % cht_height;
 
-    int *candidate;
-    vector_borrow(cht, candidate_idx, (void **)&candidate);
+    uint32_t *candidate;
+    u32_vector_borrow(cht, candidate_idx, &candidate);
     // printf("Looking for candidate %d:%d\n ", candidate_idx, *candidate);
 
     if (dchain_is_index_allocated(active_backends, (int) *candidate)) {
       *chosen_backend = (int) *candidate;
-      vector_return(cht, (int)candidate_idx, candidate);
+      u32_vector_return(cht, candidate_idx, candidate);
       return 1;
     }
-    vector_return(cht, candidate_idx, candidate);
+    u32_vector_return(cht, candidate_idx, candidate);
   }
   // printf("give up\n");
   return 0;
@@ -313,32 +331,36 @@ struct LoadBalancedBackend lb_get_backend(struct LoadBalancer *balancer,
                                           time_t now) {
   int flow_index;
   struct LoadBalancedBackend backend;
-  if (map_get(balancer->flow_to_flow_id, flow, &flow_index) == 0) {
+  // Hashed once, for the flow table and the CHT
+  int hash = lb_flow_map_hash(flow);
+  if (lb_flow_map_get_with_hash(balancer->flow_to_flow_id, flow, hash,
+                                &flow_index) == 0) {
     int backend_index;
     int found = lb_find_preferred_available_backend(
-        flow, balancer->cht, balancer->active_backends, balancer->cht_height,
+        hash, balancer->cht, balancer->active_backends, balancer->cht_height,
         balancer->backend_capacity, &backend_index);
     if (found) {
       if (dchain_allocate_new_index(balancer->flow_chain, &flow_index, now) !=
           0) {
         struct LoadBalancedFlow *vec_flow;
         uint32_t *vec_flow_id_to_backend_id;
-        vector_borrow(balancer->flow_heap, flow_index, (void **)&vec_flow);
+        lb_flow_vector_borrow(balancer->flow_heap, flow_index, &vec_flow);
         memcpy(vec_flow, flow, sizeof(struct LoadBalancedFlow));
-        vector_borrow(balancer->flow_id_to_backend_id, flow_index,
-                      (void **)&vec_flow_id_to_backend_id);
+        u32_vector_borrow(balancer->flow_id_to_backend_id, flow_index,
+                          &vec_flow_id_to_backend_id);
         *vec_flow_id_to_backend_id = backend_index;
-        vector_return(balancer->flow_id_to_backend_id, flow_index,
-                      (void *)vec_flow_id_to_backend_id);
-        map_put(balancer->flow_to_flow_id, vec_flow, flow_index);
-        vector_return(balancer->flow_heap, flow_index,
-                      vec_flow); // other half in map
+        u32_vector_return(balancer->flow_id_to_backend_id, flow_index,
+                          vec_flow_id_to_backend_id);
+        lb_flow_map_put_with_hash(balancer->flow_to_flow_id, vec_flow, hash,
+                                  flow_index);
+        lb_flow_vector_return(balancer->flow_heap, flow_index,
+                              vec_flow); // other half in map
         // VIGOR_TAG(TRAFFIC_CLASS, NEW_FLOW_ALLOCATED);
       } // Doesn't matter if we can't insert
       struct LoadBalancedBackend *vec_backend;
-      vector_borrow(balancer->backends, backend_index, (void **)&vec_backend);
+      lb_backend_vector_borrow(balancer->backends, backend_index, &vec_backend);
       memcpy(&backend, vec_backend, sizeof(struct LoadBalancedBackend));
-      vector_return(balancer->backends, backend_index, (void *)vec_backend);
+      lb_backend_vector_return(balancer->backends, backend_index, vec_backend);
     } else {
       // Drop
       // VIGOR_TAG(TRAFFIC_CLASS, DROPPED_CLIENT_REQUEST);
@@ -346,32 +368,32 @@ struct LoadBalancedBackend lb_get_backend(struct LoadBalancer *balancer,
     }
   } else {
     uint32_t *vec_backend_index;
-    vector_borrow(balancer->flow_id_to_backend_id, flow_index,
-                  (void **)&vec_backend_index);
+    u32_vector_borrow(balancer->flow_id_to_backend_id, flow_index,
+                      &vec_backend_index);
     uint32_t backend_index = *vec_backend_index;
-    vector_return(balancer->flow_id_to_backend_id, flow_index,
-                  (void *)vec_backend_index);
+    u32_vector_return(balancer->flow_id_to_backend_id, flow_index,
+                      vec_backend_index);
     if (0 ==
         dchain_is_index_allocated(balancer->active_backends, backend_index)) {
       // VIGOR_TAG(TRAFFIC_CLASS, FLOW_TO_EXP_BACKEND);
       struct LoadBalancedFlow *flow_key;
       // Nevermind the flow_id_to_backend_id, its entry
       // is automatically invalidated, by erasing the map entry.
-      vector_borrow(balancer->flow_heap, flow_index, (void **)&flow_key);
+      lb_flow_vector_borrow(balancer->flow_heap, flow_index, &flow_key);
       // could use `flow_key` just as well here, but
       // current impl of symbex models does not support
       // connecting a map with its keystore.
       map_erase(balancer->flow_to_flow_id, flow, (void **)&flow_key);
-      vector_return(balancer->flow_heap, flow_index, (void *)flow_key);
+      lb_flow_vector_return(balancer->flow_heap, flow_index, flow_key);
       return lb_get_backend(balancer, flow, now);
     } else {
       //VIGOR_TAG(TRAFFIC_CLASS, FLOW_TO_GOOD_BACKEND);
       dchain_rejuvenate_index(balancer->flow_chain, backend_index, now);
 
       struct LoadBalancedBackend *vec_backend;
-      vector_borrow(balancer->backends, backend_index, (void **)&vec_backend);
+      lb_backend_vector_borrow(balancer->backends, backend_index, &vec_backend);
       memcpy(&backend, vec_backend, sizeof(struct LoadBalancedBackend));
-      vector_return(balancer->backends, backend_index, (void *)vec_backend);
+      lb_backend_vector_return(balancer->backends, backend_index, vec_backend);
     }
   }
 
@@ -398,17 +420,17 @@ void lb_process_heartbit(struct LoadBalancer *balancer,
       // printf("allocated new backend %d \n", backend_index);
       //VIGOR_TAG(TRAFFIC_CLASS, NEW_BACKEND_ALLOCATED);
       struct LoadBalancedBackend *new_backend;
-      vector_borrow(balancer->backends, backend_index, (void **)&new_backend);
+      lb_backend_vector_borrow(balancer->backends, backend_index, &new_backend);
       new_backend->ip = flow->src_ip;
       new_backend->mac = mac_addr;
       new_backend->nic = nic;
 
-      vector_return(balancer->backends, backend_index, (void *)new_backend);
+      lb_backend_vector_return(balancer->backends, backend_index, new_backend);
       uint32_t *ip;
-      vector_borrow(balancer->backend_ips, backend_index, (void **)&ip);
+      u32_vector_borrow(balancer->backend_ips, backend_index, &ip);
       *ip = flow->src_ip;
       map_put(balancer->ip_to_backend_id, ip, backend_index);
-      vector_return(balancer->backend_ips, backend_index, (void *)ip);
+      u32_vector_return(balancer->backend_ips, backend_index, ip);
     } else {
       // Otherwise ignore this backend, we are full.
       //VIGOR_TAG(TRAFFIC_CLASS, BACKEND_TABLE_FULL);
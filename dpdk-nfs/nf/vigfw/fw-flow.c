@@ -1,5 +1,5 @@
 #include "fw-flow.h"
-#include "limits.h"
+#include "lib/flow-hash.h"
 
 
 bool fw_flow_eq(void* a, void* b)
@@ -27,23 +27,7 @@ bool fw_flow_consistency(void* flow, void* unused){
 int fw_flow_hash(void* obj)
 {
   struct Flow* id = (struct Flow*) obj;
-
-  long long hash = 0;
-  hash += id->src_port;
-  hash *= 31;
-
-  hash += id->dst_port;
-  hash *= 31;
-
-  hash += id->src_ip;
-  hash *= 31;
-
-  hash += id->dst_ip;
-  hash *= 31;
-
-  hash += id->protocol;
-
-  hash = hash % INT_MAX;
-
-  return (int)hash;
+  return flow_hash_no_device(flow_hash_pack(id->src_ip, id->dst_ip,
+                                            id->src_port, id->dst_port, 0,
+                                            id->protocol));
 }
@@ -12,6 +12,10 @@
 
 #include "fw-state.h"
 
+#define VECTOR_SPEC_NAME fw_flow
+#define VECTOR_SPEC_ELEM_T struct Flow
+#include "lib/containers/vector-specialized.h"
+
 struct FlowManager {
   struct State *state;
   uint32_t expiration_time; /*nanoseconds*/
@@ -39,10 +43,10 @@ bool flow_manager_allocate_flow(struct FlowManager *manager, struct Flow *id, ti
   }
 
   struct Flow *key = 0;
-  vector_borrow(manager->state->fv, index, (void **)&key);
+  fw_flow_vector_borrow(manager->state->fv, index, &key);
   memcpy((void *)key, (void *)id, sizeof(struct Flow));
   map_put(manager->state->fm, key, index);
-  vector_return(manager->state->fv, index, key);
+  fw_flow_vector_return(manager->state->fv, index, key);
   return true;
 }
 
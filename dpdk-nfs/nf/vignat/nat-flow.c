@@ -4,14 +4,7 @@
 
 bool FlowId_eq(void* a, void* b)
 {
-  struct FlowId* id1 = (struct FlowId*) a;
-  struct FlowId* id2 = (struct FlowId*) b;
-  return (id1->src_port == id2->src_port)
-     AND (id1->dst_port == id2->dst_port)
-     AND (id1->src_ip == id2->src_ip)
-     AND (id1->dst_ip == id2->dst_ip)
-     AND (id1->internal_device == id2->internal_device)
-     AND (id1->protocol == id2->protocol);
+  return FlowId_eq_inline(a, b);
 }
 
 
@@ -32,29 +25,7 @@ int FlowId_hash(void* obj)
 
 int FlowId_hash(void* obj)
 {
-  struct FlowId* id = (struct FlowId*) obj;
-
-  long long hash = 0;
-  hash += id->src_port;
-  hash *= 31;
-
-  hash += id->dst_port;
-  hash *= 31;
-
-  hash += id->src_ip;
-  hash *= 31;
-
-  hash += id->dst_ip;
-  hash *= 31;
-
-  hash += id->internal_device;
-  hash *= 31;
-
-  hash += id->protocol;
-
-  hash = hash % INT_MAX;
-
-  return (int)hash;
+  return FlowId_hash_inline(obj);
 }
 
 #endif//KLEE_VERIFICATION
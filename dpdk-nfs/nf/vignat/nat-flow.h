@@ -1,5 +1,6 @@
 #ifndef _FLOW_H_INCLUDED_
 #define _FLOW_H_INCLUDED_
+#include "lib/flow-hash.h"
 #include "lib/ignore.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -19,6 +20,23 @@ struct FlowId {
   uint8_t protocol;
 };
 
+// FlowId_eq and FlowId_hash, inlinable into the specialized containers
+// (lib/containers/specialize.h)
+static inline bool FlowId_eq_inline(struct FlowId *id1, struct FlowId *id2) {
+  return (id1->src_port == id2->src_port)
+      AND(id1->dst_port == id2->dst_port)
+      AND(id1->src_ip == id2->src_ip)
+      AND(id1->dst_ip == id2->dst_ip)
+      AND(id1->internal_device == id2->internal_device)
+      AND(id1->protocol == id2->protocol);
+}
+
+static inline int FlowId_hash_inline(struct FlowId *id) {
+  return flow_hash(flow_hash_pack(id->src_ip, id->dst_ip, id->src_port,
+                                  id->dst_port, id->internal_device,
+                                  id->protocol));
+}
+
 int FlowId_hash(void *obj);
 
 bool FlowId_eq(void *a, void *b);
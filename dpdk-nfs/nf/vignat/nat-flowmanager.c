@@ -12,6 +12,20 @@
 
 #include "nat-state.h"
 
+#define MAP_SPEC_NAME flow_id
+#define MAP_SPEC_KEY_T struct FlowId
+#define MAP_SPEC_KEY_EQ FlowId_eq_inline
+#define MAP_SPEC_KEY_HASH FlowId_hash_inline
+#include "lib/containers/map-specialized.h"
+
+#define VECTOR_SPEC_NAME flow_id
+#define VECTOR_SPEC_ELEM_T struct FlowId
+#include "lib/containers/vector-specialized.h"
+
+#define EXPIRATOR_SPEC_NAME flow_id
+#define EXPIRATOR_SPEC_KEY_T struct FlowId
+#include "lib/expirator-specialized.h"
+
 struct FlowManager {
   struct State *state;
   uint32_t expiration_time; /*nanoseconds*/
@@ -44,9 +58,11 @@ struct FlowManager *flow_manager_allocate(uint16_t starting_port,
   return manager;
 }
 
+int flow_manager_hash(struct FlowId *id) { return flow_id_map_hash(id); }
+
 bool flow_manager_allocate_flow(struct FlowManager *manager, struct FlowId *id,
-                                uint16_t internal_device, time_t time,
-                                uint16_t *external_port) {
+                                int hash, uint16_t internal_device,
+                                time_t time, uint16_t *external_port) {
   int index;
   if (dchain_allocate_new_index(manager->state->heap, &index, time) == 0) {
     return false;
@@ -55,10 +71,10 @@ bool flow_manager_allocate_flow(struct FlowManager *manager, struct FlowId *id,
   *external_port = manager->state->start_port + index;
 
   struct FlowId *key = 0;
-  vector_borrow(manager->state->fv, index, (void **)&key);
+  flow_id_vector_borrow(manager->state->fv, index, &key);
   memcpy((void *)key, (void *)id, sizeof(struct FlowId));
-  map_put(manager->state->fm, key, index);
-  vector_return(manager->state->fv, index, key);
+  flow_id_map_put_with_hash(manager->state->fm, key, hash, index);
+  flow_id_vector_return(manager->state->fv, index, key);
   return true;
 }
 
@@ -68,14 +84,15 @@ void flow_manager_expire(struct FlowManager *manager, time_t time) {
   uint64_t time_u = (uint64_t)time; // OK because of the two asserts
   time_t last_time =
       time_u - manager->expiration_time;
-  expire_items_single_map(manager->state->heap, manager->state->fv,
-                          manager->state->fm, last_time);
+  flow_id_expire_items_single_map(manager->state->heap, manager->state->fv,
+                                  manager->state->fm, last_time);
 }
 
 bool flow_manager_get_internal(struct FlowManager *manager, struct FlowId *id,
-                               time_t time, uint16_t *external_port) {
+                               int hash, time_t time,
+                               uint16_t *external_port) {
   int index;
-  if (map_get(manager->state->fm, id, &index) == 0) {
+  if (flow_id_map_get_with_hash(manager->state->fm, id, hash, &index) == 0) {
     return false;
   }
   *external_port = index + manager->state->start_port;
@@ -92,9 +109,9 @@ bool flow_manager_get_external(struct FlowManager *manager,
   }
 
   struct FlowId *key = 0;
-  vector_borrow(manager->state->fv, index, (void **)&key);
+  flow_id_vector_borrow(manager->state->fv, index, &key);
   memcpy((void *)out_flow, (void *)key, sizeof(struct FlowId));
-  vector_return(manager->state->fv, index, key);
+  flow_id_vector_return(manager->state->fv, index, key);
 
   dchain_rejuvenate_index(manager->state->heap, index, time);
 
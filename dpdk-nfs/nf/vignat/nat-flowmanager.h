@@ -17,12 +17,17 @@ flow_manager_allocate(uint16_t starting_port, uint32_t nat_ip,
                                               router + "only NAT" */
                       uint32_t expiration_time, uint64_t max_flows);
 
+// The hash of an internal flow, computed once per packet for
+// flow_manager_get_internal and, for a new flow, flow_manager_allocate_flow
+int flow_manager_hash(struct FlowId *id);
+
 bool flow_manager_allocate_flow(struct FlowManager *manager, struct FlowId *id,
-                                uint16_t internal_device, time_t time,
-                                uint16_t *external_port);
+                                int hash, uint16_t internal_device,
+                                time_t time, uint16_t *external_port);
 void flow_manager_expire(struct FlowManager *manager, time_t time);
 bool flow_manager_get_internal(struct FlowManager *manager, struct FlowId *id,
-                               time_t time, uint16_t *external_port);
+                               int hash, time_t time,
+                               uint16_t *external_port);
 bool flow_manager_get_external(struct FlowManager *manager,
                                uint16_t external_port, time_t time,
                                struct FlowId *out_flow);
@@ -102,13 +102,15 @@ int nf_core_process(struct rte_mbuf *mbuf, time_t now) {
     NF_DEBUG("Device %" PRIu16 " is internal (not %" PRIu16 ")", in_port,
              config.wan_device);
 
+    int hash = flow_manager_hash(&id);
     uint16_t external_port;
-    if (!flow_manager_get_internal(flow_manager, &id, now, &external_port)) {
+    if (!flow_manager_get_internal(flow_manager, &id, hash, now,
+                                   &external_port)) {
       NF_DEBUG("New flow");
 
       // VIGOR_TAG(TRAFFIC_CLASS, INTERNAL_NEW);
 
-      if (!flow_manager_allocate_flow(flow_manager, &id, in_port, now,
+      if (!flow_manager_allocate_flow(flow_manager, &id, hash, in_port, now,
                                       &external_port)) {
         NF_DEBUG("No space for the flow, dropping");
         // VIGOR_TAG(TRAFFIC_CLASS, INTERNAL_NEW_FULL);
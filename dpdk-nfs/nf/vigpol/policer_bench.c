@@ -0,0 +1,153 @@
+// Cycles per packet of VigPol's policing (expiry, then policer_check_tb) in
+// the hierarchical mode: subscribers in four rate classes, looked up by
+// prefix, under the aggregate limit of a 10 Gb/s uplink. Three phases:
+//   new     the first packet of each subscriber, in random order
+//   random  packets to subscribers picked at random
+//   runs    runs of 8 packets to the same subscriber
+// Packets are 1000 B, 1 us apart: 8 Gb/s, under the uplink rate, so that the
+// packets go through the subscriber buckets instead of mostly being dropped
+// at the uplink. Each phase is timed in windows of WINDOW packets, and the
+// random and runs phases are repeated REPEATS times; the minimum and the
+// median cycles/packet over the windows are reported.
+// Built by "make policer-bench".
+// Usage: ./policer-bench [subscribers [capacity]]
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <rte_byteorder.h>
+#include <rte_cycles.h>
+
+#include "lib/nf_forward.h"
+#include "policer_config.h"
+
+#define SUBSCRIBER_BASE 0x0A000000 // 10.0.0.0
+#define PACKET_SIZE 1000
+#define PACKET_GAP 1000 // ns
+#define PACKETS (1 << 22)
+#define RUN_LENGTH 8
+#define WINDOW (1 << 16)
+#define REPEATS 3
+
+// policer_main.c
+extern struct policer_config config;
+int policer_expire_entries(time_t time);
+bool policer_check_tb(uint32_t dst, uint16_t size, time_t time);
+
+static const uint64_t class_rates[] = {1250000, 6250000, 12500000, 125000000};
+#define CLASS_COUNT ((int)(sizeof(class_rates) / sizeof(class_rates[0])))
+
+static time_t now;
+
+// Rate class of each /24 of the subscribers, round robin
+static void write_subscribers(char *fname, unsigned subscribers) {
+  int fd = mkstemp(fname);
+  FILE *f = fd < 0 ? NULL : fdopen(fd, "w");
+  if (f == NULL) {
+    fprintf(stderr, "Could not create %s\n", fname);
+    exit(EXIT_FAILURE);
+  }
+  for (unsigned block = 0; block * 256 < subscribers; ++block) {
+    uint32_t ip = SUBSCRIBER_BASE + block * 256;
+    fprintf(f, "%u.%u.%u.%u 24 %u\n", ip >> 24, (ip >> 16) & 0xFF,
+            (ip >> 8) & 0xFF, ip & 0xFF, block % CLASS_COUNT);
+  }
+  fclose(f);
+}
+
+static double window_cycles[REPEATS * PACKETS / WINDOW + 1];
+
+static int compare_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static void run(const char *name, const uint32_t *dsts, unsigned n,
+                int repeats) {
+  unsigned forwarded = 0;
+  unsigned windows = 0;
+  for (int r = 0; r < repeats; ++r) {
+    for (unsigned w = 0; w < n; w += WINDOW) {
+      unsigned end = w + WINDOW < n ? w + WINDOW : n;
+      uint64_t start = rte_rdtsc();
+      for (unsigned i = w; i < end; ++i) {
+        policer_expire_entries(now);
+        forwarded += policer_check_tb(dsts[i], PACKET_SIZE, now);
+        now += PACKET_GAP;
+      }
+      window_cycles[windows++] = (double)(rte_rdtsc() - start) / (end - w);
+    }
+  }
+  qsort(window_cycles, windows, sizeof(double), compare_double);
+  printf("%-8s %10u packets x %d: %6.1f min, %6.1f median cycles/packet, "
+         "%5.1f%% forwarded\n",
+         name, n, repeats, window_cycles[0], window_cycles[windows / 2],
+         100.0 * forwarded / ((double)n * repeats));
+}
+
+int main(int argc, char *argv[]) {
+  unsigned subscribers = argc > 1 ? atoi(argv[1]) : 1 << 20;
+  unsigned capacity = argc > 2 ? atoi(argv[2]) : 2 * subscribers;
+  if (subscribers == 0 || subscribers > PACKETS || capacity < subscribers) {
+    fprintf(stderr, "Usage: %s [subscribers [capacity]]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  config.dyn_capacity = capacity;
+  config.rate = class_rates[0];
+  config.class_count = CLASS_COUNT;
+  for (int c = 0; c < CLASS_COUNT; ++c) {
+    // Bursts of one second: nobody expires during the run
+    config.class_rates[c] = class_rates[c];
+    config.class_bursts[c] = class_rates[c];
+  }
+  config.burst = config.class_bursts[0];
+  config.uplink_rate = 1250000000;
+  config.uplink_burst = 12500000;
+  char fname[] = "/tmp/policer-bench-XXXXXX";
+  write_subscribers(fname, subscribers);
+  snprintf(config.subscribers_fname, CONFIG_FNAME_LEN, "%s", fname);
+  nf_core_init();
+  unlink(fname);
+
+  uint32_t *dsts = malloc(PACKETS * sizeof(uint32_t));
+  if (dsts == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return EXIT_FAILURE;
+  }
+  srand(0);
+  now = 1;
+
+  for (unsigned i = 0; i < subscribers; ++i) {
+    dsts[i] = i;
+  }
+  for (unsigned i = subscribers - 1; i > 0; --i) {
+    unsigned j = rand() % (i + 1);
+    uint32_t tmp = dsts[i];
+    dsts[i] = dsts[j];
+    dsts[j] = tmp;
+  }
+  for (unsigned i = 0; i < subscribers; ++i) {
+    dsts[i] = rte_cpu_to_be_32(SUBSCRIBER_BASE + dsts[i]);
+  }
+  run("new", dsts, subscribers, 1);
+
+  for (unsigned i = 0; i < PACKETS; ++i) {
+    dsts[i] = rte_cpu_to_be_32(SUBSCRIBER_BASE + rand() % subscribers);
+  }
+  run("random", dsts, PACKETS, REPEATS);
+
+  for (unsigned i = 0; i < PACKETS; i += RUN_LENGTH) {
+    uint32_t dst = rte_cpu_to_be_32(SUBSCRIBER_BASE + rand() % subscribers);
+    for (unsigned j = i; j < i + RUN_LENGTH; ++j) {
+      dsts[j] = dst;
+    }
+  }
+  run("runs", dsts, PACKETS, REPEATS);
+
+  free(dsts);
+  return 0;
+}
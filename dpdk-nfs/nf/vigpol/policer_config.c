@@ -37,6 +37,10 @@ void policer_config_init(struct policer_config *config, int argc, char **argv) {
   config->rate = DEFAULT_RATE;             // B/s
   config->burst = DEFAULT_BURST;           // B
   config->dyn_capacity = DEFAULT_CAPACITY; // MAC addresses
+  config->class_count = 1;
+  config->subscribers_fname[0] = '\0';
+  config->uplink_rate = 0;
+  config->uplink_burst = 0;
 
   unsigned nb_devices = rte_eth_dev_count_avail();
 
@@ -46,6 +50,10 @@ void policer_config_init(struct policer_config *config, int argc, char **argv) {
                                    { "burst", required_argument, NULL, 'b' },
                                    { "capacity", required_argument, NULL, 'c' },
                                   {"eth-dest",		required_argument,	NULL, 'm'},
+                                   { "class", required_argument, NULL, 'C' },
+                                   { "subscribers", required_argument, NULL, 's' },
+                                   { "uplink-rate", required_argument, NULL, 'u' },
+                                   { "uplink-burst", required_argument, NULL, 'U' },
                                    { NULL, 0, NULL, 0 } };
 
   // Set the devices' own MACs and driver names
@@ -54,8 +62,8 @@ void policer_config_init(struct policer_config *config, int argc, char **argv) {
 	}
 
   int opt;
-  while ((opt = getopt_long(argc, argv, "l:w:r:b:c:m:", long_options, NULL)) !=
-         EOF) {
+  while ((opt = getopt_long(argc, argv, "l:w:r:b:c:m:C:s:u:U:", long_options,
+                            NULL)) != EOF) {
     unsigned device;
     switch (opt) {
       case 'l':
@@ -105,11 +113,50 @@ void policer_config_init(struct policer_config *config, int argc, char **argv) {
 				}
 				break;
 
+      case 'C':
+        if (config->class_count == POLICER_MAX_CLASSES) {
+          PARSE_ERROR("At most %d rate classes.\n", POLICER_MAX_CLASSES);
+        }
+        config->class_rates[config->class_count] =
+            nf_util_parse_int(optarg, "class rate", 10, ',');
+        optarg = strchr(optarg, ',') + 1;
+        config->class_bursts[config->class_count] =
+            nf_util_parse_int(optarg, "class burst", 10, '\0');
+        if (config->class_rates[config->class_count] == 0 ||
+            config->class_bursts[config->class_count] == 0) {
+          PARSE_ERROR("Class rate and burst must be strictly positive.\n");
+        }
+        config->class_count++;
+        break;
+
+      case 's':
+        if (strlen(optarg) >= CONFIG_FNAME_LEN) {
+          PARSE_ERROR("Subscribers file name too long.\n");
+        }
+        strcpy(config->subscribers_fname, optarg);
+        break;
+
+      case 'u':
+        config->uplink_rate =
+            nf_util_parse_int(optarg, "uplink-rate", 10, '\0');
+        break;
+
+      case 'U':
+        config->uplink_burst =
+            nf_util_parse_int(optarg, "uplink-burst", 10, '\0');
+        break;
+
       default:
         PARSE_ERROR("Unknown option %c", opt);
     }
   }
 
+  if ((config->uplink_rate == 0) != (config->uplink_burst == 0)) {
+    PARSE_ERROR("Set both the uplink rate and burst, or neither.\n");
+  }
+  config->class_rates[0] = config->rate;
+  config->class_bursts[0] = config->burst;
+
   // Reset getopt
   optind = 1;
 }
@@ -127,7 +174,13 @@ void policer_config_cmdline_print_usage(void) {
           " default: %" PRIu64 ".\n"
           "\t--capacity <n>: policer table capacity,"
           " default: %" PRIu32 ".\n"
-          "\t--eth-dest <device>,<mac>: MAC address of the endpoint linked to a device.\n",
+          "\t--eth-dest <device>,<mac>: MAC address of the endpoint linked to a device.\n"
+          "\t--class <rate>,<burst>: adds a rate class, numbered from 1;"
+          " class 0 is --rate and --burst.\n"
+          "\t--subscribers <file>: rate class of each destination, by prefix,"
+          " as lines of \"<ip> <depth> <class>\", default: all in class 0.\n"
+          "\t--uplink-rate <rate>, --uplink-burst <size>: aggregate limit of"
+          " the WAN device, default: none.\n",
           DEFAULT_LAN, DEFAULT_WAN, DEFAULT_RATE, DEFAULT_BURST,
           DEFAULT_CAPACITY);
 }
@@ -140,6 +193,17 @@ void policer_print_config(struct policer_config *config) {
   NF_INFO("Rate: %" PRIu64, config->rate);
   NF_INFO("Burst: %" PRIu64, config->burst);
   NF_INFO("Capacity: %" PRIu16, config->dyn_capacity);
+  for (uint32_t c = 1; c < config->class_count; c++) {
+    NF_INFO("Class %" PRIu32 ": rate %" PRIu64 ", burst %" PRIu64, c,
+            config->class_rates[c], config->class_bursts[c]);
+  }
+  if (config->subscribers_fname[0] != '\0') {
+    NF_INFO("Subscribers: %s", config->subscribers_fname);
+  }
+  if (config->uplink_rate != 0) {
+    NF_INFO("Uplink rate: %" PRIu64 ", burst: %" PRIu64, config->uplink_rate,
+            config->uplink_burst);
+  }
 
   uint16_t nb_devices = rte_eth_dev_count_avail();
 	for (uint16_t dev = 0; dev < nb_devices; dev++) {
@@ -9,6 +9,9 @@
 
 #define CONFIG_FNAME_LEN 512
 
+// Rate classes, including class 0
+#define POLICER_MAX_CLASSES 256
+
 struct policer_config {
   // LAN (i.e. internal) device
   uint16_t lan_device;
@@ -25,6 +28,21 @@ struct policer_config {
   // Size of the dynamic filtering table
   uint32_t dyn_capacity;
 
+  // Rate classes (plans) of the destinations, i.e. the subscribers: class 0
+  // is rate and burst, the others are added by --class
+  uint32_t class_count;
+  uint64_t class_rates[POLICER_MAX_CLASSES];
+  uint64_t class_bursts[POLICER_MAX_CLASSES];
+
+  // pfx2as file of the class of each subscriber, by prefix: lines of
+  // "<ip> <depth> <class>". Empty: all subscribers are in class 0.
+  char subscribers_fname[CONFIG_FNAME_LEN];
+
+  // Aggregate rate (B/s) and burst (B) of the traffic from the WAN device,
+  // over all subscribers; 0 for no aggregate limit
+  uint64_t uplink_rate;
+  uint64_t uplink_burst;
+
    // MAC addresses of devices
   struct rte_ether_addr device_macs[RTE_MAX_ETHPORTS];
 
@@ -1,25 +1,16 @@
 #include "policer_flow.h"
-#include "limits.h"
+#include "policer_state.h"
 #include "lib/ignore.h"
 
 
 bool policer_flow_eq(void* a, void* b)
 {
-  uint32_t* ip1 = (uint32_t*) a;
-  uint32_t* ip2 = (uint32_t*) b;
-  return *ip1 == *ip2;
+  return policer_flow_eq_inline((uint32_t*) a, (uint32_t*) b);
 }
 
 int policer_flow_hash(void* obj)
 {
-  uint32_t* ip = (uint32_t*) obj;
-
-  long long hash = 0;
-  hash += *ip;
-  hash *= 31;
-  hash = hash % INT_MAX;
-
-  return (int)hash;
+  return policer_flow_hash_inline((uint32_t*) obj);
 }
 
 void policer_flow_allocate(void* obj)
@@ -27,7 +18,8 @@ void policer_flow_allocate(void* obj)
   IGNORE(obj);
 }
 
-bool policer_bucket_sanity_check(void* bucket, void* unused){
+bool policer_bucket_sanity_check(void* bucket, void* state){
   struct Bucket* b = (struct Bucket*) bucket;
-  return b->bucket_time >=0;
+  return (b->bucket_time >= 0)
+      AND(b->rate_class < ((struct State*) state)->class_count);
 }
@@ -1,5 +1,6 @@
 #ifndef _FLOW_H_INCLUDED_
 #define _FLOW_H_INCLUDED_
+#include "lib/flow-hash.h"
 #include "lib/ignore.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -11,7 +12,12 @@
 #define AND &&
 #endif // KLEE_VERIFICATION
 
+// A flow's record: its key (the destination), its rate class (an index in
+// config.class_rates), then its token bucket. The key is first, so that the
+// map and the expirator can use a record as its key.
 struct Bucket {
+  uint32_t dst;
+  uint16_t rate_class;
   uint64_t bucket_size;
   time_t bucket_time;
 };
@@ -22,7 +28,19 @@ bool policer_flow_eq(void *a, void *b);
 
 void policer_flow_allocate(void *obj);
 
-bool policer_bucket_sanity_check(void* bucket, void* unused);
+bool policer_bucket_sanity_check(void* bucket, void* state);
+
+// policer_flow_eq and policer_flow_hash, inlinable into the specialized
+// containers (lib/containers/specialize.h)
+static inline bool policer_flow_eq_inline(uint32_t *a, uint32_t *b) {
+  return *a == *b;
+}
+
+static inline int policer_flow_hash_inline(uint32_t *ip) {
+  // Not ip * 31: the map keeps the low bits, which for an address in network
+  // byte order are its first bytes, the same for a whole subscriber block
+  return flow_hash(flow_hash_pack(0, *ip, 0, 0, 0, 0));
+}
 
 #ifdef KLEE_VERIFICATION
 #include "lib/stubs/containers/str-descr.h"
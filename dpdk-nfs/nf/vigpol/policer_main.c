@@ -10,6 +10,7 @@
 #include <rte_common.h>
 #include <rte_ethdev.h>
 #include <rte_ether.h>
+#include <rte_byteorder.h>
 #include <rte_ip.h>
 #include <rte_mbuf.h>
 
@@ -19,59 +20,160 @@
 #include "lib/nf_log.h"
 #include "lib/nf_util.h"
 #include "lib/expirator.h"
+#include "lpm/lpm.h"
+
+#define MAP_SPEC_NAME policer_key
+#define MAP_SPEC_KEY_T uint32_t
+#define MAP_SPEC_KEY_EQ policer_flow_eq_inline
+#define MAP_SPEC_KEY_HASH policer_flow_hash_inline
+#include "lib/containers/map-specialized.h"
+
+// The records, and (for the expirator) their keys, which come first
+#define VECTOR_SPEC_NAME bucket
+#define VECTOR_SPEC_ELEM_T struct Bucket
+#include "lib/containers/vector-specialized.h"
+
+#define VECTOR_SPEC_NAME policer_key
+#define VECTOR_SPEC_ELEM_T uint32_t
+#include "lib/containers/vector-specialized.h"
+
+#define EXPIRATOR_SPEC_NAME policer_key
+#define EXPIRATOR_SPEC_KEY_T uint32_t
+#include "lib/expirator-specialized.h"
 
 struct policer_config config;
 
+// A token bucket's parameters. refill_time is the time for an empty bucket
+// to fill up (burst / rate), in ns, computed once so that packets do not
+// divide by the rate: buckets older than that are full.
+struct policer_class {
+  uint64_t rate;
+  uint64_t burst;
+  uint64_t refill_time;
+};
+
+// The rate classes, indexed by the rate_class of the flows; a few cache
+// lines for the usual handful of plans
+struct policer_class classes[POLICER_MAX_CLASSES];
+
+// The aggregate bucket of the WAN device, if config.uplink_rate is not 0
+struct policer_class uplink_class;
+
+// Buckets older than the longest refill time are full, like new ones, so
+// they expire
+uint64_t max_refill_time;
+
+// Rate class of each subscriber (destination), by prefix, NULL if all are in
+// class 0
+void *subscriber_classes;
+
 struct State *flowtable;
 
 int policer_expire_entries(time_t time) {
   assert(time >= 0); // we don't support the past
   assert(sizeof(time_t) <= sizeof(uint64_t));
   uint64_t time_u = (uint64_t)time; // OK because of the two asserts
-  time_t last_time =
-      time_u - config.burst/config.rate; 
+  time_t last_time = time_u - max_refill_time;
+
+  return policer_key_expire_items_single_map(flowtable->heap, flowtable->fv,
+                                             flowtable->fm, last_time);
+}
+
+// The record of dst, borrowed, or NULL if dst has none. Packets to one
+// destination tend to come in bursts, so the flow of the previous packet is
+// tried first, without a map lookup: it is dst's if its index is still
+// allocated and its record has dst as key.
+static struct Bucket *policer_find_flow(uint32_t dst, int *index) {
+  struct Bucket *value = 0;
+  *index = flowtable->last_index;
+  if (*index != -1 && dchain_is_index_allocated(flowtable->heap, *index)) {
+    bucket_vector_borrow(flowtable->fv, *index, &value);
+    if (value->dst == dst) {
+      return value;
+    }
+    bucket_vector_return(flowtable->fv, *index, value);
+    value = 0;
+  }
+  if (policer_key_map_get(flowtable->fm, &dst, index)) {
+    bucket_vector_borrow(flowtable->fv, *index, &value);
+  }
+  return value;
+}
+
+// Adds the tokens of the time since the bucket was last updated
+static void policer_refill(struct Bucket *bucket, struct policer_class *params,
+                           uint64_t time) {
+  assert(bucket->bucket_time >= 0);
+  uint64_t time_diff = time - bucket->bucket_time;
+  if (time_diff < params->refill_time) {
+    // A division by a constant: a multiplication by its reciprocal
+    uint64_t added_tokens =
+        (time_diff * params->rate) / VIGOR_TIME_SECONDS_MULTIPLIER;
+    bucket->bucket_size += added_tokens;
+    if (bucket->bucket_size > params->burst) {
+      bucket->bucket_size = params->burst;
+    }
+  } else {
+    bucket->bucket_size = params->burst;
+  }
+  bucket->bucket_time = time;
+}
+
+// Takes size tokens from the aggregate bucket, if it has them. Called once
+// the subscriber's bucket has them, so that a packet dropped by either
+// bucket takes tokens from neither.
+static bool policer_check_uplink(uint16_t size, uint64_t time) {
+  if (config.uplink_rate == 0) {
+    return true;
+  }
+  struct Bucket *uplink = 0;
+  bucket_vector_borrow(flowtable->uplink, 0, &uplink);
+  policer_refill(uplink, &uplink_class, time);
+  bool fwd = false;
+  if (uplink->bucket_size > size) {
+    uplink->bucket_size -= size;
+    fwd = true;
+  }
+  bucket_vector_return(flowtable->uplink, 0, uplink);
+  return fwd;
+}
 
-  return expire_items_single_map(flowtable->heap, flowtable->fv,
-                                 flowtable->fm, last_time);
+// The rate class of a new subscriber: the one of its longest prefix in the
+// subscribers file, class 0 if none
+static uint16_t policer_subscriber_class(uint32_t dst) {
+  if (subscriber_classes == NULL) {
+    return 0;
+  }
+  uint32_t rate_class = lpm_lookup(subscriber_classes, rte_be_to_cpu_32(dst));
+  if (rate_class >= config.class_count) {
+    return 0;
+  }
+  return rate_class;
 }
 
 bool policer_check_tb(uint32_t dst, uint16_t size, time_t time) {
+  assert(0 <= time);
+  uint64_t time_u = (uint64_t)time;
   int index = -1;
-  int present = map_get(flowtable->fm, &dst, &index);
-  if (present) {
+  struct Bucket *value = policer_find_flow(dst, &index);
+  if (value) {
     dchain_rejuvenate_index(flowtable->heap, index, time);
+    flowtable->last_index = index;
 
-    struct Bucket *value = 0;
-    vector_borrow(flowtable->fv, index, (void **)&value);
-
-    assert(0 <= time);
-    uint64_t time_u = (uint64_t)time;
-    assert(value->bucket_time >= 0);
-    uint64_t time_diff = time_u - value->bucket_time;
-    if (time_diff <
-        config.burst * VIGOR_TIME_SECONDS_MULTIPLIER / config.rate) {
-      uint64_t added_tokens =
-          (time_diff * config.rate) / VIGOR_TIME_SECONDS_MULTIPLIER;
-      value->bucket_size += added_tokens;
-      if (value->bucket_size > config.burst) {
-        value->bucket_size = config.burst;
-      }
-    } else {
-      value->bucket_size = config.burst;
-    }
-    value->bucket_time = time_u;
+    policer_refill(value, &classes[value->rate_class], time_u);
 
     bool fwd = false;
-    if (value->bucket_size > size) {
+    if (value->bucket_size > size && policer_check_uplink(size, time_u)) {
       value->bucket_size -= size;
       fwd = true;
     }
 
-    vector_return(flowtable->fv, index, value);
+    bucket_vector_return(flowtable->fv, index, value);
 
     return fwd;
   } else {
-    if (size > config.burst) {
+    uint16_t rate_class = policer_subscriber_class(dst);
+    if (size > classes[rate_class].burst) {
       NF_DEBUG("  Unknown flow with packet larger than burst size. Dropping.");
       return false;
     }
@@ -82,26 +184,60 @@ bool policer_check_tb(uint32_t dst, uint16_t size, time_t time) {
       NF_DEBUG("No more space in the policer table");
       return false;
     }
-    uint32_t *key;
-    struct Bucket *value = 0;
-    vector_borrow(flowtable->fk, index, (void**)&key);
-    vector_borrow(flowtable->fv, index, (void **)&value);
-    *key = dst;
-    value->bucket_size = config.burst - size;
+    bucket_vector_borrow(flowtable->fv, index, &value);
+    value->dst = dst;
+    value->rate_class = rate_class;
+    value->bucket_size = classes[rate_class].burst;
     value->bucket_time = time;
-    map_put(flowtable->fm, key, index);
-    vector_return(flowtable->fk, index, key);
-    vector_return(flowtable->fv, index, value);
-    NF_DEBUG("  New flow. Forwarding.");
-    return true;
+    // A full bucket, as if the flow had been there all along
+    bool fwd = policer_check_uplink(size, time_u);
+    if (fwd) {
+      value->bucket_size -= size;
+    }
+    policer_key_map_put(flowtable->fm, &value->dst, index);
+    bucket_vector_return(flowtable->fv, index, value);
+    flowtable->last_index = index;
+    NF_DEBUG("  New flow. %s.", fwd ? "Forwarding" : "Dropping");
+    return fwd;
   }
 }
 
+static void policer_class_init(struct policer_class *params, uint64_t rate,
+                               uint64_t burst) {
+  params->rate = rate;
+  params->burst = burst;
+  params->refill_time = burst * VIGOR_TIME_SECONDS_MULTIPLIER / rate;
+}
+
 void nf_core_init() {
   unsigned capacity = config.dyn_capacity;
-  flowtable = alloc_state(capacity);
+  flowtable = alloc_state(capacity, config.class_count);
   if (flowtable == NULL) {
     rte_exit(EXIT_FAILURE, "Could not allocate flow table");}
+
+  max_refill_time = 0;
+  for (uint32_t c = 0; c < config.class_count; c++) {
+    policer_class_init(&classes[c], config.class_rates[c],
+                       config.class_bursts[c]);
+    if (max_refill_time < classes[c].refill_time) {
+      max_refill_time = classes[c].refill_time;
+    }
+  }
+
+  if (config.uplink_rate != 0) {
+    policer_class_init(&uplink_class, config.uplink_rate,
+                       config.uplink_burst);
+    struct Bucket *uplink = 0;
+    bucket_vector_borrow(flowtable->uplink, 0, &uplink);
+    uplink->bucket_size = config.uplink_burst;
+    uplink->bucket_time = 0;
+    bucket_vector_return(flowtable->uplink, 0, uplink);
+  }
+
+  subscriber_classes = NULL;
+  if (config.subscribers_fname[0] != '\0') {
+    lpm_init(config.subscribers_fname, &subscriber_classes);
+  }
 }
 
 int nf_core_process(struct rte_mbuf* mbuf,  time_t now) {
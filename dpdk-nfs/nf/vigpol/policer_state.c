@@ -10,7 +10,7 @@
 
 struct State *allocated_nf_state = NULL;
 
-struct State *alloc_state(int max_flows) {
+struct State *alloc_state(int max_flows, int class_count) {
   if (allocated_nf_state != NULL)
     return allocated_nf_state;
   struct State *ret = malloc(sizeof(struct State));
@@ -19,41 +19,51 @@ struct State *alloc_state(int max_flows) {
   ret->fm = NULL;
   if (map_allocate(policer_flow_eq, policer_flow_hash, max_flows, &(ret->fm)) == 0)
     return NULL;
-  ret->fk = NULL;
-  if (vector_allocate(sizeof(struct Bucket), max_flows, policer_flow_allocate,
-                      &(ret->fk)) == 0)
-    return NULL;
   ret->fv = NULL;
-  if (vector_allocate(sizeof(struct Bucket), max_flows, policer_flow_allocate,
-                      &(ret->fv)) == 0)
+  // A group of one, for the alignment: each record in one cache line
+  struct VectorGroupMember flow_vectors[] = {
+    {sizeof(struct Bucket), policer_flow_allocate, &(ret->fv)},
+  };
+  if (vector_allocate_group(max_flows, 1, flow_vectors) == 0)
     return NULL;
   ret->heap = NULL;
   if (dchain_allocate(max_flows, &(ret->heap)) == 0)
     return NULL;
+  ret->uplink = NULL;
+  if (vector_allocate(sizeof(struct Bucket), 1, policer_flow_allocate,
+                      &(ret->uplink)) == 0)
+    return NULL;
   ret->max_flows = max_flows;
+  ret->class_count = class_count;
+  ret->last_index = -1;
 
   DS_INIT(map, ret->fm, "policer_flowtable", "pkt.flow")
   DS_INIT(dchain, ret->heap, "nat_flowtable", "pkt.flow")
   DS_INIT(vector, ret->fv, "vector", "pkt.flow.bucket")
+  DS_INIT(vector, ret->uplink, "uplink", "pkt.uplink.bucket")
 #ifdef KLEE_VERIFICATION
   map_set_key_size(ret->fm, sizeof(uint32_t));
   vector_set_entry_condition(ret->fv, policer_bucket_sanity_check, ret);
+  vector_set_entry_condition(ret->uplink, policer_bucket_sanity_check, ret);
 #endif // KLEE_VERIFICATION
   allocated_nf_state = ret;
   return ret;
 }
 
 #ifdef KLEE_VERIFICATION
-void loop_reset(struct Map* fm, struct Vector* fk, struct Vector*fv, struct DoubleChain* heap, int max_flows, time_t* time){
+void loop_reset(struct Map* fm, struct Vector*fv, struct DoubleChain* heap, struct Vector* uplink, int max_flows, int* last_index, time_t* time){
   map_reset(fm);
-  vector_reset(fk);
   vector_reset(fv);
   dchain_reset(heap,max_flows);
+  vector_reset(uplink);
+  // Any flow, or none
+  *last_index = klee_int("last_index");
+  klee_assume(-1 <= *last_index AND *last_index < max_flows);
   *time = restart_time();
 
 }
 
 void nf_loop_iteration_border(unsigned lcore_id, time_t time) {
-  loop_reset(allocated_nf_state->fm, allocated_nf_state->fk, allocated_nf_state->fv, allocated_nf_state->heap, allocated_nf_state->max_flows, &time);
+  loop_reset(allocated_nf_state->fm, allocated_nf_state->fv, allocated_nf_state->heap, allocated_nf_state->uplink, allocated_nf_state->max_flows, &allocated_nf_state->last_index, &time);
 }
 #endif // KLEE_VERIFICATION
@@ -3,17 +3,21 @@
 #include "lib/containers/double-chain.h"
 #include "lib/containers/map.h"
 #include "lib/containers/vector.h"
+#include "lib/containers/vector-group.h"
 #include "policer_flow.h"
 #include "lib/nf_time.h"
 
 struct State {
   struct Map* fm; 
-  struct Vector* fk; // Keys
-  struct Vector* fv; // Values
+  struct Vector* fv; // Flow records (struct Bucket), keyed by their dst
   struct DoubleChain* heap;
+  // One record (struct Bucket): the aggregate bucket of the WAN device
+  struct Vector* uplink;
   int max_flows;
+  int class_count;
+  int last_index; // Of the flow of the last policed packet, -1 if none
 };
 
-struct State* alloc_state(int max_flows);
+struct State* alloc_state(int max_flows, int class_count);
 
 #endif//_STATE_H_INCLUDED_
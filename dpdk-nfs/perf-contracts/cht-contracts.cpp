@@ -20,8 +20,9 @@ long lb_find_preferred_available_backend_contract_0(std::string metric,
   else {
     assert( 0 && "Contract does not support this metric");
   }
+  // No lb_flow_hash: the balancer passes in the hash of its map_get, whose
+  // contract counts it
   long constant_dependency = vector_borrow_contract_0(metric, values);
-  constant_dependency += lb_flow_hash_contract(metric);
   constant_dependency += vector_return_contract_0(metric, values);
   constant_dependency += dchain_is_index_allocated_contract_0(metric, values);
   return constant +
@@ -80,10 +81,6 @@ perf_formula lb_find_preferred_available_backend_formula_contract_0(
     formula = add_perf_formula(
         formula, vector_return_formula_contract_0(metric, values, PCVAbs),
         PCVAbs);
-    formula = add_perf_formula(
-        formula,
-        lb_flow_hash_formula_contract(metric, PCVAbs),
-        PCVAbs);
     formula = add_perf_formula(
         formula,
         dchain_is_index_allocated_formula_contract_0(metric, values, PCVAbs),
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""
+Generate the "llvm cycles" weights from the ir-perf opcode table
+
+The "llvm instruction count" contracts count LLVM instructions; "llvm cycles"
+weights each term of that count by the mean cost of the instructions it
+counts. The constant term counts the instructions outside loops and the PCV
+terms (traversals, collisions, ...) those of loop bodies, so this script
+derives two means for every contract function from
+
+  - the opcode table written by ir-perf (run_benchmarks.py --opcode-table),
+    one row per opcode with its latency and reciprocal throughput in cycles
+  - the LLVM IR of the libVig containers (clang -S -emit-llvm)
+
+A block is in a loop if it is part of a cycle of the control flow graph.
+Functions called from a loop block count towards the loop mean, those called
+from elsewhere are split the same way, so map_get includes map_impl_get's
+loop. Calls through pointers (hash, key equality) are not followed. Opcodes the table does not measure cost DEFAULT_COST, except
+loads and stores, which cost L1_LATENCY as in contract-params.h.
+
+Usage: gen-llvm-cycles.py [--cost latency|throughput] [-o llvm-cycles-weights.h]
+                          <opcode_table.csv> <module.ll>...
+"""
+
+import argparse
+import csv
+import re
+import sys
+
+# Keep in sync with contract-params.h
+L1_LATENCY = 2
+DEFAULT_COST = 1.0
+
+COST_COLUMNS = {'latency': 'latency_cycles',
+                'throughput': 'recip_throughput_cycles'}
+
+DEFINE_RE = re.compile(r'^define\b[^@]*@("?[\w.$]+"?)\(')
+LABEL_RE = re.compile(r'^("?[\w.$-]+"?):')
+TARGET_RE = re.compile(r'\blabel %("?[\w.$-]+"?)')
+# "%x = <opcode> ..." or "<opcode> ..." (store, br, call without result, ...)
+INST_RE = re.compile(r'^\s+(?:%[\w.$"-]+\s*=\s*)?(?:tail\s+|musttail\s+|notail\s+)?([a-z_]+)\b')
+CALL_RE = re.compile(r'\b(?:call|invoke)\b[^@]*@("?[\w.$]+"?)\(')
+
+
+def read_opcode_costs(path, column):
+    costs = {}
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            try:
+                costs[row['opcode']] = max(float(row[column]), 0.0)
+            except (KeyError, ValueError):
+                continue
+    return costs
+
+
+class Block:
+    def __init__(self):
+        self.opcodes = []
+        self.callees = set()
+        self.successors = set()
+
+
+def read_functions(paths):
+    """{function: {block: Block}} over all modules."""
+    functions = {}
+    for path in paths:
+        blocks = None
+        with open(path) as f:
+            for line in f:
+                m = DEFINE_RE.match(line)
+                if m:
+                    blocks = functions[m.group(1).strip('"')] = {}
+                    block = blocks[''] = Block()  # the entry block
+                    continue
+                if blocks is None:
+                    continue
+                if line.startswith('}'):
+                    blocks = None
+                    continue
+                m = LABEL_RE.match(line)
+                if m:
+                    name = m.group(1).strip('"')
+                    if block.opcodes or len(blocks) > 1:
+                        block = blocks[name] = Block()
+                    else:
+                        # A labelled entry block
+                        blocks[name] = blocks.pop('')
+                    continue
+                # Branch and switch targets, including the case lines
+                block.successors.update(t.strip('"') for t in TARGET_RE.findall(line))
+                m = INST_RE.match(line)
+                if not m:
+                    continue
+                opcode = m.group(1)
+                # Debug intrinsics are not executed
+                if opcode == 'call' and '@llvm.dbg.' in line:
+                    continue
+                block.opcodes.append(opcode)
+                m = CALL_RE.search(line)
+                if m:
+                    block.callees.add(m.group(1).strip('"'))
+    return functions
+
+
+def loop_blocks(blocks):
+    """The blocks on a cycle of the CFG (Tarjan's strongly connected components)."""
+    index, low, stack, on_stack = {}, {}, [], set()
+    loops = set()
+
+    def visit(b):
+        index[b] = low[b] = len(index)
+        stack.append(b)
+        on_stack.add(b)
+        for s in blocks[b].successors:
+            if s not in blocks:
+                continue
+            if s not in index:
+                visit(s)
+                low[b] = min(low[b], low[s])
+            elif s in on_stack:
+                low[b] = min(low[b], index[s])
+        if low[b] == index[b]:
+            scc = []
+            while True:
+                s = stack.pop()
+                on_stack.discard(s)
+                scc.append(s)
+                if s == b:
+                    break
+            if len(scc) > 1 or b in blocks[b].successors:
+                loops.update(scc)
+
+    for b in blocks:
+        if b not in index:
+            visit(b)
+    return loops
+
+
+def all_opcodes(functions, root):
+    """Opcodes of root and of every function it reaches."""
+    seen = set()
+    opcodes = []
+    work = [root]
+    while work:
+        fn = work.pop()
+        if fn in seen or fn not in functions:
+            continue
+        seen.add(fn)
+        for block in functions[fn].values():
+            opcodes.extend(block.opcodes)
+            work.extend(block.callees)
+    return opcodes
+
+
+def split_opcodes(functions, fn, active=frozenset()):
+    """(opcodes outside loops, opcodes in loop bodies) of fn and its callees."""
+    straight, looped = [], []
+    if fn not in functions or fn in active:
+        return straight, looped
+    active = active | {fn}
+    blocks = functions[fn]
+    loops = loop_blocks(blocks)
+    for name, block in blocks.items():
+        if name in loops:
+            looped.extend(block.opcodes)
+            for callee in block.callees:
+                looped.extend(all_opcodes(functions, callee))
+        else:
+            straight.extend(block.opcodes)
+            for callee in block.callees:
+                s, l = split_opcodes(functions, callee, active)
+                straight.extend(s)
+                looped.extend(l)
+    return straight, looped
+
+
+def opcode_cost(costs, opcode):
+    if opcode in costs:
+        return costs[opcode]
+    if opcode in ('load', 'store'):
+        return float(L1_LATENCY)
+    return DEFAULT_COST
+
+
+def mean_cost(costs, opcodes):
+    return sum(opcode_cost(costs, op) for op in opcodes) / len(opcodes)
+
+
+def function_weights(functions, costs, fn):
+    """(constant term weight, PCV term weight); a function without loops
+    weights both alike."""
+    straight, looped = split_opcodes(functions, fn)
+    if not straight and not looped:
+        return None
+    constant = mean_cost(costs, straight or looped)
+    return constant, mean_cost(costs, looped) if looped else constant
+
+
+def contract_functions(perf_contracts_cpp):
+    """The fn_names list in contract_init()."""
+    with open(perf_contracts_cpp) as f:
+        text = f.read()
+    m = re.search(r'fn_names\s*=\s*\{(.*?)\};', text, re.S)
+    return re.findall(r'"(\w+)"', m.group(1)) if m else []
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('opcode_table', help='CSV written by ir-perf opcode_table -o')
+    parser.add_argument('modules', nargs='+', help='LLVM IR (.ll) of the containers')
+    parser.add_argument('--cost', choices=sorted(COST_COLUMNS), default='latency',
+                        help='opcode cost to weight with (default: latency)')
+    parser.add_argument('--contracts', default='perf-contracts.cpp',
+                        help='file whose fn_names lists the contract functions')
+    parser.add_argument('-o', '--output', default='llvm-cycles-weights.h')
+    args = parser.parse_args()
+
+    costs = read_opcode_costs(args.opcode_table, COST_COLUMNS[args.cost])
+    if not costs:
+        print(f"No opcode costs in {args.opcode_table}", file=sys.stderr)
+        sys.exit(1)
+    functions = read_functions(args.modules)
+    # loop_blocks() recurses once per block
+    sys.setrecursionlimit(100000)
+
+    weights = {}
+    missing = []
+    for fn in contract_functions(args.contracts):
+        w = function_weights(functions, costs, fn)
+        if w is None:
+            missing.append(fn)
+        else:
+            weights[fn] = w
+
+    with open(args.output, 'w') as f:
+        f.write("/* Generated by gen-llvm-cycles.py, do not edit */\n")
+        f.write(f"/* Opcode {args.cost} from {args.opcode_table} */\n")
+        f.write("/* Regenerate with: make llvm-cycles OPCODE_TABLE=<opcode_table.csv> */\n")
+        f.write("#pragma once\n\n")
+        f.write("#include <map>\n#include <string>\n")
+        f.write("#include <utility>\n\n")
+        f.write("/* Mean cycles per LLVM instruction of each contract function, outside\n"
+                " * loops (the constant term) and in loop bodies (the PCV terms) */\n")
+        f.write("static const std::map<std::string, std::pair<double, double>>\n"
+                "    llvm_cycles_weights = {\n")
+        for fn, (constant, pcv) in sorted(weights.items()):
+            f.write(f'        {{"{fn}", {{{constant:.4f}, {pcv:.4f}}}}},\n')
+        f.write("};\n")
+
+    print(f"Wrote {len(weights)} weights to {args.output}")
+    if missing:
+        # Weight 1.0: "llvm cycles" falls back to "llvm instruction count"
+        print(f"Not defined in the modules: {' '.join(missing)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -73,6 +73,7 @@ long ext_key_eq_contract(std::string metric, long success) {
 
 long flow_id_hash_contract(std::string metric) {
   long constant;
+#ifdef FLOW_HASH_MUL31
   if (metric == "instruction count")
     constant = 45;
   else if (metric == "memory instructions")
@@ -83,6 +84,19 @@ long flow_id_hash_contract(std::string metric) {
     constant = 35;
   else if (metric == "llvm memory instructions")
     constant = 6;
+#else  // FLOW_HASH_MUL31
+  // flow_hash_mix (nf/lib/flow-hash.h): six field loads and one multiply
+  if (metric == "instruction count")
+    constant = 22;
+  else if (metric == "memory instructions")
+    constant = 7;
+  else if (metric == "execution cycles")
+    constant = 0 * DRAM_LATENCY + 7 * L1_LATENCY + 20;
+  else if (metric == "llvm instruction count")
+    constant = 37;
+  else if (metric == "llvm memory instructions")
+    constant = 6;
+#endif // FLOW_HASH_MUL31
   else {
     assert( 0 && "Contract does not support this metric");
   }
@@ -0,0 +1,26 @@
+/* Generated by gen-llvm-cycles.py, do not edit */
+/* Opcode latency from opcode_table_20261016.csv */
+/* Regenerate with: make llvm-cycles OPCODE_TABLE=<opcode_table.csv> */
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+
+/* Mean cycles per LLVM instruction of each contract function, outside
+ * loops (the constant term) and in loop bodies (the PCV terms) */
+static const std::map<std::string, std::pair<double, double>>
+    llvm_cycles_weights = {
+        {"dchain_allocate", {1.0443, 1.1287}},
+        {"dchain_allocate_new_index", {1.3603, 1.3603}},
+        {"dchain_is_index_allocated", {1.1124, 1.1124}},
+        {"dchain_rejuvenate_index", {1.2493, 1.2493}},
+        {"expire_items_single_map", {1.2798, 1.2825}},
+        {"map_allocate", {1.0437, 1.0998}},
+        {"map_erase", {1.2967, 1.1448}},
+        {"map_get", {1.2538, 1.1061}},
+        {"map_put", {1.2847, 1.1088}},
+        {"vector_allocate", {1.1516, 1.3212}},
+        {"vector_borrow", {1.4688, 1.4688}},
+        {"vector_return", {1.0000, 1.0000}},
+};
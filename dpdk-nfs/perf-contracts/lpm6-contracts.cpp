@@ -0,0 +1,82 @@
+#include "lpm6-contracts.h"
+
+/* Contracts for the IPv6 Poptrie in nf/lpm/lpm6_poptrie.c.
+ * Every lookup reads one top-level entry; lpm6_levels counts the compressed
+ * nodes visited after it (0 to 19), each a node read plus a popcount, and the
+ * last one also reads a leaf. lpm6_lookup_bulk has no contract: no NF calls
+ * it. */
+
+/* Perf contracts */
+
+/* Cost = constant + per_level * lpm6_levels */
+static void lpm6_lookup_costs(std::string metric, long *constant,
+                              long *per_level) {
+  if (metric == "instruction count") {
+    *constant = 12;
+    *per_level = 14;
+  } else if (metric == "memory instructions") {
+    *constant = 4;
+    *per_level = 3;
+  } else if (metric == "execution cycles") {
+    *constant = 1 * DRAM_LATENCY + 3 * L1_LATENCY + 8;
+    *per_level = 1 * DRAM_LATENCY + 2 * L1_LATENCY + 9;
+  } else if (metric == "llvm instruction count") {
+    *constant = 14;
+    *per_level = 16;
+  } else if (metric == "llvm memory instructions") {
+    *constant = 4;
+    *per_level = 3;
+  } else {
+    assert(0 && "Contract does not support this metric");
+  }
+}
+
+long lpm6_init_contract_0(std::string metric, std::vector<long> values) {
+  return 0;
+}
+long lpm6_lookup_contract_0(std::string metric, std::vector<long> values) {
+  long lpm6_levels = values[0];
+  long constant, per_level;
+  lpm6_lookup_costs(metric, &constant, &per_level);
+  return constant + per_level * lpm6_levels;
+}
+
+/* Cstate contracts */
+
+std::map<std::string, std::set<int>>
+lpm6_init_cstate_contract_0(std::vector<long> values) {
+
+  std::map<std::string, std::set<int>> cstate;
+  return cstate;
+}
+std::map<std::string, std::set<int>>
+lpm6_lookup_cstate_contract_0(std::vector<long> values) {
+
+  std::map<std::string, std::set<int>> cstate;
+  return cstate;
+}
+
+/* Perf Formula contracts */
+
+perf_formula lpm6_init_formula_contract_0(std::string metric,
+                                          std::vector<long> values,
+                                          PCVAbstraction PCVAbs) {
+  perf_formula formula;
+  if (PCVAbs == LOOP_CTRS)
+    formula["constant"] = 0;
+  return formula;
+}
+
+perf_formula lpm6_lookup_formula_contract_0(std::string metric,
+                                            std::vector<long> values,
+                                            PCVAbstraction PCVAbs) {
+  perf_formula formula;
+  if (PCVAbs == LOOP_CTRS) {
+    long constant, per_level;
+    lpm6_lookup_costs(metric, &constant, &per_level);
+    formula["constant"] = constant;
+    formula["d"] = per_level;
+  } else if (PCVAbs == FN_CALLS)
+    formula["lpm6_lookup"] = 1;
+  return formula;
+}
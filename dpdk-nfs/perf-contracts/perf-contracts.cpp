@@ -9,11 +9,13 @@
 #include "helper-contracts.h"
 #include "ip-opt-contracts.h"
 #include "lpm-contracts.h"
+#include "lpm6-contracts.h"
 #include "map-contracts.h"
 #include "map-impl-contracts.h"
 #include "vector-contracts.h"
 #include "natasha-contracts.h"
 #include "bpf-map-contracts.h"
+#include "llvm-cycles-weights.h"
 
 std::vector<std::string> supported_metrics;
 std::vector<std::string> fn_names;
@@ -71,6 +73,17 @@ bool check_metric(std::string metric) {
   return false;
 }
 
+/* "llvm cycles" has no contracts of its own: it is "llvm instruction count"
+ * with each term weighted by the mean ir-perf cost of the LLVM instructions
+ * it counts, those outside loops for the constant and those of loop bodies
+ * for the PCV terms */
+double llvm_cycles_weight(std::string function_name, bool constant_term) {
+  auto it = llvm_cycles_weights.find(function_name);
+  if (it == llvm_cycles_weights.end())
+    return 1.0;
+  return constant_term ? it->second.first : it->second.second;
+}
+
 bool check_formula(perf_formula formula, PCVAbstraction PCVAbs) {
   for (auto itf = formula.begin(); itf != formula.end(); ++itf) {
     if (std::find(supported_pcv_symbols[PCVAbs].begin(),
@@ -190,7 +203,8 @@ void contract_init() {
   supported_metrics = {"execution cycles", "instruction count",
                        "memory instructions"};
 #else
-  supported_metrics = {"llvm instruction count", "llvm memory instructions"};
+  supported_metrics = {"llvm instruction count", "llvm memory instructions",
+                       "llvm cycles"};
 #endif
   fn_names = {
       "dchain_allocate",
@@ -208,6 +222,8 @@ void contract_init() {
       "handle_packet_timestamp",
       "lpm_init",
       "lpm_lookup",
+      "lpm6_init",
+      "lpm6_lookup",
       "trace_reset_buffers",
       "lb_find_preferred_available_backend",
       "nf_set_ipv4_checksum",
@@ -225,6 +241,7 @@ void contract_init() {
       {"expired_flows", "(ReadLSB w32 0 initial_map_occupancy)"},
       {"available_backends", "(ReadLSB w32 0 initial_backend_capacity)"},
       {"lpm_stages", "(ReadLSB w32 0 initial_max_lpm_depth)"},
+      {"lpm6_levels", "(ReadLSB w32 0 initial_lpm6_max_levels)"},
   };
 
   supported_pcv_symbols = {
@@ -234,6 +251,7 @@ void contract_init() {
            "t",        /* bucket traversals */
            "c",        /* hash collisions */
            "s",        /* lpm stages */
+           "d",        /* lpm6 trie levels */
            "constant", /* final constant*/
        }},
       {FN_CALLS, {}},
@@ -270,6 +288,7 @@ void contract_init() {
        {"Num_bucket_traversals", "Num_hash_collisions", "expired_flows"}},
       {"lb_find_preferred_available_backend", {"available_backends"}},
       {"process_ip_packet", {"lpm_stages"}},
+      {"lpm6_lookup", {"lpm6_levels"}},
   };
 
   /* Map of function name to shadow variable. If a variable is both a UV and a
@@ -320,6 +339,8 @@ void contract_init() {
       {"handle_packet_timestamp", {{0, "true"}}},
       {"lpm_init", {{0, "true"}}},
       {"lpm_lookup", {{0, "true"}}},
+      {"lpm6_init", {{0, "true"}}},
+      {"lpm6_lookup", {{0, "true"}}},
       {"trace_reset_buffers", {{0, "true"}}},
       {"lb_find_preferred_available_backend", {{0, "true"}}},
       {"flood", {{0, "true"}}},
@@ -347,6 +368,8 @@ void contract_init() {
       {"vector_return", {{0, &vector_return_contract_0}}},
       {"lpm_init", {{0, &lpm_init_contract_0}}},
       {"lpm_lookup", {{0, &lpm_lookup_contract_0}}},
+      {"lpm6_init", {{0, &lpm6_init_contract_0}}},
+      {"lpm6_lookup", {{0, &lpm6_lookup_contract_0}}},
       {"trace_reset_buffers", {{0, &trace_reset_buffers_contract_0}}},
       {"handle_packet_timestamp", {{0, &handle_packet_timestamp_contract_0}}},
       {"lb_find_preferred_available_backend",
@@ -379,6 +402,8 @@ void contract_init() {
       {"vector_return", {{0, &vector_return_cstate_contract_0}}},
       {"lpm_init", {{0, &lpm_init_cstate_contract_0}}},
       {"lpm_lookup", {{0, &lpm_lookup_cstate_contract_0}}},
+      {"lpm6_init", {{0, &lpm6_init_cstate_contract_0}}},
+      {"lpm6_lookup", {{0, &lpm6_lookup_cstate_contract_0}}},
       {"trace_reset_buffers", {{0, &trace_reset_buffers_cstate_contract_0}}},
       {"handle_packet_timestamp",
        {{0, &handle_packet_timestamp_cstate_contract_0}}},
@@ -412,6 +437,8 @@ void contract_init() {
       {"vector_return", {{0, &vector_return_formula_contract_0}}},
       {"lpm_init", {{0, &lpm_init_formula_contract_0}}},
       {"lpm_lookup", {{0, &lpm_lookup_formula_contract_0}}},
+      {"lpm6_init", {{0, &lpm6_init_formula_contract_0}}},
+      {"lpm6_lookup", {{0, &lpm6_lookup_formula_contract_0}}},
       {"trace_reset_buffers", {{0, &trace_reset_buffers_formula_contract_0}}},
       {"handle_packet_timestamp",
        {{0, &handle_packet_timestamp_formula_contract_0}}},
@@ -442,6 +469,8 @@ void contract_init() {
       {"vector_return", {{0, "vector_return"}}},
       {"lpm_init", {{0, ""}}},
       {"lpm_lookup", {{0, "lpm_lookup"}}},
+      {"lpm6_init", {{0, ""}}},
+      {"lpm6_lookup", {{0, "lpm6_lookup"}}},
       {"trace_reset_buffers", {{0, "trace_reset_buffers"}}},
       {"handle_packet_timestamp", {{0, "handle_packet_timestamp"}}},
       {"lb_find_preferred_available_backend",
@@ -557,6 +586,12 @@ std::set<std::string> contract_get_symbols() {
       "array lpm_stages[4] : w32 -> w8 = symbolic",
       "array current_lpm_stages[4] : w32 -> w8 = symbolic",
       "array initial_lpm_stages[4] : w32 -> w8 = symbolic",
+      "array lpm6_max_levels[4] : w32 -> w8 = symbolic",
+      "array current_lpm6_max_levels[4] : w32 -> w8 = symbolic",
+      "array initial_lpm6_max_levels[4] : w32 -> w8 = symbolic",
+      "array lpm6_levels[4] : w32 -> w8 = symbolic",
+      "array current_lpm6_levels[4] : w32 -> w8 = symbolic",
+      "array initial_lpm6_levels[4] : w32 -> w8 = symbolic",
       "array rewrite_src_ip[4] : w32 -> w8 = symbolic",
       "array current_rewrite_src_ip[4] : w32 -> w8 = symbolic",
       "array initial_rewrite_src_ip[4] : w32 -> w8 = symbolic",
@@ -623,6 +658,8 @@ int contract_get_symbol_size(std::string symbol_name) {
       /* Natasha symbols */
       {"max_lpm_depth", 4},
       {"lpm_stages", 4},
+      {"lpm6_max_levels", 4},
+      {"lpm6_levels", 4},
       {"rewrite_src_ip", 4},
       {"rewrite_dst_ip", 4},
       {"matching_rule_found", 4},
@@ -661,6 +698,19 @@ long contract_get_sub_contract_performance(
   perf_calc_fn_ptr fn_ptr;
   fn_ptr = perf_fn_ptrs[function_name][sub_contract_idx];
   assert(fn_ptr);
+  if (metric == "llvm cycles") {
+    /* The formula splits the count into its constant and the PCV terms */
+    long count = fn_ptr("llvm instruction count", relevant_vals);
+    perf_formula_ptr formula_ptr =
+        perf_formula_fn_ptrs[function_name][sub_contract_idx];
+    perf_formula formula =
+        formula_ptr("llvm instruction count", relevant_vals, LOOP_CTRS);
+    long constant = std::min(formula["constant"], count);
+    double constant_weight = llvm_cycles_weight(function_name, true);
+    double pcv_weight = llvm_cycles_weight(function_name, false);
+    return (long)(constant * constant_weight + (count - constant) * pcv_weight +
+                  0.5);
+  }
   long perf = fn_ptr(metric, relevant_vals);
   if (metric == "memory instructions" && perf > 0) {
     perf = perf - 1;
@@ -705,7 +755,16 @@ perf_formula contract_get_perf_formula(std::string function_name,
       perf_formula_fn_ptrs[function_name][sub_contract_idx];
   assert(fn_ptr && "Function pointer not found for formula call\n");
 
-  perf_formula formula = fn_ptr(metric, relevant_vals, PCVAbs);
+  perf_formula formula;
+  if (metric == "llvm cycles") {
+    formula = fn_ptr("llvm instruction count", relevant_vals, PCVAbs);
+    for (auto &it : formula) {
+      double weight = llvm_cycles_weight(function_name, it.first == "constant");
+      it.second = (long)(it.second * weight + 0.5);
+    }
+  } else {
+    formula = fn_ptr(metric, relevant_vals, PCVAbs);
+  }
   if (formula.count("constant") == 0)
     formula["constant"] = 0;
   assert(check_formula(formula, PCVAbs));
@@ -47,7 +47,7 @@ int main(int argc, char *argv[]) {
 
   std::set<std::string> metrics = get_metrics();
   std::set<std::string> expected_metrics = {
-      "instruction count", "memory instructions", "execution cycles", "llvm instruction count", "llvm memory instructions"};
+      "instruction count", "memory instructions", "execution cycles", "llvm instruction count", "llvm memory instructions", "llvm cycles"};
   assert(metrics == expected_metrics);
   std::cout << "get_metrics test successful" << std::endl;
 
@@ -241,7 +241,7 @@ int main(int argc, char *argv[]) {
 		"map_erase"
   };
 
-  std::vector<std::string> llvm_metrics = {"llvm instruction count", "llvm memory instructions"};
+  std::vector<std::string> llvm_metrics = {"llvm instruction count", "llvm memory instructions", "llvm cycles"};
 
 
   decltype(&contract_get_perf_formula) get_perf_formula =
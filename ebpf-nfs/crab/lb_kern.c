@@ -125,12 +125,12 @@ static __always_inline int handle_syn(struct xdp_md *ctx, struct ethhdr *ethh,
   data_end = (void *)(long)ctx->data_end;
   ethh = (void *)(long)ctx->data;
 
-  if (ethh + 1 > data_end)
+  if ((void *)(ethh + 1) > data_end)
     return XDP_ABORTED;
   __builtin_memcpy(ethh, &ethh_old, sizeof(ethh_old));
 
   iph = (struct iphdr *)(ethh + 1);
-  if (iph + 1 > data_end)
+  if ((void *)(iph + 1) > data_end)
     return XDP_ABORTED;
   __builtin_memcpy(iph, &iph_old, sizeof(iph_old));
 
@@ -149,7 +149,7 @@ static __always_inline int handle_syn(struct xdp_md *ctx, struct ethhdr *ethh,
 
   /* TCP HDR */
   tcph = (struct tcphdr *)(iph + 1);
-  if (tcph + 1 > data_end)
+  if ((void *)(tcph + 1) > data_end)
     return XDP_ABORTED;
   __builtin_memcpy(tcph, &tcph_old, sizeof(tcph_old));
   tcph->doff = tcph->doff + sizeof(struct redir_opt) / 4;
@@ -171,7 +171,7 @@ static __always_inline int handle_syn(struct xdp_md *ctx, struct ethhdr *ethh,
   opt = ptr + sizeof(struct redir_opt);
 #pragma unroll
   for (i = 0; i < MAX_OPT_WORDS; i++) {
-    if (opt + 1 > data_end)
+    if ((void *)(opt + 1) > data_end)
       break;
 
     csum = bpf_csum_diff(0, 0, opt, sizeof(__u32), csum);
@@ -0,0 +1,44 @@
+/* Driver for the userspace XDP runner (ebpf-nfs/xdp-runner) */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lb_kern.c"
+#include "xdp_runner.h"
+
+static void runner_update(struct bpf_map_def *map, const void *key,
+                          const void *value) {
+  if (bpf_map_update_elem(map, key, value, BPF_ANY) < 0) {
+    fprintf(stderr, "crab runner: cannot populate maps\n");
+    exit(1);
+  }
+}
+
+/* Same targets as the symbex driver in lb_kern.c */
+void xdp_runner_nf_init(void) {
+  const __u32 num_targets = 3;
+  struct eth_addr dst[num_targets];
+  for (__u32 i = 0; i < num_targets; i++) {
+    for (__u32 j = 0; j < 6; j++) {
+      dst[i].addr[j] = i;
+    }
+  }
+  __u32 ipaddrs[num_targets];
+  __u32 localhost = 2130706432;
+  for (__u32 i = 0; i < num_targets; i++) {
+    ipaddrs[i] = localhost + i;
+  }
+
+  BPF_MAP_INIT(&targets_map, "targets_list", "", "target_ip");
+  BPF_MAP_INIT(&macs_map, "ips_to_mac_map", "ip", "mac_addr");
+  BPF_MAP_INIT(&targets_count, "targets_counter", "", "num_targets");
+  BPF_MAP_INIT(&cpu_rr_idx, "cpu_rr_id", "", "last_sent_target");
+
+  __u32 zero = 0, targets = num_targets;
+  runner_update(&targets_count, &zero, &targets);
+  for (__u32 i = 0; i < num_targets; i++) {
+    runner_update(&targets_map, &i, &ipaddrs[i]);
+    runner_update(&macs_map, &ipaddrs[i], &dst[i]);
+  }
+}
+
+int xdp_runner_nf_prog(struct xdp_md *ctx) { return xdp_prog_simple(ctx); }
@@ -0,0 +1,28 @@
+/* Driver for the userspace XDP runner (ebpf-nfs/xdp-runner) */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "xdp_fw_kern.h"
+#include "xdp_runner.h"
+
+void xdp_runner_nf_init(void) {
+  BPF_MAP_INIT(&tx_port, "tx_devices_map", "", "tx_device");
+  BPF_MAP_INIT(&flow_ctx_table, "flowtable", "pkt.flow", "output_port");
+
+  /* Init from xdp_fw_user.c */
+  const unsigned int num_ports = 2;
+  int key[] = {B_PORT, A_PORT};
+  int ifindex_out[] = {B_PORT, A_PORT};
+
+  for (unsigned int i = 0; i < num_ports; i++) {
+    if (bpf_map_update_elem(&tx_port, &key[i], &ifindex_out[i], 0) < 0) {
+      fprintf(stderr, "fw runner: cannot populate tx_port\n");
+      exit(1);
+    }
+  }
+}
+
+/* Packets from any interface but B_PORT (-i 7) open flows; packets from
+ * B_PORT are only let through on existing flows */
+int xdp_runner_nf_prog(struct xdp_md *ctx) { return xdp_fw_prog(ctx); }
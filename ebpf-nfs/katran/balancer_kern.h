@@ -174,7 +174,7 @@ process_l3_headers(struct packet_description *pckt, __u8 *protocol, __u64 off,
   struct ipv6hdr *ip6h;
   if (is_ipv6) {
     ip6h = data + off;
-    if (ip6h + 1 > data_end) {
+    if ((void *)(ip6h + 1) > data_end) {
       return XDP_DROP;
     }
 
@@ -202,7 +202,7 @@ process_l3_headers(struct packet_description *pckt, __u8 *protocol, __u64 off,
     }
   } else {
     iph = data + off;
-    if (iph + 1 > data_end) {
+    if ((void *)(iph + 1) > data_end) {
       return XDP_DROP;
     }
     // ihl contains len of ipv4 header in 32bit words
@@ -429,7 +429,7 @@ process_packet(void *data, __u64 off, void *data_end, bool is_ipv6,
   }
 #endif // INLINE_DECAP_IPIP
 
-  if (protocol == IPPROTO_UDP | protocol == IPPROTO_TCP) {
+  if ((protocol == IPPROTO_UDP) | (protocol == IPPROTO_TCP)) {
     if (protocol == IPPROTO_TCP) {
       VIGOR_TAG(TRAFFIC_CLASS, TCP);
       if (!parse_tcp(data, data_end, is_ipv6, &pckt)) {
@@ -20,7 +20,9 @@
 
 #include "bpf_map_def.h"
 
-#if (defined USES_BPF_MAPS) && (defined KLEE_VERIFICATION)
+#if defined XDP_RUNNER
+#include "bpf/bpf_map_helper_defs_native.h"
+#elif (defined USES_BPF_MAPS) && (defined KLEE_VERIFICATION)
 
 #ifndef REPLAY
 #include "bpf/bpf_map_helper_defs.h"
@@ -106,7 +108,9 @@ void bpf_map_reset_stub(struct bpf_map_def* map) {
 #endif
 
 /* helper functions called from eBPF programs written in C */
-#ifdef USES_BPF_MAP_LOOKUP_ELEM
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_MAP_LOOKUP_ELEM
 static __attribute__((noinline)) void *bpf_map_lookup_elem(void *map, const void *key) {
   if(record_calls){
     klee_trace_ret_just_ptr(sizeof(void*));
@@ -129,7 +133,9 @@ static void *(*bpf_map_lookup_elem)(void *map, void *key) =
   (void *) BPF_FUNC_map_lookup_elem;
 #endif
 
-#ifdef USES_BPF_MAP_UPDATE_ELEM
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_MAP_UPDATE_ELEM
 static __attribute__((noinline)) long bpf_map_update_elem(void *map, const void *key, const void *value,
                                 __u64 flags) {
   if(record_calls){
@@ -152,8 +158,10 @@ static int (*bpf_map_update_elem)(void *map, void *key, void *value,
   (void *) BPF_FUNC_map_update_elem;
 #endif
 
+#ifndef XDP_RUNNER
 static int (*bpf_map_delete_elem)(void *map, void *key) =
   (void *) BPF_FUNC_map_delete_elem;
+#endif
 static int (*bpf_map_push_elem)(void *map, void *value,
         unsigned long long flags) =
   (void *) BPF_FUNC_map_push_elem;
@@ -164,7 +172,9 @@ static int (*bpf_map_peek_elem)(void *map, void *value) =
 static int (*bpf_probe_read)(void *dst, int size, const void *unsafe_ptr) =
   (void *) BPF_FUNC_probe_read;
 
-#ifdef USES_BPF_KTIME_GET_NS
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_KTIME_GET_NS
 static __attribute__ ((noinline)) unsigned long long bpf_ktime_get_ns(void) {
   if(record_calls){
     klee_trace_ret();
@@ -184,7 +194,9 @@ static int (*bpf_trace_printk)(const char *fmt, int fmt_size, ...) =
 static void (*bpf_tail_call)(void *ctx, void *map, int index) =
   (void *) BPF_FUNC_tail_call;
 
-#ifdef USES_BPF_GET_SMP_PROC_ID
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_GET_SMP_PROC_ID
 static __attribute__ ((noinline)) unsigned long long bpf_get_smp_processor_id(void){
   if(record_calls){
     klee_trace_ret();
@@ -208,10 +220,12 @@ static unsigned long long (*bpf_perf_event_read)(void *map,
   (void *) BPF_FUNC_perf_event_read;
 static int (*bpf_clone_redirect)(void *ctx, int ifindex, int flags) =
   (void *) BPF_FUNC_clone_redirect;
+#ifndef XDP_RUNNER
 static int (*bpf_redirect)(int ifindex, int flags) =
   (void *) BPF_FUNC_redirect;
 static int (*bpf_redirect_map)(void *map, int key, int flags) =
   (void *) BPF_FUNC_redirect_map;
+#endif
 static int (*bpf_perf_event_output)(void *ctx, void *map,
             unsigned long long flags, void *data,
             int size) =
@@ -230,10 +244,14 @@ static int (*bpf_skb_get_tunnel_opt)(void *ctx, void *md, int size) =
   (void *) BPF_FUNC_skb_get_tunnel_opt;
 static int (*bpf_skb_set_tunnel_opt)(void *ctx, void *md, int size) =
   (void *) BPF_FUNC_skb_set_tunnel_opt;
+#ifndef XDP_RUNNER
 static unsigned long long (*bpf_get_prandom_u32)(void) =
   (void *) BPF_FUNC_get_prandom_u32;
+#endif
 
-#ifdef USES_BPF_XDP_ADJUST_HEAD
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_XDP_ADJUST_HEAD
 static __attribute__((noinline)) int bpf_xdp_adjust_head(struct xdp_md *xdp_md, int delta) {
   /* Simple stub for now that only moves data pointer without a check. We assume
    * programs don't use the metadata for now */
@@ -296,8 +314,10 @@ static int (*bpf_msg_pop_data)(void *ctx, int start, int cut, int flags) =
   (void *) BPF_FUNC_msg_pop_data;
 static int (*bpf_bind)(void *ctx, void *addr, int addr_len) =
   (void *) BPF_FUNC_bind;
+#ifndef XDP_RUNNER
 static int (*bpf_xdp_adjust_tail)(void *ctx, int offset) =
   (void *) BPF_FUNC_xdp_adjust_tail;
+#endif
 static int (*bpf_skb_get_xfrm_state)(void *ctx, int index, void *state,
              int size, int flags) =
   (void *) BPF_FUNC_skb_get_xfrm_state;
@@ -428,7 +448,9 @@ static int (*bpf_l3_csum_replace)(void *ctx, int off, int from, int to, int flag
 static int (*bpf_l4_csum_replace)(void *ctx, int off, int from, int to, int flags) =
   (void *) BPF_FUNC_l4_csum_replace;
 
-#ifdef USES_BPF_CSUM_DIFF
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_CSUM_DIFF
 
 static __attribute__ ((noinline)) __s64 bpf_csum_diff(__be32 *from, __u32 from_size, __be32 *to,
                            __u32 to_size, __wsum seed) {
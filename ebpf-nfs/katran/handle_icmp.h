@@ -225,7 +225,7 @@ static inline int parse_icmpv6(void *data, void *data_end, __u64 off,
   struct icmp6hdr *icmp_hdr;
   struct ipv6hdr *ip6h;
   icmp_hdr = data + off;
-  if (icmp_hdr + 1 > data_end) {
+  if ((void *)(icmp_hdr + 1) > data_end) {
     return XDP_DROP;
   }
   if (icmp_hdr->icmp6_type == ICMPV6_ECHO_REQUEST) {
@@ -242,7 +242,7 @@ static inline int parse_icmpv6(void *data, void *data_end, __u64 off,
   // data partition of icmp 'pkt too big' contains header (and as much data as
   // as possible) of the packet, which has trigered this icmp.
   ip6h = data + off;
-  if (ip6h + 1 > data_end) {
+  if ((void *)(ip6h + 1) > data_end) {
     return XDP_DROP;
   }
   pckt->flow.proto = ip6h->nexthdr;
@@ -258,7 +258,7 @@ static inline int parse_icmp(void *data, void *data_end, __u64 off,
   struct icmphdr *icmp_hdr;
   struct iphdr *iph;
   icmp_hdr = data + off;
-  if (icmp_hdr + 1 > data_end) {
+  if ((void *)(icmp_hdr + 1) > data_end) {
     return XDP_DROP;
   }
   if (icmp_hdr->type == ICMP_ECHO) {
@@ -270,7 +270,7 @@ static inline int parse_icmp(void *data, void *data_end, __u64 off,
   }
   off += sizeof(struct icmphdr);
   iph = data + off;
-  if (iph + 1 > data_end) {
+  if ((void *)(iph + 1) > data_end) {
     return XDP_DROP;
   }
   if (iph->ihl != 5) {
@@ -0,0 +1,77 @@
+/* Driver for the userspace XDP runner (ebpf-nfs/xdp-runner) */
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "balancer_kern.h"
+#include "xdp_runner.h"
+
+/* One VIP, TCP and UDP on port 80, balanced over RUNNER_REALS backends */
+#define RUNNER_VIP "10.0.0.10"
+#define RUNNER_VIP_PORT 80
+#define RUNNER_REALS 16
+
+/* Per-CPU connection tables, as katran's loader sets up for every CPU. CPUs
+ * past MAX_SUPPORTED_CPUS share fallback_cache, as in the kernel. */
+static struct bpf_map_def cpu_lru[MAX_SUPPORTED_CPUS];
+
+static void runner_update(struct bpf_map_def *map, const void *key,
+                          const void *value) {
+  if (bpf_map_update_elem(map, key, value, BPF_ANY) != 0) {
+    fprintf(stderr, "katran runner: cannot populate maps\n");
+    exit(1);
+  }
+}
+
+void xdp_runner_nf_init(void) {
+  BPF_MAP_INIT(&vip_map, "vip_map", "pkt.vip", "vip_metadata");
+  BPF_MAP_OF_MAPS_INIT(&lru_mapping, &fallback_cache, "flowtable", "pkt.flow",
+                       "backend");
+  BPF_MAP_INIT(&fallback_cache, "flowtable", "pkt.flow", "backend");
+  BPF_MAP_INIT(&ch_rings, "vip_to_real_map", "", "backend_real_id");
+  BPF_MAP_INIT(&reals, "backend_metadata_map", "", "backend_metadata");
+  BPF_MAP_INIT(&reals_stats, "backend_stats_map", "", "backend_stats");
+  BPF_MAP_INIT(&stats, "vip_stats_map", "", "vip_stats");
+  BPF_MAP_INIT(&quic_mapping, "conn_id_to_real_map", "", "backend_real_id");
+  BPF_MAP_INIT(&ctl_array, "backend_mac_addrs_map", "", "backend_mac_addrs");
+#ifdef LPM_SRC_LOOKUP
+  BPF_MAP_INIT(&lpm_src_v4, "lpm_src_v4", "", "");
+  BPF_MAP_INIT(&lpm_src_v6, "lpm_src_v6", "", "");
+#endif
+
+  for (__u32 cpu = 0;
+       cpu < MAX_SUPPORTED_CPUS && cpu < bpf_native_get_cpus(); ++cpu) {
+    cpu_lru[cpu] = fallback_cache;
+    BPF_MAP_INIT(&cpu_lru[cpu], "flowtable", "pkt.flow", "backend");
+    bpf_native_map_set_inner(bpf_native_maps[lru_mapping.map_id], &cpu,
+                             &cpu_lru[cpu]);
+  }
+
+  struct vip_definition vip = {};
+  vip.vip = inet_addr(RUNNER_VIP);
+  vip.port = htons(RUNNER_VIP_PORT);
+  /* The program pins vip_num to CONCRETE_VIP_NUM after the lookup */
+  struct vip_meta meta = {.flags = 0, .vip_num = CONCRETE_VIP_NUM};
+  vip.proto = IPPROTO_TCP;
+  runner_update(&vip_map, &vip, &meta);
+  vip.proto = IPPROTO_UDP;
+  runner_update(&vip_map, &vip, &meta);
+
+  /* Reals 1..RUNNER_REALS at 10.1.0.x; real 0 means "unset" to katran */
+  for (__u32 real = 1; real <= RUNNER_REALS; ++real) {
+    struct real_definition def = {};
+    def.dst = htonl(0x0A010000 | real);
+    runner_update(&reals, &real, &def);
+  }
+  for (__u32 pos = 0; pos < RING_SIZE; ++pos) {
+    __u32 key = RING_SIZE * CONCRETE_VIP_NUM + pos;
+    __u32 real = 1 + pos % RUNNER_REALS;
+    runner_update(&ch_rings, &key, &real);
+  }
+
+  __u32 mac_addr_pos = 0;
+  struct ctl_value router_mac = {.mac = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}};
+  runner_update(&ctl_array, &mac_addr_pos, &router_mac);
+}
+
+int xdp_runner_nf_prog(struct xdp_md *ctx) { return balancer_ingress(ctx); }
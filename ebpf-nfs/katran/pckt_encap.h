@@ -63,7 +63,8 @@ __attribute__((__always_inline__)) static inline bool encap_v6(
   new_eth = data;
   ip6h = data + sizeof(struct eth_hdr);
   old_eth = data + sizeof(struct ipv6hdr);
-  if (new_eth + 1 > data_end || old_eth + 1 > data_end || ip6h + 1 > data_end) {
+  if ((void *)(new_eth + 1) > data_end || (void *)(old_eth + 1) > data_end ||
+      (void *)(ip6h + 1) > data_end) {
     return false;
   }
   memcpy(new_eth->eth_dest, cval->mac, 6);
@@ -113,7 +114,8 @@ __attribute__((__always_inline__)) static inline bool encap_v4(
   new_eth = data;
   iph = data + sizeof(struct eth_hdr);
   old_eth = data + sizeof(struct iphdr);
-  if (new_eth + 1 > data_end || old_eth + 1 > data_end || iph + 1 > data_end) {
+  if ((void *)(new_eth + 1) > data_end || (void *)(old_eth + 1) > data_end ||
+      (void *)(iph + 1) > data_end) {
     return false;
   }
   memcpy(new_eth->eth_dest, cval->mac, 6);
@@ -87,7 +87,7 @@ static inline bool parse_udp(void *data, void *data_end,
   struct udphdr *udp;
   udp = data + off;
 
-  if (udp + 1 > data_end) {
+  if ((void *)(udp + 1) > data_end) {
     return false;
   }
 
@@ -113,7 +113,7 @@ static inline bool parse_tcp(void *data, void *data_end,
   struct tcphdr *tcp;
   tcp = data + off;
 
-  if (tcp + 1 > data_end) {
+  if ((void *)(tcp + 1) > data_end) {
     return false;
   }
 
@@ -154,7 +154,7 @@ static inline int parse_quic(void *data, void *data_end,
   // concerned about the first 16 bits in Dest Conn Id
   if ((*pkt_type & QUIC_LONG_HEADER) == QUIC_LONG_HEADER) {
     // packet with long header
-    if (quic_data + sizeof(struct quic_long_header) > data_end) {
+    if ((void *)(quic_data + sizeof(struct quic_long_header)) > data_end) {
       return FURTHER_PROCESSING;
     }
     if ((*pkt_type & QUIC_PACKET_TYPE_MASK) < QUIC_HANDSHAKE) {
@@ -171,7 +171,7 @@ static inline int parse_quic(void *data, void *data_end,
     connId = long_header->dst_connection_id;
   } else {
     // short header: just read the connId
-    if (quic_data + sizeof(struct quic_short_header) > data_end) {
+    if ((void *)(quic_data + sizeof(struct quic_short_header)) > data_end) {
       return FURTHER_PROCESSING;
     }
     connId = ((struct quic_short_header*)quic_data)->connection_id;
@@ -44,7 +44,9 @@ struct bpf_map_def {
   unsigned int map_id;
 };
 
-#if (defined USES_BPF_MAPS) && (defined KLEE_VERIFICATION)
+#if defined XDP_RUNNER
+#include "bpf/bpf_map_helper_defs_native.h"
+#elif (defined USES_BPF_MAPS) && (defined KLEE_VERIFICATION)
 #ifndef REPLAY
 #include "bpf/bpf_map_helper_defs.h"
 #else 
@@ -135,7 +137,9 @@ void bpf_map_reset_stub(struct bpf_map_def* map) {
  * 	found.
  */
 
-#ifdef USES_BPF_MAP_LOOKUP_ELEM
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_MAP_LOOKUP_ELEM
 static __attribute__ ((noinline)) void *bpf_map_lookup_elem(void *map, const void *key) {
   if(record_calls){
     klee_trace_ret_just_ptr(sizeof(void*));
@@ -179,7 +183,9 @@ static void *(*bpf_map_lookup_elem)(void *map, const void *key) = (void *)1;
  * 	0 on success, or a negative error in case of failure.
  */
 
-#ifdef USES_BPF_MAP_UPDATE_ELEM
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_MAP_UPDATE_ELEM
 static __attribute__ ((noinline)) long bpf_map_update_elem(void *map, const void *key, const void *value,
                                 __u64 flags) {
   if(record_calls){
@@ -209,7 +215,9 @@ static long (*bpf_map_update_elem)(void *map, const void *key,
  * Returns
  * 	0 on success, or a negative error in case of failure.
  */
+#ifndef XDP_RUNNER
 static long (*bpf_map_delete_elem)(void *map, const void *key) = (void *)3;
+#endif
 
 /*
  * bpf_probe_read
@@ -237,7 +245,9 @@ static long (*bpf_probe_read)(void *dst, __u32 size,
  * 	Current *ktime*.
  */
 
-#ifdef USES_BPF_KTIME_GET_NS
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_KTIME_GET_NS
 static __attribute__ ((noinline)) __u64 bpf_ktime_get_ns(void) {
   if(record_calls){
     klee_trace_ret();
@@ -330,7 +340,9 @@ static long (*bpf_trace_printk)(const char *fmt, __u32 fmt_size,
  * Returns
  * 	A random 32-bit unsigned value.
  */
+#ifndef XDP_RUNNER
 static __u32 (*bpf_get_prandom_u32)(void) = (void *)7;
+#endif
 
 /*
  * bpf_get_smp_processor_id
@@ -344,7 +356,9 @@ static __u32 (*bpf_get_prandom_u32)(void) = (void *)7;
  * 	The SMP id of the processor running the program.
  */
 
-#ifdef USES_BPF_GET_SMP_PROC_ID
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_GET_SMP_PROC_ID
 static __attribute__ ((noinline)) __u32 bpf_get_smp_processor_id(void){
   if(record_calls){
     klee_trace_ret();
@@ -775,7 +789,9 @@ static __u64 (*bpf_perf_event_read)(void *map, __u64 flags) = (void *)22;
  * 	are **TC_ACT_REDIRECT** on success or **TC_ACT_SHOT** on
  * 	error.
  */
+#ifndef XDP_RUNNER
 static long (*bpf_redirect)(__u32 ifindex, __u64 flags) = (void *)23;
+#endif
 
 /*
  * bpf_get_route_realm
@@ -953,7 +969,9 @@ static long (*bpf_get_stackid)(void *ctx, void *map, __u64 flags) = (void *)27;
  * 	failure.
  */
 
-#ifdef USES_BPF_CSUM_DIFF
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_CSUM_DIFF
 
 static __attribute__ ((noinline)) __s64 bpf_csum_diff(__be32 *from, __u32 from_size, __be32 *to,
                            __u32 to_size, __wsum seed) {
@@ -1315,7 +1333,9 @@ static long (*bpf_skb_change_head)(struct __sk_buff *skb, __u32 len,
  * 	0 on success, or a negative error in case of failure.
  */
 
-#ifdef USES_BPF_XDP_ADJUST_HEAD
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_XDP_ADJUST_HEAD
 static __attribute__ ((noinline)) int bpf_xdp_adjust_head(struct xdp_md *xdp_md, int delta) {
   /* Simple stub for now that only moves data pointer without a check. We assume
    * programs don't use the metadata for now */
@@ -1501,7 +1521,9 @@ static long (*bpf_skb_adjust_room)(struct __sk_buff *skb, __s32 len_diff,
  * 	of the *flags* argument on error.
  */
 
-#ifdef USES_BPF_REDIRECT_MAP
+#if defined XDP_RUNNER
+/* Defined in bpf_map_helper_defs_native.h */
+#elif defined USES_BPF_REDIRECT_MAP
 static __attribute__ ((noinline)) long bpf_redirect_map (void *map, __u32 key, __u64 flags){
   if(record_calls){
     klee_trace_ret();
@@ -1944,8 +1966,10 @@ static long (*bpf_bind)(struct bpf_sock_addr *ctx, struct sockaddr *addr,
  * Returns
  * 	0 on success, or a negative error in case of failure.
  */
+#ifndef XDP_RUNNER
 static long (*bpf_xdp_adjust_tail)(struct xdp_md *xdp_md,
                                    int delta) = (void *)65;
+#endif
 
 /*
  * bpf_skb_get_xfrm_state
@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: (LGPL-2.1 OR BSD-2-Clause) */
+#ifndef __BPF_MAP_HELPERS_NATIVE__
+#define __BPF_MAP_HELPERS_NATIVE__
+
+/*
+ * Helpers for running XDP programs natively with the userspace runner
+ * (ebpf-nfs/xdp-runner), selected with -DXDP_RUNNER. Maps are backed by
+ * bpf_native_maps.c; everything else mirrors the kernel helper's behaviour.
+ *
+ * Must be included after struct bpf_map_def and struct xdp_md are defined.
+ */
+
+#include "bpf/bpf_native_maps.h"
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+/* The frame currently being processed by this thread, set by the runner */
+extern __thread void *bpf_native_xdp_hard_start;
+extern __thread void *bpf_native_xdp_frame_end;
+
+#define BPF_MAP_INIT(x, y, z, w)                                               \
+  ((x)->map_id = bpf_native_map_create((y), (x)->type, (x)->key_size,          \
+                                       (x)->value_size, (x)->max_entries,      \
+                                       (x)->map_flags))
+/* Inner maps are created and inserted by the runner driver, see
+ * bpf_native_map_set_inner() */
+#define BPF_MAP_OF_MAPS_INIT(x, y, z, w, v) BPF_MAP_INIT(x, z, w, v)
+/* Native maps start zeroed, like the kernel's */
+#define BPF_MAP_RESET(x)
+
+static inline struct bpf_native_map *bpf_native_map_of(void *map) {
+  return bpf_native_maps[((struct bpf_map_def *)map)->map_id];
+}
+
+static void *bpf_map_lookup_elem(void *map, const void *key) {
+  return bpf_native_map_lookup(bpf_native_map_of(map), key);
+}
+
+static long bpf_map_update_elem(void *map, const void *key, const void *value,
+                                __u64 flags) {
+  return bpf_native_map_update(bpf_native_map_of(map), key, value, flags);
+}
+
+static long bpf_map_delete_elem(void *map, const void *key) {
+  return bpf_native_map_delete(bpf_native_map_of(map), key);
+}
+
+static __u64 bpf_ktime_get_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (__u64)ts.tv_sec * 1000000000ull + (__u64)ts.tv_nsec;
+}
+
+static __u32 bpf_get_smp_processor_id(void) { return bpf_native_cpu; }
+
+static __u32 bpf_get_prandom_u32(void) {
+  static __thread __u32 state;
+  if (state == 0) {
+    state = 0x9E3779B9u * (bpf_native_cpu + 1);
+  }
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/* 32-bit one's complement sum of seed + to - from, like csum_partial() over
+ * the kernel's diff buffer; callers fold it down to 16 bits */
+static __s64 bpf_csum_diff(void *from, __u32 from_size, void *to,
+                           __u32 to_size, __wsum seed) {
+  if ((from_size | to_size) & 3) {
+    return -EINVAL;
+  }
+  __u64 sum = seed;
+  for (__u32 i = 0; i < from_size / 4; ++i) {
+    __u32 word;
+    memcpy(&word, (char *)from + i * 4, 4);
+    sum += (__u32)~word;
+  }
+  for (__u32 i = 0; i < to_size / 4; ++i) {
+    __u32 word;
+    memcpy(&word, (char *)to + i * 4, 4);
+    sum += word;
+  }
+  sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+  sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+  return (__s64)(__u32)sum;
+}
+
+/* Frames must keep at least an Ethernet header, as in the kernel */
+#define BPF_NATIVE_XDP_MIN_FRAME 14
+
+static int bpf_xdp_adjust_head(struct xdp_md *xdp_md, int delta) {
+  char *data = (char *)(long)xdp_md->data + delta;
+  char *data_end = (char *)(long)xdp_md->data_end;
+  if (data < (char *)bpf_native_xdp_hard_start ||
+      data > data_end - BPF_NATIVE_XDP_MIN_FRAME) {
+    return -EINVAL;
+  }
+  xdp_md->data = (__u32)(long)data;
+  /* Metadata does not survive head adjustments */
+  xdp_md->data_meta = xdp_md->data;
+  return 0;
+}
+
+static long bpf_xdp_adjust_tail(struct xdp_md *xdp_md, int delta) {
+  char *data = (char *)(long)xdp_md->data;
+  char *data_end = (char *)(long)xdp_md->data_end + delta;
+  if (data_end > (char *)bpf_native_xdp_frame_end ||
+      data_end < data + BPF_NATIVE_XDP_MIN_FRAME) {
+    return -EINVAL;
+  }
+  xdp_md->data_end = (__u32)(long)data_end;
+  return 0;
+}
+
+static long bpf_redirect(__u32 ifindex, __u64 flags) {
+  return flags ? XDP_ABORTED : XDP_REDIRECT;
+}
+
+static long bpf_redirect_map(void *map, __u32 key, __u64 flags) {
+  return bpf_native_redirect_map(bpf_native_map_of(map), key, flags);
+}
+
+#endif /* __BPF_MAP_HELPERS_NATIVE__ */
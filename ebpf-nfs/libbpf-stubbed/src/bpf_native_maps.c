@@ -0,0 +1,1118 @@
+// SPDX-License-Identifier: (LGPL-2.1 OR BSD-2-Clause)
+/*
+ * Concrete BPF maps for the userspace XDP runner, see bpf_native_maps.h.
+ *
+ * Each map type provides a struct native_map_ops, as the kernel's
+ * bpf_map_ops; the data structures follow the kernel's as well:
+ *
+ * - Hash maps preallocate max_entries elements and chain them in
+ *   power-of-two buckets. Lookups are lock-free; updates and deletes take a
+ *   per-bucket spin lock. As in the kernel's preallocated hash maps, a
+ *   deleted (or evicted) element can be reused right away, so a concurrent
+ *   lookup may observe it being rewritten.
+ * - LRU hash maps keep their elements on the lists of kernel/bpf/bpf_lru_list.c
+ *   (common LRU): global active/inactive/free lists behind one lock, plus a
+ *   per-CPU local free list and pending list so most allocations never touch
+ *   the global lock. Lookups only set a reference bit.
+ * - LPM tries are the kernel's path-compressed binary trie
+ *   (kernel/bpf/lpm_trie.c). Lookups are lock-free; updates serialise on a
+ *   mutex. There is no RCU, so replaced nodes are retired until the map is
+ *   gone, never freed.
+ * - Arrays, including per-CPU ones, are cpu-major so each CPU's values are
+ *   contiguous and cache-line aligned.
+ */
+
+#include "bpf_native_maps.h"
+
+#include <errno.h>
+#include <linux/bpf.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NATIVE_NIL UINT32_MAX
+#define NATIVE_ROUND_UP(x, a) (((x) + (a)-1) / (a) * (a))
+
+/* Elements moved to a CPU's local free list at once, LOCAL_FREE_TARGET in
+ * the kernel. Small maps move fewer so a few CPUs cannot strand them all. */
+#define NATIVE_LRU_LOCAL_FREE_TARGET 128
+/* Elements rotated or shrunk per pass, lru->nr_scans in the kernel */
+#define NATIVE_LRU_NR_SCANS 128
+
+struct bpf_native_map;
+
+struct native_map_ops {
+  void *(*lookup)(struct bpf_native_map *map, const void *key,
+                  unsigned int cpu);
+  long (*update)(struct bpf_native_map *map, const void *key,
+                 const void *value, __u64 flags);
+  long (*delete)(struct bpf_native_map *map, const void *key);
+};
+
+/* Which list an LRU element is on */
+enum native_lru_type {
+  NATIVE_LRU_FREE,
+  NATIVE_LRU_ACTIVE,
+  NATIVE_LRU_INACTIVE,
+  NATIVE_LRU_NR_LISTS,
+  NATIVE_LRU_LOCAL_FREE = NATIVE_LRU_NR_LISTS,
+  NATIVE_LRU_LOCAL_PENDING,
+};
+
+struct native_htab_elem {
+  /* Bucket chain, or the free list of non-LRU maps */
+  uint32_t next;
+  uint32_t hash;
+  /* LRU maps only */
+  uint32_t lru_prev;
+  uint32_t lru_next;
+  uint8_t ref;
+  uint8_t lru_type;
+  uint16_t lru_cpu;
+  /* Key padded to 8 bytes, then one value per CPU for per-CPU maps */
+  char key_value[] __attribute__((aligned(8)));
+};
+
+struct native_list {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t count;
+};
+
+struct native_lru_local {
+  pthread_spinlock_t lock;
+  struct native_list free;
+  struct native_list pending;
+} __attribute__((aligned(64)));
+
+struct native_lru {
+  pthread_spinlock_t lock;
+  struct native_list lists[NATIVE_LRU_NR_LISTS];
+  uint32_t local_target;
+  unsigned int nlocal;
+  struct native_lru_local *local;
+};
+
+struct native_htab {
+  uint32_t *buckets;
+  pthread_spinlock_t *locks;
+  uint32_t n_buckets;
+  char *elems;
+  size_t elem_size;
+  /* Non-LRU maps */
+  uint32_t free_head;
+  pthread_spinlock_t free_lock;
+  /* LRU maps */
+  struct native_lru lru;
+};
+
+#define NATIVE_LPM_INTERMEDIATE 1u
+
+struct native_lpm_key {
+  __u32 prefixlen;
+  __u8 data[];
+};
+
+struct native_lpm_node {
+  struct native_lpm_node *child[2];
+  __u32 prefixlen;
+  __u32 flags;
+  /* data_size bytes of prefix, then the value at an 8-byte boundary */
+  __u8 data[] __attribute__((aligned(8)));
+};
+
+struct native_lpm {
+  struct native_lpm_node *root;
+  size_t n_entries;
+  size_t data_size;
+  size_t value_offset;
+  unsigned int max_prefixlen;
+  pthread_mutex_t lock;
+  /* Nodes unlinked from the trie, which lookups may still be reading */
+  struct native_lpm_node **retired;
+  size_t n_retired;
+  size_t retired_cap;
+};
+
+struct bpf_native_map {
+  const struct native_map_ops *ops;
+  char name[32];
+  unsigned int type;
+  unsigned int key_size;
+  unsigned int value_size;
+  unsigned int max_entries;
+  unsigned int map_flags;
+
+  /* Layout of one key/value slot */
+  size_t key_area;
+  size_t value_stride;
+  unsigned int ncpus;
+
+  /* Array maps: cpu-major, so each CPU's values are contiguous */
+  char *data;
+  size_t cpu_stride;
+
+  struct native_htab htab;
+  struct native_lpm lpm;
+};
+
+struct bpf_native_map *bpf_native_maps[BPF_NATIVE_MAX_MAPS];
+static unsigned int bpf_native_map_ctr = 0;
+static unsigned int bpf_native_ncpus = 1;
+
+__thread unsigned int bpf_native_cpu = 0;
+
+void bpf_native_set_cpus(unsigned int ncpus) {
+  if (ncpus == 0 || ncpus > BPF_NATIVE_MAX_CPUS) {
+    fprintf(stderr, "bpf_native: unsupported number of CPUs %u\n", ncpus);
+    exit(1);
+  }
+  bpf_native_ncpus = ncpus;
+}
+
+unsigned int bpf_native_get_cpus(void) { return bpf_native_ncpus; }
+
+static void *native_alloc(size_t size) {
+  void *ptr;
+  if (posix_memalign(&ptr, 64, size ? size : 1)) {
+    fprintf(stderr, "bpf_native: out of memory\n");
+    exit(1);
+  }
+  memset(ptr, 0, size);
+  return ptr;
+}
+
+static uint32_t native_hash(const void *key, uint32_t len) {
+  const uint8_t *p = key;
+  uint64_t h = 0x9E3779B97F4A7C15ull ^ len;
+  while (len >= 8) {
+    uint64_t w;
+    memcpy(&w, p, 8);
+    h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+    h ^= h >> 32;
+    p += 8;
+    len -= 8;
+  }
+  if (len) {
+    uint64_t w = 0;
+    memcpy(&w, p, len);
+    h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+    h ^= h >> 32;
+  }
+  h *= 0xC4CEB9FE1A85EC53ull;
+  h ^= h >> 29;
+  return (uint32_t)h;
+}
+
+/* Per-CPU maps hold one value per runner thread, other maps just one */
+static inline unsigned int native_cpu(struct bpf_native_map *map) {
+  return bpf_native_cpu < map->ncpus ? bpf_native_cpu : 0;
+}
+
+/* Hash table */
+
+static inline struct native_htab_elem *htab_elem(struct bpf_native_map *map,
+                                                 uint32_t idx) {
+  return (void *)(map->htab.elems + (size_t)idx * map->htab.elem_size);
+}
+
+static inline void *htab_elem_value(struct bpf_native_map *map,
+                                    struct native_htab_elem *elem,
+                                    unsigned int cpu) {
+  return elem->key_value + map->key_area + cpu * map->value_stride;
+}
+
+static inline int htab_is_lru(struct bpf_native_map *map) {
+  return map->type == BPF_MAP_TYPE_LRU_HASH ||
+         map->type == BPF_MAP_TYPE_LRU_PERCPU_HASH;
+}
+
+static uint32_t htab_find(struct bpf_native_map *map, uint32_t hash,
+                          const void *key) {
+  struct native_htab *htab = &map->htab;
+  uint32_t idx = __atomic_load_n(&htab->buckets[hash & (htab->n_buckets - 1)],
+                                 __ATOMIC_ACQUIRE);
+  while (idx != NATIVE_NIL) {
+    struct native_htab_elem *elem = htab_elem(map, idx);
+    if (elem->hash == hash && !memcmp(elem->key_value, key, map->key_size)) {
+      return idx;
+    }
+    idx = __atomic_load_n(&elem->next, __ATOMIC_ACQUIRE);
+  }
+  return NATIVE_NIL;
+}
+
+/* Unlinks idx from its bucket; returns 0 if it was not linked anymore. Used
+ * by LRU eviction, which holds the LRU lock so idx cannot be reused. */
+static int htab_unlink(struct bpf_native_map *map, uint32_t idx) {
+  struct native_htab *htab = &map->htab;
+  struct native_htab_elem *elem = htab_elem(map, idx);
+  uint32_t bucket = elem->hash & (htab->n_buckets - 1);
+  int found = 0;
+  pthread_spin_lock(&htab->locks[bucket]);
+  uint32_t *link = &htab->buckets[bucket];
+  while (*link != NATIVE_NIL) {
+    if (*link == idx) {
+      __atomic_store_n(link, elem->next, __ATOMIC_RELEASE);
+      found = 1;
+      break;
+    }
+    link = &htab_elem(map, *link)->next;
+  }
+  pthread_spin_unlock(&htab->locks[bucket]);
+  return found;
+}
+
+/* LRU lists, indices into the element pool */
+
+static inline void list_init(struct native_list *list) {
+  list->head = list->tail = NATIVE_NIL;
+  list->count = 0;
+}
+
+static void list_add_head(struct bpf_native_map *map, struct native_list *list,
+                          uint32_t idx) {
+  struct native_htab_elem *elem = htab_elem(map, idx);
+  elem->lru_prev = NATIVE_NIL;
+  elem->lru_next = list->head;
+  if (list->head != NATIVE_NIL) {
+    htab_elem(map, list->head)->lru_prev = idx;
+  } else {
+    list->tail = idx;
+  }
+  list->head = idx;
+  list->count++;
+}
+
+static void list_del(struct bpf_native_map *map, struct native_list *list,
+                     uint32_t idx) {
+  struct native_htab_elem *elem = htab_elem(map, idx);
+  if (elem->lru_prev != NATIVE_NIL) {
+    htab_elem(map, elem->lru_prev)->lru_next = elem->lru_next;
+  } else {
+    list->head = elem->lru_next;
+  }
+  if (elem->lru_next != NATIVE_NIL) {
+    htab_elem(map, elem->lru_next)->lru_prev = elem->lru_prev;
+  } else {
+    list->tail = elem->lru_prev;
+  }
+  list->count--;
+}
+
+static inline void lru_set_type(struct native_htab_elem *elem, uint8_t type) {
+  __atomic_store_n(&elem->lru_type, type, __ATOMIC_RELAXED);
+}
+
+/* The reference bit is set by lock-free lookups, like the kernel's
+ * bpf_lru_node_set_ref() */
+static inline int lru_ref(struct native_htab_elem *elem) {
+  return __atomic_load_n(&elem->ref, __ATOMIC_RELAXED);
+}
+
+static inline void lru_set_ref(struct native_htab_elem *elem, uint8_t ref) {
+  __atomic_store_n(&elem->ref, ref, __ATOMIC_RELAXED);
+}
+
+/* Moves idx between global lists, clearing its reference bit; called with
+ * the LRU lock held */
+static void lru_move(struct bpf_native_map *map, uint32_t idx, uint8_t type) {
+  struct native_lru *lru = &map->htab.lru;
+  struct native_htab_elem *elem = htab_elem(map, idx);
+  list_del(map, &lru->lists[elem->lru_type], idx);
+  lru_set_ref(elem, 0);
+  list_add_head(map, &lru->lists[type], idx);
+  lru_set_type(elem, type);
+}
+
+/* Moves idx from a global list to a local one */
+static void lru_move_to_local(struct bpf_native_map *map, uint32_t idx,
+                              struct native_list *dst, uint8_t type,
+                              unsigned int cpu) {
+  struct native_lru *lru = &map->htab.lru;
+  struct native_htab_elem *elem = htab_elem(map, idx);
+  list_del(map, &lru->lists[elem->lru_type], idx);
+  lru_set_ref(elem, 0);
+  elem->lru_cpu = cpu;
+  list_add_head(map, dst, idx);
+  lru_set_type(elem, type);
+}
+
+/* Second chance for the tail of the active list: referenced elements go
+ * back to its head, the others to the inactive list */
+static void lru_rotate_active(struct bpf_native_map *map) {
+  struct native_lru *lru = &map->htab.lru;
+  uint32_t idx = lru->lists[NATIVE_LRU_ACTIVE].tail;
+  for (unsigned int i = 0; idx != NATIVE_NIL && i < NATIVE_LRU_NR_SCANS;
+       ++i) {
+    uint32_t prev = htab_elem(map, idx)->lru_prev;
+    lru_move(map, idx,
+             lru_ref(htab_elem(map, idx)) ? NATIVE_LRU_ACTIVE
+                                      : NATIVE_LRU_INACTIVE);
+    idx = prev;
+  }
+}
+
+/* Evicts up to want unreferenced elements from the inactive tail into dst;
+ * if none could be, force-evicts one from the inactive or else the active
+ * tail. Called with the LRU lock held. */
+static void lru_shrink(struct bpf_native_map *map, struct native_list *dst,
+                       unsigned int cpu, uint32_t want) {
+  struct native_lru *lru = &map->htab.lru;
+  uint32_t got = 0;
+  uint32_t idx = lru->lists[NATIVE_LRU_INACTIVE].tail;
+  for (unsigned int i = 0;
+       idx != NATIVE_NIL && got < want && i < NATIVE_LRU_NR_SCANS; ++i) {
+    uint32_t prev = htab_elem(map, idx)->lru_prev;
+    if (lru_ref(htab_elem(map, idx))) {
+      lru_move(map, idx, NATIVE_LRU_ACTIVE);
+    } else if (htab_unlink(map, idx)) {
+      lru_move_to_local(map, idx, dst, NATIVE_LRU_LOCAL_FREE, cpu);
+      got++;
+    }
+    idx = prev;
+  }
+  if (got) {
+    return;
+  }
+
+  struct native_list *victims = &lru->lists[NATIVE_LRU_INACTIVE];
+  if (victims->count == 0) {
+    victims = &lru->lists[NATIVE_LRU_ACTIVE];
+  }
+  for (idx = victims->tail; idx != NATIVE_NIL;
+       idx = htab_elem(map, idx)->lru_prev) {
+    if (htab_unlink(map, idx)) {
+      lru_move_to_local(map, idx, dst, NATIVE_LRU_LOCAL_FREE, cpu);
+      return;
+    }
+  }
+}
+
+/* Refills a CPU's local free list from the global lists, first handing its
+ * pending elements over to them. Called with the local lock held. */
+static void lru_refill_local(struct bpf_native_map *map,
+                             struct native_lru_local *loc, unsigned int cpu) {
+  struct native_lru *lru = &map->htab.lru;
+  pthread_spin_lock(&lru->lock);
+
+  uint32_t idx;
+  while ((idx = loc->pending.tail) != NATIVE_NIL) {
+    struct native_htab_elem *elem = htab_elem(map, idx);
+    uint8_t type = lru_ref(elem) ? NATIVE_LRU_ACTIVE : NATIVE_LRU_INACTIVE;
+    list_del(map, &loc->pending, idx);
+    lru_set_ref(elem, 0);
+    list_add_head(map, &lru->lists[type], idx);
+    lru_set_type(elem, type);
+  }
+
+  if (lru->lists[NATIVE_LRU_INACTIVE].count <
+      lru->lists[NATIVE_LRU_ACTIVE].count) {
+    lru_rotate_active(map);
+  }
+
+  uint32_t got = 0;
+  while (got < lru->local_target &&
+         (idx = lru->lists[NATIVE_LRU_FREE].head) != NATIVE_NIL) {
+    lru_move_to_local(map, idx, &loc->free, NATIVE_LRU_LOCAL_FREE, cpu);
+    got++;
+  }
+  if (got < lru->local_target) {
+    lru_shrink(map, &loc->free, cpu, lru->local_target - got);
+  }
+
+  pthread_spin_unlock(&lru->lock);
+}
+
+static uint32_t lru_pop_free(struct bpf_native_map *map) {
+  struct native_lru *lru = &map->htab.lru;
+  unsigned int cpu = bpf_native_cpu < lru->nlocal ? bpf_native_cpu : 0;
+  struct native_lru_local *loc = &lru->local[cpu];
+
+  pthread_spin_lock(&loc->lock);
+  uint32_t idx = loc->free.head;
+  if (idx == NATIVE_NIL) {
+    lru_refill_local(map, loc, cpu);
+    idx = loc->free.head;
+  }
+  if (idx != NATIVE_NIL) {
+    struct native_htab_elem *elem = htab_elem(map, idx);
+    list_del(map, &loc->free, idx);
+    lru_set_ref(elem, 0);
+    list_add_head(map, &loc->pending, idx);
+    lru_set_type(elem, NATIVE_LRU_LOCAL_PENDING);
+  }
+  pthread_spin_unlock(&loc->lock);
+  return idx;
+}
+
+static void lru_push_free(struct bpf_native_map *map, uint32_t idx) {
+  struct native_lru *lru = &map->htab.lru;
+  struct native_htab_elem *elem = htab_elem(map, idx);
+
+  /* Still pending on the CPU that allocated it: give it back to that CPU,
+   * unless it was flushed to the global lists meanwhile */
+  if (__atomic_load_n(&elem->lru_type, __ATOMIC_RELAXED) ==
+      NATIVE_LRU_LOCAL_PENDING) {
+    struct native_lru_local *loc = &lru->local[elem->lru_cpu];
+    pthread_spin_lock(&loc->lock);
+    if (__atomic_load_n(&elem->lru_type, __ATOMIC_RELAXED) ==
+        NATIVE_LRU_LOCAL_PENDING) {
+      list_del(map, &loc->pending, idx);
+      lru_set_ref(elem, 0);
+      list_add_head(map, &loc->free, idx);
+      lru_set_type(elem, NATIVE_LRU_LOCAL_FREE);
+      pthread_spin_unlock(&loc->lock);
+      return;
+    }
+    pthread_spin_unlock(&loc->lock);
+  }
+
+  pthread_spin_lock(&lru->lock);
+  lru_move(map, idx, NATIVE_LRU_FREE);
+  pthread_spin_unlock(&lru->lock);
+}
+
+static void lru_init(struct bpf_native_map *map) {
+  struct native_lru *lru = &map->htab.lru;
+  pthread_spin_init(&lru->lock, PTHREAD_PROCESS_PRIVATE);
+  for (unsigned int l = 0; l < NATIVE_LRU_NR_LISTS; ++l) {
+    list_init(&lru->lists[l]);
+  }
+  for (uint32_t i = map->max_entries; i-- > 0;) {
+    list_add_head(map, &lru->lists[NATIVE_LRU_FREE], i);
+    htab_elem(map, i)->lru_type = NATIVE_LRU_FREE;
+  }
+
+  lru->nlocal = bpf_native_ncpus;
+  lru->local = native_alloc(lru->nlocal * sizeof(*lru->local));
+  for (unsigned int cpu = 0; cpu < lru->nlocal; ++cpu) {
+    pthread_spin_init(&lru->local[cpu].lock, PTHREAD_PROCESS_PRIVATE);
+    list_init(&lru->local[cpu].free);
+    list_init(&lru->local[cpu].pending);
+  }
+  lru->local_target = map->max_entries / (2 * lru->nlocal);
+  if (lru->local_target > NATIVE_LRU_LOCAL_FREE_TARGET) {
+    lru->local_target = NATIVE_LRU_LOCAL_FREE_TARGET;
+  } else if (lru->local_target == 0) {
+    lru->local_target = 1;
+  }
+}
+
+static uint32_t htab_alloc_elem(struct bpf_native_map *map) {
+  struct native_htab *htab = &map->htab;
+  if (htab_is_lru(map)) {
+    return lru_pop_free(map);
+  }
+  pthread_spin_lock(&htab->free_lock);
+  uint32_t idx = htab->free_head;
+  if (idx != NATIVE_NIL) {
+    htab->free_head = htab_elem(map, idx)->next;
+  }
+  pthread_spin_unlock(&htab->free_lock);
+  return idx;
+}
+
+static void htab_free_elem(struct bpf_native_map *map, uint32_t idx) {
+  struct native_htab *htab = &map->htab;
+  if (htab_is_lru(map)) {
+    lru_push_free(map, idx);
+    return;
+  }
+  pthread_spin_lock(&htab->free_lock);
+  htab_elem(map, idx)->next = htab->free_head;
+  htab->free_head = idx;
+  pthread_spin_unlock(&htab->free_lock);
+}
+
+static void htab_init(struct bpf_native_map *map) {
+  struct native_htab *htab = &map->htab;
+  htab->n_buckets = 1;
+  while (htab->n_buckets < map->max_entries) {
+    htab->n_buckets <<= 1;
+  }
+  htab->buckets = native_alloc(htab->n_buckets * sizeof(uint32_t));
+  htab->locks = native_alloc(htab->n_buckets * sizeof(pthread_spinlock_t));
+  for (uint32_t b = 0; b < htab->n_buckets; ++b) {
+    htab->buckets[b] = NATIVE_NIL;
+    pthread_spin_init(&htab->locks[b], PTHREAD_PROCESS_PRIVATE);
+  }
+
+  htab->elem_size = NATIVE_ROUND_UP(sizeof(struct native_htab_elem) +
+                                        map->key_area +
+                                        map->value_stride * map->ncpus,
+                                    8);
+  htab->elems = native_alloc(htab->elem_size * map->max_entries);
+  if (htab_is_lru(map)) {
+    lru_init(map);
+    return;
+  }
+  for (uint32_t i = 0; i < map->max_entries; ++i) {
+    htab_elem(map, i)->next = i + 1 < map->max_entries ? i + 1 : NATIVE_NIL;
+  }
+  htab->free_head = map->max_entries ? 0 : NATIVE_NIL;
+  pthread_spin_init(&htab->free_lock, PTHREAD_PROCESS_PRIVATE);
+}
+
+static void *htab_lookup(struct bpf_native_map *map, const void *key,
+                         unsigned int cpu) {
+  uint32_t idx = htab_find(map, native_hash(key, map->key_size), key);
+  if (idx == NATIVE_NIL) {
+    return NULL;
+  }
+  return htab_elem_value(map, htab_elem(map, idx), cpu);
+}
+
+static void *htab_lru_lookup(struct bpf_native_map *map, const void *key,
+                             unsigned int cpu) {
+  uint32_t idx = htab_find(map, native_hash(key, map->key_size), key);
+  if (idx == NATIVE_NIL) {
+    return NULL;
+  }
+  struct native_htab_elem *elem = htab_elem(map, idx);
+  /* Only write when needed, hot elements stay clean in other CPUs' caches */
+  if (!lru_ref(elem)) {
+    lru_set_ref(elem, 1);
+  }
+  return htab_elem_value(map, elem, cpu);
+}
+
+static void *htab_of_maps_lookup(struct bpf_native_map *map, const void *key,
+                                 unsigned int cpu) {
+  void **inner = htab_lookup(map, key, cpu);
+  return inner ? *inner : NULL;
+}
+
+static long htab_update(struct bpf_native_map *map, const void *key,
+                        const void *value, __u64 flags) {
+  struct native_htab *htab = &map->htab;
+  if (flags > BPF_EXIST) {
+    return -EINVAL;
+  }
+  uint32_t hash = native_hash(key, map->key_size);
+  uint32_t bucket = hash & (htab->n_buckets - 1);
+  unsigned int cpu = native_cpu(map);
+
+  /* Allocate before taking the bucket lock: LRU eviction locks buckets. */
+  uint32_t new_idx = NATIVE_NIL;
+  if (htab_find(map, hash, key) == NATIVE_NIL) {
+    if (flags == BPF_EXIST) {
+      return -ENOENT;
+    }
+    new_idx = htab_alloc_elem(map);
+    if (new_idx == NATIVE_NIL) {
+      return -E2BIG;
+    }
+  }
+
+  pthread_spin_lock(&htab->locks[bucket]);
+  uint32_t idx = htab_find(map, hash, key);
+  long ret = 0;
+  if (idx != NATIVE_NIL) {
+    if (flags == BPF_NOEXIST) {
+      ret = -EEXIST;
+    } else {
+      struct native_htab_elem *elem = htab_elem(map, idx);
+      memcpy(htab_elem_value(map, elem, cpu), value, map->value_size);
+      if (htab_is_lru(map) && !lru_ref(elem)) {
+        lru_set_ref(elem, 1);
+      }
+    }
+  } else if (new_idx == NATIVE_NIL) {
+    /* Deleted since we looked */
+    ret = flags == BPF_EXIST ? -ENOENT : -EAGAIN;
+  } else {
+    struct native_htab_elem *elem = htab_elem(map, new_idx);
+    elem->hash = hash;
+    memcpy(elem->key_value, key, map->key_size);
+    memset(htab_elem_value(map, elem, 0), 0, map->value_stride * map->ncpus);
+    memcpy(htab_elem_value(map, elem, cpu), value, map->value_size);
+    elem->next = htab->buckets[bucket];
+    __atomic_store_n(&htab->buckets[bucket], new_idx, __ATOMIC_RELEASE);
+    new_idx = NATIVE_NIL;
+  }
+  pthread_spin_unlock(&htab->locks[bucket]);
+
+  if (new_idx != NATIVE_NIL) {
+    htab_free_elem(map, new_idx);
+  }
+  return ret;
+}
+
+/* Matches the key under the bucket lock, so an element evicted and reused
+ * for another key since a lock-free lookup is never removed by mistake */
+static long htab_delete(struct bpf_native_map *map, const void *key) {
+  struct native_htab *htab = &map->htab;
+  uint32_t hash = native_hash(key, map->key_size);
+  uint32_t bucket = hash & (htab->n_buckets - 1);
+  uint32_t idx = NATIVE_NIL;
+
+  pthread_spin_lock(&htab->locks[bucket]);
+  uint32_t *link = &htab->buckets[bucket];
+  while (*link != NATIVE_NIL) {
+    struct native_htab_elem *elem = htab_elem(map, *link);
+    if (elem->hash == hash && !memcmp(elem->key_value, key, map->key_size)) {
+      idx = *link;
+      __atomic_store_n(link, elem->next, __ATOMIC_RELEASE);
+      break;
+    }
+    link = &elem->next;
+  }
+  pthread_spin_unlock(&htab->locks[bucket]);
+
+  if (idx == NATIVE_NIL) {
+    return -ENOENT;
+  }
+  htab_free_elem(map, idx);
+  return 0;
+}
+
+static const struct native_map_ops htab_ops = {
+    .lookup = htab_lookup, .update = htab_update, .delete = htab_delete};
+static const struct native_map_ops htab_lru_ops = {
+    .lookup = htab_lru_lookup, .update = htab_update, .delete = htab_delete};
+static const struct native_map_ops htab_of_maps_ops = {
+    .lookup = htab_of_maps_lookup,
+    .update = htab_update,
+    .delete = htab_delete};
+
+/* LPM trie */
+
+static inline struct native_lpm_node *
+lpm_load(struct native_lpm_node *const *slot) {
+  return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+}
+
+static inline void lpm_publish(struct native_lpm_node **slot,
+                               struct native_lpm_node *node) {
+  __atomic_store_n(slot, node, __ATOMIC_RELEASE);
+}
+
+static inline void *lpm_value(struct native_lpm *lpm,
+                              struct native_lpm_node *node) {
+  return node->data + lpm->value_offset;
+}
+
+/* Bit index of the prefix, MSB first, as the kernel's extract_bit() */
+static inline int lpm_extract_bit(const __u8 *data, size_t index) {
+  return !!(data[index / 8] & (1 << (7 - (index % 8))));
+}
+
+/* Number of leading bits node and key have in common, at most the shorter of
+ * their prefix lengths; compares big-endian words like the kernel */
+static size_t lpm_match(struct native_lpm *lpm,
+                        const struct native_lpm_node *node,
+                        const struct native_lpm_key *key) {
+  __u32 limit = node->prefixlen < key->prefixlen ? node->prefixlen
+                                                 : key->prefixlen;
+  __u32 prefixlen = 0;
+  size_t i = 0;
+
+  while (lpm->data_size >= i + 8) {
+    uint64_t a, b;
+    memcpy(&a, node->data + i, 8);
+    memcpy(&b, key->data + i, 8);
+    uint64_t diff = __builtin_bswap64(a ^ b);
+    prefixlen += diff ? (__u32)__builtin_clzll(diff) : 64;
+    if (prefixlen >= limit) {
+      return limit;
+    }
+    if (diff) {
+      return prefixlen;
+    }
+    i += 8;
+  }
+  while (lpm->data_size >= i + 4) {
+    uint32_t a, b;
+    memcpy(&a, node->data + i, 4);
+    memcpy(&b, key->data + i, 4);
+    uint32_t diff = __builtin_bswap32(a ^ b);
+    prefixlen += diff ? (__u32)__builtin_clz(diff) : 32;
+    if (prefixlen >= limit) {
+      return limit;
+    }
+    if (diff) {
+      return prefixlen;
+    }
+    i += 4;
+  }
+  while (lpm->data_size > i) {
+    uint32_t diff = (uint32_t)(node->data[i] ^ key->data[i]) << 24;
+    prefixlen += diff ? (__u32)__builtin_clz(diff) : 8;
+    if (prefixlen >= limit) {
+      return limit;
+    }
+    if (diff) {
+      return prefixlen;
+    }
+    i++;
+  }
+  return prefixlen;
+}
+
+static void *lpm_lookup(struct bpf_native_map *map, const void *key,
+                        unsigned int cpu) {
+  (void)cpu; // the trie is shared by all CPUs
+  struct native_lpm *lpm = &map->lpm;
+  const struct native_lpm_key *k = key;
+  struct native_lpm_node *found = NULL;
+
+  for (struct native_lpm_node *node = lpm_load(&lpm->root); node;) {
+    size_t matchlen = lpm_match(lpm, node, k);
+    if (matchlen == lpm->max_prefixlen) {
+      found = node;
+      break;
+    }
+    if (matchlen < node->prefixlen) {
+      break;
+    }
+    if (!(__atomic_load_n(&node->flags, __ATOMIC_RELAXED) &
+          NATIVE_LPM_INTERMEDIATE)) {
+      found = node;
+    }
+    node = lpm_load(&node->child[lpm_extract_bit(k->data, node->prefixlen)]);
+  }
+  return found ? lpm_value(lpm, found) : NULL;
+}
+
+/* Called with the trie lock held */
+static void lpm_retire(struct native_lpm *lpm, struct native_lpm_node *node) {
+  if (lpm->n_retired == lpm->retired_cap) {
+    size_t cap = lpm->retired_cap ? lpm->retired_cap * 2 : 64;
+    struct native_lpm_node **retired =
+        realloc(lpm->retired, cap * sizeof(*retired));
+    if (!retired) {
+      fprintf(stderr, "bpf_native: out of memory\n");
+      exit(1);
+    }
+    lpm->retired = retired;
+    lpm->retired_cap = cap;
+  }
+  lpm->retired[lpm->n_retired++] = node;
+}
+
+static long lpm_update(struct bpf_native_map *map, const void *key,
+                       const void *value, __u64 flags) {
+  struct native_lpm *lpm = &map->lpm;
+  const struct native_lpm_key *k = key;
+  if (flags > BPF_EXIST) {
+    return -EINVAL;
+  }
+  if (k->prefixlen > lpm->max_prefixlen) {
+    return -EINVAL;
+  }
+
+  pthread_mutex_lock(&lpm->lock);
+  long ret = 0;
+  struct native_lpm_node *new_node = NULL;
+  struct native_lpm_node *node;
+  struct native_lpm_node **slot = &lpm->root;
+  size_t matchlen = 0;
+
+  /* Find the node that should precede the new one, as the kernel does */
+  while ((node = *slot)) {
+    matchlen = lpm_match(lpm, node, k);
+    if (node->prefixlen != matchlen || node->prefixlen == k->prefixlen ||
+        node->prefixlen == lpm->max_prefixlen) {
+      break;
+    }
+    slot = &node->child[lpm_extract_bit(k->data, node->prefixlen)];
+  }
+
+  int replace = node && node->prefixlen == matchlen &&
+                node->prefixlen == k->prefixlen &&
+                !(node->flags & NATIVE_LPM_INTERMEDIATE);
+  if (replace ? flags == BPF_NOEXIST : flags == BPF_EXIST) {
+    ret = replace ? -EEXIST : -ENOENT;
+    goto out;
+  }
+  if (!replace && lpm->n_entries == map->max_entries) {
+    ret = -ENOSPC;
+    goto out;
+  }
+
+  new_node = native_alloc(sizeof(*new_node) + lpm->value_offset +
+                          map->value_size);
+  new_node->prefixlen = k->prefixlen;
+  memcpy(new_node->data, k->data, lpm->data_size);
+  memcpy(lpm_value(lpm, new_node), value, map->value_size);
+  if (!replace) {
+    lpm->n_entries++;
+  }
+
+  if (!node) {
+    /* Empty slot */
+    lpm_publish(slot, new_node);
+    goto out;
+  }
+
+  if (node->prefixlen == matchlen) {
+    /* Same prefix: replaces node, or fills an intermediate node */
+    new_node->child[0] = node->child[0];
+    new_node->child[1] = node->child[1];
+    lpm_publish(slot, new_node);
+    lpm_retire(lpm, node);
+    goto out;
+  }
+
+  if (matchlen == k->prefixlen) {
+    /* The new node is a prefix of node and becomes its parent */
+    new_node->child[lpm_extract_bit(node->data, matchlen)] = node;
+    lpm_publish(slot, new_node);
+    goto out;
+  }
+
+  /* Diverging prefixes: join both under an intermediate node */
+  struct native_lpm_node *im_node =
+      native_alloc(sizeof(*im_node) + lpm->value_offset);
+  im_node->prefixlen = matchlen;
+  im_node->flags = NATIVE_LPM_INTERMEDIATE;
+  memcpy(im_node->data, node->data, lpm->data_size);
+  if (lpm_extract_bit(k->data, matchlen)) {
+    im_node->child[0] = node;
+    im_node->child[1] = new_node;
+  } else {
+    im_node->child[0] = new_node;
+    im_node->child[1] = node;
+  }
+  lpm_publish(slot, im_node);
+
+out:
+  pthread_mutex_unlock(&lpm->lock);
+  return ret;
+}
+
+static long lpm_delete(struct bpf_native_map *map, const void *key) {
+  struct native_lpm *lpm = &map->lpm;
+  const struct native_lpm_key *k = key;
+  if (k->prefixlen > lpm->max_prefixlen) {
+    return -EINVAL;
+  }
+
+  pthread_mutex_lock(&lpm->lock);
+  struct native_lpm_node **trim = &lpm->root, **trim2 = trim;
+  struct native_lpm_node *parent = NULL, *node;
+  size_t matchlen = 0;
+
+  /* Walk to the exact match, remembering the slots leading to it and its
+   * parent */
+  while ((node = *trim)) {
+    matchlen = lpm_match(lpm, node, k);
+    if (node->prefixlen != matchlen || node->prefixlen == k->prefixlen) {
+      break;
+    }
+    parent = node;
+    trim2 = trim;
+    trim = &node->child[lpm_extract_bit(k->data, node->prefixlen)];
+  }
+
+  if (!node || node->prefixlen != k->prefixlen ||
+      node->prefixlen != matchlen ||
+      (node->flags & NATIVE_LPM_INTERMEDIATE)) {
+    pthread_mutex_unlock(&lpm->lock);
+    return -ENOENT;
+  }
+  lpm->n_entries--;
+
+  if (node->child[0] && node->child[1]) {
+    /* Still needed to join both children */
+    __atomic_store_n(&node->flags, NATIVE_LPM_INTERMEDIATE, __ATOMIC_RELAXED);
+  } else if (parent && (parent->flags & NATIVE_LPM_INTERMEDIATE) &&
+             !node->child[0] && !node->child[1]) {
+    /* A leaf whose intermediate parent now has a single child: replace the
+     * parent with the sibling */
+    lpm_publish(trim2, node == parent->child[0] ? parent->child[1]
+                                                : parent->child[0]);
+    lpm_retire(lpm, parent);
+    lpm_retire(lpm, node);
+  } else {
+    /* At most one child, which takes node's place */
+    lpm_publish(trim, node->child[0] ? node->child[0] : node->child[1]);
+    lpm_retire(lpm, node);
+  }
+
+  pthread_mutex_unlock(&lpm->lock);
+  return 0;
+}
+
+static void lpm_init(struct bpf_native_map *map) {
+  struct native_lpm *lpm = &map->lpm;
+  if (map->key_size <= sizeof(__u32) ||
+      map->key_size > sizeof(__u32) + 256) {
+    fprintf(stderr, "bpf_native: bad LPM trie key size for %s\n", map->name);
+    exit(1);
+  }
+  lpm->data_size = map->key_size - sizeof(__u32);
+  lpm->value_offset = NATIVE_ROUND_UP(lpm->data_size, 8);
+  lpm->max_prefixlen = lpm->data_size * 8;
+  pthread_mutex_init(&lpm->lock, NULL);
+}
+
+static const struct native_map_ops lpm_ops = {
+    .lookup = lpm_lookup, .update = lpm_update, .delete = lpm_delete};
+
+/* Arrays */
+
+static inline void *array_elem(struct bpf_native_map *map, __u32 index,
+                               unsigned int cpu) {
+  return map->data + cpu * map->cpu_stride + (size_t)index * map->value_stride;
+}
+
+static void *array_lookup(struct bpf_native_map *map, const void *key,
+                          unsigned int cpu) {
+  __u32 index = *(const __u32 *)key;
+  if (index >= map->max_entries) {
+    return NULL;
+  }
+  return array_elem(map, index, cpu);
+}
+
+static void *array_of_maps_lookup(struct bpf_native_map *map, const void *key,
+                                  unsigned int cpu) {
+  void **inner = array_lookup(map, key, cpu);
+  return inner ? *inner : NULL;
+}
+
+static long array_update(struct bpf_native_map *map, const void *key,
+                         const void *value, __u64 flags) {
+  __u32 index = *(const __u32 *)key;
+  if (flags > BPF_EXIST) {
+    return -EINVAL;
+  }
+  if (index >= map->max_entries) {
+    return -E2BIG;
+  }
+  if (flags == BPF_NOEXIST) {
+    /* All array elements always exist */
+    return -EEXIST;
+  }
+  memcpy(array_elem(map, index, native_cpu(map)), value, map->value_size);
+  return 0;
+}
+
+static long array_delete(struct bpf_native_map *map, const void *key) {
+  (void)map;
+  (void)key;
+  return -EINVAL;
+}
+
+static const struct native_map_ops array_ops = {
+    .lookup = array_lookup, .update = array_update, .delete = array_delete};
+static const struct native_map_ops array_of_maps_ops = {
+    .lookup = array_of_maps_lookup,
+    .update = array_update,
+    .delete = array_delete};
+
+/* Generic interface */
+
+static int is_percpu(unsigned int type) {
+  return type == BPF_MAP_TYPE_PERCPU_ARRAY ||
+         type == BPF_MAP_TYPE_PERCPU_HASH ||
+         type == BPF_MAP_TYPE_LRU_PERCPU_HASH;
+}
+
+unsigned int bpf_native_map_create(const char *name, unsigned int type,
+                                   unsigned int key_size,
+                                   unsigned int value_size,
+                                   unsigned int max_entries,
+                                   unsigned int map_flags) {
+  if (bpf_native_map_ctr == BPF_NATIVE_MAX_MAPS) {
+    fprintf(stderr, "bpf_native: too many maps\n");
+    exit(1);
+  }
+  struct bpf_native_map *map = native_alloc(sizeof(*map));
+  snprintf(map->name, sizeof(map->name), "%s", name ? name : "");
+  map->type = type;
+  map->key_size = key_size;
+  map->value_size = value_size;
+  map->max_entries = max_entries;
+  map->map_flags = map_flags;
+  map->ncpus = is_percpu(type) ? bpf_native_ncpus : 1;
+
+  /* Maps of maps hold pointers to the inner struct bpf_map_def */
+  if (type == BPF_MAP_TYPE_ARRAY_OF_MAPS ||
+      type == BPF_MAP_TYPE_HASH_OF_MAPS) {
+    map->value_size = sizeof(void *);
+  }
+  map->key_area = NATIVE_ROUND_UP(key_size, 8);
+  map->value_stride = NATIVE_ROUND_UP(map->value_size, 8);
+
+  switch (type) {
+  case BPF_MAP_TYPE_ARRAY:
+  case BPF_MAP_TYPE_PERCPU_ARRAY:
+  case BPF_MAP_TYPE_PROG_ARRAY:
+  case BPF_MAP_TYPE_DEVMAP:
+  case BPF_MAP_TYPE_CPUMAP:
+  case BPF_MAP_TYPE_ARRAY_OF_MAPS:
+    map->cpu_stride =
+        NATIVE_ROUND_UP((size_t)max_entries * map->value_stride, 64);
+    map->data = native_alloc(map->cpu_stride * map->ncpus);
+    map->ops =
+        type == BPF_MAP_TYPE_ARRAY_OF_MAPS ? &array_of_maps_ops : &array_ops;
+    break;
+  case BPF_MAP_TYPE_HASH:
+  case BPF_MAP_TYPE_PERCPU_HASH:
+  case BPF_MAP_TYPE_LRU_HASH:
+  case BPF_MAP_TYPE_LRU_PERCPU_HASH:
+  case BPF_MAP_TYPE_HASH_OF_MAPS:
+    htab_init(map);
+    map->ops = htab_is_lru(map)                      ? &htab_lru_ops
+               : type == BPF_MAP_TYPE_HASH_OF_MAPS ? &htab_of_maps_ops
+                                                   : &htab_ops;
+    break;
+  case BPF_MAP_TYPE_LPM_TRIE:
+    lpm_init(map);
+    map->ops = &lpm_ops;
+    break;
+  default:
+    fprintf(stderr, "bpf_native: unsupported map type %u for %s\n", type,
+            name);
+    exit(1);
+  }
+
+  bpf_native_maps[bpf_native_map_ctr] = map;
+  return bpf_native_map_ctr++;
+}
+
+void *bpf_native_map_lookup_percpu(struct bpf_native_map *map,
+                                   const void *key, unsigned int cpu) {
+  return map->ops->lookup(map, key, cpu < map->ncpus ? cpu : 0);
+}
+
+void *bpf_native_map_lookup(struct bpf_native_map *map, const void *key) {
+  return map->ops->lookup(map, key, native_cpu(map));
+}
+
+long bpf_native_map_update(struct bpf_native_map *map, const void *key,
+                           const void *value, __u64 flags) {
+  return map->ops->update(map, key, value, flags);
+}
+
+long bpf_native_map_delete(struct bpf_native_map *map, const void *key) {
+  return map->ops->delete(map, key);
+}
+
+long bpf_native_map_set_inner(struct bpf_native_map *map, const void *key,
+                              void *inner_def) {
+  if (map->type != BPF_MAP_TYPE_ARRAY_OF_MAPS &&
+      map->type != BPF_MAP_TYPE_HASH_OF_MAPS) {
+    return -EINVAL;
+  }
+  return bpf_native_map_update(map, key, &inner_def, BPF_ANY);
+}
+
+long bpf_native_redirect_map(struct bpf_native_map *map, __u32 key,
+                             __u64 flags) {
+  if (key < map->max_entries &&
+      (map->type == BPF_MAP_TYPE_DEVMAP || map->type == BPF_MAP_TYPE_CPUMAP)) {
+    /* An unset devmap/cpumap slot holds ifindex/queue size 0 */
+    if (*(__u32 *)array_elem(map, key, 0) != 0) {
+      return XDP_REDIRECT;
+    }
+  } else if (bpf_native_map_lookup(map, &key)) {
+    return XDP_REDIRECT;
+  }
+  return flags & 3;
+}
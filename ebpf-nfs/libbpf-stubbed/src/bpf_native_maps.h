@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: (LGPL-2.1 OR BSD-2-Clause) */
+#ifndef __BPF_NATIVE_MAPS_H
+#define __BPF_NATIVE_MAPS_H
+
+/*
+ * Concrete BPF maps, used to run XDP programs natively in userspace (see
+ * ebpf-nfs/xdp-runner). Unlike the symbolic models in bpf_map_helper_defs.h,
+ * these hold real data, are safe to use from several threads, and follow the
+ * kernel's semantics: preallocated elements, BPF_ANY/BPF_NOEXIST/BPF_EXIST
+ * update flags, errno-style return codes, and one value per CPU for per-CPU
+ * maps, where the "CPU" is the calling runner thread.
+ */
+
+#include <linux/types.h>
+
+#define BPF_NATIVE_MAX_MAPS 64
+#define BPF_NATIVE_MAX_CPUS 128
+
+struct bpf_native_map;
+
+/* Indexed by bpf_map_def.map_id */
+extern struct bpf_native_map *bpf_native_maps[BPF_NATIVE_MAX_MAPS];
+
+/* What bpf_get_smp_processor_id() returns on the calling thread */
+extern __thread unsigned int bpf_native_cpu;
+
+/* Number of CPUs per-CPU maps keep values for. Call before creating maps. */
+void bpf_native_set_cpus(unsigned int ncpus);
+unsigned int bpf_native_get_cpus(void);
+
+/* Returns the map id, exits on unsupported map types or allocation failure */
+unsigned int bpf_native_map_create(const char *name, unsigned int type,
+                                   unsigned int key_size,
+                                   unsigned int value_size,
+                                   unsigned int max_entries,
+                                   unsigned int map_flags);
+
+void *bpf_native_map_lookup(struct bpf_native_map *map, const void *key);
+long bpf_native_map_update(struct bpf_native_map *map, const void *key,
+                           const void *value, __u64 flags);
+long bpf_native_map_delete(struct bpf_native_map *map, const void *key);
+
+/* Control plane access to per-CPU values, cpu need not be the caller's */
+void *bpf_native_map_lookup_percpu(struct bpf_native_map *map,
+                                   const void *key, unsigned int cpu);
+
+/* Makes inner_def, a struct bpf_map_def already created with
+ * bpf_native_map_create, the entry for key in an array/hash of maps */
+long bpf_native_map_set_inner(struct bpf_native_map *map, const void *key,
+                              void *inner_def);
+
+/* bpf_redirect_map(): XDP_REDIRECT if key holds a target, else the action in
+ * the low bits of flags */
+long bpf_native_redirect_map(struct bpf_native_map *map, __u32 key,
+                             __u64 flags);
+
+#endif /* __BPF_NATIVE_MAPS_H */
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Writes a synthetic Ethernet/IPv4 pcap for the XDP runner.
+
+Each flow starts with a SYN (TCP), then sends ACKs; flows are interleaved
+round-robin. Defaults target the katran runner's VIP (10.0.0.10:80).
+
+  gen_pcap.py -o trace.pcap --flows 1000 --packets 100000 [--udp]
+"""
+
+import argparse
+import random
+import socket
+import struct
+
+
+def checksum(data):
+    if len(data) % 2:
+        data += b"\0"
+    total = sum(struct.unpack("!%dH" % (len(data) // 2), data))
+    while total >> 16:
+        total = (total & 0xFFFF) + (total >> 16)
+    return ~total & 0xFFFF
+
+
+def packet(src, dst, sport, dport, udp, flags, size):
+    payload_len = max(0, size - 14 - 20 - (8 if udp else 20))
+    payload = bytes(payload_len)
+    if udp:
+        l4 = struct.pack("!HHHH", sport, dport, 8 + payload_len, 0) + payload
+        proto = socket.IPPROTO_UDP
+    else:
+        l4 = struct.pack("!HHIIBBHHH", sport, dport, 1, 0, 5 << 4, flags,
+                         65535, 0, 0) + payload
+        proto = socket.IPPROTO_TCP
+    ip = struct.pack("!BBHHHBBH4s4s", 0x45, 0, 20 + len(l4), 0, 0x4000, 64,
+                     proto, 0, src, dst)
+    ip = ip[:10] + struct.pack("!H", checksum(ip)) + ip[12:]
+    eth = b"\x02\x00\x00\x00\x00\x02" + b"\x02\x00\x00\x00\x00\x01" + \
+        struct.pack("!H", 0x0800)
+    return eth + ip + l4
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--flows", type=int, default=1000)
+    parser.add_argument("--packets", type=int, default=100000)
+    parser.add_argument("--dst", default="10.0.0.10")
+    parser.add_argument("--dport", type=int, default=80)
+    parser.add_argument("--size", type=int, default=64,
+                        help="frame size without FCS")
+    parser.add_argument("--udp", action="store_true")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    dst = socket.inet_aton(args.dst)
+    flows = [(struct.pack("!I", rng.randrange(0x0B000000, 0x0BFFFFFF)),
+              rng.randrange(1024, 65536)) for _ in range(args.flows)]
+
+    with open(args.output, "wb") as out:
+        out.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, 1))
+        for i in range(args.packets):
+            src, sport = flows[i % len(flows)]
+            flags = 0x02 if i < len(flows) else 0x10  # SYN, then ACK
+            data = packet(src, dst, sport, args.dport, args.udp, flags,
+                          args.size)
+            out.write(struct.pack("<IIII", i // 1000000, i % 1000000,
+                                  len(data), len(data)))
+            out.write(data)
+
+
+if __name__ == "__main__":
+    main()
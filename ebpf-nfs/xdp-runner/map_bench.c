@@ -0,0 +1,257 @@
+// Per-operation cost of the native BPF maps (bpf_native_maps.c), in the
+// shape of the kernel's map benchmarks (tools/testing/selftests/bpf/bench,
+// samples/bpf/map_perf_test): every thread runs the same operation on its
+// own CPU id, and the cost is reported in ns/op and aggregate Mops/s.
+// Usage: ./map-bench [-t threads] [-n ops per thread]
+
+#include <linux/bpf.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bpf/bpf_native_maps.h"
+
+#define BENCH_ENTRIES (1 << 16)
+/* Maps of MAX_LPM_SRC's order, as katran's lpm_src_v4/v6 */
+#define BENCH_PREFIXES (1 << 20)
+#define BENCH_KEYS (1 << 20)
+
+struct lpm_v4_key {
+  __u32 prefixlen;
+  __u32 addr;
+};
+
+struct lpm_v6_key {
+  __u32 prefixlen;
+  __u32 addr[4];
+};
+
+struct bench {
+  const char *name;
+  struct bpf_native_map *map;
+  /* Returns a value to keep the operation from being optimised away */
+  uint64_t (*op)(struct bench *bench, uint32_t key);
+  /* Keys are drawn from [0, keyspace) */
+  uint32_t keyspace;
+};
+
+static unsigned int bench_threads = 1;
+static unsigned long bench_ops = 1 << 20;
+static uint32_t *bench_keys;
+
+static pthread_barrier_t bench_barrier;
+
+struct bench_thread {
+  pthread_t thread;
+  unsigned int cpu;
+  struct bench *bench;
+  double ns;
+  uint64_t sink;
+};
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t bench_rand(uint64_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return (uint32_t)(*state >> 16);
+}
+
+static uint64_t op_lookup(struct bench *bench, uint32_t key) {
+  return bpf_native_map_lookup(bench->map, &key) != NULL;
+}
+
+static uint64_t op_update(struct bench *bench, uint32_t key) {
+  uint64_t value = key;
+  return bpf_native_map_update(bench->map, &key, &value, BPF_ANY) == 0;
+}
+
+static uint64_t op_lpm_v4(struct bench *bench, uint32_t key) {
+  struct lpm_v4_key k = {.prefixlen = 32, .addr = key};
+  return bpf_native_map_lookup(bench->map, &k) != NULL;
+}
+
+static uint64_t op_lpm_v6(struct bench *bench, uint32_t key) {
+  struct lpm_v6_key k = {.prefixlen = 128,
+                         .addr = {0x20010DB8, key, key * 0x9E3779B9u, key}};
+  return bpf_native_map_lookup(bench->map, &k) != NULL;
+}
+
+static void *bench_thread_main(void *arg) {
+  struct bench_thread *t = arg;
+  struct bench *bench = t->bench;
+  bpf_native_cpu = t->cpu;
+
+  /* Each thread walks the shared random key stream from its own offset */
+  unsigned long pos = (unsigned long)t->cpu * (BENCH_KEYS / bench_threads);
+  uint64_t sink = 0;
+  pthread_barrier_wait(&bench_barrier);
+  double start = now_ns();
+  for (unsigned long i = 0; i < bench_ops; ++i) {
+    sink += bench->op(bench, bench_keys[(pos + i) % BENCH_KEYS] %
+                                 bench->keyspace);
+  }
+  t->ns = now_ns() - start;
+  t->sink = sink;
+  return NULL;
+}
+
+static void bench_run(struct bench *bench) {
+  struct bench_thread threads[bench_threads];
+  pthread_barrier_init(&bench_barrier, NULL, bench_threads);
+  for (unsigned int cpu = 0; cpu < bench_threads; ++cpu) {
+    threads[cpu] = (struct bench_thread){.cpu = cpu, .bench = bench};
+    if (pthread_create(&threads[cpu].thread, NULL, bench_thread_main,
+                       &threads[cpu])) {
+      fprintf(stderr, "map-bench: cannot create thread\n");
+      exit(1);
+    }
+  }
+
+  double ns = 0;
+  uint64_t hits = 0;
+  for (unsigned int cpu = 0; cpu < bench_threads; ++cpu) {
+    pthread_join(threads[cpu].thread, NULL);
+    ns += threads[cpu].ns;
+    hits += threads[cpu].sink;
+  }
+  pthread_barrier_destroy(&bench_barrier);
+
+  double ns_per_op = ns / ((double)bench_ops * bench_threads);
+  printf("%-28s %8.1f ns/op %8.2f Mops/s %6.1f%% hit\n", bench->name,
+         ns_per_op, bench_threads * 1e3 / ns_per_op,
+         100.0 * hits / ((double)bench_ops * bench_threads));
+}
+
+static struct bpf_native_map *bench_map(const char *name, unsigned int type,
+                                        unsigned int key_size,
+                                        unsigned int value_size,
+                                        unsigned int max_entries) {
+  return bpf_native_maps[bpf_native_map_create(name, type, key_size,
+                                               value_size, max_entries, 0)];
+}
+
+static void fill(struct bpf_native_map *map, uint32_t entries) {
+  for (uint32_t key = 0; key < entries; ++key) {
+    uint64_t value = key;
+    if (bpf_native_map_update(map, &key, &value, BPF_ANY) != 0) {
+      fprintf(stderr, "map-bench: cannot populate map\n");
+      exit(1);
+    }
+  }
+}
+
+/* Random prefixes with the length mix of a BGP table: mostly /16-/24 for
+ * IPv4 and /32-/48 for IPv6 */
+static void fill_lpm_v4(struct bpf_native_map *map, uint64_t *rng) {
+  for (uint32_t i = 0; i < BENCH_PREFIXES; ++i) {
+    struct lpm_v4_key k;
+    k.prefixlen = 16 + bench_rand(rng) % 9;
+    k.addr = bench_rand(rng);
+    uint64_t value = i;
+    bpf_native_map_update(map, &k, &value, BPF_ANY);
+  }
+}
+
+static void fill_lpm_v6(struct bpf_native_map *map, uint64_t *rng) {
+  for (uint32_t i = 0; i < BENCH_PREFIXES; ++i) {
+    struct lpm_v6_key k = {.addr = {0x20010DB8}};
+    k.prefixlen = 32 + bench_rand(rng) % 17;
+    k.addr[1] = bench_rand(rng);
+    uint64_t value = i;
+    bpf_native_map_update(map, &k, &value, BPF_ANY);
+  }
+}
+
+int main(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "t:n:")) != -1) {
+    switch (opt) {
+    case 't':
+      bench_threads = strtoul(optarg, NULL, 0);
+      break;
+    case 'n':
+      bench_ops = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      fprintf(stderr, "Usage: %s [-t threads] [-n ops per thread]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (bench_threads == 0 || bench_threads > BPF_NATIVE_MAX_CPUS ||
+      bench_ops == 0) {
+    fprintf(stderr, "map-bench: bad arguments\n");
+    return 1;
+  }
+  bpf_native_set_cpus(bench_threads);
+
+  uint64_t rng = 0x2545F4914F6CDD1Dull;
+  bench_keys = malloc(BENCH_KEYS * sizeof(*bench_keys));
+  if (!bench_keys) {
+    fprintf(stderr, "map-bench: out of memory\n");
+    return 1;
+  }
+  for (uint32_t i = 0; i < BENCH_KEYS; ++i) {
+    bench_keys[i] = bench_rand(&rng);
+  }
+
+  printf("%u thread(s), %lu ops per thread, %u entries\n", bench_threads,
+         bench_ops, BENCH_ENTRIES);
+
+  struct bpf_native_map *hash =
+      bench_map("hash", BPF_MAP_TYPE_HASH, 4, 8, BENCH_ENTRIES);
+  fill(hash, BENCH_ENTRIES);
+  bench_run(&(struct bench){"hash lookup", hash, op_lookup, BENCH_ENTRIES});
+  bench_run(&(struct bench){"hash lookup (miss)", hash, op_lookup,
+                            UINT32_MAX});
+  bench_run(&(struct bench){"hash update", hash, op_update, BENCH_ENTRIES});
+
+  struct bpf_native_map *lru =
+      bench_map("lru_hash", BPF_MAP_TYPE_LRU_HASH, 4, 8, BENCH_ENTRIES);
+  fill(lru, BENCH_ENTRIES);
+  bench_run(&(struct bench){"lru_hash lookup", lru, op_lookup, BENCH_ENTRIES});
+  bench_run(&(struct bench){"lru_hash update", lru, op_update, BENCH_ENTRIES});
+  /* Four times as many keys as entries: most updates evict */
+  bench_run(&(struct bench){"lru_hash update (evicting)", lru, op_update,
+                            4 * BENCH_ENTRIES});
+
+  struct bpf_native_map *percpu_lru = bench_map(
+      "lru_percpu_hash", BPF_MAP_TYPE_LRU_PERCPU_HASH, 4, 8, BENCH_ENTRIES);
+  bench_run(&(struct bench){"lru_percpu_hash update (ev.)", percpu_lru,
+                            op_update, 4 * BENCH_ENTRIES});
+
+  struct bpf_native_map *array =
+      bench_map("array", BPF_MAP_TYPE_ARRAY, 4, 8, BENCH_ENTRIES);
+  bench_run(&(struct bench){"array lookup", array, op_lookup, BENCH_ENTRIES});
+  struct bpf_native_map *percpu_array = bench_map(
+      "percpu_array", BPF_MAP_TYPE_PERCPU_ARRAY, 4, 8, BENCH_ENTRIES);
+  bench_run(&(struct bench){"percpu_array lookup", percpu_array, op_lookup,
+                            BENCH_ENTRIES});
+  bench_run(&(struct bench){"percpu_array update", percpu_array, op_update,
+                            BENCH_ENTRIES});
+
+  struct bpf_native_map *lpm_v4 = bench_map(
+      "lpm_v4", BPF_MAP_TYPE_LPM_TRIE, sizeof(struct lpm_v4_key), 8,
+      BENCH_PREFIXES);
+  fill_lpm_v4(lpm_v4, &rng);
+  bench_run(&(struct bench){"lpm_trie v4 lookup", lpm_v4, op_lpm_v4,
+                            UINT32_MAX});
+  struct bpf_native_map *lpm_v6 = bench_map(
+      "lpm_v6", BPF_MAP_TYPE_LPM_TRIE, sizeof(struct lpm_v6_key), 8,
+      BENCH_PREFIXES);
+  fill_lpm_v6(lpm_v6, &rng);
+  bench_run(&(struct bench){"lpm_trie v6 lookup", lpm_v6, op_lpm_v6,
+                            UINT32_MAX});
+
+  free(bench_keys);
+  return 0;
+}
@@ -0,0 +1,496 @@
+/*
+ * Userspace XDP runner, see xdp_runner.h.
+ *
+ * Usage: <nf>-runner [-t threads] [-n loops] [-w warmup loops]
+ *                    [-c first cpu] [-i ingress ifindex] <trace.pcap>
+ *
+ * Packets are spread over the threads by a 5-tuple hash, the way RSS would
+ * spread them over NIC queues, so each flow stays on one "CPU". Every thread
+ * is pinned to its own core and runs its share of the trace loops times.
+ * Only the XDP program itself is timed: copying the packet into the frame
+ * buffer happens outside the rdtsc window.
+ */
+
+#define _GNU_SOURCE
+
+#include "xdp_runner.h"
+
+#include <bpf/bpf_native_maps.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <linux/bpf.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <x86intrin.h>
+
+/* Frame layout: XDP_PACKET_HEADROOM bytes of headroom, then the packet */
+#define RUNNER_FRAME_SIZE 4096
+#define RUNNER_HEADROOM 256
+#define RUNNER_MAX_PKT (RUNNER_FRAME_SIZE - RUNNER_HEADROOM)
+
+/* One bucket per cycle up to RUNNER_HIST_MAX, plus one overflow bucket */
+#define RUNNER_HIST_MAX 65536
+#define RUNNER_ACTIONS (XDP_REDIRECT + 2)
+
+__thread void *bpf_native_xdp_hard_start;
+__thread void *bpf_native_xdp_frame_end;
+
+struct runner_pkt {
+  const uint8_t *data;
+  uint32_t len;
+};
+
+struct runner_thread {
+  pthread_t thread;
+  unsigned int id;
+  unsigned int cpu;
+  struct runner_pkt *pkts;
+  size_t n_pkts;
+  size_t capacity;
+
+  uint64_t *hist;
+  uint64_t max_cycles;
+  uint64_t total_cycles;
+  uint64_t measured;
+  uint64_t actions[RUNNER_ACTIONS];
+};
+
+static unsigned int n_threads = 1;
+static unsigned int n_loops = 10;
+static unsigned int n_warmup = 1;
+static unsigned int first_cpu = 0;
+static unsigned int ingress_ifindex = 0;
+static uint64_t rdtsc_overhead = 0;
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-t threads] [-n loops] [-w warmup loops] "
+          "[-c first cpu] [-i ingress ifindex] <trace.pcap>\n",
+          prog);
+  exit(1);
+}
+
+static unsigned int parse_uint_arg(const char *arg, const char *what) {
+  char *end;
+  unsigned long value = strtoul(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || value > UINT32_MAX) {
+    fprintf(stderr, "Invalid %s: %s\n", what, arg);
+    exit(1);
+  }
+  return (unsigned int)value;
+}
+
+static inline uint64_t rdtsc_begin(void) {
+  _mm_lfence();
+  uint64_t tsc = __rdtsc();
+  _mm_lfence();
+  return tsc;
+}
+
+static inline uint64_t rdtsc_end(void) {
+  unsigned int aux;
+  uint64_t tsc = __rdtscp(&aux);
+  _mm_lfence();
+  return tsc;
+}
+
+static uint64_t calibrate_rdtsc_overhead(void) {
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t start = rdtsc_begin();
+    uint64_t end = rdtsc_end();
+    if (end - start < best) {
+      best = end - start;
+    }
+  }
+  return best;
+}
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double estimate_tsc_hz(void) {
+  struct timespec pause = {.tv_sec = 0, .tv_nsec = 100 * 1000 * 1000};
+  double start = now_seconds();
+  uint64_t tsc_start = rdtsc_begin();
+  nanosleep(&pause, NULL);
+  uint64_t tsc_end = rdtsc_end();
+  double end = now_seconds();
+  return (tsc_end - tsc_start) / (end - start);
+}
+
+/* pcap */
+
+struct pcap_file_header {
+  uint32_t magic;
+  uint16_t version_major;
+  uint16_t version_minor;
+  int32_t thiszone;
+  uint32_t sigfigs;
+  uint32_t snaplen;
+  uint32_t linktype;
+};
+
+struct pcap_record_header {
+  uint32_t ts_sec;
+  uint32_t ts_frac;
+  uint32_t caplen;
+  uint32_t len;
+};
+
+#define PCAP_MAGIC_US 0xA1B2C3D4
+#define PCAP_MAGIC_NS 0xA1B23C4D
+#define PCAP_LINKTYPE_ETHERNET 1
+
+static uint8_t *load_file(const char *fname, size_t *size_out) {
+  FILE *file = fopen(fname, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Cannot open %s: %s\n", fname, strerror(errno));
+    exit(1);
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  uint8_t *data = malloc(size > 0 ? size : 1);
+  if (data == NULL || fread(data, 1, size, file) != (size_t)size) {
+    fprintf(stderr, "Cannot read %s\n", fname);
+    exit(1);
+  }
+  fclose(file);
+  *size_out = size;
+  return data;
+}
+
+/* RSS-like flow hash over the IPv4/IPv6 5-tuple, direction sensitive */
+static uint32_t flow_hash(const uint8_t *pkt, uint32_t len) {
+  uint64_t h = 0xCBF29CE484222325ull;
+#define RUNNER_HASH_BYTES(p, n)                                                \
+  for (uint32_t _i = 0; _i < (n); ++_i) {                                      \
+    h = (h ^ (p)[_i]) * 0x100000001B3ull;                                      \
+  }
+  if (len < 14) {
+    return 0;
+  }
+  uint16_t ethertype = (uint16_t)(pkt[12] << 8 | pkt[13]);
+  const uint8_t *l3 = pkt + 14;
+  uint32_t l3_len = len - 14;
+  const uint8_t *l4 = NULL;
+  uint8_t proto = 0;
+  if (ethertype == 0x0800 && l3_len >= 20) {
+    uint32_t ihl = (l3[0] & 0xF) * 4;
+    proto = l3[9];
+    RUNNER_HASH_BYTES(l3 + 12, 8);
+    if (ihl >= 20 && l3_len >= ihl + 4) {
+      l4 = l3 + ihl;
+    }
+  } else if (ethertype == 0x86DD && l3_len >= 40) {
+    proto = l3[6];
+    RUNNER_HASH_BYTES(l3 + 8, 32);
+    if (l3_len >= 44) {
+      l4 = l3 + 40;
+    }
+  } else {
+    RUNNER_HASH_BYTES(pkt, 14);
+    return (uint32_t)(h ^ (h >> 32));
+  }
+  RUNNER_HASH_BYTES(&proto, 1);
+  if (l4 != NULL && (proto == 6 || proto == 17)) {
+    RUNNER_HASH_BYTES(l4, 4);
+  }
+#undef RUNNER_HASH_BYTES
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+static void add_packet(struct runner_thread *thread, const uint8_t *data,
+                       uint32_t len) {
+  if (thread->n_pkts == thread->capacity) {
+    thread->capacity = thread->capacity ? 2 * thread->capacity : 1024;
+    thread->pkts = realloc(thread->pkts, thread->capacity * sizeof(*thread->pkts));
+    if (thread->pkts == NULL) {
+      fprintf(stderr, "Out of memory loading the trace\n");
+      exit(1);
+    }
+  }
+  thread->pkts[thread->n_pkts++] = (struct runner_pkt){.data = data, .len = len};
+}
+
+static void load_pcap(const char *fname, struct runner_thread *threads) {
+  size_t size;
+  uint8_t *data = load_file(fname, &size);
+  if (size < sizeof(struct pcap_file_header)) {
+    fprintf(stderr, "%s: not a pcap file\n", fname);
+    exit(1);
+  }
+  struct pcap_file_header header;
+  memcpy(&header, data, sizeof(header));
+  int swapped;
+  if (header.magic == PCAP_MAGIC_US || header.magic == PCAP_MAGIC_NS) {
+    swapped = 0;
+  } else if (header.magic == __builtin_bswap32(PCAP_MAGIC_US) ||
+             header.magic == __builtin_bswap32(PCAP_MAGIC_NS)) {
+    swapped = 1;
+  } else {
+    fprintf(stderr, "%s: not a pcap file (pcapng is not supported)\n", fname);
+    exit(1);
+  }
+  uint32_t linktype =
+      swapped ? __builtin_bswap32(header.linktype) : header.linktype;
+  if ((linktype & 0xFFFF) != PCAP_LINKTYPE_ETHERNET) {
+    fprintf(stderr, "%s: link type %u is not Ethernet\n", fname, linktype);
+    exit(1);
+  }
+
+  size_t offset = sizeof(header);
+  size_t total = 0;
+  size_t skipped = 0;
+  while (offset + sizeof(struct pcap_record_header) <= size) {
+    struct pcap_record_header record;
+    memcpy(&record, data + offset, sizeof(record));
+    uint32_t caplen = swapped ? __builtin_bswap32(record.caplen) : record.caplen;
+    offset += sizeof(record);
+    if (offset + caplen > size) {
+      fprintf(stderr, "%s: truncated record, ignoring the rest\n", fname);
+      break;
+    }
+    if (caplen > RUNNER_MAX_PKT || caplen < 14) {
+      ++skipped;
+    } else {
+      const uint8_t *pkt = data + offset;
+      add_packet(&threads[flow_hash(pkt, caplen) % n_threads], pkt, caplen);
+      ++total;
+    }
+    offset += caplen;
+  }
+  if (total == 0) {
+    fprintf(stderr, "%s: no usable packets\n", fname);
+    exit(1);
+  }
+  printf("Loaded %zu packets from %s", total, fname);
+  if (skipped) {
+    printf(" (skipped %zu shorter than 14 or longer than %d bytes)", skipped,
+           RUNNER_MAX_PKT);
+  }
+  printf("\n");
+}
+
+/* Packet loop */
+
+static void *run_thread(void *arg) {
+  struct runner_thread *thread = arg;
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(thread->cpu, &cpus);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+    fprintf(stderr, "Warning: cannot pin thread %u to CPU %u\n", thread->id,
+            thread->cpu);
+  }
+  bpf_native_cpu = thread->id;
+
+  /* struct xdp_md holds 32-bit pointers, so frames must live below 4GiB */
+  uint8_t *frame = mmap(NULL, RUNNER_FRAME_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+  if (frame == MAP_FAILED) {
+    fprintf(stderr, "Cannot map a frame buffer below 4GiB\n");
+    exit(1);
+  }
+  bpf_native_xdp_hard_start = frame;
+  bpf_native_xdp_frame_end = frame + RUNNER_FRAME_SIZE;
+
+  thread->hist = calloc(RUNNER_HIST_MAX + 1, sizeof(uint64_t));
+  if (thread->hist == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+
+  struct xdp_md ctx;
+  for (unsigned int loop = 0; loop < n_warmup + n_loops; ++loop) {
+    int timed = loop >= n_warmup;
+    for (size_t i = 0; i < thread->n_pkts; ++i) {
+      const struct runner_pkt *pkt = &thread->pkts[i];
+      memcpy(frame + RUNNER_HEADROOM, pkt->data, pkt->len);
+      ctx.data = (__u32)(uintptr_t)(frame + RUNNER_HEADROOM);
+      ctx.data_end = ctx.data + pkt->len;
+      ctx.data_meta = ctx.data;
+      ctx.ingress_ifindex = ingress_ifindex;
+      ctx.rx_queue_index = thread->id;
+
+      uint64_t tsc_start = rdtsc_begin();
+      int action = xdp_runner_nf_prog(&ctx);
+      uint64_t tsc_end = rdtsc_end();
+
+      if (!timed) {
+        continue;
+      }
+      uint64_t cycles = tsc_end - tsc_start;
+      cycles = cycles > rdtsc_overhead ? cycles - rdtsc_overhead : 0;
+      ++thread->hist[cycles < RUNNER_HIST_MAX ? cycles : RUNNER_HIST_MAX];
+      thread->total_cycles += cycles;
+      if (cycles > thread->max_cycles) {
+        thread->max_cycles = cycles;
+      }
+      ++thread->actions[action >= 0 && action <= XDP_REDIRECT
+                            ? action
+                            : RUNNER_ACTIONS - 1];
+      ++thread->measured;
+    }
+  }
+  munmap(frame, RUNNER_FRAME_SIZE);
+  return NULL;
+}
+
+/* Reporting */
+
+static uint64_t percentile(const uint64_t *hist, uint64_t count, double p) {
+  uint64_t rank = (uint64_t)(p * count);
+  if (rank >= count) {
+    rank = count - 1;
+  }
+  uint64_t seen = 0;
+  for (uint64_t cycles = 0; cycles <= RUNNER_HIST_MAX; ++cycles) {
+    seen += hist[cycles];
+    if (seen > rank) {
+      return cycles;
+    }
+  }
+  return RUNNER_HIST_MAX;
+}
+
+static void print_stats(const char *label, const uint64_t *hist,
+                        uint64_t count, uint64_t total_cycles,
+                        uint64_t max_cycles, double mpps) {
+  if (count == 0) {
+    printf("%-8s no packets\n", label);
+    return;
+  }
+  printf("%-8s %10" PRIu64 " pkts %8.3f Mpps  mean %7.1f  p50 %6" PRIu64
+         "  p90 %6" PRIu64 "  p99 %6" PRIu64 "  p99.9 %6" PRIu64
+         "  max %8" PRIu64 " cycles\n",
+         label, count, mpps, (double)total_cycles / count,
+         percentile(hist, count, 0.50), percentile(hist, count, 0.90),
+         percentile(hist, count, 0.99), percentile(hist, count, 0.999),
+         max_cycles);
+}
+
+int main(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "t:n:w:c:i:h")) != -1) {
+    switch (opt) {
+    case 't':
+      n_threads = parse_uint_arg(optarg, "thread count");
+      break;
+    case 'n':
+      n_loops = parse_uint_arg(optarg, "loop count");
+      break;
+    case 'w':
+      n_warmup = parse_uint_arg(optarg, "warmup loop count");
+      break;
+    case 'c':
+      first_cpu = parse_uint_arg(optarg, "CPU");
+      break;
+    case 'i':
+      ingress_ifindex = parse_uint_arg(optarg, "ifindex");
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (optind != argc - 1 || n_threads == 0 ||
+      n_threads > BPF_NATIVE_MAX_CPUS || n_loops == 0) {
+    usage(argv[0]);
+  }
+
+  struct runner_thread *threads = calloc(n_threads, sizeof(*threads));
+  if (threads == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+  for (unsigned int t = 0; t < n_threads; ++t) {
+    threads[t].id = t;
+    threads[t].cpu = first_cpu + t;
+  }
+
+  load_pcap(argv[optind], threads);
+
+  bpf_native_set_cpus(n_threads);
+  xdp_runner_nf_init();
+
+  rdtsc_overhead = calibrate_rdtsc_overhead();
+  double tsc_hz = estimate_tsc_hz();
+  printf("TSC %.3f GHz, rdtsc overhead %" PRIu64 " cycles (subtracted)\n",
+         tsc_hz * 1e-9, rdtsc_overhead);
+  printf("%u thread(s), %u warmup + %u measured loop(s)\n", n_threads,
+         n_warmup, n_loops);
+
+  for (unsigned int t = 0; t < n_threads; ++t) {
+    if (pthread_create(&threads[t].thread, NULL, run_thread, &threads[t])) {
+      fprintf(stderr, "Cannot create thread %u\n", t);
+      return 1;
+    }
+  }
+  for (unsigned int t = 0; t < n_threads; ++t) {
+    pthread_join(threads[t].thread, NULL);
+  }
+
+  /* Mpps only counts the time spent in the XDP program */
+  uint64_t *hist = calloc(RUNNER_HIST_MAX + 1, sizeof(uint64_t));
+  uint64_t count = 0, total_cycles = 0, max_cycles = 0;
+  uint64_t actions[RUNNER_ACTIONS] = {0};
+  double mpps = 0;
+  for (unsigned int t = 0; t < n_threads; ++t) {
+    struct runner_thread *thread = &threads[t];
+    double thread_mpps =
+        thread->total_cycles
+            ? thread->measured * tsc_hz / thread->total_cycles * 1e-6
+            : 0;
+    char label[16];
+    snprintf(label, sizeof(label), "cpu %u", thread->cpu);
+    print_stats(label, thread->hist, thread->measured, thread->total_cycles,
+                thread->max_cycles, thread_mpps);
+
+    for (uint64_t c = 0; c <= RUNNER_HIST_MAX; ++c) {
+      hist[c] += thread->hist[c];
+    }
+    for (int a = 0; a < RUNNER_ACTIONS; ++a) {
+      actions[a] += thread->actions[a];
+    }
+    count += thread->measured;
+    total_cycles += thread->total_cycles;
+    if (thread->max_cycles > max_cycles) {
+      max_cycles = thread->max_cycles;
+    }
+    mpps += thread_mpps;
+  }
+  print_stats("total", hist, count, total_cycles, max_cycles, mpps);
+  if (hist[RUNNER_HIST_MAX]) {
+    printf("%" PRIu64 " packet(s) took over %d cycles; percentiles are capped\n",
+           hist[RUNNER_HIST_MAX], RUNNER_HIST_MAX);
+  }
+
+  static const char *action_names[RUNNER_ACTIONS] = {
+      "ABORTED", "DROP", "PASS", "TX", "REDIRECT", "other"};
+  printf("actions:");
+  for (int a = 0; a < RUNNER_ACTIONS; ++a) {
+    printf(" %s %" PRIu64, action_names[a], actions[a]);
+  }
+  printf("\n");
+
+  for (unsigned int t = 0; t < n_threads; ++t) {
+    free(threads[t].hist);
+    free(threads[t].pkts);
+  }
+  free(threads);
+  free(hist);
+  return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef __XDP_RUNNER_H
+#define __XDP_RUNNER_H
+
+/*
+ * Userspace XDP runner: replays a pcap through an XDP program compiled
+ * natively with -DXDP_RUNNER, against the concrete maps in
+ * libbpf-stubbed/src/bpf_native_maps.c, and reports per-packet cycles.
+ *
+ * Each NF provides a driver (<nf>/<XDP_TARGETS>_runner.c) that includes the
+ * XDP program and implements the two functions below.
+ */
+
+struct xdp_md;
+
+/* Creates and populates the NF's maps, like its userspace loader would.
+ * Called once, after bpf_native_set_cpus(), before any packet is run. */
+void xdp_runner_nf_init(void);
+
+/* Runs the XDP program on one packet, returns its XDP action */
+int xdp_runner_nf_prog(struct xdp_md *ctx);
+
+#endif /* __XDP_RUNNER_H */
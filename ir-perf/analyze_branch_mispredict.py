@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Branch Misprediction Analysis Script
+
+Estimates the branch misprediction penalty of this CPU from the data-driven
+branching benchmarks (generate_branch_benchmarks.py).
+
+The loops differ only in the bit array their branches read, so within one
+depth (branches per iteration) every benchmark runs the same instructions:
+
+  cycles = base(depth) + penalty * branch_misses
+
+A least-squares fit over all of them, with one base per depth, gives the
+penalty. Each pattern is also reported with its misprediction rate and its
+cycles per branch above the never-taken baseline.
+"""
+
+import argparse
+import csv
+import glob
+import os
+import platform
+import re
+from datetime import datetime
+
+import numpy as np
+
+
+BENCH_RE = re.compile(r'bench_branching_(data-(?:random-p\d+|alternating|periodic-\d+))(?:-(\d+))?$')
+BASELINE = 'data-random-p0'
+
+
+def cpu_model():
+    try:
+        with open('/proc/cpuinfo') as f:
+            for line in f:
+                if line.startswith('model name'):
+                    return line.split(':', 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or platform.machine()
+
+
+class BranchMispredictAnalyzer:
+    def __init__(self, verbose=False, iterations=None):
+        self.verbose = verbose
+        self.iterations = iterations  # If None, will be read from CSV
+        self.rows = []
+        self.penalty = None
+        self.r_squared = None
+        self.pattern_results = []
+        self.cpu = cpu_model()
+
+    def load_csv_files(self, pattern="benchmark_results_*.csv"):
+        """Load the data-driven branching results of the latest results CSV."""
+        csv_files = sorted(glob.glob(pattern), reverse=True)
+        if not csv_files:
+            print(f"No CSV files found matching pattern: {pattern}")
+            return False
+
+        if self.verbose:
+            print(f"Loading data from: {csv_files[0]}")
+        with open(csv_files[0], newline='') as csvfile:
+            for row in csv.DictReader(csvfile):
+                m = BENCH_RE.match(row['benchmark'])
+                if not m or 'N/A' in (row.get('cycles'), row.get('branch_misses')):
+                    continue
+                if self.iterations is None and row.get('iterations'):
+                    self.iterations = int(row['iterations'])
+                self.rows.append({
+                    'benchmark': row['benchmark'],
+                    'pattern': m.group(1),
+                    'depth': int(m.group(2) or 1),
+                    'cycles': float(row['cycles']),
+                    'branch_misses': float(row['branch_misses']),
+                })
+
+        if self.iterations is None:
+            print("⚠ Warning: No iterations data found in CSV, assuming 100M iterations")
+            self.iterations = 100000000
+        print(f"Loaded {len(self.rows)} data-driven branching results")
+        return bool(self.rows)
+
+    def analyze(self):
+        """Fit the penalty and summarize every pattern."""
+        depths = sorted({r['depth'] for r in self.rows})
+        if len(self.rows) < len(depths) + 1:
+            raise ValueError("Not enough data-driven branching results to fit the penalty")
+
+        # Columns: branch misses, then one intercept per depth
+        A = np.zeros((len(self.rows), 1 + len(depths)))
+        b = np.zeros(len(self.rows))
+        for i, r in enumerate(self.rows):
+            A[i, 0] = r['branch_misses']
+            A[i, 1 + depths.index(r['depth'])] = 1.0
+            b[i] = r['cycles']
+        solution, _, rank, _ = np.linalg.lstsq(A, b, rcond=None)
+        if rank < A.shape[1]:
+            raise ValueError("Branch misses do not vary between the benchmarks; "
+                             "are the data-random-p* results present?")
+        self.penalty = solution[0]
+        pred = A @ solution
+        ss_res = np.sum((b - pred) ** 2)
+        ss_tot = np.sum((b - np.mean(b)) ** 2)
+        self.r_squared = 1 - ss_res / ss_tot if ss_tot > 0 else 0
+
+        baseline = {r['depth']: r['cycles'] for r in self.rows if r['pattern'] == BASELINE}
+        self.pattern_results = []
+        natural = lambda r: [int(t) if t.isdigit() else t for t in re.split(r'(\d+)', r['pattern'])]
+        for r in sorted(self.rows, key=lambda r: (natural(r), r['depth'])):
+            branches = self.iterations * r['depth']
+            base = baseline.get(r['depth'])
+            self.pattern_results.append({
+                'pattern': r['pattern'],
+                'depth': r['depth'],
+                'mispredict_rate': r['branch_misses'] / branches,
+                'extra_cycles_per_branch': (r['cycles'] - base) / branches if base is not None else None,
+            })
+            if self.verbose:
+                print(f"  {r['benchmark']}: {r['cycles']:.0f} cycles, {r['branch_misses']:.0f} misses")
+
+        print(f"✓ Misprediction penalty: {self.penalty:.2f} cycles (R²={self.r_squared:.4f})")
+
+    def print_summary(self):
+        print("\n" + "="*60)
+        print("BRANCH MISPREDICTION SUMMARY")
+        print("="*60)
+        print(f"CPU: {self.cpu}")
+        print(f"Misprediction penalty: {self.penalty:.2f} cycles (R²={self.r_squared:.4f})")
+        print(f"\n  {'pattern':<22} {'branches':>8} {'mispredict':>11} {'extra cycles':>13}")
+        for r in self.pattern_results:
+            extra = f"{r['extra_cycles_per_branch']:.2f}" if r['extra_cycles_per_branch'] is not None else 'N/A'
+            print(f"  {r['pattern']:<22} {r['depth']:>8} {r['mispredict_rate']:>11.4f} {extra:>13}")
+        print("="*60)
+
+    def save(self, output_file=None):
+        if output_file is None:
+            timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
+            output_file = f"branch_mispredict_{timestamp}.csv"
+
+        with open(output_file, 'w', newline='') as csvfile:
+            fieldnames = ['cpu', 'pattern', 'branches_per_iteration', 'mispredict_rate',
+                          'extra_cycles_per_branch', 'mispredict_penalty_cycles', 'r_squared']
+            writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
+            writer.writeheader()
+            for r in self.pattern_results:
+                extra = r['extra_cycles_per_branch']
+                writer.writerow({
+                    'cpu': self.cpu,
+                    'pattern': r['pattern'],
+                    'branches_per_iteration': r['depth'],
+                    'mispredict_rate': f"{r['mispredict_rate']:.6f}",
+                    'extra_cycles_per_branch': f"{extra:.4f}" if extra is not None else 'N/A',
+                    'mispredict_penalty_cycles': f"{self.penalty:.4f}",
+                    'r_squared': f"{self.r_squared:.4f}",
+                })
+
+        os.chmod(output_file, 0o666)
+        print(f"✓ Branch misprediction results saved to: {output_file}")
+        return output_file
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Estimate the branch misprediction penalty from the data-driven branching benchmarks",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  %(prog)s                                   # Latest benchmark_results_*.csv
+  %(prog)s --input benchmark_results_X.csv   # A specific run
+        """
+    )
+    parser.add_argument('--input', default="benchmark_results_*.csv",
+                        help='Input CSV file pattern (default: benchmark_results_*.csv)')
+    parser.add_argument('--output', help='Output CSV file for the analysis')
+    parser.add_argument('--iterations', type=int,
+                        help='Loop iterations of the run (default: from the CSV)')
+    parser.add_argument('--verbose', action='store_true', help='Enable verbose output')
+    args = parser.parse_args()
+
+    analyzer = BranchMispredictAnalyzer(verbose=args.verbose, iterations=args.iterations)
+    if not analyzer.load_csv_files(args.input):
+        return 1
+    try:
+        analyzer.analyze()
+    except ValueError as e:
+        print(f"✗ Analysis failed: {e}")
+        return 1
+    analyzer.print_summary()
+    analyzer.save(args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    exit(main())
@@ -13,6 +13,12 @@ It works by:
 2. Setting up a system of linear equations across different benchmark cases
 3. Solving for individual L1/L2/L3/memory latencies
 4. Failing explicitly when the system cannot be solved reliably
+
+The MLP, TLB and gather benchmarks (generate_mlp_benchmarks.py) do not fit
+the one-miss-at-a-time model above and are reported separately: cycles per
+step for every chain count and page size, the effective memory-level
+parallelism, the dTLB miss penalty (4K minus 2M pages) and the part of a
+random gather the prefetchers cannot hide (gather minus stream).
 """
 
 import argparse
@@ -26,6 +32,11 @@ from collections import defaultdict
 import math
 
 
+# Benchmarks of generate_mlp_benchmarks.py:
+# bench_memory_<pattern>-<size>-K<chains>-P<page>[-<depth>]
+ACCESS_PATTERNS = ('mlp', 'tlb', 'gather', 'stream')
+
+
 class MemoryLatencyAnalyzer:
     def __init__(self, verbose=False, iterations=None):
         self.verbose = verbose
@@ -33,6 +44,7 @@ class MemoryLatencyAnalyzer:
         self.benchmark_data = []
         self.regression_results = {}
         self.latency_results = {}
+        self.pattern_results = []
         
     def load_csv_files(self, pattern="memory_benchmark_results_*.csv"):
         """Load memory benchmark CSV files."""
@@ -83,6 +95,8 @@ class MemoryLatencyAnalyzer:
                 # Remove the bench_memory_ prefix
                 name_part = benchmark.replace('bench_memory_', '')
                 parts = name_part.split('-')
+                if parts[0] in ACCESS_PATTERNS:
+                    continue  # see analyze_access_patterns()
                 
                 if len(parts) >= 2:
                     operation = parts[0]      # store, load, atomic_add, etc.
@@ -558,11 +572,139 @@ class MemoryLatencyAnalyzer:
         
         return available_levels
     
+    def analyze_access_patterns(self):
+        """
+        Cycles per step of the MLP/TLB/gather benchmarks.
+
+        Each series (pattern, size, chains, page) runs at several depths, i.e.
+        steps of every chain per iteration; the slope of cycles against depth
+        divided by the iterations is the cost of one step, without the setup
+        and the loop overhead.
+        """
+        series = defaultdict(dict)
+        for result in self.benchmark_data:
+            m = re.match(r'bench_memory_(\w+)-(\w+)-K(\d+)-P(\w+?)(?:-(\d+))?$', result['benchmark'])
+            if not m or m.group(1) not in ACCESS_PATTERNS or result.get('cycles') in (None, '', 'N/A'):
+                continue
+            pattern, size, chains, page, depth = m.groups()
+            series[(pattern, size, int(chains), page)][int(depth or 1)] = float(result['cycles'])
+
+        self.pattern_results = []
+        for (pattern, size, chains, page), by_depth in sorted(series.items()):
+            if len(by_depth) < 2:
+                if self.verbose:
+                    print(f"  Skipping {pattern}-{size}-K{chains}-P{page}: need two depths")
+                continue
+            depths = sorted(by_depth)
+            slope = np.polyfit(depths, [by_depth[d] for d in depths], 1)[0]
+            step = max(slope, 0.0) / self.iterations
+            self.pattern_results.append({
+                'pattern': pattern, 'buffer_size': size, 'chains': chains, 'page_size': page,
+                'cycles_per_step': step, 'cycles_per_load': step / chains,
+            })
+
+        # Effective MLP: misses in flight, relative to the single chain
+        single = {(r['buffer_size'], r['page_size']): r['cycles_per_step']
+                  for r in self.pattern_results if r['pattern'] == 'mlp' and r['chains'] == 1}
+        for r in self.pattern_results:
+            c1 = single.get((r['buffer_size'], r['page_size']))
+            if r['pattern'] == 'mlp' and c1 and r['cycles_per_step'] > 0:
+                r['mlp'] = r['chains'] * c1 / r['cycles_per_step']
+
+        if self.pattern_results:
+            print(f"Analyzed {len(self.pattern_results)} MLP/TLB/gather series")
+        return bool(self.pattern_results)
+
+    def _pattern_cost(self, pattern, size, page):
+        for r in self.pattern_results:
+            if (r['pattern'], r['buffer_size'], r['page_size']) == (pattern, size, page):
+                return r['cycles_per_load']
+        return None
+
+    def print_access_patterns(self):
+        """Print the MLP, dTLB and gather tables."""
+        if not self.pattern_results:
+            return
+
+        print("\n" + "="*60)
+        print("MEMORY-LEVEL PARALLELISM, TLB AND GATHER")
+        print("="*60)
+
+        mlp = [r for r in self.pattern_results if r['pattern'] == 'mlp']
+        if mlp:
+            print(f"\nIndependent pointer chains ({mlp[0]['buffer_size']} buffer):")
+            print(f"  {'page':>5} {'chains':>6} {'cycles/step':>12} {'cycles/load':>12} {'MLP':>6}")
+            for r in sorted(mlp, key=lambda r: (r['page_size'], r['chains'])):
+                m = f"{r['mlp']:.2f}" if 'mlp' in r else 'N/A'
+                print(f"  {r['page_size']:>5} {r['chains']:>6} {r['cycles_per_step']:>12.2f} "
+                      f"{r['cycles_per_load']:>12.2f} {m:>6}")
+
+        tlb_sizes = sorted({r['buffer_size'] for r in self.pattern_results if r['pattern'] == 'tlb'},
+                           key=self._size_bytes)
+        if tlb_sizes:
+            print("\nOne line per 4K page (cycles/load):")
+            print(f"  {'span':>8} {'4K pages':>10} {'2M pages':>10} {'dTLB miss':>10}")
+            for size in tlb_sizes:
+                small, huge = self._pattern_cost('tlb', size, '4K'), self._pattern_cost('tlb', size, '2M')
+                penalty = f"{small - huge:.2f}" if small is not None and huge is not None else 'N/A'
+                print(f"  {size:>8} {self._fmt(small):>10} {self._fmt(huge):>10} {penalty:>10}")
+
+        gather_keys = sorted({(r['buffer_size'], r['page_size']) for r in self.pattern_results
+                              if r['pattern'] in ('gather', 'stream')},
+                             key=lambda k: (self._size_bytes(k[0]), k[1]))
+        if gather_keys:
+            print("\nFlow-table sized loads (cycles/load):")
+            print(f"  {'table':>8} {'page':>5} {'hashed':>8} {'linear':>8} {'not prefetched':>15}")
+            for size, page in gather_keys:
+                rand, seq = self._pattern_cost('gather', size, page), self._pattern_cost('stream', size, page)
+                hidden = f"{rand - seq:.2f}" if rand is not None and seq is not None else 'N/A'
+                print(f"  {size:>8} {page:>5} {self._fmt(rand):>8} {self._fmt(seq):>8} {hidden:>15}")
+
+    @staticmethod
+    def _fmt(value):
+        return f"{value:.2f}" if value is not None else 'N/A'
+
+    @staticmethod
+    def _size_bytes(size):
+        m = re.match(r'(\d+)([KMG]?B)', size)
+        return int(m.group(1)) * {'B': 1, 'KB': 1 << 10, 'MB': 1 << 20, 'GB': 1 << 30}[m.group(2)] if m else 0
+
+    def save_access_patterns(self, output_file=None):
+        """Save the MLP/TLB/gather results to CSV."""
+        if not self.pattern_results:
+            return None
+        if output_file is None:
+            timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
+            output_file = f"memory_access_patterns_{timestamp}.csv"
+
+        with open(output_file, 'w', newline='') as csvfile:
+            fieldnames = ['pattern', 'buffer_size', 'page_size', 'chains',
+                          'cycles_per_step', 'cycles_per_load', 'mlp']
+            writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
+            writer.writeheader()
+            for r in self.pattern_results:
+                writer.writerow({
+                    'pattern': r['pattern'],
+                    'buffer_size': r['buffer_size'],
+                    'page_size': r['page_size'],
+                    'chains': r['chains'],
+                    'cycles_per_step': f"{r['cycles_per_step']:.4f}",
+                    'cycles_per_load': f"{r['cycles_per_load']:.4f}",
+                    'mlp': f"{r['mlp']:.4f}" if 'mlp' in r else 'N/A'
+                })
+
+        os.chmod(output_file, 0o666)
+        print(f"✓ MLP/TLB/gather results saved to: {output_file}")
+        return output_file
+
     def analyze_all_groups(self):
         """Analyze all benchmark groups using comprehensive linear regression."""
+        self.analyze_access_patterns()
         groups = self.group_benchmarks_by_type()
         
         if not groups:
+            if self.pattern_results:
+                return
             raise ValueError("No benchmark groups found")
             
         print(f"Found {len(groups)} benchmark groups to analyze")
@@ -601,8 +743,10 @@ class MemoryLatencyAnalyzer:
     
     def save_latency_analysis(self, output_file=None):
         """Save latency analysis results to CSV."""
+        self.save_access_patterns()
         if not self.latency_results:
-            print("No latency results to save")
+            if not self.pattern_results:
+                print("No latency results to save")
             return
             
         if output_file is None:
@@ -635,8 +779,10 @@ class MemoryLatencyAnalyzer:
     
     def print_summary(self):
         """Print analysis summary for comprehensive regression results"""
+        self.print_access_patterns()
         if not hasattr(self, 'latency_results') or not self.latency_results:
-            print("No latency analysis results available")
+            if not self.pattern_results:
+                print("No latency analysis results available")
             return
         
         results = self.latency_results
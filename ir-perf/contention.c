@@ -0,0 +1,82 @@
+// Contending thread for templates/atomic-contended.ll: bench_loop calls
+// contention_start before its loop and contention_stop after it; in between
+// the thread keeps adding to the same word from another core, so every
+// atomic of the loop first has to take the cache line back.
+//
+// The thread runs on IR_PERF_CONTENDER_CPU when it is set, otherwise on the
+// CPU after the one bench_loop runs on. run_benchmarks.py measures these
+// benchmarks with perf stat --no-inherit, which counts the loop's thread
+// only.
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static pthread_t contender;
+static long *contended;
+static int running;
+static int stop;
+
+static void *contend(void *arg) {
+    (void)arg;
+    __atomic_store_n(&running, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(contended, 1, __ATOMIC_SEQ_CST);
+    }
+    return NULL;
+}
+
+static int contender_cpu(void) {
+    const char *env = getenv("IR_PERF_CONTENDER_CPU");
+    if (env != NULL) {
+        return atoi(env);
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 2) {
+        fprintf(stderr, "contention_start: one CPU online, the contender shares it\n");
+        return -1;
+    }
+    return (sched_getcpu() + 1) % (int)cpus;
+}
+
+void contention_start(long *word) {
+    contended = word;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    int cpu = contender_cpu();
+    if (cpu >= 0) {
+        // The thread starts with the affinity of the benchmark (taskset),
+        // which is only the benchmark's own CPU
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+    int err = pthread_create(&contender, &attr, contend, NULL);
+    if (err != 0 && cpu >= 0) {
+        fprintf(stderr, "contention_start: CPU %d: %s; not pinning the contender\n", cpu, strerror(err));
+        pthread_attr_destroy(&attr);
+        pthread_attr_init(&attr);
+        err = pthread_create(&contender, &attr, contend, NULL);
+    }
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        fprintf(stderr, "contention_start: pthread_create: %s\n", strerror(err));
+        exit(1);
+    }
+
+    // Contended from the first iteration on
+    while (!__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+}
+
+void contention_stop(void) {
+    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+    pthread_join(contender, NULL);
+}
@@ -34,6 +34,15 @@ template_configs = {
     },
     "alloca": {
         "template_file": "templates/alloca.ll"
+    },
+    "vector": {
+        "template_file": "templates/vector.ll"
+    },
+    "atomic": {
+        "template_file": "templates/atomic.ll"
+    },
+    "atomic-contended": {
+        "template_file": "templates/atomic-contended.ll"
     }
 }
 
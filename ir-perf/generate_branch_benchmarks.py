@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Generate Data-Driven Branch Predictability Benchmarks
+
+The branching snippets take their conditions from bits of the loop counter,
+which the predictor learns. Here every branch condition is read from a bit
+array generated with a controlled pattern, so the only difference between
+two benchmarks is how predictable the branch is:
+
+  data-random-p<P>      taken with probability P% (independent draws);
+                        p0 is never taken and is the baseline
+  data-alternating      taken, not taken, ...
+  data-periodic-<N>     a random pattern of N outcomes (half taken),
+                        repeated; predictors learn it up to some N
+
+The array holds PATTERN_BITS outcomes, more than a predictor can memorize,
+and is read sequentially (it stays in L1/L2). Each benchmark is generated
+with 1, 2 and 4 branches per iteration, each on the next bit, named like the
+snippets: bench_branching_data-random-p50, ...-2, ...-4.
+
+The loops are identical apart from the array, so cycles against branch
+misses across all of them gives the misprediction penalty
+(analyze_branch_mispredict.py).
+
+Usage: generate_branch_benchmarks.py <output_dir>
+
+Writes the .ll files and branch_benchmarks.cmake (BRANCH_BENCHMARK_FILES).
+"""
+
+import random
+import sys
+from pathlib import Path
+
+PATTERN_BITS = 1 << 16
+WORDS = PATTERN_BITS // 64
+DEPTHS = (1, 2, 4)
+
+TAKEN_PERCENT = (0, 1, 5, 10, 25, 50)
+PERIODS = (4, 16, 64, 256, 1024, 4096)
+
+SEED = 0x5eed
+
+
+def random_bits(percent, rng):
+    return [rng.random() * 100 < percent for _ in range(PATTERN_BITS)]
+
+
+def periodic_bits(period, rng):
+    # Exactly half taken, so only the period changes between benchmarks
+    one_period = [True] * (period // 2) + [False] * (period - period // 2)
+    rng.shuffle(one_period)
+    return [one_period[i % period] for i in range(PATTERN_BITS)]
+
+
+def patterns():
+    rng = random.Random(SEED)
+    result = {}
+    for p in TAKEN_PERCENT:
+        result[f"data-random-p{p}"] = random_bits(p, rng)
+    result["data-alternating"] = [i % 2 == 0 for i in range(PATTERN_BITS)]
+    for n in PERIODS:
+        result[f"data-periodic-{n}"] = periodic_bits(n, rng)
+    return result
+
+
+def pack(bits):
+    words = []
+    for w in range(WORDS):
+        value = 0
+        for b in range(64):
+            if bits[w * 64 + b]:
+                value |= 1 << b
+        words.append(value - (1 << 64) if value >= 1 << 63 else value)
+    return words
+
+
+def emit_module(name, bits, depth):
+    taken = sum(bits)
+    lines = ["; Generated by generate_branch_benchmarks.py, do not edit",
+             f"; {name}: {taken} of {PATTERN_BITS} taken, {depth} branches per iteration",
+             "declare void @sink(i64)",
+             "",
+             f"@pattern = private constant [{WORDS} x i64] [",
+             ",\n".join(f"  i64 {w}" for w in pack(bits)),
+             "]",
+             "",
+             "define void @bench_loop(i64 %N) {",
+             "entry:",
+             "  br label %loop",
+             "",
+             "loop:",
+             f"  %iv = phi i64 [ 0, %entry ], [ %next_iv, %merge{depth - 1} ]",
+             f"  %acc0 = phi i64 [ 0, %entry ], [ %acc{depth}, %merge{depth - 1} ]",
+             f"  %base = mul i64 %iv, {depth}"]
+    for j in range(depth):
+        lines += [f"  %i{j} = add i64 %base, {j}",
+                  f"  %bit{j} = and i64 %i{j}, {PATTERN_BITS - 1}",
+                  f"  %w{j} = lshr i64 %bit{j}, 6",
+                  f"  %wp{j} = getelementptr [{WORDS} x i64], [{WORDS} x i64]* @pattern, i64 0, i64 %w{j}",
+                  f"  %word{j} = load i64, i64* %wp{j}",
+                  f"  %sh{j} = and i64 %bit{j}, 63",
+                  f"  %v{j} = lshr i64 %word{j}, %sh{j}",
+                  f"  %b{j} = and i64 %v{j}, 1",
+                  f"  %c{j} = icmp ne i64 %b{j}, 0",
+                  f"  br i1 %c{j}, label %taken{j}, label %not_taken{j}",
+                  "",
+                  f"taken{j}:",
+                  f"  %t{j} = add i64 %acc{j}, 3",
+                  f"  br label %merge{j}",
+                  "",
+                  f"not_taken{j}:",
+                  f"  %n{j} = add i64 %acc{j}, 5",
+                  f"  br label %merge{j}",
+                  "",
+                  f"merge{j}:",
+                  f"  %acc{j + 1} = phi i64 [ %t{j}, %taken{j} ], [ %n{j}, %not_taken{j} ]"]
+    lines += ["  %next_iv = add i64 %iv, 1",
+              "  %done = icmp eq i64 %next_iv, %N",
+              "  br i1 %done, label %exit, label %loop",
+              "",
+              "exit:",
+              f"  call void @sink(i64 %acc{depth})",
+              "  ret void",
+              "}",
+              ""]
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python3 generate_branch_benchmarks.py <output_dir>")
+        return 1
+
+    output_dir = Path(sys.argv[1])
+    output_dir.mkdir(parents=True, exist_ok=True)
+
+    generated = []
+    for name, bits in patterns().items():
+        for depth in DEPTHS:
+            filename = f"{name}.ll" if depth == 1 else f"{name}-{depth}.ll"
+            (output_dir / filename).write_text(emit_module(name, bits, depth))
+            generated.append(filename)
+
+    with open(output_dir / "branch_benchmarks.cmake", 'w') as f:
+        f.write("# Generated by generate_branch_benchmarks.py\n")
+        f.write("set(BRANCH_BENCHMARK_FILES\n")
+        for filename in generated:
+            f.write(f"    {filename}\n")
+        f.write(")\n")
+
+    print(f"Generated {len(generated)} branch predictability benchmarks")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
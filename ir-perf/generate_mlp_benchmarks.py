@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""
+Generate Memory-Level-Parallelism, TLB and Gather Benchmarks
+
+The load latency benchmarks (generate_load_benchmarks.py) chase a single
+pointer chain, so they only ever have one miss in flight. The loops
+generated here measure what the map and dchain lookups of large flow tables
+actually see:
+
+  mlp     K independent random pointer chains over a buffer well beyond the
+          LLC; cycles per step against K shows how many misses overlap
+  tlb     one random pointer chain touching one line per page, over more
+          pages than the dTLB reaches; 4K against 2M pages gives the cost of
+          a dTLB miss (the lines themselves stay in L2/L3)
+  gather  independent loads at hashed (multiplicative hash) slots of a
+          table sized like a flow table, one 64-byte entry per flow
+  stream  the same loads at consecutive slots, which the prefetchers cover;
+          gather minus stream is what they cannot hide
+
+Every benchmark exists for 4K and 2M pages (mem_alloc in mem-setup.c uses
+hugetlbfs or madvise) and at two depths, 1 and 2 steps of every chain per
+iteration, so the setup and loop overhead cancel in analyze_memory_latency.py.
+
+Executables are named bench_memory_<pattern>-<size>-K<chains>-P<page>[-<depth>],
+e.g. bench_memory_mlp-64MB-K8-P2M-2.
+
+Usage: generate_mlp_benchmarks.py <output_dir>
+
+Writes the .ll files and mlp_benchmarks.cmake (MLP_BENCHMARK_FILES).
+"""
+
+import re
+import sys
+from pathlib import Path
+
+from generate_load_benchmarks import read_cache_info
+
+CHAINS = (1, 2, 3, 4, 6, 8, 10, 12, 14, 16)
+DEPTHS = (1, 2)
+PAGES = {'4K': 4096, '2M': 2 << 20}
+
+# Flow tables of 64K and 1M flows, one 64-byte entry each
+FLOW_TABLE_SIZES = (64 * 1024 * 64, 1024 * 1024 * 64)
+ENTRY_SIZE = 64
+
+# dTLB reach: 512 pages stay within the STLB of current cores (L1 dTLB
+# misses only), 16K pages miss it too and walk the page table
+TLB_PAGES = (512, 16384)
+
+GOLDEN = 0x9E3779B97F4A7C15
+
+
+def size_label(size):
+    for unit, scale in (('GB', 1 << 30), ('MB', 1 << 20), ('KB', 1 << 10)):
+        if size >= scale and size % scale == 0:
+            return f"{size // scale}{unit}"
+    return f"{size}B"
+
+
+def parse_cache_size(size):
+    m = re.match(r'(\d+)([KMG]?)', size)
+    num, unit = int(m.group(1)), m.group(2)
+    return num * {'': 1, 'K': 1 << 10, 'M': 1 << 20, 'G': 1 << 30}[unit]
+
+
+def signed64(value):
+    return value - (1 << 64) if value >= 1 << 63 else value
+
+
+def emit_chase(chains, depth, bytes_, node_stride, page_size, comment):
+    lines = [f"; Generated by generate_mlp_benchmarks.py, do not edit",
+             f"; {comment}",
+             f"; {chains} chains, {depth} steps per chain per iteration, "
+             f"node every {node_stride} bytes, {page_size}-byte pages",
+             "declare void @sink(i64)",
+             "declare i8* @mem_alloc(i64, i64)",
+             "declare void @mem_chase_init(i8*, i64, i64, i64, i8**)",
+             "",
+             "define void @bench_loop(i64 %N) {",
+             "entry:",
+             f"  %heads = alloca [{chains} x i8*]",
+             f"  %buf = call i8* @mem_alloc(i64 {bytes_}, i64 {page_size})",
+             f"  %h0 = getelementptr [{chains} x i8*], [{chains} x i8*]* %heads, i64 0, i64 0",
+             f"  call void @mem_chase_init(i8* %buf, i64 {bytes_}, i64 {node_stride}, "
+             f"i64 {chains}, i8** %h0)"]
+    for c in range(chains):
+        if c:
+            lines.append(f"  %h{c} = getelementptr [{chains} x i8*], [{chains} x i8*]* %heads, "
+                         f"i64 0, i64 {c}")
+        lines.append(f"  %start{c} = load i8*, i8** %h{c}")
+    lines += ["  br label %loop",
+              "",
+              "loop:",
+              "  %iv = phi i64 [ 0, %entry ], [ %next_iv, %loop ]"]
+    for c in range(chains):
+        lines.append(f"  %p{c}.0 = phi i8* [ %start{c}, %entry ], [ %p{c}.{depth}, %loop ]")
+    # Interleave the chains, so that their loads issue back to back
+    for d in range(depth):
+        for c in range(chains):
+            lines.append(f"  %a{c}.{d} = bitcast i8* %p{c}.{d} to i8**")
+            lines.append(f"  %p{c}.{d + 1} = load i8*, i8** %a{c}.{d}")
+    lines += ["  %next_iv = add i64 %iv, 1",
+              "  %done = icmp eq i64 %next_iv, %N",
+              "  br i1 %done, label %exit, label %loop",
+              "",
+              "exit:",
+              f"  %acc0 = ptrtoint i8* %p0.{depth} to i64"]
+    for c in range(1, chains):
+        lines.append(f"  %x{c} = ptrtoint i8* %p{c}.{depth} to i64")
+        lines.append(f"  %acc{c} = xor i64 %acc{c - 1}, %x{c}")
+    lines += [f"  call void @sink(i64 %acc{chains - 1})",
+              "  ret void",
+              "}",
+              ""]
+    return "\n".join(lines)
+
+
+def emit_gather(hashed, depth, bytes_, page_size):
+    slots = bytes_ // ENTRY_SIZE
+    shift = 64 - (slots.bit_length() - 1)
+    order = f"slot = (i * {GOLDEN:#x}) >> {shift}" if hashed else f"slot = i & {slots - 1}"
+    lines = [f"; Generated by generate_mlp_benchmarks.py, do not edit",
+             f"; {slots} entries of {ENTRY_SIZE} bytes, {order}",
+             f"; {depth} loads per iteration, {page_size}-byte pages",
+             "declare void @sink(i64)",
+             "declare i8* @mem_alloc(i64, i64)",
+             "",
+             "define void @bench_loop(i64 %N) {",
+             "entry:",
+             f"  %buf = call i8* @mem_alloc(i64 {bytes_}, i64 {page_size})",
+             "  br label %loop",
+             "",
+             "loop:",
+             "  %iv = phi i64 [ 0, %entry ], [ %next_iv, %loop ]",
+             "  %acc.0 = phi i64 [ 0, %entry ], [ %acc.{0}, %loop ]".format(depth),
+             f"  %base = mul i64 %iv, {depth}"]
+    for j in range(depth):
+        lines.append(f"  %i{j} = add i64 %base, {j}")
+        if hashed:
+            lines.append(f"  %h{j} = mul i64 %i{j}, {signed64(GOLDEN)}")
+            lines.append(f"  %s{j} = lshr i64 %h{j}, {shift}")
+        else:
+            lines.append(f"  %s{j} = and i64 %i{j}, {slots - 1}")
+        lines += [f"  %o{j} = shl i64 %s{j}, {ENTRY_SIZE.bit_length() - 1}",
+                  f"  %e{j} = getelementptr i8, i8* %buf, i64 %o{j}",
+                  f"  %q{j} = bitcast i8* %e{j} to i64*",
+                  f"  %v{j} = load i64, i64* %q{j}",
+                  f"  %acc.{j + 1} = add i64 %acc.{j}, %v{j}"]
+    lines += ["  %next_iv = add i64 %iv, 1",
+              "  %done = icmp eq i64 %next_iv, %N",
+              "  br i1 %done, label %exit, label %loop",
+              "",
+              "exit:",
+              f"  call void @sink(i64 %acc.{depth})",
+              "  ret void",
+              "}",
+              ""]
+    return "\n".join(lines)
+
+
+def bench_name(pattern, size, chains, page, depth):
+    name = f"{pattern}-{size_label(size)}-K{chains}-P{page}"
+    return name if depth == 1 else f"{name}-{depth}"
+
+
+def generate_benchmarks(cache_info, output_dir):
+    output_dir = Path(output_dir)
+    output_dir.mkdir(parents=True, exist_ok=True)
+    line = cache_info['line_size']
+    generated = []
+
+    def write(name, text):
+        (output_dir / f"{name}.ll").write_text(text)
+        generated.append(f"{name}.ll")
+
+    # Well beyond the LLC, and at least a million-flow table
+    mlp_size = max(8 * parse_cache_size(cache_info['L3']), FLOW_TABLE_SIZES[-1])
+    for page, page_size in PAGES.items():
+        for chains in CHAINS:
+            for depth in DEPTHS:
+                write(bench_name('mlp', mlp_size, chains, page, depth),
+                      emit_chase(chains, depth, mlp_size, line, page_size,
+                                 "Independent random pointer chains"))
+
+        # One line per 4K page; the extra line of stride spreads the nodes
+        # over the cache sets
+        for pages in TLB_PAGES:
+            stride = PAGES['4K'] + line
+            for depth in DEPTHS:
+                write(bench_name('tlb', pages * PAGES['4K'], 1, page, depth),
+                      emit_chase(1, depth, pages * stride, stride, page_size,
+                                 f"One line in each of {pages} 4K pages"))
+
+        for size in FLOW_TABLE_SIZES:
+            for pattern, hashed in (('gather', True), ('stream', False)):
+                for depth in DEPTHS:
+                    write(bench_name(pattern, size, 1, page, depth),
+                          emit_gather(hashed, depth, size, page_size))
+    return generated
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python3 generate_mlp_benchmarks.py <output_dir>")
+        return 1
+
+    output_dir = Path(sys.argv[1])
+    cache_info = read_cache_info()
+    generated = generate_benchmarks(cache_info, output_dir)
+
+    with open(output_dir / "mlp_benchmarks.cmake", 'w') as f:
+        f.write("# Generated by generate_mlp_benchmarks.py\n")
+        f.write("set(MLP_BENCHMARK_FILES\n")
+        for filename in generated:
+            f.write(f"    {filename}\n")
+        f.write(")\n")
+
+    print(f"Generated {len(generated)} MLP/TLB/gather benchmarks")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""
+Generate Opcode Latency/Throughput Benchmarks
+
+Reads the LLVM opcode names from operators.txt and, for every opcode that
+can be measured as straight-line register code, emits an LLVM IR module
+with four loops:
+
+  lat_<op>_<U1>, lat_<op>_<U2>    one dependent chain of U ops per iteration
+  tput_<op>_<U1>, tput_<op>_<U2>  STREAMS independent chains, U ops in total
+
+The driver (opcode-driver.c) runs both depths and takes the difference, so
+the loop counter, compare and branch cancel out:
+
+  cycles/op = (cycles(U2) - cycles(U1)) / ((U2 - U1) * N)
+
+which is the latency for the lat_ loops and the reciprocal throughput for
+the tput_ loops. The second operand of every op is loaded (volatile) from a
+global at function entry, so llc can neither constant-fold nor reassociate
+the chain.
+
+Usage: generate_opcode_benchmarks.py <operators.txt> <output_dir>
+
+Writes <output_dir>/opcode_<name>.ll, opcode_registry.c (the table the
+driver iterates) and opcode_benchmarks.cmake (OPCODE_BENCHMARK_FILES).
+"""
+
+import re
+import sys
+from pathlib import Path
+
+# Ops per loop iteration at the two depths; the tput_ loops split them over
+# STREAMS chains, so both must be multiples of it
+DEPTHS = (16, 32)
+STREAMS = 8
+
+# Each step takes its second operand from NK values loaded (volatile) at
+# function entry, in rotation, so that no two adjacent steps share it and
+# llc cannot fold idempotent pairs such as select(c, select(c, x, k), k)
+NK = 4
+
+# One chain step per opcode: {x} is the chain value, {y} the next one, {k}
+# this step's loop-invariant operand ({kc}: the same as i1, {ki}: as i64),
+# {t} a prefix for temporaries and {p} the chain's own i64 slot in memory.
+#   type:  chain value type
+#   init:  starting value of the chain (stream s starts at init + s)
+#   k:     operand value; chosen so the chain neither overflows nor
+#          collapses to a constant (e.g. udiv by 1 keeps a 64-bit quotient)
+#   name:  what the step measures, when it is more than the opcode
+#   minus: opcode whose result the driver subtracts, for steps that need
+#          an extra op to stay on the chain (conversions and compares that
+#          would otherwise fold away)
+#   slot:  the step uses {p}; every chain gets a cache line of its own, so
+#          the atomics are uncontended (templates/atomic-contended.ll
+#          measures them contended)
+I64_BINOPS = {
+    'add': 1, 'sub': 1, 'mul': 1, 'udiv': 1, 'sdiv': 1,
+    'urem': 0x7fffffffffffffff, 'srem': 0x7fffffffffffffff,
+    'shl': 1, 'lshr': 1, 'ashr': 1, 'and': -1, 'or': 0, 'xor': 0,
+}
+F64_BINOPS = {'fadd': 1.0, 'fsub': 1.0, 'fmul': 1.0, 'fdiv': 1.0, 'frem': 1e300}
+
+OPCODES = {}
+for _op, _k in I64_BINOPS.items():
+    OPCODES[_op] = {'type': 'i64', 'init': 0x123456789, 'k': _k,
+                    'step': ['{y} = ' + _op + ' i64 {x}, {k}']}
+for _op, _k in F64_BINOPS.items():
+    OPCODES[_op] = {'type': 'double', 'init': 1.5, 'k': _k,
+                    'step': ['{y} = ' + _op + ' double {x}, {k}']}
+
+
+def _ext_round_trip(narrow, ext):
+    return {'type': 'i64', 'init': 1, 'k': 1, 'minus': 'add',
+            'step': ['{t}t = trunc i64 {x} to ' + narrow,
+                     '{t}e = ' + ext + ' ' + narrow + ' {t}t to i64',
+                     '{y} = add i64 {t}e, {k}'],
+            'name': f'trunc+{ext}.{narrow}'}
+
+
+OPCODES.update({
+    # llc folds fadd (fneg x), k into fsub k, x; the empty asm takes the
+    # negated value in a register and emits nothing, so the fneg stays
+    'fneg': {'type': 'double', 'init': 1.5, 'k': 1.0, 'minus': 'fadd',
+             'step': ['{t}n = fneg double {x}',
+                      '{t}o = call double asm "", "=x,0"(double {t}n)',
+                      '{y} = fadd double {t}o, {k}'],
+             'name': 'fneg+fadd'},
+    'select': {'type': 'i64', 'init': 1, 'k': 2,
+               'step': ['{y} = select i1 {kc}, i64 {x}, i64 {k}']},
+    'freeze': {'type': 'i64', 'init': 1, 'k': 1, 'minus': 'add',
+               'step': ['{t}f = freeze i64 {x}', '{y} = add i64 {t}f, {k}'],
+               'name': 'freeze'},
+    'icmp': {'type': 'i64', 'init': 1, 'k': 2, 'minus': 'add',
+             'step': ['{t}c = icmp ult i64 {x}, {k}',
+                      '{t}z = zext i1 {t}c to i64',
+                      '{y} = add i64 {x}, {t}z'],
+             'name': 'icmp+zext'},
+    'fcmp': {'type': 'double', 'init': 1.5, 'k': 2.0,
+             'step': ['{t}c = fcmp olt double {x}, {k}',
+                      '{y} = select i1 {t}c, double {x}, double {k}'],
+             'name': 'fcmp+select'},
+    'trunc': _ext_round_trip('i32', 'sext'),
+    'zext': _ext_round_trip('i16', 'zext'),
+    'sext': _ext_round_trip('i8', 'sext'),
+    'fptrunc': {'type': 'double', 'init': 1.5, 'k': 1.0, 'minus': 'fadd',
+                'step': ['{t}t = fptrunc double {x} to float',
+                         '{t}e = fpext float {t}t to double',
+                         '{y} = fadd double {t}e, {k}'],
+                'name': 'fptrunc+fpext'},
+    'fptosi': {'type': 'double', 'init': 1.5, 'k': 0.0,
+               'step': ['{t}i = fptosi double {x} to i64', '{y} = sitofp i64 {t}i to double'],
+               'name': 'fptosi+sitofp'},
+    'fptoui': {'type': 'double', 'init': 1.5, 'k': 0.0,
+               'step': ['{t}i = fptoui double {x} to i64', '{y} = uitofp i64 {t}i to double'],
+               'name': 'fptoui+uitofp'},
+    'bitcast': {'type': 'double', 'init': 1.5, 'k': 0.0, 'minus': 'add',
+                'step': ['{t}i = bitcast double {x} to i64',
+                         '{t}a = add i64 {t}i, {ki}',
+                         '{y} = bitcast i64 {t}a to double'],
+                'name': 'bitcast.f64+i64'},
+    'atomicrmw': {'type': 'i64', 'init': 0, 'k': 1, 'minus': 'add', 'slot': True,
+                  'step': ['{t}o = atomicrmw add i64* {p}, i64 {x} seq_cst',
+                           '{y} = add i64 {t}o, {k}'],
+                  'name': 'atomicrmw.add+add'},
+    'cmpxchg': {'type': 'i64', 'init': 0, 'k': 1, 'minus': 'add', 'slot': True,
+                'step': ['{t}n = add i64 {x}, {k}',
+                         '{t}r = cmpxchg i64* {p}, i64 {x}, i64 {t}n seq_cst seq_cst',
+                         '{y} = extractvalue {{ i64, i1 }} {t}r, 0'],
+                'name': 'cmpxchg+add'},
+    'fence': {'type': 'i64', 'init': 0, 'k': 1, 'minus': 'add',
+              'step': ['fence seq_cst', '{y} = add i64 {x}, {k}'],
+              'name': 'fence.seq_cst+add'},
+    'getelementptr': {'type': 'i64', 'init': 0, 'k': 8,
+                      'step': ['{t}p = inttoptr i64 {x} to i8*',
+                               '{t}q = getelementptr i8, i8* {t}p, i64 {k}',
+                               '{y} = ptrtoint i8* {t}q to i64']},
+})
+
+
+def read_opcodes(operators_file):
+    """Opcode names in the order operators.txt lists them."""
+    return re.findall(r'case\s+\w+\s*:\s*return\s+"([a-z_]+)";', Path(operators_file).read_text())
+
+
+def ir_const(type_, value):
+    if type_ == 'double':
+        return f"{float(value):e}"
+    return str(value)
+
+
+def emit_loop(fn, spec, chains, depth):
+    """One bench loop: `chains` independent chains of depth/chains steps."""
+    type_ = spec['type']
+    init = spec['init']
+    lines = [f"define void @{fn}(i64 %N) {{",
+             "entry:",
+             ]
+    for j in range(NK):
+        lines.append(f"  %kp{j} = getelementptr [{NK} x {type_}], [{NK} x {type_}]* @k.{spec['op']}, i64 0, i64 {j}")
+        lines.append(f"  %k{j} = load volatile {type_}, {type_}* %kp{j}")
+        if type_ == 'i64':
+            lines.append(f"  %kc{j} = icmp ne i64 %k{j}, 0")
+        else:
+            lines.append(f"  %ki{j} = bitcast double %k{j} to i64")
+    if spec.get('slot'):
+        for c in range(chains):
+            lines.append(f"  %p{c} = getelementptr [{STREAMS} x [8 x i64]], "
+                         f"[{STREAMS} x [8 x i64]]* @a.{spec['op']}, i64 0, i64 {c}, i64 0")
+    lines += ["  br label %loop",
+             "",
+             "loop:",
+             "  %iv = phi i64 [ 0, %entry ], [ %next_iv, %loop ]"]
+    for c in range(chains):
+        lines.append(f"  %x{c}.0 = phi {type_} [ {ir_const(type_, init + c)}, %entry ], "
+                     f"[ %x{c}.{depth // chains}, %loop ]")
+    # Interleave the chains, so that independent ops are adjacent
+    for d in range(depth // chains):
+        for c in range(chains):
+            x, y, t = f"%x{c}.{d}", f"%x{c}.{d + 1}", f"%s{c}.{d}."
+            for step in spec['step']:
+                j = d % NK
+                lines.append("  " + step.format(x=x, y=y, t=t, k=f'%k{j}', kc=f'%kc{j}', ki=f'%ki{j}',
+                                                p=f'%p{c}'))
+    lines += ["  %next_iv = add i64 %iv, 1",
+              "  %done = icmp eq i64 %next_iv, %N",
+              "  br i1 %done, label %exit, label %loop",
+              "",
+              "exit:"]
+    # Every chain reaches the sink, or llc drops the ones that do not
+    acc = f"%x0.{depth // chains}"
+    for c in range(1, chains):
+        op = 'add' if type_ == 'i64' else 'fadd'
+        lines.append(f"  %sum{c} = {op} {type_} {acc}, %x{c}.{depth // chains}")
+        acc = f"%sum{c}"
+    if type_ == 'double':
+        lines.append(f"  %out = bitcast double {acc} to i64")
+        acc = "%out"
+    lines += [f"  call void @sink(i64 {acc})",
+              "  ret void",
+              "}",
+              ""]
+    return "\n".join(lines)
+
+
+def emit_module(spec):
+    op = spec['op']
+    parts = ["; Generated by generate_opcode_benchmarks.py, do not edit",
+             "declare void @sink(i64)",
+             "",
+             f"@k.{op} = global [{NK} x {spec['type']}] ["
+             + ", ".join([f"{spec['type']} {ir_const(spec['type'], spec['k'])}"] * NK) + "]",
+             ""]
+    if spec.get('slot'):
+        parts += [f"@a.{op} = global [{STREAMS} x [8 x i64]] zeroinitializer, align 64", ""]
+    for depth in DEPTHS:
+        parts.append(emit_loop(f"lat_{op}_{depth}", spec, 1, depth))
+        parts.append(emit_loop(f"tput_{op}_{depth}", spec, STREAMS, depth))
+    return "\n".join(parts)
+
+
+def emit_registry(specs):
+    lines = ["/* Generated by generate_opcode_benchmarks.py, do not edit */",
+             '#include <stddef.h>',
+             '#include "opcode-driver.h"',
+             ""]
+    for spec in specs:
+        for mode in ('lat', 'tput'):
+            for depth in DEPTHS:
+                lines.append(f"extern void {mode}_{spec['op']}_{depth}(long N);")
+    lines += ["",
+              f"const unsigned opcode_depths[2] = {{ {DEPTHS[0]}, {DEPTHS[1]} }};",
+              "",
+              "const struct opcode_bench opcode_benchmarks[] = {"]
+    for spec in specs:
+        s = spec['op']
+        minus = f'"{spec["minus"]}"' if 'minus' in spec else 'NULL'
+        lines.append(f'    {{ "{s}", "{spec.get("name", s)}", "{spec["type"]}", {minus}, '
+                     f'{{ lat_{s}_{DEPTHS[0]}, lat_{s}_{DEPTHS[1]} }}, '
+                     f'{{ tput_{s}_{DEPTHS[0]}, tput_{s}_{DEPTHS[1]} }} }},')
+    lines += ["    { 0 }",
+              "};",
+              ""]
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} <operators.txt> <output_dir>")
+        sys.exit(1)
+
+    output_dir = Path(sys.argv[2])
+    output_dir.mkdir(parents=True, exist_ok=True)
+
+    specs = []
+    skipped = []
+    for op in read_opcodes(sys.argv[1]):
+        if op not in OPCODES:
+            skipped.append(op)
+            continue
+        spec = dict(OPCODES[op], op=op)
+        specs.append(spec)
+        (output_dir / f"opcode_{op}.ll").write_text(emit_module(spec))
+
+    (output_dir / "opcode_registry.c").write_text(emit_registry(specs))
+    with open(output_dir / "opcode_benchmarks.cmake", 'w') as f:
+        f.write("# Generated by generate_opcode_benchmarks.py\n")
+        f.write("set(OPCODE_BENCHMARK_FILES\n")
+        for spec in specs:
+            f.write(f"    opcode_{spec['op']}.ll\n")
+        f.write(")\n")
+
+    print(f"Generated {len(specs)} opcode benchmarks")
+    # Control flow, memory, calls and aggregates have their own templates
+    print(f"No straight-line chain for: {' '.join(skipped)}")
+
+
+if __name__ == "__main__":
+    main()
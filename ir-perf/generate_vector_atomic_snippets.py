@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+Generate the Vector and Atomic Snippets
+
+Writes the snippets of the vector and atomic templates, at the usual depths
+(1, 2 and 4 ops per iteration, named <snippet>, <snippet>-2, <snippet>-4):
+
+  snippets/vector/<op>-<elem>-v<W>   W = 128, 256, 512 bit vectors
+      add, mul, and, icmp-eq (with the sext of its mask), shufflevector
+      (lane reversal), extract-insert (high lane into lane 0), gather and
+      scatter (llvm.masked.*, with their index arithmetic) on i32; add on
+      i64; fadd, fmul on double
+  snippets/atomic/<op>                 atomics on one shared word
+      atomicrmw add/or/xchg, cmpxchg, atomic load/store, fences
+
+Every op takes the previous op's result, so a snippet measures latency.
+Vector snippets keep their own vector phi and fold lane 0 into %next_op1
+once per iteration, which cancels between depths. The atomic snippets are
+built twice, with templates/atomic.ll (uncontended) and
+templates/atomic-contended.ll (another core adds to the same word).
+
+Usage: generate_vector_atomic_snippets.py [snippets_dir]
+"""
+
+import sys
+from pathlib import Path
+
+DEPTHS = (1, 2, 4)
+WIDTHS = (128, 256, 512)
+
+ELEMENTS = {'i32': 32, 'i64': 64, 'double': 64}
+# Template operand names (templates/vector.ll) per element type
+OPERANDS = {'i32': 'ki', 'i64': 'kl', 'double': 'kf'}
+LABELS = {'i32': 'i32', 'i64': 'i64', 'double': 'f64'}
+
+# Gather/scatter indices: 256 entries per lane, so each lane reads its own
+# part of the 16KB @vec_table (which stays in L1)
+LANE_ENTRIES = 256
+
+
+def vtype(elem, width):
+    return f"<{width // ELEMENTS[elem]} x {elem}>"
+
+
+def vconst(elem, values):
+    return "<" + ", ".join(f"{elem} {v}" for v in values) + ">"
+
+
+def lane_indices(x, t, width):
+    lanes = width // 32
+    ty = vtype('i32', width)
+    return [f"{t}i = and {ty} {x}, {vconst('i32', [LANE_ENTRIES - 1] * lanes)}",
+            f"{t}o = or {ty} {t}i, "
+            f"{vconst('i32', [l * LANE_ENTRIES for l in range(lanes)])}",
+            f"{t}z = zext {ty} {t}o to <{lanes} x i64>",
+            f"{t}p = getelementptr i32, i32* %table, <{lanes} x i64> {t}z"]
+
+
+def all_true(lanes):
+    return "<" + ", ".join(["i1 true"] * lanes) + ">"
+
+
+# One vector step: {x} chain value, {y} next, {k} loop-invariant operand of
+# the same type, {t} prefix for temporaries
+def vector_steps(elem, width):
+    ty = vtype(elem, width)
+    lanes = width // ELEMENTS[elem]
+    k = f"%{OPERANDS[elem]}{width}"
+    steps = {}
+    if elem == 'i32':
+        for op in ('add', 'mul', 'and'):
+            steps[op] = lambda x, y, t, op=op: [f"{y} = {op} {ty} {x}, {k}"]
+        steps['icmp-eq'] = lambda x, y, t: [
+            f"{t}c = icmp eq {ty} {x}, {k}",
+            f"{t}m = sext <{lanes} x i1> {t}c to {ty}",
+            f"{y} = xor {ty} {x}, {t}m"]
+        reverse = vconst('i32', range(lanes - 1, -1, -1))
+        steps['shufflevector'] = lambda x, y, t: [
+            f"{y} = shufflevector {ty} {x}, {ty} undef, <{lanes} x i32> {reverse}"]
+        steps['extract-insert'] = lambda x, y, t: [
+            f"{t}e = extractelement {ty} {x}, i32 {lanes - 1}",
+            f"{y} = insertelement {ty} {x}, i32 {t}e, i32 0"]
+        gather = f"@llvm.masked.gather.v{lanes}i32.v{lanes}p0i32"
+        scatter = f"@llvm.masked.scatter.v{lanes}i32.v{lanes}p0i32"
+        steps['gather'] = lambda x, y, t: lane_indices(x, t, width) + [
+            f"{y} = call {ty} {gather}(<{lanes} x i32*> {t}p, i32 4, "
+            f"<{lanes} x i1> {all_true(lanes)}, {ty} undef)"]
+        steps['scatter'] = lambda x, y, t: lane_indices(x, t, width) + [
+            f"call void {scatter}({ty} {x}, <{lanes} x i32*> {t}p, i32 4, "
+            f"<{lanes} x i1> {all_true(lanes)})",
+            f"{y} = add {ty} {x}, {k}"]
+    elif elem == 'i64':
+        steps['add'] = lambda x, y, t: [f"{y} = add {ty} {x}, {k}"]
+    else:
+        for op in ('fadd', 'fmul'):
+            steps[op] = lambda x, y, t, op=op: [f"{y} = {op} {ty} {x}, {k}"]
+    return steps
+
+
+def vector_snippet(elem, width, step, depth):
+    ty = vtype(elem, width)
+    lines = [f"%x.0 = phi {ty} [ zeroinitializer, %entry ], [ %x.{depth}, %loop ]"]
+    for d in range(depth):
+        # Without the freeze llc merges consecutive steps (and with the same
+        # mask, two shuffles) into one
+        lines.append(f"%f.{d} = freeze {ty} %x.{d}")
+        lines += step(f"%f.{d}", f"%x.{d + 1}", f"%s{d}.")
+    lines.append(f"%lane = extractelement {ty} %x.{depth}, i32 0")
+    if elem == 'i32':
+        lines += ["%lane64 = zext i32 %lane to i64",
+                  "%next_op1 = add i64 %op1, %lane64"]
+    elif elem == 'i64':
+        lines.append("%next_op1 = add i64 %op1, %lane")
+    else:
+        lines += ["%lane64 = bitcast double %lane to i64",
+                  "%next_op1 = xor i64 %op1, %lane64"]
+    return "\n".join(lines)
+
+
+# Atomic steps on %slot (templates/atomic.ll): {x} chain value (i64), {y}
+# next, {t} prefix for temporaries
+ATOMIC_STEPS = {
+    'atomicrmw-add': lambda x, y, t: [
+        f"{t}o = atomicrmw add i64* %slot, i64 {x} seq_cst",
+        f"{y} = add i64 {t}o, 1"],
+    # With its result used, an atomic or is a cmpxchg loop on x86
+    'atomicrmw-or': lambda x, y, t: [
+        f"{t}o = atomicrmw or i64* %slot, i64 {x} seq_cst",
+        f"{y} = add i64 {t}o, 1"],
+    'atomicrmw-xchg': lambda x, y, t: [
+        f"{t}o = atomicrmw xchg i64* %slot, i64 {x} seq_cst",
+        f"{y} = add i64 {t}o, 1"],
+    # One step of a compare-and-swap loop: retry with the value seen on failure
+    'cmpxchg': lambda x, y, t: [
+        f"{t}n = add i64 {x}, 1",
+        f"{t}r = cmpxchg i64* %slot, i64 {x}, i64 {t}n seq_cst seq_cst",
+        f"{t}o = extractvalue {{ i64, i1 }} {t}r, 0",
+        f"{t}ok = extractvalue {{ i64, i1 }} {t}r, 1",
+        f"{y} = select i1 {t}ok, i64 {t}n, i64 {t}o"],
+    # The loaded value picks the next word of the line, a load-to-use chain
+    'load-atomic-seq-cst': lambda x, y, t: [
+        f"{t}w = and i64 {x}, 7",
+        f"{t}p = getelementptr i64, i64* %slot, i64 {t}w",
+        f"{t}v = load atomic i64, i64* {t}p seq_cst, align 8",
+        f"{y} = add i64 {x}, {t}v"],
+    'store-atomic-release': lambda x, y, t: [
+        f"store atomic i64 {x}, i64* %slot release, align 8",
+        f"{y} = add i64 {x}, 1"],
+    'store-atomic-seq-cst': lambda x, y, t: [
+        f"store atomic i64 {x}, i64* %slot seq_cst, align 8",
+        f"{y} = add i64 {x}, 1"],
+    'fence-seq-cst': lambda x, y, t: [
+        "fence seq_cst",
+        f"{y} = add i64 {x}, 1"],
+    'fence-acq-rel': lambda x, y, t: [
+        "fence acq_rel",
+        f"{y} = add i64 {x}, 1"],
+}
+
+
+def atomic_snippet(step, depth):
+    lines = []
+    for d in range(depth):
+        x = "%op1" if d == 0 else f"%a{d}"
+        y = "%next_op1" if d == depth - 1 else f"%a{d + 1}"
+        lines += step(x, y, f"%s{d}.")
+    return "\n".join(lines)
+
+
+def snippet_name(name, depth):
+    return f"{name}.ll" if depth == 1 else f"{name}-{depth}.ll"
+
+
+def main():
+    snippets_dir = Path(sys.argv[1] if len(sys.argv) > 1 else Path(__file__).parent / "snippets")
+
+    count = 0
+    vector_dir = snippets_dir / "vector"
+    vector_dir.mkdir(parents=True, exist_ok=True)
+    for elem in ELEMENTS:
+        for width in WIDTHS:
+            for op, step in vector_steps(elem, width).items():
+                for depth in DEPTHS:
+                    name = snippet_name(f"{op}-{LABELS[elem]}-v{width}", depth)
+                    (vector_dir / name).write_text(vector_snippet(elem, width, step, depth))
+                    count += 1
+
+    atomic_dir = snippets_dir / "atomic"
+    atomic_dir.mkdir(parents=True, exist_ok=True)
+    for op, step in ATOMIC_STEPS.items():
+        for depth in DEPTHS:
+            (atomic_dir / snippet_name(op, depth)).write_text(atomic_snippet(step, depth))
+            count += 1
+
+    print(f"Generated {count} vector and atomic snippets in {snippets_dir}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
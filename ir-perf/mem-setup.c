@@ -0,0 +1,113 @@
+// Buffer setup for the loops generated by generate_mlp_benchmarks.py: the
+// loops call these from bench_loop before the measured part, so the cost is
+// the same at both depths and cancels out in the analysis.
+//
+//   mem_alloc(bytes, page_size)   buffer backed by 4K or 2M pages
+//   mem_chase_init(buf, bytes, node_stride, chains, heads)
+//                                 `chains` disjoint random pointer cycles
+//                                 over the nodes, one every node_stride bytes
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+#define HUGE_PAGE_SIZE (2L << 20)
+
+static void *map_anonymous(long bytes, int extra_flags) {
+    void *p = mmap(NULL, (size_t)bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+// 2M pages come from the hugetlbfs pool (vm.nr_hugepages) when it has
+// enough, otherwise from transparent huge pages via madvise; 4K pages are
+// requested with MADV_NOHUGEPAGE so THP in "always" mode does not merge them
+void *mem_alloc(long bytes, long page_size) {
+    void *p;
+
+    if (page_size == HUGE_PAGE_SIZE) {
+        long huge_bytes = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        p = map_anonymous(huge_bytes, MAP_HUGETLB | MAP_HUGE_2MB);
+        if (p == NULL) {
+            // Over-allocate to start on a 2M boundary
+            char *raw = map_anonymous(huge_bytes + HUGE_PAGE_SIZE, 0);
+            if (raw == NULL) {
+                fprintf(stderr, "mem_alloc: mmap %ld bytes: %s\n", bytes, strerror(errno));
+                exit(1);
+            }
+            p = (void *)(((uintptr_t)raw + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+            if (madvise(p, (size_t)huge_bytes, MADV_HUGEPAGE) != 0) {
+                fprintf(stderr, "mem_alloc: madvise(MADV_HUGEPAGE): %s; using 4K pages\n", strerror(errno));
+            }
+        }
+    } else {
+        p = map_anonymous(bytes, 0);
+        if (p == NULL) {
+            fprintf(stderr, "mem_alloc: mmap %ld bytes: %s\n", bytes, strerror(errno));
+            exit(1);
+        }
+        madvise(p, (size_t)bytes, MADV_NOHUGEPAGE);
+    }
+
+    // Fault everything in now rather than in the measured loop
+    memset(p, 1, (size_t)bytes);
+    return p;
+}
+
+static uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// The nodes are shuffled once and the permutation is cut into `chains`
+// consecutive runs, each closed into a cycle: every chain visits its nodes
+// in random order, so neither the hardware prefetchers nor another chain
+// bring in the next line
+void mem_chase_init(char *buf, long bytes, long node_stride, long chains, char **heads) {
+    long nodes = bytes / node_stride;
+    if (chains < 1 || nodes < chains) {
+        fprintf(stderr, "mem_chase_init: %ld nodes for %ld chains\n", nodes, chains);
+        exit(1);
+    }
+
+    long *order = malloc((size_t)nodes * sizeof(*order));
+    if (order == NULL) {
+        fprintf(stderr, "mem_chase_init: out of memory\n");
+        exit(1);
+    }
+    for (long i = 0; i < nodes; i++) {
+        order[i] = i;
+    }
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (long i = nodes - 1; i > 0; i--) {
+        long j = (long)(xorshift64(&state) % (uint64_t)(i + 1));
+        long t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    for (long c = 0; c < chains; c++) {
+        long first = nodes * c / chains;
+        long last = nodes * (c + 1) / chains - 1;
+        for (long i = first; i < last; i++) {
+            *(char **)(buf + order[i] * node_stride) = buf + order[i + 1] * node_stride;
+        }
+        *(char **)(buf + order[last] * node_stride) = buf + order[first] * node_stride;
+        heads[c] = buf + order[first] * node_stride;
+    }
+    free(order);
+}
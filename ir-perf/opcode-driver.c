@@ -0,0 +1,251 @@
+// Runs every loop generated by generate_opcode_benchmarks.py in one process
+// and prints a per-opcode table of latency and reciprocal throughput.
+//
+// Usage: opcode_table [-n N] [-r R] [-o file.csv] [opcode ...]
+//   -n N   loop iterations per measurement (default 1000000)
+//   -r R   measurements per loop, the minimum is kept (default 5)
+//   -o     also write the table as CSV
+//
+// Cycles and instructions are counted with perf_event_open (user space
+// only); without access to the counters the TSC is used and instructions
+// are not reported. Each loop runs at two depths and the difference is
+// divided by the extra ops, which removes the loop overhead.
+//
+// The noise floor of a result is the spread (max - min) of its repeated
+// measurements, per op. A result below it, including a negative one after
+// subtracting the helper op, is reported as "<floor" in the table and as
+// the floor with the below_noise column set in the CSV.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+#include "opcode-driver.h"
+
+void sink(long x) {
+    volatile long y = x;
+    (void)y;
+}
+
+struct counts {
+    double cycles;
+    double instructions;
+    double noise;  // cycles, max - min over the repetitions
+};
+
+struct result {
+    double lat, tput, ipo;  // cycles/op, cycles/op, instructions/op
+    double lat_noise, tput_noise;
+};
+
+static int cycles_fd = -1;
+static int instructions_fd = -1;
+
+static int open_counter(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static void open_counters(void) {
+    cycles_fd = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (cycles_fd < 0) {
+        fprintf(stderr, "perf_event_open: %s; using the TSC, no instruction counts\n", strerror(errno));
+        return;
+    }
+    instructions_fd = open_counter(PERF_COUNT_HW_INSTRUCTIONS, cycles_fd);
+}
+
+static uint64_t read_counter(int fd) {
+    uint64_t value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+
+static struct counts measure_once(opcode_loop_fn fn, long n) {
+    struct counts c = { 0, 0, 0 };
+    if (cycles_fd < 0) {
+        uint64_t start = __rdtsc();
+        fn(n);
+        c.cycles = (double)(__rdtsc() - start);
+        return c;
+    }
+    ioctl(cycles_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(cycles_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    fn(n);
+    ioctl(cycles_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    c.cycles = (double)read_counter(cycles_fd);
+    c.instructions = (double)read_counter(instructions_fd);
+    return c;
+}
+
+// Minimum over the repetitions: interrupts and frequency ramps only add
+static struct counts measure(opcode_loop_fn fn, long n, int reps) {
+    struct counts best = measure_once(fn, n);
+    double worst = best.cycles;
+    for (int r = 1; r < reps; r++) {
+        struct counts c = measure_once(fn, n);
+        if (c.cycles < best.cycles) {
+            best = c;
+        }
+        if (c.cycles > worst) {
+            worst = c.cycles;
+        }
+    }
+    best.noise = worst - best.cycles;
+    return best;
+}
+
+static struct counts per_op(const opcode_loop_fn fns[2], long n, int reps) {
+    struct counts shallow = measure(fns[0], n, reps);
+    struct counts deep = measure(fns[1], n, reps);
+    double ops = (double)(opcode_depths[1] - opcode_depths[0]) * (double)n;
+    struct counts c = {
+        (deep.cycles - shallow.cycles) / ops,
+        (deep.instructions - shallow.instructions) / ops,
+        (deep.noise + shallow.noise) / ops,
+    };
+    return c;
+}
+
+static const struct opcode_bench *find(const char *opcode) {
+    for (const struct opcode_bench *b = opcode_benchmarks; b->opcode; b++) {
+        if (strcmp(b->opcode, opcode) == 0) {
+            return b;
+        }
+    }
+    return NULL;
+}
+
+static int selected(const char *opcode, char **names, int count) {
+    if (count == 0) {
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], opcode) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static struct result run(const struct opcode_bench *b, long n, int reps) {
+    struct counts lat = per_op(b->lat, n, reps);
+    struct counts tput = per_op(b->tput, n, reps);
+    struct result r = { lat.cycles, tput.cycles, lat.instructions, lat.noise, tput.noise };
+    if (b->minus) {
+        // The chain step includes one of these to keep it from folding away
+        const struct opcode_bench *m = find(b->minus);
+        if (m == NULL) {
+            fprintf(stderr, "%s: no benchmark for %s\n", b->opcode, b->minus);
+            exit(1);
+        }
+        struct result base = run(m, n, reps);
+        r.lat -= base.lat;
+        r.tput -= base.tput;
+        r.ipo -= base.ipo;
+        r.lat_noise += base.lat_noise;
+        r.tput_noise += base.tput_noise;
+    }
+    return r;
+}
+
+static int below_noise(double cycles, double noise) {
+    return cycles < noise || cycles < 0;
+}
+
+// The table column of one result: the cycles, or "<floor" below the noise
+static const char *format_cycles(char *buf, size_t size, double cycles, double noise) {
+    if (below_noise(cycles, noise)) {
+        snprintf(buf, size, "<%.2f", noise);
+    } else {
+        snprintf(buf, size, "%.2f", cycles);
+    }
+    return buf;
+}
+
+int main(int argc, char **argv) {
+    long n = 1000000;
+    int reps = 5;
+    const char *csv_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:o:")) != -1) {
+        switch (opt) {
+        case 'n': n = atol(optarg); break;
+        case 'r': reps = atoi(optarg); break;
+        case 'o': csv_path = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-n N] [-r R] [-o file.csv] [opcode ...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n <= 0 || reps <= 0) {
+        fprintf(stderr, "-n and -r must be positive\n");
+        return 1;
+    }
+    for (int i = optind; i < argc; i++) {
+        if (find(argv[i]) == NULL) {
+            fprintf(stderr, "Unknown opcode: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Cannot open %s: %s\n", csv_path, strerror(errno));
+            return 1;
+        }
+        fprintf(csv, "opcode,measured,type,latency_cycles,recip_throughput_cycles,instructions_per_op,"
+                     "latency_below_noise,recip_throughput_below_noise\n");
+    }
+
+    open_counters();
+    printf("%-14s %-18s %-7s %12s %12s %10s\n", "opcode", "measured", "type", "latency", "recip.tput", "insts/op");
+    for (const struct opcode_bench *b = opcode_benchmarks; b->opcode; b++) {
+        if (!selected(b->opcode, argv + optind, argc - optind)) {
+            continue;
+        }
+        struct result r = run(b, n, reps);
+        int lat_low = below_noise(r.lat, r.lat_noise);
+        int tput_low = below_noise(r.tput, r.tput_noise);
+        char lat[32], tput[32];
+        format_cycles(lat, sizeof(lat), r.lat, r.lat_noise);
+        format_cycles(tput, sizeof(tput), r.tput, r.tput_noise);
+        if (cycles_fd < 0) {
+            printf("%-14s %-18s %-7s %12s %12s %10s\n", b->opcode, b->name, b->type, lat, tput, "-");
+        } else {
+            printf("%-14s %-18s %-7s %12s %12s %10.2f\n", b->opcode, b->name, b->type, lat, tput, r.ipo);
+        }
+        fflush(stdout);
+        if (csv) {
+            fprintf(csv, "%s,%s,%s,%.4f,%.4f,", b->opcode, b->name, b->type,
+                    lat_low ? r.lat_noise : r.lat, tput_low ? r.tput_noise : r.tput);
+            if (cycles_fd >= 0) {
+                fprintf(csv, "%.4f", r.ipo);
+            }
+            fprintf(csv, ",%d,%d\n", lat_low, tput_low);
+        }
+    }
+    if (csv) {
+        fclose(csv);
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef OPCODE_DRIVER_H
+#define OPCODE_DRIVER_H
+
+typedef void (*opcode_loop_fn)(long N);
+
+// One opcode of generate_opcode_benchmarks.py: its loops at the two depths
+// in opcode_depths, as a single dependent chain (lat) and as independent
+// chains (tput)
+struct opcode_bench {
+    const char *opcode;
+    const char *name;       // what the chain step measures, e.g. "icmp+zext"
+    const char *type;       // chain value type
+    const char *minus;      // opcode whose result to subtract, or NULL
+    opcode_loop_fn lat[2];
+    opcode_loop_fn tput[2];
+};
+
+extern const unsigned opcode_depths[2];
+extern const struct opcode_bench opcode_benchmarks[];
+
+#endif // OPCODE_DRIVER_H
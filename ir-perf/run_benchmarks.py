@@ -18,6 +18,7 @@ import math
 from datetime import datetime
 
 from analyze_memory_latency import MemoryLatencyAnalyzer
+from analyze_branch_mispredict import BranchMispredictAnalyzer
 
 class BenchmarkRunner:
     def __init__(self, cpu_core=3, iterations=100000000, verbose=False):
@@ -346,6 +347,9 @@ class BenchmarkRunner:
         
         try:
             cmd = ["perf", "stat", "-e", perf_events]
+            if executable.startswith('bench_atomic-contended_'):
+                # Leave out the contending thread (contention.c)
+                cmd.append("--no-inherit")
             if perf_metrics:
                 cmd.extend(["-M", perf_metrics])
             cmd.extend(["taskset", "-c", str(self.cpu_core), str(executable_path), str(self.iterations)])
@@ -638,6 +642,9 @@ class BenchmarkRunner:
         if all_results:
             csv_file = self.save_results_to_csv(all_results)
             print(f"\nDetailed results saved to: {csv_file}")
+
+            if any(r['benchmark'].startswith('bench_branching_data-') for r in all_results):
+                self.run_branch_analysis(csv_file)
             
             # Save memory benchmark results to separate CSV
             memory_csv_file = self.save_memory_results_to_csv(all_results)
@@ -648,6 +655,28 @@ class BenchmarkRunner:
                 if hasattr(self, 'analyze_latency') and self.analyze_latency:
                     self.run_latency_analysis(memory_csv_file)
     
+    def run_opcode_table(self, opcodes=None, iterations=1000000):
+        """Run the in-process opcode latency/throughput table (opcode_table)."""
+        executable = self.build_dir / "opcode_table"
+        if not executable.exists():
+            print(f"✗ {executable} not found; build it with cmake first")
+            return None
+
+        timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
+        csv_filename = f"opcode_table_{timestamp}.csv"
+        cmd = ["taskset", "-c", str(self.cpu_core), str(executable),
+               "-n", str(iterations), "-o", csv_filename] + list(opcodes or [])
+        if self.verbose:
+            print(f"Command: {' '.join(cmd)}")
+        try:
+            subprocess.run(cmd, check=True)
+        except subprocess.CalledProcessError as e:
+            print(f"✗ opcode_table failed: {e}")
+            return None
+
+        print(f"\n✓ Opcode table saved to {csv_filename}")
+        return csv_filename
+
     def group_benchmarks(self, benchmarks):
         """Group benchmarks by instruction type (e.g., add-imm, add-imm-2, add-imm-4)."""
         groups = {}
@@ -797,7 +826,7 @@ class BenchmarkRunner:
         csv_filename = f"benchmark_results_{timestamp}.csv"
         
         with open(csv_filename, 'w', newline='') as csvfile:
-            fieldnames = ['benchmark', 'group', 'cycles', 'instructions', 'branch_misses', 'cycles_per_inst']
+            fieldnames = ['benchmark', 'group', 'iterations', 'cycles', 'instructions', 'branch_misses', 'cycles_per_inst']
             writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
             
             writer.writeheader()
@@ -805,6 +834,7 @@ class BenchmarkRunner:
                 writer.writerow({
                     'benchmark': result['benchmark'],
                     'group': result['group'],
+                    'iterations': result['iterations'],
                     'cycles': result['cycles'],
                     'instructions': result['instructions'],
                     'branch_misses': result.get('branch_misses', 'N/A'),
@@ -923,6 +953,22 @@ class BenchmarkRunner:
         except Exception as e:
             print(f"✗ Error running latency analysis: {e}")
     
+    def run_branch_analysis(self, csv_file):
+        """Estimate the misprediction penalty from the data-driven branching results."""
+        print("\n" + "=" * 60)
+        print("RUNNING BRANCH MISPREDICTION ANALYSIS")
+        print("=" * 60)
+        analyzer = BranchMispredictAnalyzer(verbose=self.verbose, iterations=self.iterations)
+        if not analyzer.load_csv_files(csv_file):
+            return
+        try:
+            analyzer.analyze()
+        except ValueError as e:
+            print(f"✗ Branch misprediction analysis failed: {e}")
+            return
+        analyzer.print_summary()
+        analyzer.save()
+
     def save_summary_to_csv(self, latency_results):
         """Save latency summary results to a CSV file."""
         if not latency_results:
@@ -982,6 +1028,8 @@ Examples:
   %(prog)s bench_memory_store-32KB-4         # Run specific benchmark
   %(prog)s --cpu-core 2 --iterations 50000000 bench_memory_store-32KB-4
   %(prog)s --verbose bench_memory_store-32KB-4 bench_memory_load-1MB
+  %(prog)s --opcode-table                     # Latency/throughput of every opcode
+  %(prog)s --opcode-table udiv fdiv           # ... of some opcodes
         """
     )
     
@@ -1019,6 +1067,20 @@ Examples:
         help='Disable memory latency analysis after benchmarking (default: enabled)'
     )
     
+    parser.add_argument(
+        '--opcode-table',
+        action='store_true',
+        help='Run the in-process opcode latency/throughput table instead of the snippet '
+             'executables; positional arguments are then opcode names'
+    )
+
+    parser.add_argument(
+        '--opcode-iterations',
+        type=int,
+        default=1000000,
+        help='Loop iterations per opcode table measurement (default: 1000000)'
+    )
+
     # Parse arguments
     args = parser.parse_args()
     
@@ -1029,7 +1091,10 @@ Examples:
     runner = BenchmarkRunner(cpu_core=args.cpu_core, iterations=args.iterations, verbose=args.verbose)
     runner.analyze_latency = args.analyze_latency
     runner.setup_cpu()
-    runner.run_benchmarks(args.benchmarks if args.benchmarks else None)
+    if args.opcode_table:
+        runner.run_opcode_table(args.benchmarks, args.opcode_iterations)
+    else:
+        runner.run_benchmarks(args.benchmarks if args.benchmarks else None)
 
 if __name__ == "__main__":
     main() 
\ No newline at end of file
@@ -0,0 +1,4 @@
+%s0.o = atomicrmw add i64* %slot, i64 %op1 seq_cst
+%a1 = add i64 %s0.o, 1
+%s1.o = atomicrmw add i64* %slot, i64 %a1 seq_cst
+%next_op1 = add i64 %s1.o, 1
\ No newline at end of file
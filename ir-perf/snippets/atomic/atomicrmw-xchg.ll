@@ -0,0 +1,2 @@
+%s0.o = atomicrmw xchg i64* %slot, i64 %op1 seq_cst
+%next_op1 = add i64 %s0.o, 1
\ No newline at end of file
@@ -0,0 +1,10 @@
+%s0.n = add i64 %op1, 1
+%s0.r = cmpxchg i64* %slot, i64 %op1, i64 %s0.n seq_cst seq_cst
+%s0.o = extractvalue { i64, i1 } %s0.r, 0
+%s0.ok = extractvalue { i64, i1 } %s0.r, 1
+%a1 = select i1 %s0.ok, i64 %s0.n, i64 %s0.o
+%s1.n = add i64 %a1, 1
+%s1.r = cmpxchg i64* %slot, i64 %a1, i64 %s1.n seq_cst seq_cst
+%s1.o = extractvalue { i64, i1 } %s1.r, 0
+%s1.ok = extractvalue { i64, i1 } %s1.r, 1
+%next_op1 = select i1 %s1.ok, i64 %s1.n, i64 %s1.o
\ No newline at end of file
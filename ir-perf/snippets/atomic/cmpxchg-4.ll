@@ -0,0 +1,20 @@
+%s0.n = add i64 %op1, 1
+%s0.r = cmpxchg i64* %slot, i64 %op1, i64 %s0.n seq_cst seq_cst
+%s0.o = extractvalue { i64, i1 } %s0.r, 0
+%s0.ok = extractvalue { i64, i1 } %s0.r, 1
+%a1 = select i1 %s0.ok, i64 %s0.n, i64 %s0.o
+%s1.n = add i64 %a1, 1
+%s1.r = cmpxchg i64* %slot, i64 %a1, i64 %s1.n seq_cst seq_cst
+%s1.o = extractvalue { i64, i1 } %s1.r, 0
+%s1.ok = extractvalue { i64, i1 } %s1.r, 1
+%a2 = select i1 %s1.ok, i64 %s1.n, i64 %s1.o
+%s2.n = add i64 %a2, 1
+%s2.r = cmpxchg i64* %slot, i64 %a2, i64 %s2.n seq_cst seq_cst
+%s2.o = extractvalue { i64, i1 } %s2.r, 0
+%s2.ok = extractvalue { i64, i1 } %s2.r, 1
+%a3 = select i1 %s2.ok, i64 %s2.n, i64 %s2.o
+%s3.n = add i64 %a3, 1
+%s3.r = cmpxchg i64* %slot, i64 %a3, i64 %s3.n seq_cst seq_cst
+%s3.o = extractvalue { i64, i1 } %s3.r, 0
+%s3.ok = extractvalue { i64, i1 } %s3.r, 1
+%next_op1 = select i1 %s3.ok, i64 %s3.n, i64 %s3.o
\ No newline at end of file
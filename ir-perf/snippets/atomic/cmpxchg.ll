@@ -0,0 +1,5 @@
+%s0.n = add i64 %op1, 1
+%s0.r = cmpxchg i64* %slot, i64 %op1, i64 %s0.n seq_cst seq_cst
+%s0.o = extractvalue { i64, i1 } %s0.r, 0
+%s0.ok = extractvalue { i64, i1 } %s0.r, 1
+%next_op1 = select i1 %s0.ok, i64 %s0.n, i64 %s0.o
\ No newline at end of file
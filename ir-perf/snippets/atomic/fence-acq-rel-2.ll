@@ -0,0 +1,4 @@
+fence acq_rel
+%a1 = add i64 %op1, 1
+fence acq_rel
+%next_op1 = add i64 %a1, 1
\ No newline at end of file
@@ -0,0 +1,2 @@
+fence acq_rel
+%next_op1 = add i64 %op1, 1
\ No newline at end of file
@@ -0,0 +1,4 @@
+fence seq_cst
+%a1 = add i64 %op1, 1
+fence seq_cst
+%next_op1 = add i64 %a1, 1
\ No newline at end of file
@@ -0,0 +1,8 @@
+fence seq_cst
+%a1 = add i64 %op1, 1
+fence seq_cst
+%a2 = add i64 %a1, 1
+fence seq_cst
+%a3 = add i64 %a2, 1
+fence seq_cst
+%next_op1 = add i64 %a3, 1
\ No newline at end of file
@@ -0,0 +1,16 @@
+%s0.w = and i64 %op1, 7
+%s0.p = getelementptr i64, i64* %slot, i64 %s0.w
+%s0.v = load atomic i64, i64* %s0.p seq_cst, align 8
+%a1 = add i64 %op1, %s0.v
+%s1.w = and i64 %a1, 7
+%s1.p = getelementptr i64, i64* %slot, i64 %s1.w
+%s1.v = load atomic i64, i64* %s1.p seq_cst, align 8
+%a2 = add i64 %a1, %s1.v
+%s2.w = and i64 %a2, 7
+%s2.p = getelementptr i64, i64* %slot, i64 %s2.w
+%s2.v = load atomic i64, i64* %s2.p seq_cst, align 8
+%a3 = add i64 %a2, %s2.v
+%s3.w = and i64 %a3, 7
+%s3.p = getelementptr i64, i64* %slot, i64 %s3.w
+%s3.v = load atomic i64, i64* %s3.p seq_cst, align 8
+%next_op1 = add i64 %a3, %s3.v
\ No newline at end of file
@@ -0,0 +1,4 @@
+%s0.w = and i64 %op1, 7
+%s0.p = getelementptr i64, i64* %slot, i64 %s0.w
+%s0.v = load atomic i64, i64* %s0.p seq_cst, align 8
+%next_op1 = add i64 %op1, %s0.v
\ No newline at end of file
@@ -0,0 +1,8 @@
+store atomic i64 %op1, i64* %slot release, align 8
+%a1 = add i64 %op1, 1
+store atomic i64 %a1, i64* %slot release, align 8
+%a2 = add i64 %a1, 1
+store atomic i64 %a2, i64* %slot release, align 8
+%a3 = add i64 %a2, 1
+store atomic i64 %a3, i64* %slot release, align 8
+%next_op1 = add i64 %a3, 1
\ No newline at end of file
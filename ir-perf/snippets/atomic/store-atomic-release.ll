@@ -0,0 +1,2 @@
+store atomic i64 %op1, i64* %slot release, align 8
+%next_op1 = add i64 %op1, 1
\ No newline at end of file
@@ -0,0 +1,8 @@
+%x.0 = phi <4 x i32> [ zeroinitializer, %entry ], [ %x.2, %loop ]
+%f.0 = freeze <4 x i32> %x.0
+%x.1 = add <4 x i32> %f.0, %ki128
+%f.1 = freeze <4 x i32> %x.1
+%x.2 = add <4 x i32> %f.1, %ki128
+%lane = extractelement <4 x i32> %x.2, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
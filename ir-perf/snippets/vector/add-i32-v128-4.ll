@@ -0,0 +1,12 @@
+%x.0 = phi <4 x i32> [ zeroinitializer, %entry ], [ %x.4, %loop ]
+%f.0 = freeze <4 x i32> %x.0
+%x.1 = add <4 x i32> %f.0, %ki128
+%f.1 = freeze <4 x i32> %x.1
+%x.2 = add <4 x i32> %f.1, %ki128
+%f.2 = freeze <4 x i32> %x.2
+%x.3 = add <4 x i32> %f.2, %ki128
+%f.3 = freeze <4 x i32> %x.3
+%x.4 = add <4 x i32> %f.3, %ki128
+%lane = extractelement <4 x i32> %x.4, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,11 @@
+%x.0 = phi <2 x i64> [ zeroinitializer, %entry ], [ %x.4, %loop ]
+%f.0 = freeze <2 x i64> %x.0
+%x.1 = add <2 x i64> %f.0, %kl128
+%f.1 = freeze <2 x i64> %x.1
+%x.2 = add <2 x i64> %f.1, %kl128
+%f.2 = freeze <2 x i64> %x.2
+%x.3 = add <2 x i64> %f.2, %kl128
+%f.3 = freeze <2 x i64> %x.3
+%x.4 = add <2 x i64> %f.3, %kl128
+%lane = extractelement <2 x i64> %x.4, i32 0
+%next_op1 = add i64 %op1, %lane
\ No newline at end of file
@@ -0,0 +1,7 @@
+%x.0 = phi <4 x i64> [ zeroinitializer, %entry ], [ %x.2, %loop ]
+%f.0 = freeze <4 x i64> %x.0
+%x.1 = add <4 x i64> %f.0, %kl256
+%f.1 = freeze <4 x i64> %x.1
+%x.2 = add <4 x i64> %f.1, %kl256
+%lane = extractelement <4 x i64> %x.2, i32 0
+%next_op1 = add i64 %op1, %lane
\ No newline at end of file
@@ -0,0 +1,5 @@
+%x.0 = phi <4 x i64> [ zeroinitializer, %entry ], [ %x.1, %loop ]
+%f.0 = freeze <4 x i64> %x.0
+%x.1 = add <4 x i64> %f.0, %kl256
+%lane = extractelement <4 x i64> %x.1, i32 0
+%next_op1 = add i64 %op1, %lane
\ No newline at end of file
@@ -0,0 +1,8 @@
+%x.0 = phi <16 x i32> [ zeroinitializer, %entry ], [ %x.2, %loop ]
+%f.0 = freeze <16 x i32> %x.0
+%x.1 = and <16 x i32> %f.0, %ki512
+%f.1 = freeze <16 x i32> %x.1
+%x.2 = and <16 x i32> %f.1, %ki512
+%lane = extractelement <16 x i32> %x.2, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,10 @@
+%x.0 = phi <4 x i32> [ zeroinitializer, %entry ], [ %x.2, %loop ]
+%f.0 = freeze <4 x i32> %x.0
+%s0.e = extractelement <4 x i32> %f.0, i32 3
+%x.1 = insertelement <4 x i32> %f.0, i32 %s0.e, i32 0
+%f.1 = freeze <4 x i32> %x.1
+%s1.e = extractelement <4 x i32> %f.1, i32 3
+%x.2 = insertelement <4 x i32> %f.1, i32 %s1.e, i32 0
+%lane = extractelement <4 x i32> %x.2, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
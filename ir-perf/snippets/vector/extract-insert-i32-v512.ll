@@ -0,0 +1,7 @@
+%x.0 = phi <16 x i32> [ zeroinitializer, %entry ], [ %x.1, %loop ]
+%f.0 = freeze <16 x i32> %x.0
+%s0.e = extractelement <16 x i32> %f.0, i32 15
+%x.1 = insertelement <16 x i32> %f.0, i32 %s0.e, i32 0
+%lane = extractelement <16 x i32> %x.1, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,8 @@
+%x.0 = phi <8 x double> [ zeroinitializer, %entry ], [ %x.2, %loop ]
+%f.0 = freeze <8 x double> %x.0
+%x.1 = fadd <8 x double> %f.0, %kf512
+%f.1 = freeze <8 x double> %x.1
+%x.2 = fadd <8 x double> %f.1, %kf512
+%lane = extractelement <8 x double> %x.2, i32 0
+%lane64 = bitcast double %lane to i64
+%next_op1 = xor i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,12 @@
+%x.0 = phi <2 x double> [ zeroinitializer, %entry ], [ %x.4, %loop ]
+%f.0 = freeze <2 x double> %x.0
+%x.1 = fmul <2 x double> %f.0, %kf128
+%f.1 = freeze <2 x double> %x.1
+%x.2 = fmul <2 x double> %f.1, %kf128
+%f.2 = freeze <2 x double> %x.2
+%x.3 = fmul <2 x double> %f.2, %kf128
+%f.3 = freeze <2 x double> %x.3
+%x.4 = fmul <2 x double> %f.3, %kf128
+%lane = extractelement <2 x double> %x.4, i32 0
+%lane64 = bitcast double %lane to i64
+%next_op1 = xor i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,6 @@
+%x.0 = phi <4 x double> [ zeroinitializer, %entry ], [ %x.1, %loop ]
+%f.0 = freeze <4 x double> %x.0
+%x.1 = fmul <4 x double> %f.0, %kf256
+%lane = extractelement <4 x double> %x.1, i32 0
+%lane64 = bitcast double %lane to i64
+%next_op1 = xor i64 %op1, %lane64
\ No newline at end of file
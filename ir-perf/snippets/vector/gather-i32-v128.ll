@@ -0,0 +1,10 @@
+%x.0 = phi <4 x i32> [ zeroinitializer, %entry ], [ %x.1, %loop ]
+%f.0 = freeze <4 x i32> %x.0
+%s0.i = and <4 x i32> %f.0, <i32 255, i32 255, i32 255, i32 255>
+%s0.o = or <4 x i32> %s0.i, <i32 0, i32 256, i32 512, i32 768>
+%s0.z = zext <4 x i32> %s0.o to <4 x i64>
+%s0.p = getelementptr i32, i32* %table, <4 x i64> %s0.z
+%x.1 = call <4 x i32> @llvm.masked.gather.v4i32.v4p0i32(<4 x i32*> %s0.p, i32 4, <4 x i1> <i1 true, i1 true, i1 true, i1 true>, <4 x i32> undef)
+%lane = extractelement <4 x i32> %x.1, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,28 @@
+%x.0 = phi <8 x i32> [ zeroinitializer, %entry ], [ %x.4, %loop ]
+%f.0 = freeze <8 x i32> %x.0
+%s0.i = and <8 x i32> %f.0, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s0.o = or <8 x i32> %s0.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792>
+%s0.z = zext <8 x i32> %s0.o to <8 x i64>
+%s0.p = getelementptr i32, i32* %table, <8 x i64> %s0.z
+%x.1 = call <8 x i32> @llvm.masked.gather.v8i32.v8p0i32(<8 x i32*> %s0.p, i32 4, <8 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>, <8 x i32> undef)
+%f.1 = freeze <8 x i32> %x.1
+%s1.i = and <8 x i32> %f.1, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s1.o = or <8 x i32> %s1.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792>
+%s1.z = zext <8 x i32> %s1.o to <8 x i64>
+%s1.p = getelementptr i32, i32* %table, <8 x i64> %s1.z
+%x.2 = call <8 x i32> @llvm.masked.gather.v8i32.v8p0i32(<8 x i32*> %s1.p, i32 4, <8 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>, <8 x i32> undef)
+%f.2 = freeze <8 x i32> %x.2
+%s2.i = and <8 x i32> %f.2, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s2.o = or <8 x i32> %s2.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792>
+%s2.z = zext <8 x i32> %s2.o to <8 x i64>
+%s2.p = getelementptr i32, i32* %table, <8 x i64> %s2.z
+%x.3 = call <8 x i32> @llvm.masked.gather.v8i32.v8p0i32(<8 x i32*> %s2.p, i32 4, <8 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>, <8 x i32> undef)
+%f.3 = freeze <8 x i32> %x.3
+%s3.i = and <8 x i32> %f.3, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s3.o = or <8 x i32> %s3.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792>
+%s3.z = zext <8 x i32> %s3.o to <8 x i64>
+%s3.p = getelementptr i32, i32* %table, <8 x i64> %s3.z
+%x.4 = call <8 x i32> @llvm.masked.gather.v8i32.v8p0i32(<8 x i32*> %s3.p, i32 4, <8 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>, <8 x i32> undef)
+%lane = extractelement <8 x i32> %x.4, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
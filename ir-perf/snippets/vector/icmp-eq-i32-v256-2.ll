@@ -0,0 +1,12 @@
+%x.0 = phi <8 x i32> [ zeroinitializer, %entry ], [ %x.2, %loop ]
+%f.0 = freeze <8 x i32> %x.0
+%s0.c = icmp eq <8 x i32> %f.0, %ki256
+%s0.m = sext <8 x i1> %s0.c to <8 x i32>
+%x.1 = xor <8 x i32> %f.0, %s0.m
+%f.1 = freeze <8 x i32> %x.1
+%s1.c = icmp eq <8 x i32> %f.1, %ki256
+%s1.m = sext <8 x i1> %s1.c to <8 x i32>
+%x.2 = xor <8 x i32> %f.1, %s1.m
+%lane = extractelement <8 x i32> %x.2, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
@@ -0,0 +1,20 @@
+%x.0 = phi <16 x i32> [ zeroinitializer, %entry ], [ %x.4, %loop ]
+%f.0 = freeze <16 x i32> %x.0
+%s0.c = icmp eq <16 x i32> %f.0, %ki512
+%s0.m = sext <16 x i1> %s0.c to <16 x i32>
+%x.1 = xor <16 x i32> %f.0, %s0.m
+%f.1 = freeze <16 x i32> %x.1
+%s1.c = icmp eq <16 x i32> %f.1, %ki512
+%s1.m = sext <16 x i1> %s1.c to <16 x i32>
+%x.2 = xor <16 x i32> %f.1, %s1.m
+%f.2 = freeze <16 x i32> %x.2
+%s2.c = icmp eq <16 x i32> %f.2, %ki512
+%s2.m = sext <16 x i1> %s2.c to <16 x i32>
+%x.3 = xor <16 x i32> %f.2, %s2.m
+%f.3 = freeze <16 x i32> %x.3
+%s3.c = icmp eq <16 x i32> %f.3, %ki512
+%s3.m = sext <16 x i1> %s3.c to <16 x i32>
+%x.4 = xor <16 x i32> %f.3, %s3.m
+%lane = extractelement <16 x i32> %x.4, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
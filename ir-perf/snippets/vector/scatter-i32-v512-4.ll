@@ -0,0 +1,32 @@
+%x.0 = phi <16 x i32> [ zeroinitializer, %entry ], [ %x.4, %loop ]
+%f.0 = freeze <16 x i32> %x.0
+%s0.i = and <16 x i32> %f.0, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s0.o = or <16 x i32> %s0.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792, i32 2048, i32 2304, i32 2560, i32 2816, i32 3072, i32 3328, i32 3584, i32 3840>
+%s0.z = zext <16 x i32> %s0.o to <16 x i64>
+%s0.p = getelementptr i32, i32* %table, <16 x i64> %s0.z
+call void @llvm.masked.scatter.v16i32.v16p0i32(<16 x i32> %f.0, <16 x i32*> %s0.p, i32 4, <16 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>)
+%x.1 = add <16 x i32> %f.0, %ki512
+%f.1 = freeze <16 x i32> %x.1
+%s1.i = and <16 x i32> %f.1, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s1.o = or <16 x i32> %s1.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792, i32 2048, i32 2304, i32 2560, i32 2816, i32 3072, i32 3328, i32 3584, i32 3840>
+%s1.z = zext <16 x i32> %s1.o to <16 x i64>
+%s1.p = getelementptr i32, i32* %table, <16 x i64> %s1.z
+call void @llvm.masked.scatter.v16i32.v16p0i32(<16 x i32> %f.1, <16 x i32*> %s1.p, i32 4, <16 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>)
+%x.2 = add <16 x i32> %f.1, %ki512
+%f.2 = freeze <16 x i32> %x.2
+%s2.i = and <16 x i32> %f.2, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s2.o = or <16 x i32> %s2.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792, i32 2048, i32 2304, i32 2560, i32 2816, i32 3072, i32 3328, i32 3584, i32 3840>
+%s2.z = zext <16 x i32> %s2.o to <16 x i64>
+%s2.p = getelementptr i32, i32* %table, <16 x i64> %s2.z
+call void @llvm.masked.scatter.v16i32.v16p0i32(<16 x i32> %f.2, <16 x i32*> %s2.p, i32 4, <16 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>)
+%x.3 = add <16 x i32> %f.2, %ki512
+%f.3 = freeze <16 x i32> %x.3
+%s3.i = and <16 x i32> %f.3, <i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255, i32 255>
+%s3.o = or <16 x i32> %s3.i, <i32 0, i32 256, i32 512, i32 768, i32 1024, i32 1280, i32 1536, i32 1792, i32 2048, i32 2304, i32 2560, i32 2816, i32 3072, i32 3328, i32 3584, i32 3840>
+%s3.z = zext <16 x i32> %s3.o to <16 x i64>
+%s3.p = getelementptr i32, i32* %table, <16 x i64> %s3.z
+call void @llvm.masked.scatter.v16i32.v16p0i32(<16 x i32> %f.3, <16 x i32*> %s3.p, i32 4, <16 x i1> <i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true, i1 true>)
+%x.4 = add <16 x i32> %f.3, %ki512
+%lane = extractelement <16 x i32> %x.4, i32 0
+%lane64 = zext i32 %lane to i64
+%next_op1 = add i64 %op1, %lane64
\ No newline at end of file
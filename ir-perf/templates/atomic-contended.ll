@@ -0,0 +1,39 @@
+; Adjust the DataLayout and Triple for your target, or let llc infer them.
+; (You can `llc -march=... -o-` to see the defaults.)
+;
+; Same loop as atomic.ll, but a thread on another core (contention.c) keeps
+; adding to %slot while it runs, so every atomic has to take the line back.
+
+; Declare an external "sink" so the compiler can't optimize away your result.
+declare void @sink(i64)
+
+declare void @contention_start(i64*)
+declare void @contention_stop()
+
+; The word the atomic snippets operate on, alone on its cache line
+@shared = global [8 x i64] zeroinitializer, align 64
+
+define void @bench_loop(i64 %N) {
+entry:
+  %slot = getelementptr [8 x i64], [8 x i64]* @shared, i64 0, i64 0
+  call void @contention_start(i64* %slot)
+  br label %loop
+
+loop:
+  %iv    = phi i64 [0, %entry], [%next_iv, %loop]
+  %op1   = phi i64 [0, %entry], [%next_op1, %loop]
+
+  ; --- The instruction you want to measure: ---
+  ; Atomic pattern on %slot will be inserted here
+  ; -------------------------------------------
+
+  ; increment loop counter
+  %next_iv   = add  i64 %iv, 1
+  %cmp   = icmp slt  i64 %iv, %N
+  br     i1 %cmp, label %loop, label %exit
+
+exit:
+  call void @contention_stop()
+  call void @sink(i64 %op1)    ; prevent dead-code elimination
+  ret void
+}
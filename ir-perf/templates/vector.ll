@@ -0,0 +1,69 @@
+; Adjust the DataLayout and Triple for your target, or let llc infer them.
+; (You can `llc -march=... -o-` to see the defaults.)
+;
+; Built with llc -mcpu=${IR_PERF_VECTOR_MCPU} (default: native), so 256- and
+; 512-bit vectors use AVX2/AVX-512 where the CPU has them and are split into
+; narrower operations where it does not.
+
+; Declare an external "sink" so the compiler can't optimize away your result.
+declare void @sink(i64)
+
+declare <4 x i32> @llvm.masked.gather.v4i32.v4p0i32(<4 x i32*>, i32, <4 x i1>, <4 x i32>)
+declare <8 x i32> @llvm.masked.gather.v8i32.v8p0i32(<8 x i32*>, i32, <8 x i1>, <8 x i32>)
+declare <16 x i32> @llvm.masked.gather.v16i32.v16p0i32(<16 x i32*>, i32, <16 x i1>, <16 x i32>)
+declare void @llvm.masked.scatter.v4i32.v4p0i32(<4 x i32>, <4 x i32*>, i32, <4 x i1>)
+declare void @llvm.masked.scatter.v8i32.v8p0i32(<8 x i32>, <8 x i32*>, i32, <8 x i1>)
+declare void @llvm.masked.scatter.v16i32.v16p0i32(<16 x i32>, <16 x i32*>, i32, <16 x i1>)
+
+; Loop-invariant operands, loaded volatile so that llc cannot fold them
+@vec_ki = global [16 x i32] [i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1,
+                             i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1], align 64
+@vec_kl = global [8 x i64] [i64 1, i64 1, i64 1, i64 1, i64 1, i64 1, i64 1, i64 1], align 64
+@vec_kf = global [8 x double] [double 1.0, double 1.0, double 1.0, double 1.0,
+                               double 1.0, double 1.0, double 1.0, double 1.0], align 64
+
+; Gather/scatter target: 4096 entries (16KB), stays in L1
+@vec_table = global [4096 x i32] zeroinitializer, align 64
+
+define void @bench_loop(i64 %N) {
+entry:
+  %ki128.p = bitcast [16 x i32]* @vec_ki to <4 x i32>*
+  %ki128 = load volatile <4 x i32>, <4 x i32>* %ki128.p, align 64
+  %ki256.p = bitcast [16 x i32]* @vec_ki to <8 x i32>*
+  %ki256 = load volatile <8 x i32>, <8 x i32>* %ki256.p, align 64
+  %ki512.p = bitcast [16 x i32]* @vec_ki to <16 x i32>*
+  %ki512 = load volatile <16 x i32>, <16 x i32>* %ki512.p, align 64
+  %kl128.p = bitcast [8 x i64]* @vec_kl to <2 x i64>*
+  %kl128 = load volatile <2 x i64>, <2 x i64>* %kl128.p, align 64
+  %kl256.p = bitcast [8 x i64]* @vec_kl to <4 x i64>*
+  %kl256 = load volatile <4 x i64>, <4 x i64>* %kl256.p, align 64
+  %kl512.p = bitcast [8 x i64]* @vec_kl to <8 x i64>*
+  %kl512 = load volatile <8 x i64>, <8 x i64>* %kl512.p, align 64
+  %kf128.p = bitcast [8 x double]* @vec_kf to <2 x double>*
+  %kf128 = load volatile <2 x double>, <2 x double>* %kf128.p, align 64
+  %kf256.p = bitcast [8 x double]* @vec_kf to <4 x double>*
+  %kf256 = load volatile <4 x double>, <4 x double>* %kf256.p, align 64
+  %kf512.p = bitcast [8 x double]* @vec_kf to <8 x double>*
+  %kf512 = load volatile <8 x double>, <8 x double>* %kf512.p, align 64
+  %table = getelementptr [4096 x i32], [4096 x i32]* @vec_table, i64 0, i64 0
+  br label %loop
+
+loop:
+  %iv    = phi i64 [0, %entry], [%next_iv, %loop]
+  %op1   = phi i64 [0, %entry], [%next_op1, %loop]
+
+  ; --- The instruction you want to measure: ---
+  ; Vector pattern will be inserted here: a vector phi, the ops on it with
+  ; %ki<W>/%kl<W>/%kf<W> (<W>-bit i32/i64/double) as operands, and lane 0
+  ; folded into %next_op1
+  ; -------------------------------------------
+
+  ; increment loop counter
+  %next_iv   = add  i64 %iv, 1
+  %cmp   = icmp slt  i64 %iv, %N
+  br     i1 %cmp, label %loop, label %exit
+
+exit:
+  call void @sink(i64 %op1)    ; prevent dead-code elimination
+  ret void
+}